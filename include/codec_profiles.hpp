@@ -6,7 +6,7 @@
 //  ---
 //  • Déclare les profils prototypes (HaarTernary, AnisoRC).
 //  • Paramètres `ProtoConfig` (seulement ceux utilisés par les outils).
-//  • Helpers de trits balanced↔unbalanced (inline).
+//  • Helpers de trits balanced↔unbalanced (ré-exportés du cœur).
 //  • Prototypes de packing base-243 (5 trits → 1 octet) et de l’encodeur proto.
 //
 //  LIMITES
@@ -23,6 +23,19 @@
 //                                 std::vector<int8_t>& out_balanced,
 //                                 std::vector<uint8_t>* out_packed_base243,
 //                                 std::string& meta_json);
+//   bool decode_prototype_ternary(ProtoProfile p, uint32_t W, uint32_t H,
+//                                 const std::vector<int8_t>& balanced,
+//                                 const std::string& meta_json,
+//                                 ImageU8& outY, unsigned threads=0);
+//   bool decode_prototype_ternary(p, W, H, const int8_t* balanced, size_t n, meta_json, outY, threads=0);
+//
+//   // Layout progressif (.t3proto v2) : sections par priorité
+//   bool encode_prototype_progressive(rgb, cfg, std::vector<ProtoSection>& out, meta_json);
+//   bool decode_prototype_progressive(p, W,H, sections, meta_json, outY, threads=0);
+//
+//   // Séquence Haar (.t3proto v3) : trames clés + résidus temporels par tuile
+//   bool encode_prototype_sequence(next_frame, cfg, W,H, std::vector<ProtoSeqFrame>& out, meta_json);
+//   bool decode_prototype_sequence(p, W,H, frames, meta_json, sink, threads=0);
 //
 //   void pack_base243_from_balanced(const std::vector<int8_t>& bal, std::vector<uint8_t>& out);
 //   void unpack_base243_to_balanced(const std::vector<uint8_t>& bytes, size_t n_trits, std::vector<int8_t>& out);
@@ -41,6 +54,9 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <functional>
+
+#include "ternary_image_codec_v6_min.hpp" // trit_bal_to_unb / trit_unb_to_bal
 
 // Profil des prototypes
 enum class ProtoProfile : uint8_t { None=0, HaarTernary=1, AnisoRC=2 };
@@ -50,35 +66,69 @@ struct ProtoConfig
 {
     ProtoProfile profile = ProtoProfile::None;
 
-    // Haar
+    // Haar (0 → défaut de ProtoParams)
     int   haar_tile   = 8;
     int   haar_thresh = 6;
+    int   haar_sketchSize = 0;
+    int   haar_sketchDown = 0;
+    int   haar_radialBins = 0;
+    int   haar_angleBins  = 0;
+    bool  haar_keep_LL_u8 = true;
 
     // Aniso Ridgelet/Curvelet prototype
     int   rc_block    = 32;
     int   rc_angles   = 8;
     float rc_tern_z   = 1.2f;
+    bool  rc_keep_LL_u8 = true;
+    bool  rc_normalize  = true;
+    // Quadtree adaptatif 64→32→16 (remplace rc_block ; 0/0.f → défaut AnisoRCParams)
+    bool  rc_quadtree = false;
+    int   rc_qt_max   = 0;
+    int   rc_qt_min   = 0;
+    float rc_qt_var   = 0.f;
+
+    // Contrôle de débit 1 passe (remplace haar_thresh / rc_tern_z si actif).
+    // Le pack base-243 est à longueur fixe : la cible porte sur les trits
+    // de détail non nuls. target_nnz prioritaire ; 0 et 0.f → inactif.
+    uint64_t target_nnz     = 0;
+    float    target_density = 0.f; // fraction ]0,1] de trits de détail non nuls
+
+    // Séquence (Haar) : 1 trame clé toutes les K trames (0 → 1re seule)
+    int   seq_key_interval = 30;
 
     // Sortie packée base-243 (octets) en plus des trits balanced
     bool  pack_base243 = true;
-
-    // (Extensions possibles: keep_LL_u8, normalize_proj, etc.)
 };
 
-// --- Helpers trits (inline, sûrs)
-inline uint8_t trit_bal_to_unb(int8_t b)
+// --- Sections du layout progressif (.t3proto v2), dans l’ordre de priorité :
+//     sketch (signature spectrale) → plan LL/DC (u8, 1 par tuile/bloc) →
+//     détails HL → LH → HH (Haar) ou détails (AnisoRC), trits packés base-243.
+//     AnisoRC quadtree : structure (QTree, trits) en tête, LL = 1 par feuille.
+enum class ProtoSecKind : uint8_t { Sketch=1, LL=2, DetHL=3, DetLH=4, DetHH=5, Details=6, QTree=7 };
+enum class ProtoSecEnc  : uint8_t { U8=0, Base243=1 };
+
+struct ProtoSection
 {
-    // map {-1,0,+1} → {0,1,2} avec clamp de sûreté
-    if(b < -1) b = -1;
-    if(b > 1) b = 1;
-    return (uint8_t)(b + 1);
-}
-inline int8_t trit_unb_to_bal(uint8_t u)
+    ProtoSecKind kind = ProtoSecKind::Details;
+    ProtoSecEnc  enc  = ProtoSecEnc::Base243;
+    uint64_t     n_items = 0;       // #octets (U8) ou #trits (Base243)
+    std::vector<uint8_t> data;      // vide = section absente/tronquée
+};
+
+// --- Trames d’une séquence (.t3proto v3) : clé (intra) ou delta (tuiles
+//     sautées / résidus ternaires mod 3 + delta LL), cf. proto_temporal.hpp.
+enum class ProtoSeqFrameType : uint8_t { Key=1, Delta=2 };
+
+struct ProtoSeqFrame
 {
-    // map {0,1,2} → {-1,0,+1} avec clamp de sûreté
-    if(u > 2) u = 2;
-    return (int8_t)((int)u - 1);
-}
+    ProtoSeqFrameType type = ProtoSeqFrameType::Key;
+    uint32_t n_coded = 0;           // # tuiles avec détails (clé : toutes)
+    uint64_t n_trits = 0;           // # trits base-243 de la trame
+    std::vector<uint8_t> data;
+};
+
+// --- Helpers trits : trit_bal_to_unb / trit_unb_to_bal viennent du cœur
+//     (une seule définition, sinon redéfinition avec io_image.hpp).
 
 // --- Disponibilité des profils (implémentations en .cpp)
 bool encode_prototype_available(ProtoProfile p);
@@ -91,6 +141,53 @@ bool encode_prototype_ternary(const ImageU8& rgb,
                               std::vector<uint8_t>* out_packed_base243, // peut être nullptr
                               std::string& meta_json);
 
+// --- Décodeur prototype (balanced + meta JSON) → plan Y (c=1) W×H
+//     Tuiles/blocs reconstruits en parallèle (threads==0 → tous les cœurs).
+//     LL absent du flux → DC neutre 128 (le proto ne sérialise que les détails).
+bool decode_prototype_ternary(ProtoProfile p,
+                              uint32_t W, uint32_t H,
+                              const std::vector<int8_t>& balanced,
+                              const std::string& meta_json,
+                              ImageU8& outY,
+                              unsigned threads = 0);
+// Variante sans copie (span/buffer appelant) : balanced[0..n_balanced)
+bool decode_prototype_ternary(ProtoProfile p,
+                              uint32_t W, uint32_t H,
+                              const int8_t* balanced, size_t n_balanced,
+                              const std::string& meta_json,
+                              ImageU8& outY,
+                              unsigned threads = 0);
+
+// --- Layout progressif : encode en sections / décode avec les sections
+//     disponibles (préfixe d’un fichier : sections manquantes → 0, LL → 128).
+bool encode_prototype_progressive(const ImageU8& rgb,
+                                  const ProtoConfig& cfg,
+                                  std::vector<ProtoSection>& out_sections,
+                                  std::string& meta_json);
+bool decode_prototype_progressive(ProtoProfile p,
+                                  uint32_t W, uint32_t H,
+                                  const std::vector<ProtoSection>& sections,
+                                  const std::string& meta_json,
+                                  ImageU8& outY,
+                                  unsigned threads = 0);
+const char* proto_section_name(ProtoSecKind k);
+
+// --- Séquence (HaarTernary) : next_frame(i, rgb) fournit la trame i (false =
+//     fin) ; toutes les trames ont les dims de la 1re (W,H en sortie).
+//     Décodage : sink(i, Y) reçoit chaque plan Y W×H (false = arrêt).
+bool encode_prototype_sequence(const std::function<bool(size_t, ImageU8&)>& next_frame,
+                               const ProtoConfig& cfg,
+                               uint32_t& W, uint32_t& H,
+                               std::vector<ProtoSeqFrame>& out_frames,
+                               std::string& meta_json,
+                               unsigned threads = 0);
+bool decode_prototype_sequence(ProtoProfile p,
+                               uint32_t W, uint32_t H,
+                               const std::vector<ProtoSeqFrame>& frames,
+                               const std::string& meta_json,
+                               const std::function<bool(size_t, const ImageU8&)>& sink,
+                               unsigned threads = 0);
+
 // --- Packing base-243 (5 trits balanced → 1 octet) & inverse
 void pack_base243_from_balanced(const std::vector<int8_t>& balanced,
                                 std::vector<uint8_t>& out_bytes);
@@ -0,0 +1,66 @@
+// ============================================================================
+//  File: include/io_fastdecode.hpp — Décodeurs JPEG/PNG rapides (optionnels) (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Décoder JPEG/PNG en RGB8 avec un décodeur SIMD (libjpeg-turbo)
+//    directement dans un tampon fourni par l’appelant (pool, ImageU8::data
+//    réutilisé…) : ni tampon intermédiaire ni copie, contrairement à stb.
+//  • load_image_rgb8 (io_image.hpp) passe par ce module dès qu’un backend est
+//    compilé ; stb_image reste le repli (format non couvert, échec).
+//  • decode_rgb8_fast_scaled : JPEG décodé directement réduit dans le domaine
+//    DCT (1/2, 1/4, 1/8) à la plus petite taille qui couvre encore
+//    min_w×min_h — l’IDCT réduite évite de décoder des pixels aussitôt jetés
+//    par le resize (jusqu’à ×16 pour une vignette). PNG : pleine taille.
+//
+//  DÉPENDANCES (compile-time)
+//  --------------------------
+//  • TERNARY_USE_LIBJPEG   : JPEG via l’API libjpeg (SIMD si la lib liée est
+//                            libjpeg-turbo, cas courant des distributions).
+//  • TERNARY_USE_LIBPNG    : PNG via libpng.
+//  Avec l’une de ces macros, lier src/io_fastdecode.cpp et la bibliothèque
+//  correspondante.
+//  (Sans backend pour le format, decode_rgb8_fast retourne false proprement.)
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <functional>
+
+#if defined(TERNARY_USE_LIBJPEG) || defined(TERNARY_USE_LIBPNG)
+#define TERNARY_HAVE_FAST_DECODE 1
+#else
+#define TERNARY_HAVE_FAST_DECODE 0
+#endif
+
+namespace TernaryIO
+{
+
+/// Tampon destination pour une image w×h : w*h*3 octets, lignes contiguës
+/// (nullptr → abandon). Appelé une fois, après lecture de l’en-tête.
+using RgbAllocFn = std::function<uint8_t*(int w, int h)>;
+
+/// Backends compilés, ex. "libjpeg,libpng" ("" si aucun)
+const char* fast_decode_backends();
+
+/// JPEG/PNG → RGB8 dans le tampon de alloc ; out_backend = nom du décodeur
+/// utilisé ("libjpeg", "libpng").
+bool decode_rgb8_fast(const std::string& path,
+                      const RgbAllocFn& alloc,
+                      int& out_w, int& out_h,
+                      const char** out_backend = nullptr,
+                      std::string* err = nullptr);
+
+/// Idem, JPEG réduit (DCT) tant que out_w >= min_w et out_h >= min_h ;
+/// min_w/min_h <= 0 → pleine taille. Le redimensionnement final reste à
+/// l’appelant.
+bool decode_rgb8_fast_scaled(const std::string& path,
+                             int min_w, int min_h,
+                             const RgbAllocFn& alloc,
+                             int& out_w, int& out_h,
+                             const char** out_backend = nullptr,
+                             std::string* err = nullptr);
+
+} // namespace TernaryIO
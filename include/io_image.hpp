@@ -13,11 +13,20 @@
 //  • Décodage robuste:
 //      - Si le cœur renvoie une S27, extraction de la fenêtre centrale vers
 //        la taille (w,h) attendue; sinon usage direct.
+//  • Décodage décimé (aperçus 1/k) : seuls les mots échantillonnés sont
+//    décodés (words_to_rgb_decimated), moyenne k×k optionnelle.
 //
 //  REMARQUES
 //  ---------
 //  • La logique balanced/unbalanced vit dans le cœur; ici, uniquement le pont.
 //  • Pas d’ECC ici. Quantification Y/Cb/Cr simple et déterministe.
+//  • Chargement : libjpeg(-turbo) / libpng si compilés (io_fastdecode.hpp),
+//    stb_image en repli ; image_to_words_subword demande un JPEG déjà réduit
+//    (DCT 1/2..1/8) vers la résolution du sub, puis seulement le resize résiduel.
+//  • save_image_png : encodeur PNG multi-thread (io_png_mt.hpp, réglage via
+//    T3Png::default_options()) au lieu de stbi_write_png.
+//  • resize_rgb_area : réduction par moyenne de surface (×½ exact vectorisé
+//    SSE2), utilisée pour les échelles de proxies (FFLadderWriter).
 // ============================================================================
 
 #pragma once
@@ -27,14 +36,26 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "ternary_image_codec_v6_min.hpp" // Word27, PixelYCbCrQuant, SubwordMode, StdRes, std_res_for
+#include "io_fastdecode.hpp"               // décodeurs JPEG/PNG optionnels (TERNARY_USE_*)
+#include "io_png_mt.hpp"                   // T3Png::write_rgb8 (PNG multi-thread)
 
 // == [1] Types & déclarations stb ============================================
 struct ImageU8
 {
     int w=0,h=0,c=0;
     std::vector<uint8_t> data;
+    void swap(ImageU8& o)
+    {
+        std::swap(w,o.w);
+        std::swap(h,o.h);
+        std::swap(c,o.c);
+        data.swap(o.data);
+    }
 };
 
 extern "C" {
@@ -98,7 +119,7 @@ inline void dequantize_ycbcr(const PixelYCbCrQuant& q,uint8_t& Y,uint8_t& Cb,uin
     Cr=(uint8_t)std::clamp<int>((int)std::lround(128+q.Crq*(128.0/40.0)),0,255);
 }
 
-// == [3] Outils image (resize NN, centrage) ==================================
+// == [3] Outils image (resize NN/aire, centrage) =============================
 inline void resize_rgb_nn(const ImageU8& src,int dstW,int dstH,ImageU8& dst)
 {
     dst.w=dstW;
@@ -138,14 +159,132 @@ inline void blit_center_rgb(const ImageU8& src,int canvasW,int canvasH,ImageU8&
         std::copy(sp, sp+(size_t)src.w*3, dp);
     }
 }
+// Réduction exacte ×½ (boîte 2×2, arrondi au plus proche) ; dst = floor(w/2)×floor(h/2).
+// Passe verticale (somme de deux lignes en 16 bits) en SSE2 si dispo, puis
+// passe horizontale scalaire sur la ligne de sommes.
+inline void downsample_rgb_half(const ImageU8& src,ImageU8& dst)
+{
+    const int dw=src.w/2, dh=src.h/2;
+    dst.w=dw;
+    dst.h=dh;
+    dst.c=3;
+    dst.data.assign((size_t)dw*dh*3,0);
+    if(dw<=0||dh<=0) return;
+    const size_t n=(size_t)dw*2*3;                 // octets utiles d’une ligne source
+    std::vector<uint16_t> vs(n);
+    for(int y=0; y<dh; ++y)
+    {
+        const uint8_t* a=&src.data[(size_t)(2*y)*src.w*3];
+        const uint8_t* b=a+(size_t)src.w*3;
+        size_t i=0;
+#if defined(__SSE2__)
+        const __m128i z=_mm_setzero_si128();
+        for(; i+16<=n; i+=16)
+        {
+            const __m128i va=_mm_loadu_si128((const __m128i*)(a+i));
+            const __m128i vb=_mm_loadu_si128((const __m128i*)(b+i));
+            _mm_storeu_si128((__m128i*)(vs.data()+i),  _mm_add_epi16(_mm_unpacklo_epi8(va,z),_mm_unpacklo_epi8(vb,z)));
+            _mm_storeu_si128((__m128i*)(vs.data()+i+8),_mm_add_epi16(_mm_unpackhi_epi8(va,z),_mm_unpackhi_epi8(vb,z)));
+        }
+#endif
+        for(; i<n; ++i) vs[i]=(uint16_t)(a[i]+b[i]);
+        uint8_t* dp=&dst.data[(size_t)y*dw*3];
+        for(int x=0; x<dw; ++x)
+        {
+            const uint16_t* s=&vs[(size_t)x*6];
+            dp[x*3+0]=(uint8_t)((s[0]+s[3]+2)>>2);
+            dp[x*3+1]=(uint8_t)((s[1]+s[4]+2)>>2);
+            dp[x*3+2]=(uint8_t)((s[2]+s[5]+2)>>2);
+        }
+    }
+}
+// Réduction « aire » (moyenne des pixels source couverts, couverture fractionnaire
+// aux bords) ; ×½ exact → downsample_rgb_half ; agrandissement → resize_rgb_nn.
+inline void resize_rgb_area(const ImageU8& src,int dstW,int dstH,ImageU8& dst)
+{
+    if(src.w<=0||src.h<=0||dstW<=0||dstH<=0||dstW>src.w||dstH>src.h)
+    {
+        resize_rgb_nn(src,dstW,dstH,dst);
+        return;
+    }
+    if(src.w==2*dstW && src.h==2*dstH)
+    {
+        downsample_rgb_half(src,dst);
+        return;
+    }
+    if(src.w==dstW && src.h==dstH)
+    {
+        dst=src;
+        return;
+    }
+    dst.w=dstW;
+    dst.h=dstH;
+    dst.c=3;
+    dst.data.assign((size_t)dstW*dstH*3,0);
+    const double fy=(double)src.h/dstH, fx=(double)src.w/dstW;
+    const size_t rowN=(size_t)src.w*3;
+    std::vector<float> acc(rowN);
+    for(int y=0; y<dstH; ++y)
+    {
+        // 1) Passe verticale : lignes [y0,y1) pondérées par leur couverture
+        const double y0=y*fy, y1=(y+1)*fy;
+        std::fill(acc.begin(),acc.end(),0.0f);
+        for(int sy=(int)y0; sy<src.h && sy<y1; ++sy)
+        {
+            const float wgt=(float)((std::min<double>(sy+1,y1)-std::max<double>(sy,y0))/fy);
+            if(wgt<=0.0f) continue;
+            const uint8_t* sp=&src.data[(size_t)sy*rowN];
+            for(size_t i=0; i<rowN; ++i) acc[i]+=wgt*sp[i];
+        }
+        // 2) Passe horizontale sur la ligne accumulée
+        uint8_t* dp=&dst.data[(size_t)y*dstW*3];
+        for(int x=0; x<dstW; ++x)
+        {
+            const double x0=x*fx, x1=(x+1)*fx;
+            float s0=0,s1=0,s2=0;
+            for(int sx=(int)x0; sx<src.w && sx<x1; ++sx)
+            {
+                const float wgt=(float)((std::min<double>(sx+1,x1)-std::max<double>(sx,x0))/fx);
+                s0+=wgt*acc[(size_t)sx*3+0];
+                s1+=wgt*acc[(size_t)sx*3+1];
+                s2+=wgt*acc[(size_t)sx*3+2];
+            }
+            dp[x*3+0]=(uint8_t)std::clamp<int>((int)std::lround(s0),0,255);
+            dp[x*3+1]=(uint8_t)std::clamp<int>((int)std::lround(s1),0,255);
+            dp[x*3+2]=(uint8_t)std::clamp<int>((int)std::lround(s2),0,255);
+        }
+    }
+}
 inline int pad_even(int w)
 {
     return (w%2==0)? w : (w+1);
 }
 
 // == [4] I/O disque basiques =================================================
-inline bool load_image_rgb8(const std::string& path, ImageU8& out)
+// Backend rapide compilé (io_fastdecode.hpp) : décodage en place dans out.data
+// (capacité réutilisée d’un appel à l’autre) ; sinon stb_image + copie.
+// backend (optionnel) ← nom du décodeur utilisé.
+// load_image_rgb8_fit : l’appelant va réduire vers min_w×min_h → JPEG décodé
+// réduit (DCT) si le backend le permet ; taille de sortie >= cible, le
+// resize résiduel reste à faire.
+inline bool load_image_rgb8_fit(const std::string& path, int min_w, int min_h,
+                                ImageU8& out, const char** backend=nullptr)
 {
+#if TERNARY_HAVE_FAST_DECODE
+    int fw=0,fh=0;
+    auto into_out=[&](int w,int h)
+    {
+        out.data.resize((size_t)w*h*3);
+        return out.data.data();
+    };
+    if(TernaryIO::decode_rgb8_fast_scaled(path, min_w, min_h, into_out, fw, fh, backend))
+    {
+        out.w=fw;
+        out.h=fh;
+        out.c=3;
+        return true;
+    }
+#endif
     int x=0,y=0,n=0;
     unsigned char* pix=stbi_load(path.c_str(), &x,&y,&n, 3);
     if(!pix) return false;
@@ -154,11 +293,18 @@ inline bool load_image_rgb8(const std::string& path, ImageU8& out)
     out.c=3;
     out.data.assign(pix, pix+(size_t)x*y*3);
     stbi_image_free(pix);
+    if(backend) *backend="stb";
+    (void)min_w;
+    (void)min_h;
     return true;
 }
+inline bool load_image_rgb8(const std::string& path, ImageU8& out, const char** backend=nullptr)
+{
+    return load_image_rgb8_fit(path, 0, 0, out, backend);
+}
 inline bool save_image_png(const std::string& path, const ImageU8& img)
 {
-    return stbi_write_png(path.c_str(), img.w, img.h, 3, img.data.data(), img.w*3)!=0;
+    return T3Png::write_rgb8(path, img.data.data(), img.w, img.h, (size_t)img.w*3);
 }
 inline bool save_image_jpg(const std::string& path, const ImageU8& img, int quality=90)
 {
@@ -240,10 +386,10 @@ inline bool image_to_words_subword(const std::string& path,
                                    bool centered,
                                    std::vector<Word27>& out_words)
 {
+    const StdRes tgt = std_res_for(sub);
     ImageU8 src;
-    if(!load_image_rgb8(path, src)) return false;
+    if(!load_image_rgb8_fit(path, tgt.w, tgt.h, src)) return false;
 
-    const StdRes tgt = std_res_for(sub);
     ImageU8 work;
     if(src.w!=tgt.w || src.h!=tgt.h)
     {
@@ -336,6 +482,89 @@ inline bool words_to_image_subword(const std::vector<Word27>& words,
     return save_image_png(out_path_png, img);
 }
 
+// == [5.D] Décodage décimé (aperçus 1/k) =====================================
+// 1 pixel = 1 mot en ordre raster : l’aperçu 1/k ne décode qu’un mot sur k
+// d’une ligne sur k (centre du bloc k×k, même pixel que resize_rgb_nn pour un
+// facteur entier), ou la moyenne RGB du bloc (box=true : tous les mots du
+// bloc décodés, bande par bande). Sortie ceil(w/k) × ceil(h/k).
+// Payload S27 plein d’une image sub (embed centré) : fenêtre centrale
+// (word_raster_for, decimated_dim/decimated_pick : ternary_image_codec_v6_min.hpp).
+inline bool words_to_rgb_decimated(const Word27* words,size_t n_words,
+                                   SubwordMode sub,
+                                   int w,int h,int k,bool box,
+                                   ImageU8& out)
+{
+    WordRaster R;
+    if(k<1 || !word_raster_for((uint64_t)n_words, sub, w, h, R)) return false;
+    const size_t stride=(size_t)R.stride;
+    const int x0=R.x0, y0=R.y0;
+
+    const int dw=decimated_dim(w,k), dh=decimated_dim(h,k);
+    std::vector<Word27> s;
+    std::vector<PixelYCbCrQuant> q;
+    if(!box || k==1)
+    {
+        s.reserve((size_t)dw*dh);
+        for(int y=0; y<dh; ++y)
+        {
+            const Word27* row=words + (size_t)(y0+decimated_pick(y,k,h))*stride + (size_t)x0;
+            for(int x=0; x<dw; ++x) s.push_back(row[decimated_pick(x,k,w)]);
+        }
+        if(!decode_raw_words_to_pixels_subword(s, sub, q)) return false;
+        if(q.size()<s.size()) return false;
+        quant_stream_to_rgb(q, dw, dh, out);
+        return true;
+    }
+
+    out.w=dw;
+    out.h=dh;
+    out.c=3;
+    out.data.assign((size_t)dw*dh*3,0);
+    std::vector<uint32_t> acc((size_t)dw*3);
+    for(int y=0; y<dh; ++y)
+    {
+        const int r0=y*k, r1=std::min(h,r0+k);
+        s.clear();
+        for(int r=r0; r<r1; ++r)
+        {
+            const Word27* row=words + (size_t)(y0+r)*stride + (size_t)x0;
+            s.insert(s.end(), row, row+w);
+        }
+        if(!decode_raw_words_to_pixels_subword(s, sub, q)) return false;
+        if(q.size()<s.size()) return false;
+        std::fill(acc.begin(),acc.end(),0u);
+        for(int r=0; r<r1-r0; ++r)
+        {
+            for(int x=0; x<w; ++x)
+            {
+                uint8_t Y,Cb,Cr,R,G,B;
+                dequantize_ycbcr(q[(size_t)r*w+x],Y,Cb,Cr);
+                ycbcr_to_rgb(Y,Cb,Cr,R,G,B);
+                uint32_t* a=&acc[(size_t)(x/k)*3];
+                a[0]+=R;
+                a[1]+=G;
+                a[2]+=B;
+            }
+        }
+        uint8_t* dp=&out.data[(size_t)y*dw*3];
+        for(int x=0; x<dw; ++x)
+        {
+            const uint32_t cnt=(uint32_t)((std::min(w,(x+1)*k)-x*k)*(r1-r0));
+            for(int c=0; c<3; ++c) dp[x*3+c]=(uint8_t)((acc[(size_t)x*3+c]+cnt/2)/cnt);
+        }
+    }
+    return true;
+}
+inline bool words_to_image_decimated(const std::vector<Word27>& words,
+                                     SubwordMode sub,
+                                     int w,int h,int k,bool box,
+                                     const std::string& out_path_png)
+{
+    ImageU8 img;
+    if(!words_to_rgb_decimated(words.data(), words.size(), sub, w, h, k, box, img)) return false;
+    return save_image_png(out_path_png, img);
+}
+
 // == [5.C] Raccourcis hérités (S27) ==========================================
 inline bool image_to_words27(const std::string& path,
                              std::vector<Word27>& out_words,
@@ -0,0 +1,486 @@
+// ============================================================================
+//  File: include/io_png_mt.hpp — Écriture PNG RGB8 multi-thread (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Remplace stbi_write_png (mono-thread, deflate lent et peu efficace) pour
+//    l’extraction de frames (t3dump --extract-png, words_to_image_subword).
+//  • Image découpée en blocs de lignes ; chaque bloc est filtré (filtre PNG
+//    adaptatif par ligne) puis compressé indépendamment sur T3Par, façon
+//    pigz : flux deflate bruts terminés par un « sync flush » (alignement
+//    octet) et concaténés, la fenêtre 32 Ko du bloc précédent servant de
+//    dictionnaire. Adler-32 par bloc puis combiné ; un IDAT par bloc (CRC
+//    calculé dans le bloc).
+//
+//  NIVEAUX
+//  -------
+//   0 (« fast » / « store ») : filtre None + blocs deflate stockés — débit
+//                              mémoire, fichier ≈ taille brute.
+//   1..9                     : filtre adaptatif + deflate. Avec
+//                              TERNARY_USE_ZLIB : deflate zlib du niveau
+//                              demandé ; sinon deflate intégré (LZ77 à chaînes
+//                              de hachage + Huffman fixe), profondeur de
+//                              recherche croissante avec le niveau.
+//
+//  API
+//  ---
+//   T3Png::Options{level, threads, block_bytes}, T3Png::default_options()
+//   bool T3Png::parse_level("fast|store|speed|default|best|0..9", level)
+//   bool T3Png::encode_rgb8(rgb, w, h, stride, opt, out_bytes, err)
+//   bool T3Png::write_rgb8(path, rgb, w, h, stride, opt, err)
+//
+//  NOTES
+//  -----
+//  • Header-only ; zlib seulement si TERNARY_USE_ZLIB (lier -lz).
+//  • default_options() : réglage process-wide utilisé par save_image_png
+//    (io_image.hpp) ; les CLIs le fixent depuis leurs options.
+//  • Mémoire : une copie filtrée de l’image (h × (1+3w)) + sorties des blocs.
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#if defined(TERNARY_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "t3_parallel.hpp"  // T3Par::parallel_for
+#include "t3_crc32.hpp"     // CRC des chunks PNG
+
+namespace T3Png {
+
+struct Options {
+    int      level       = 6;  // 0 = stockage, 1..9 = deflate
+    unsigned threads     = 0;  // 0 → T3Par::hw_threads()
+    size_t   block_bytes = 0;  // octets filtrés par bloc (0 → auto)
+};
+
+inline Options& default_options()
+{
+    static Options o;
+    return o;
+}
+
+inline bool parse_level(const std::string& s, int& level)
+{
+    if(s=="fast" || s=="store"){ level = 0; return true; }
+    if(s=="speed"){ level = 1; return true; }
+    if(s=="default"){ level = 6; return true; }
+    if(s=="best"){ level = 9; return true; }
+    if(s.size()==1 && s[0]>='0' && s[0]<='9'){ level = s[0]-'0'; return true; }
+    return false;
+}
+
+// ------------------------------- Adler-32 -----------------------------------
+inline uint32_t adler32(uint32_t adler, const uint8_t* p, size_t n)
+{
+    uint32_t a = adler & 0xFFFFu, b = adler >> 16;
+    while(n)
+    {
+        size_t k = std::min<size_t>(n, 5552);   // pas de débordement avant modulo
+        n -= k;
+        while(k--){ a += *p++; b += a; }
+        a %= 65521u; b %= 65521u;
+    }
+    return (b << 16) | a;
+}
+
+// Adler de A‖B depuis adler(A), adler(B), |B| (formule zlib)
+inline uint32_t adler32_combine(uint32_t a1, uint32_t a2, uint64_t len2)
+{
+    const uint32_t BASE = 65521u;
+    const uint32_t rem = (uint32_t)(len2 % BASE);
+    uint32_t sum1 = a1 & 0xFFFFu;
+    uint32_t sum2 = (uint32_t)(((uint64_t)rem * sum1) % BASE);
+    sum1 += (a2 & 0xFFFFu) + BASE - 1;
+    sum2 += (a1 >> 16) + (a2 >> 16) + BASE - rem;
+    if(sum1 >= BASE) sum1 -= BASE;
+    if(sum1 >= BASE) sum1 -= BASE;
+    if(sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+    if(sum2 >= BASE) sum2 -= BASE;
+    return sum1 | (sum2 << 16);
+}
+
+namespace detail {
+
+// ------------------------------- Filtres ------------------------------------
+inline uint8_t paeth(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if(pa <= pb && pa <= pc) return (uint8_t)a;
+    return (uint8_t)(pb <= pc ? b : c);
+}
+
+// Ligne filtrée (octet de type + n octets) ; prev==nullptr → ligne nulle.
+// adaptive : filtre minimisant Σ|octet signé| (heuristique libpng).
+inline void filter_row(const uint8_t* cur, const uint8_t* prev, size_t n, bool adaptive,
+                       uint8_t* out, uint8_t* tmp)
+{
+    if(!adaptive)
+    {
+        out[0] = 0;
+        std::memcpy(out + 1, cur, n);
+        return;
+    }
+    auto cost_of = [](const uint8_t* d, size_t m){
+        uint64_t c = 0;
+        for(size_t i=0; i<m; ++i) c += (d[i] < 128) ? d[i] : 256 - d[i];
+        return c;
+    };
+    auto keep = [&](int f, uint64_t cost, uint64_t& best){
+        if(cost >= best) return;
+        best = cost;
+        out[0] = (uint8_t)f;
+        std::memcpy(out + 1, tmp, n);
+    };
+
+    // None
+    out[0] = 0;
+    std::memcpy(out + 1, cur, n);
+    uint64_t best = cost_of(cur, n);
+    // Sub
+    std::memcpy(tmp, cur, std::min<size_t>(3, n));
+    for(size_t i=3; i<n; ++i) tmp[i] = (uint8_t)(cur[i] - cur[i-3]);
+    keep(1, cost_of(tmp, n), best);
+    if(!prev) return;   // ligne nulle au-dessus : Up = None, Paeth = Sub
+    // Up
+    for(size_t i=0; i<n; ++i) tmp[i] = (uint8_t)(cur[i] - prev[i]);
+    keep(2, cost_of(tmp, n), best);
+    // Avg
+    for(size_t i=0; i<n; ++i) tmp[i] = (uint8_t)(cur[i] - (((i >= 3 ? cur[i-3] : 0) + prev[i]) >> 1));
+    keep(3, cost_of(tmp, n), best);
+    // Paeth
+    for(size_t i=0; i<3 && i<n; ++i) tmp[i] = (uint8_t)(cur[i] - prev[i]);
+    for(size_t i=3; i<n; ++i) tmp[i] = (uint8_t)(cur[i] - paeth(cur[i-3], prev[i], prev[i-3]));
+    keep(4, cost_of(tmp, n), best);
+}
+
+// ------------------------------- Sortie bits --------------------------------
+struct BitOut {
+    std::vector<uint8_t>& out;
+    uint64_t acc = 0;
+    int      n   = 0;
+    explicit BitOut(std::vector<uint8_t>& o) : out(o) {}
+    void put(uint32_t bits, int cnt)
+    {
+        acc |= (uint64_t)bits << n;
+        n += cnt;
+        while(n >= 8){ out.push_back((uint8_t)acc); acc >>= 8; n -= 8; }
+    }
+    void align(){ if(n > 0){ out.push_back((uint8_t)acc); acc = 0; n = 0; } }
+};
+
+inline uint32_t rev_bits(uint32_t c, int len)
+{
+    uint32_t r = 0;
+    for(int i=0; i<len; ++i){ r = (r << 1) | (c & 1u); c >>= 1; }
+    return r;
+}
+
+// Tables deflate (RFC 1951 §3.2.5) : codes Huffman fixes pré-inversés
+struct Tables {
+    uint16_t lit_code[288]; uint8_t lit_len[288];
+    uint8_t  len_sym[259];          // longueur 3..258 → index 0..28
+    uint8_t  dist_lo[257];          // distance 1..256 → code
+    uint8_t  dist_hi[256];          // (distance-1)>>7 pour distance > 256
+    static constexpr uint16_t lbase[29] = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+    static constexpr uint8_t  lext[29]  = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+    static constexpr uint16_t dbase[30] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+    static constexpr uint8_t  dext[30]  = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+    Tables()
+    {
+        for(int s=0; s<288; ++s)
+        {
+            uint32_t c; int l;
+            if(s < 144){ c = 0x30 + s; l = 8; }
+            else if(s < 256){ c = 0x190 + (s - 144); l = 9; }
+            else if(s < 280){ c = (uint32_t)(s - 256); l = 7; }
+            else { c = 0xC0 + (s - 280); l = 8; }
+            lit_code[s] = (uint16_t)rev_bits(c, l);
+            lit_len[s] = (uint8_t)l;
+        }
+        for(int L=3, k=0; L<=258; ++L)
+        {
+            while(k < 28 && lbase[k+1] <= L) ++k;
+            len_sym[L] = (uint8_t)k;
+        }
+        for(int d=1, k=0; d<=256; ++d)
+        {
+            while(k < 29 && dbase[k+1] <= d) ++k;
+            dist_lo[d] = (uint8_t)k;
+        }
+        for(int i=0, k=0; i<256; ++i)
+        {
+            const int d = (i << 7) + 1;
+            while(k < 29 && dbase[k+1] <= d) ++k;
+            dist_hi[i] = (uint8_t)k;
+        }
+    }
+};
+
+inline const Tables& tables()
+{
+    static const Tables T;
+    return T;
+}
+
+// Bloc deflate « sync flush » : bloc stocké vide → sortie alignée, BFINAL=0
+inline void sync_flush(BitOut& bo)
+{
+    bo.put(0, 3);
+    bo.align();
+    const uint8_t tail[4] = {0x00, 0x00, 0xFF, 0xFF};
+    bo.out.insert(bo.out.end(), tail, tail + 4);
+}
+
+// Stockage : blocs de ≤ 65535 octets, BFINAL=0
+inline void deflate_store(const uint8_t* p, size_t n, std::vector<uint8_t>& out)
+{
+    out.reserve(out.size() + n + (n / 65535 + 1) * 5);
+    while(n)
+    {
+        const size_t k = std::min<size_t>(n, 65535);
+        const uint8_t hdr[5] = {0x00, (uint8_t)k, (uint8_t)(k >> 8), (uint8_t)~k, (uint8_t)(~k >> 8)};
+        out.insert(out.end(), hdr, hdr + 5);
+        out.insert(out.end(), p, p + k);
+        p += k; n -= k;
+    }
+}
+
+// Deflate intégré : LZ77 (chaînes de hachage sur 3 octets, fenêtre 32 Ko)
+// + Huffman fixe. buf[0..start) = dictionnaire, buf[start..end) = données.
+inline void deflate_fixed(const uint8_t* buf, size_t start, size_t end, int level,
+                          std::vector<uint8_t>& out)
+{
+    static const int chain_for[10] = {0, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+    static const int nice_for[10]  = {0, 16, 32, 32, 64, 128, 128, 258, 258, 258};
+    const int max_chain = chain_for[std::clamp(level, 1, 9)];
+    const int nice = nice_for[std::clamp(level, 1, 9)];
+    const int max_insert = level <= 3 ? 4 : 258;   // niveaux rapides : longues répétitions non indexées
+    const size_t WIN = 32768;
+    const int HBITS = 15;
+
+    const Tables& T = tables();
+    const size_t base = start > WIN ? start - WIN : 0;   // positions relatives à base
+    std::vector<int32_t> head((size_t)1 << HBITS, -1);
+    std::vector<int32_t> prev(end - base, -1);
+    auto hash = [&](size_t i){
+        const uint32_t v = (uint32_t)buf[i] | ((uint32_t)buf[i+1] << 8) | ((uint32_t)buf[i+2] << 16);
+        return (v * 2654435761u) >> (32 - HBITS);
+    };
+    auto insert = [&](size_t i){
+        if(i + 3 > end) return;
+        const uint32_t h = hash(i);
+        prev[i - base] = head[h];
+        head[h] = (int32_t)(i - base);
+    };
+    for(size_t i=base; i<start; ++i) insert(i);
+
+    out.reserve(out.size() + (end - start) / 2 + 64);
+    BitOut bo(out);
+    bo.put(0, 1);               // BFINAL=0
+    bo.put(1, 2);               // BTYPE=01 (Huffman fixe)
+    auto lit = [&](int s){ bo.put(T.lit_code[s], T.lit_len[s]); };
+
+    size_t i = start;
+    while(i < end)
+    {
+        int best_len = 0;
+        size_t best_dist = 0;
+        if(i + 3 <= end)
+        {
+            const size_t max_len = std::min<size_t>(258, end - i);
+            int32_t cand = head[hash(i)];
+            for(int chain=0; cand >= 0 && chain < max_chain; ++chain)
+            {
+                const size_t c = base + (size_t)cand;
+                const size_t dist = i - c;
+                if(dist > WIN) break;
+                if(buf[c + best_len] == buf[i + best_len])
+                {
+                    size_t L = 0;
+                    while(L < max_len && buf[c + L] == buf[i + L]) ++L;
+                    if((int)L > best_len){ best_len = (int)L; best_dist = dist; if(best_len >= nice) break; }
+                }
+                cand = prev[(size_t)cand];
+            }
+        }
+        if(best_len >= 3)
+        {
+            const int ls = T.len_sym[best_len];
+            lit(257 + ls);
+            if(Tables::lext[ls]) bo.put((uint32_t)(best_len - Tables::lbase[ls]), Tables::lext[ls]);
+            const int ds = best_dist <= 256 ? T.dist_lo[best_dist] : T.dist_hi[(best_dist - 1) >> 7];
+            bo.put(rev_bits((uint32_t)ds, 5), 5);
+            if(Tables::dext[ds]) bo.put((uint32_t)(best_dist - Tables::dbase[ds]), Tables::dext[ds]);
+            if(best_len <= max_insert) for(int k=0; k<best_len; ++k) insert(i + k);
+            else insert(i);
+            i += (size_t)best_len;
+        }
+        else
+        {
+            lit(buf[i]);
+            insert(i);
+            ++i;
+        }
+    }
+    lit(256);                   // fin de bloc
+    sync_flush(bo);
+}
+
+#if defined(TERNARY_USE_ZLIB)
+inline bool deflate_zlib(const uint8_t* buf, size_t start, size_t end, int level,
+                         std::vector<uint8_t>& out)
+{
+    z_stream zs{};
+    if(deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+    const size_t dict = std::min<size_t>(start, 32768);
+    if(dict) deflateSetDictionary(&zs, buf + start - dict, (uInt)dict);
+    out.resize(deflateBound(&zs, (uLong)(end - start)) + 16);
+    zs.next_in = const_cast<Bytef*>(buf + start);
+    zs.avail_in = (uInt)(end - start);
+    zs.next_out = out.data();
+    zs.avail_out = (uInt)out.size();
+    const int rc = deflate(&zs, Z_SYNC_FLUSH);
+    const bool ok = (rc == Z_OK || rc == Z_BUF_ERROR) && zs.avail_in == 0;
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return ok;
+}
+#endif
+
+inline void put_be32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+using Sink = std::function<bool(const void*, size_t)>;
+
+inline uint32_t chunk_crc(const char type[4], const uint8_t* data, size_t n)
+{
+    return T3Crc32::update(T3Crc32::crc32(type, 4), data, n);
+}
+
+inline bool put_chunk(const Sink& sink, const char type[4], const uint8_t* data, size_t n, uint32_t crc)
+{
+    uint8_t hdr[8];
+    put_be32(hdr, (uint32_t)n);
+    std::memcpy(hdr + 4, type, 4);
+    uint8_t tail[4];
+    put_be32(tail, crc);
+    return sink(hdr, 8) && (n == 0 || sink(data, n)) && sink(tail, 4);
+}
+
+inline bool encode(const uint8_t* rgb, int w, int h, size_t stride, const Options& opt,
+                   const Sink& sink, std::string* err)
+{
+    auto fail = [&](const char* m){ if(err) *err = m; return false; };
+    if(!rgb || w <= 0 || h <= 0 || w > 0x3FFFFFFF / 3 || h > 0x7FFFFFFF) return fail("png: bad image size");
+    const size_t row = (size_t)w * 3;
+    if(stride == 0) stride = row;
+    if(stride < row) return fail("png: stride < 3*w");
+    const size_t frow = row + 1;
+    const int level = std::clamp(opt.level, 0, 9);
+    const unsigned threads = opt.threads ? opt.threads : T3Par::hw_threads();
+
+    // 1) Filtrage (lignes indépendantes : la ligne précédente vient de la source)
+    std::vector<uint8_t> filt(frow * (size_t)h);
+    T3Par::parallel_for((size_t)h, [&](size_t b, size_t e){
+        std::vector<uint8_t> tmp(row);
+        for(size_t y=b; y<e; ++y)
+            filter_row(rgb + y*stride, y ? rgb + (y-1)*stride : nullptr, row, level > 0,
+                       filt.data() + y*frow, tmp.data());
+    }, threads);
+
+    // 2) Blocs de lignes compressés en parallèle (fenêtre du bloc précédent)
+    size_t bb = opt.block_bytes;
+    if(bb == 0) bb = std::clamp<size_t>(filt.size() / ((size_t)threads * 2), (size_t)256 << 10, (size_t)4 << 20);
+    bb = std::min<size_t>(bb, (size_t)64 << 20);
+    const size_t rows_per = std::max<size_t>(1, bb / frow);
+    const size_t nblocks = ((size_t)h + rows_per - 1) / rows_per;
+
+    std::vector<std::vector<uint8_t>> comp(nblocks);
+    std::vector<uint32_t> adl(nblocks), crc(nblocks);
+    std::vector<char> ok(nblocks, 1);
+    T3Par::parallel_for(nblocks, [&](size_t b, size_t e){
+        for(size_t k=b; k<e; ++k)
+        {
+            const size_t s = k * rows_per * frow;
+            const size_t t = std::min(filt.size(), s + rows_per * frow);
+            adl[k] = adler32(1, filt.data() + s, t - s);
+            if(level == 0) deflate_store(filt.data() + s, t - s, comp[k]);
+#if defined(TERNARY_USE_ZLIB)
+            else ok[k] = deflate_zlib(filt.data(), s, t, level, comp[k]);
+#else
+            else deflate_fixed(filt.data(), s, t, level, comp[k]);
+#endif
+            crc[k] = chunk_crc("IDAT", comp[k].data(), comp[k].size());
+        }
+    }, threads, 1);
+    for(char c : ok) if(!c) return fail("png: deflate failed");
+
+    uint32_t adler = adl[0];
+    for(size_t k=1; k<nblocks; ++k)
+    {
+        const size_t s = k * rows_per * frow;
+        adler = adler32_combine(adler, adl[k], std::min(filt.size(), s + rows_per * frow) - s);
+    }
+
+    // 3) Assemblage : signature, IHDR, IDAT(en-tête zlib), IDAT×bloc, IDAT(fin), IEND
+    static const uint8_t sig[8] = {0x89,'P','N','G','\r','\n',0x1A,'\n'};
+    uint8_t ihdr[13];
+    put_be32(ihdr, (uint32_t)w);
+    put_be32(ihdr + 4, (uint32_t)h);
+    ihdr[8] = 8; ihdr[9] = 2; ihdr[10] = 0; ihdr[11] = 0; ihdr[12] = 0;   // RGB8, non entrelacé
+    const uint8_t zhdr[2] = {0x78, (uint8_t)(level == 0 ? 0x01 : level < 6 ? 0x5E : level == 6 ? 0x9C : 0xDA)};
+    uint8_t ztail[6] = {0x03, 0x00};   // bloc final vide (Huffman fixe, BFINAL=1)
+    put_be32(ztail + 2, adler);
+
+    bool good = sink(sig, 8)
+             && put_chunk(sink, "IHDR", ihdr, 13, chunk_crc("IHDR", ihdr, 13))
+             && put_chunk(sink, "IDAT", zhdr, 2, chunk_crc("IDAT", zhdr, 2));
+    for(size_t k=0; good && k<nblocks; ++k)
+    {
+        good = put_chunk(sink, "IDAT", comp[k].data(), comp[k].size(), crc[k]);
+        std::vector<uint8_t>().swap(comp[k]);
+    }
+    good = good && put_chunk(sink, "IDAT", ztail, 6, chunk_crc("IDAT", ztail, 6))
+                && put_chunk(sink, "IEND", nullptr, 0, chunk_crc("IEND", nullptr, 0));
+    return good ? true : fail("png: write failed");
+}
+
+} // namespace detail
+
+inline bool encode_rgb8(const uint8_t* rgb, int w, int h, size_t stride, const Options& opt,
+                        std::vector<uint8_t>& out, std::string* err = nullptr)
+{
+    out.clear();
+    return detail::encode(rgb, w, h, stride, opt, [&](const void* p, size_t n){
+        out.insert(out.end(), (const uint8_t*)p, (const uint8_t*)p + n);
+        return true;
+    }, err);
+}
+
+inline bool write_rgb8(const std::string& path, const uint8_t* rgb, int w, int h, size_t stride,
+                       const Options& opt = default_options(), std::string* err = nullptr)
+{
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if(!f){ if(err) *err = "png: cannot open " + path; return false; }
+    bool ok = detail::encode(rgb, w, h, stride, opt, [&](const void* p, size_t n){
+        return std::fwrite(p, 1, n, f) == n;
+    }, err);
+    if(std::fclose(f) != 0 && ok){ ok = false; if(err) *err = "png: write failed"; }
+    if(!ok) std::remove(path.c_str());
+    return ok;
+}
+
+} // namespace T3Png
@@ -18,6 +18,78 @@
 //      u32 meta_len, u64 words_count, u32 hdr_crc32,
 //      meta_json[meta_len], words[words_count]*sizeof(Word27LE), u32 payload_crc32
 //  • T3V6 : idem avec frame_count et table d’offsets simple (v6-min).
+//      ver=6 : index n × { u64 offset, u64 words, u32 meta_len }
+//      ver=7 : u32 tb_num, u32 tb_den, index n × { u64 offset, u64 words,
+//              u32 meta_len, u32 flags, i64 pts }, u32 index_crc32
+//              (pts en unités tb_num/tb_den s, croissants ; flags : T3V_FRAME_*)
+//    Un fichier ver=6 est lu avec pts = i, flags = KEY et tb = 1/fps (clé
+//    "fps" de la méta globale, sinon 1 s).
+//  • T3PL (.t3pl, plans de trits, raffinement progressif — t3_tritplanes.hpp) :
+//      magic[4]="T3PL", u8 ver=1, u8 sub, u16 w, u16 h, u8 n_planes, u8 rsv,
+//      u32 meta_len, u64 words_count,
+//      n_planes × { u8 digit, u8 rsv[3], u64 offset, u32 bytes, u32 crc32 },
+//      u32 hdr_crc32 (champs ver.. + table), meta_json[meta_len],
+//      plans base-243 (ordre T3Planes::kPlaneDigit, MSB → LSB)
+//    Un fichier tronqué reste lisible : les plans complets (CRC ok) sont
+//    utilisés, les chiffres manquants valent le milieu de l’intervalle.
+//
+//  • T3A1 (.t3a, archive de .t3p, ajout seul) :
+//      header 32 o : magic[4]="T3A1", u8 ver=1, u8 rsv, u16 rsv,
+//                    u64 dir_offset, u64 dir_bytes, u32 dir_crc32, u32 n_entries
+//      blobs .t3p complets (T3P6, octet pour octet), puis répertoire central :
+//        n_entries × 48 o { u64 name_hash, u64 offset, u64 bytes, u64 meta_offset,
+//                           u32 meta_len, u16 w, u16 h, u8 sub, u8 rsv,
+//                           u16 name_len, u32 name_ofs }
+//        n_slots (u32, puissance de 2) + slots[n_slots] (u32 : index+1, 0 = vide)
+//        noms concaténés (UTF-8)
+//    name_hash = FNV-1a 64 ; table ouverte (sondage linéaire) → recherche O(1).
+//    Ajout : nouveaux blobs + nouveau répertoire en fin de fichier, puis le
+//    header (seule écriture en place) bascule dessus : un ajout interrompu
+//    laisse l’archive lisible dans son état précédent. Un nom déjà présent
+//    est remplacé (l’ancien blob devient inaccessible).
+//    Lecture par mmap (POSIX ; sinon fichier chargé en mémoire).
+//
+//  • T3K1 (.t3k, magasin de chunks adressé par contenu — t3_chunkstore.hpp) :
+//      header 16 o : magic[4]="T3K1", u8 ver=1, u8 rsv[3], u64 gen
+//      enregistrements : { u64 hash_lo, u64 hash_hi, u32 bytes, data[bytes] }
+//    Index <pack>.idx : magic[4]="T3KI", u8 ver=1, u8 rsv[3], u64 gen,
+//      u64 pack_end, u64 n, n × 32 o { u64 hash_lo, u64 hash_hi, u64 offset,
+//      u32 bytes, u32 refs }, u32 crc32 (tout ce qui précède, magic exclu).
+//    L’index est réécrit (fichier temporaire + rename) à chaque commit : c’est
+//    le point de validation ; les octets du pack au-delà de pack_end (écriture
+//    interrompue) sont ignorés puis recouverts. gc() écrit <pack>.gc et
+//    <pack>.idx.gc (gen+1) puis renomme le pack (bascule) et l’index ;
+//    l’ouverture termine une bascule interrompue (gen du pack == gen de .idx.gc).
+//  • T3R1 (.t3r, image/vidéo par références de chunks) :
+//      magic[4]="T3R1", u8 ver=1, u8 sub, u16 w, u16 h, u16 tile_w, u16 tile_h,
+//      u32 frame_count, u32 meta_len, meta_json[meta_len],
+//      frame_count × { u32 meta_len, u64 words, u32 n_chunks, u32 payload_crc32,
+//                      meta[meta_len], n_chunks × { u64 hash_lo, u64 hash_hi } },
+//      u32 crc32 (tout ce qui précède, magic exclu)
+//    Le conteneur ne porte que des références : ajout d’un conteneur =
+//    nouveaux chunks seulement (+1 ref par référence), release = -1 ref,
+//    gc() recopie les chunks encore référencés dans un nouveau pack.
+//  • T3S1 (.t3s, vidéo répartie sur N segments .t3g, un par disque) :
+//      manifeste : magic[4]="T3S1", u8 ver=1, u8 sub, u16 w, u16 h,
+//        u16 n_segments, u64 set_id, u64 frame_count, u32 meta_len,
+//        meta_json[meta_len], n_segments × { u16 path_len, path },
+//        frame_count × 24 o { u64 offset, u64 words, u32 meta_len, u16 seg,
+//                             u16 rsv },
+//        u32 crc32 (tout ce qui précède, magic exclu)
+//      segment : magic[4]="T3G1", u8 ver=1, u8 rsv, u16 seg, u64 set_id,
+//        puis blocs frame { meta, words, u32 payload_crc32 } (comme T3V6)
+//    Frame i → segment i % n_segments (round-robin), un thread d’écriture
+//    par segment ; le manifeste (index unifié) est écrit à la fermeture.
+//    Chemins de segments relatifs = relatifs au dossier du manifeste.
+//
+//  • T3PMapWriter / T3VMapWriter : mêmes formats T3P6 / T3V6, écrits en place
+//    dans le fichier projeté (méta complétée pour aligner les mots sur 4 o).
+//  • Vérification (t3_verify) : fichier projeté (mmap, accès séquentiel
+//    annoncé), header + index contrôlés puis CRC32 de chaque payload
+//    (.t3p / frames .t3v / entrées .t3a) en parallèle ; les payloads de plus
+//    de 4 Mo sont découpés et leurs CRC combinés (t3_crc32.hpp).
+//  • Lecture décimée (t3p_read_decimated / t3v_read_frame_decimated) : aperçu
+//    1/k par lecture des seules lignes échantillonnées (1/k² des octets).
 //
 //  NB : Endianness : little-endian pour les champs numériques et Word27.u.
 // ============================================================================
@@ -27,8 +99,12 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <cstdio>
+#include <unordered_map>
+#include <memory>
 
 #include "ternary_image_codec_v6_min.hpp" // Word27, SubwordMode
+#include "t3_chunkstore.hpp"              // T3Chunk::Hash128, Layout, ChunkCache
 
 namespace T3Container {
 
@@ -59,6 +135,21 @@ struct T3VFrameIndex {
     uint64_t offset = 0;   // offset fichier de début du bloc frame
     uint64_t words = 0;    // nombre de mots Word27 dans la frame
     uint32_t meta_len = 0; // longueur méta JSON par frame
+    uint32_t flags = 0;    // T3V_FRAME_* (ver 7)
+    int64_t  pts = 0;      // horodatage en unités de T3VTimeBase (ver 7)
+};
+
+constexpr uint32_t T3V_FRAME_KEY = 1u; // frame décodable seule (début de GOP)
+
+// pts * num / den = secondes
+struct T3VTimeBase {
+    uint32_t num = 1, den = 1;
+    double seconds(int64_t pts) const { return (double)pts * num / den; }
+};
+
+struct T3VFrameTime {
+    int64_t  pts = 0;
+    uint32_t flags = T3V_FRAME_KEY;
 };
 
 bool t3v_write(const std::string& path,
@@ -68,12 +159,35 @@ bool t3v_write(const std::string& path,
                const std::vector<std::string>& metas_per_frame, // size==frames.size() ou vide
                std::string* err = nullptr);
 
+// Variante horodatée (ver 7) : times.size()==frames.size(), pts croissants
+bool t3v_write_timed(const std::string& path,
+                     SubwordMode sub, int w, int h,
+                     const std::vector<std::vector<Word27>>& frames,
+                     const std::vector<T3VFrameTime>& times,
+                     const T3VTimeBase& tb,
+                     const std::string& meta_json_global,
+                     const std::vector<std::string>& metas_per_frame,
+                     std::string* err = nullptr);
+
 bool t3v_read_header(const std::string& path,
                      SubwordMode& out_sub, int& out_w, int& out_h,
                      std::string& out_meta_json_global,
                      uint64_t& out_frame_count,
                      std::vector<T3VFrameIndex>& out_index,
-                     std::string* err = nullptr);
+                     std::string* err = nullptr,
+                     T3VTimeBase* out_tb = nullptr);
+
+// Recherche dichotomique dans l’index : dernière frame de pts <= t (0 si t
+// précède la première) ; key_only → keyframe qui la précède. -1 si vide.
+long t3v_seek_time(const std::vector<T3VFrameIndex>& index,
+                   const T3VTimeBase& tb, double t_seconds,
+                   bool key_only = false);
+
+// Idem depuis le fichier (lecture du header + index seulement)
+bool t3v_seek_time(const std::string& path, double t_seconds,
+                   uint64_t& out_frame_idx,
+                   bool key_only = false,
+                   std::string* err = nullptr);
 
 // Lecture sécurisée de 1 frame (approve_meta sur méta frame)
 bool t3v_read_frame(const std::string& path,
@@ -82,4 +196,435 @@ bool t3v_read_frame(const std::string& path,
                     std::vector<Word27>& out_words,
                     std::string* err = nullptr);
 
+// Aperçu 1/k sans lecture complète (1 pixel = 1 mot, ordre raster) : seules
+// les lignes échantillonnées (centre de chaque bloc k×k, comme
+// words_to_rgb_decimated) sont lues, un mot sur k gardé. out_words = image
+// out_w × out_h = ceil(w/k) × ceil(h/k) ; payload S27 plein d’une image sub
+// (embed centré) → fenêtre centrale. approve_meta comme pour la lecture
+// complète ; CRC payload non vérifié (lecture partielle : voir t3_verify).
+bool t3p_read_decimated(const std::string& path, int k,
+                        const ApproveMetaFn& approve_meta,
+                        std::vector<Word27>& out_words,
+                        int& out_w, int& out_h,
+                        std::string* err = nullptr);
+
+bool t3v_read_frame_decimated(const std::string& path,
+                              uint64_t frame_idx, int k,
+                              const ApproveMetaFn& approve_meta,
+                              std::vector<Word27>& out_words,
+                              int& out_w, int& out_h,
+                              std::string* err = nullptr);
+
+// Montage sans décodage : les blocs frame { méta, mots, CRC } sont copiés
+// tels quels (copy_file_range : reflink ou copie côté noyau si disponible),
+// seuls header et index sont réécrits. Méta globale = celle du 1er fichier ;
+// ver 7 si une entrée est ver 7 (timebase du 1er fichier, pts convertis et
+// rebasés : la sortie commence à 0, chaque fichier suit le précédent).
+// Sortie écrite dans `out`.tmp puis renommée ; sortie = une entrée
+// (même st_dev/st_ino) refusée.
+struct T3VEditStats {
+    uint64_t frames = 0;
+    uint64_t bytes = 0;          // octets de blocs frame copiés
+    bool kernel_copy = false;    // copy_file_range utilisé (sinon lecture/écriture)
+};
+
+// Frames [begin, end) de `in` → `out`
+bool t3v_cut(const std::string& in, uint64_t begin, uint64_t end,
+             const std::string& out,
+             T3VEditStats* stats = nullptr, std::string* err = nullptr);
+
+// Concaténation (même sub/w/h)
+bool t3v_concat(const std::vector<std::string>& inputs,
+                const std::string& out,
+                T3VEditStats* stats = nullptr, std::string* err = nullptr);
+
+// ---------------------------- API .t3pl (plans de trits) -------------------
+struct T3PLPlaneIndex {
+    uint8_t  digit = 0;    // chiffre base-3 du code pixel (0..12)
+    uint64_t offset = 0;   // offset fichier du plan
+    uint32_t bytes = 0;    // taille packée base-243
+    uint32_t crc32 = 0;    // CRC32 du plan
+};
+
+bool t3pl_write(const std::string& path,
+                SubwordMode sub, int w, int h,
+                const std::vector<Word27>& words,
+                const std::string& meta_json,
+                std::string* err = nullptr);
+
+bool t3pl_read_header(const std::string& path,
+                      SubwordMode& out_sub, int& out_w, int& out_h,
+                      std::string& out_meta_json,
+                      uint64_t& out_words_count,
+                      std::vector<T3PLPlaneIndex>& out_planes,
+                      std::string* err = nullptr);
+
+// Lecture des max_planes premiers plans (arrêt anticipé sur troncature ou
+// CRC invalide) → mots reconstruits ; out_planes_read = #plans utilisés.
+bool t3pl_read(const std::string& path,
+               const ApproveMetaFn& approve_meta,
+               int max_planes,
+               std::vector<Word27>& out_words,
+               int* out_planes_read = nullptr,
+               std::string* err = nullptr);
+
+// ---------------------------- API .t3a (archive) ----------------------------
+struct T3AEntry {
+    std::string name;
+    uint64_t name_hash = 0;   // FNV-1a 64 du nom
+    uint64_t offset = 0;      // début du blob .t3p dans l’archive
+    uint64_t bytes = 0;       // taille du blob
+    uint64_t meta_offset = 0; // offset absolu de la méta JSON
+    uint32_t meta_len = 0;
+    uint16_t w = 0, h = 0;
+    SubwordMode sub = SubwordMode::S27;
+};
+
+uint64_t t3a_name_hash(const std::string& name);
+
+// Lecteur : archive projetée en mémoire ; entrées décodées à la demande
+// depuis le répertoire (ouverture sans allocation par entrée), recherche
+// par nom et extraction en O(1).
+class T3AReader {
+public:
+    T3AReader() = default;
+    ~T3AReader();
+    T3AReader(const T3AReader&) = delete;
+    T3AReader& operator=(const T3AReader&) = delete;
+
+    bool open(const std::string& path, std::string* err = nullptr);
+    void close();
+
+    size_t size() const { return n_; }
+    T3AEntry entry(size_t i) const;
+
+    // Index de l’entrée `name` (-1 si absente)
+    long find(const std::string& name) const;
+
+    // Blob .t3p brut (pointeur dans la projection, valide jusqu’à close())
+    const uint8_t* blob(size_t i, size_t* n) const;
+    std::string meta(size_t i) const;
+
+    // Lecture sécurisée : approve_meta(meta) avant le décodage du payload
+    bool read_payload(size_t i, const ApproveMetaFn& approve_meta,
+                      std::vector<Word27>& out_words,
+                      std::string* err = nullptr) const;
+
+    // Copie du blob vers un fichier .t3p autonome
+    bool extract_t3p(size_t i, const std::string& out_path,
+                     std::string* err = nullptr) const;
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t len_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> heap_;    // repli sans mmap
+    const uint8_t* dir_ = nullptr; // répertoire (entrées | slots | noms)
+    const uint8_t* slots_ = nullptr;
+    const uint8_t* names_ = nullptr;
+    size_t n_ = 0, n_slots_ = 0, names_len_ = 0;
+};
+
+// Écrivain en ajout seul : open() crée ou reprend une archive, add_*()
+// ajoute des blobs en fin de fichier, commit() écrit le répertoire.
+class T3AWriter {
+public:
+    T3AWriter() = default;
+    ~T3AWriter();
+    T3AWriter(const T3AWriter&) = delete;
+    T3AWriter& operator=(const T3AWriter&) = delete;
+
+    bool open(const std::string& path, std::string* err = nullptr);
+
+    bool add(const std::string& name,
+             SubwordMode sub, int w, int h,
+             const std::vector<Word27>& words,
+             const std::string& meta_json,
+             std::string* err = nullptr);
+
+    // Ajoute un .t3p existant tel quel (header vérifié)
+    bool add_t3p_file(const std::string& name, const std::string& t3p_path,
+                      std::string* err = nullptr);
+
+    // Répertoire + bascule du header ; l’archive reste ouverte pour d’autres ajouts
+    bool commit(std::string* err = nullptr);
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    bool append_entry(T3AEntry e, std::string* err);
+
+    std::FILE* f_ = nullptr;
+    uint64_t end_ = 0;             // fin des données (prochain blob)
+    bool dirty_ = false;
+    std::vector<T3AEntry> entries_;
+    std::unordered_map<std::string, size_t> index_; // nom -> entrée
+};
+
+// ---------------------------- API .t3k / .t3r (chunks) ----------------------
+struct T3KStats {
+    uint64_t chunks = 0;        // références écrites
+    uint64_t chunks_new = 0;    // chunks réellement ajoutés au pack
+    uint64_t bytes_in = 0;      // octets de payload (Word27) soumis
+    uint64_t bytes_written = 0; // octets ajoutés au pack
+};
+
+struct T3RFrame {
+    std::string meta;
+    uint64_t words = 0;
+    uint32_t payload_crc32 = 0;            // CRC32 des mots de la frame
+    std::vector<T3Chunk::Hash128> refs;    // ordre T3Chunk::grid_for
+};
+
+struct T3RInfo {
+    SubwordMode sub = SubwordMode::S27;
+    int w = 0, h = 0;
+    T3Chunk::Layout layout;
+    std::string meta_json;
+    std::vector<T3RFrame> frames;
+};
+
+bool t3r_read_header(const std::string& path, T3RInfo& out, std::string* err = nullptr);
+
+// Magasin : un pack .t3k + son index. Un seul écrivain à la fois ; lecture
+// à travers un cache LRU (T3Chunk::ChunkCache). Non thread-safe.
+class T3ChunkStore {
+public:
+    T3ChunkStore() = default;
+    ~T3ChunkStore();
+    T3ChunkStore(const T3ChunkStore&) = delete;
+    T3ChunkStore& operator=(const T3ChunkStore&) = delete;
+
+    // Crée le magasin s’il n’existe pas
+    bool open(const std::string& pack_path, std::string* err = nullptr);
+    void close();
+
+    void set_layout(const T3Chunk::Layout& L) { layout_ = L; }
+    const T3Chunk::Layout& layout() const { return layout_; }
+    void set_cache_bytes(size_t n) { cache_.set_budget(n); }
+    const T3Chunk::ChunkCache& cache() const { return cache_; }
+
+    // Chunks nouveaux → pack, refs +1, commit de l’index, puis écriture .t3r
+    bool put_image(const std::string& t3r_path,
+                   SubwordMode sub, int w, int h,
+                   const std::vector<Word27>& words,
+                   const std::string& meta_json,
+                   T3KStats* stats = nullptr,
+                   std::string* err = nullptr);
+    bool put_video(const std::string& t3r_path,
+                   SubwordMode sub, int w, int h,
+                   const std::vector<std::vector<Word27>>& frames,
+                   const std::string& meta_json_global,
+                   const std::vector<std::string>& metas_per_frame, // size==frames.size() ou vide
+                   T3KStats* stats = nullptr,
+                   std::string* err = nullptr);
+
+    // refs -1 pour chaque référence du .t3r, commit, puis suppression du fichier
+    bool release(const std::string& t3r_path, std::string* err = nullptr);
+
+    // Compactage : pack réécrit avec les seuls chunks refs>0
+    bool gc(uint64_t* reclaimed_bytes = nullptr, std::string* err = nullptr);
+
+    // Chunk vérifié (hash recalculé) ; pointeur valide jusqu’à la lecture suivante
+    const std::vector<uint8_t>* get_chunk(const T3Chunk::Hash128& h, std::string* err = nullptr);
+
+    // Frame i reconstruite (approve_meta sur la méta frame avant tout chunk)
+    bool read_frame(const T3RInfo& info, size_t i,
+                    const ApproveMetaFn& approve_meta,
+                    std::vector<Word27>& out_words,
+                    std::string* err = nullptr);
+
+    size_t   chunk_count() const { return map_.size(); }
+    size_t   dead_chunks() const;      // refs==0 (récupérables par gc)
+    uint64_t live_bytes() const;       // données des chunks refs>0
+    uint64_t pack_bytes() const { return end_; }
+
+private:
+    struct Loc { uint64_t offset = 0; uint32_t bytes = 0; uint32_t refs = 0; };
+
+    bool put_frames(const std::string& t3r_path, SubwordMode sub, int w, int h,
+                    const std::vector<const std::vector<Word27>*>& frames,
+                    const std::string& meta_g, const std::vector<std::string>& metas,
+                    T3KStats* stats, std::string* err);
+    bool commit(std::string* err);
+
+    std::string path_;
+    std::FILE* f_ = nullptr;
+    uint64_t end_ = 0;   // fin validée du pack (prochain enregistrement)
+    T3Chunk::Layout layout_;
+    std::unordered_map<T3Chunk::Hash128, Loc, T3Chunk::Hash128Hasher> map_;
+    T3Chunk::ChunkCache cache_;
+};
+
+// ---------------------------- API .t3s (segments) --------------------------
+struct T3SFrameIndex {
+    uint64_t offset = 0;   // offset du bloc frame dans son segment
+    uint64_t words = 0;
+    uint32_t meta_len = 0;
+    uint16_t seg = 0;
+};
+
+// Écrivain : frames distribuées en round-robin, un thread par segment
+// (file bornée : add_frame bloque si le disque cible est en retard).
+class T3SWriter {
+public:
+    T3SWriter();
+    ~T3SWriter();
+    T3SWriter(const T3SWriter&) = delete;
+    T3SWriter& operator=(const T3SWriter&) = delete;
+
+    // segment_paths : un fichier .t3g par point de montage
+    bool open(const std::string& manifest_path,
+              const std::vector<std::string>& segment_paths,
+              SubwordMode sub, int w, int h,
+              const std::string& meta_json_global,
+              std::string* err = nullptr,
+              size_t queue_frames = 4);
+
+    bool add_frame(std::vector<Word27>&& words, const std::string& meta = {},
+                   std::string* err = nullptr);
+    bool add_frame(const std::vector<Word27>& words, const std::string& meta = {},
+                   std::string* err = nullptr);
+
+    // Vide les files, joint les threads, écrit le manifeste
+    bool close(std::string* err = nullptr);
+
+    uint64_t frame_count() const { return index_.size(); }
+
+private:
+    struct Lane;
+    bool fail(std::string* err);
+
+    std::string manifest_;
+    std::vector<std::string> paths_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<T3SFrameIndex> index_;
+    std::string meta_g_;
+    SubwordMode sub_ = SubwordMode::S27;
+    int w_ = 0, h_ = 0;
+    uint64_t set_id_ = 0;
+    bool open_ = false;
+};
+
+// Lecteur : manifeste chargé une fois, segments ouverts à la demande et
+// gardés ouverts → read_frame en O(1) (1 seek + 1 lecture).
+class T3SReader {
+public:
+    T3SReader() = default;
+    ~T3SReader();
+    T3SReader(const T3SReader&) = delete;
+    T3SReader& operator=(const T3SReader&) = delete;
+
+    bool open(const std::string& manifest_path, std::string* err = nullptr);
+    void close();
+
+    SubwordMode sub() const { return sub_; }
+    int width() const { return w_; }
+    int height() const { return h_; }
+    const std::string& meta_json() const { return meta_g_; }
+    uint64_t frame_count() const { return index_.size(); }
+    const T3SFrameIndex& frame(uint64_t i) const { return index_[(size_t)i]; }
+    const std::vector<std::string>& segments() const { return paths_; }
+
+    // Lecture sécurisée (approve_meta sur méta frame)
+    bool read_frame(uint64_t frame_idx,
+                    const ApproveMetaFn& approve_meta,
+                    std::vector<Word27>& out_words,
+                    std::string* err = nullptr);
+
+private:
+    std::FILE* segment(uint16_t s, std::string* err);
+
+    std::vector<std::string> paths_;   // chemins résolus
+    std::vector<std::FILE*> files_;
+    std::vector<T3SFrameIndex> index_;
+    std::string meta_g_;
+    SubwordMode sub_ = SubwordMode::S27;
+    int w_ = 0, h_ = 0;
+    uint64_t set_id_ = 0;
+};
+
+// ---------------------------- Écriture projetée (mmap) ----------------------
+// Fichier pré-dimensionné (ftruncate + posix_fallocate) et projeté en écriture :
+// l’encodeur écrit les mots directement dans le fichier (ni vector<Word27>
+// complet, ni fwrite). commit(begin, n) signale une plage de mots terminée :
+// son CRC est calculé aussitôt (données encore en cache), depuis n’importe
+// quel thread, dans n’importe quel ordre ; les CRC des plages sont combinés
+// à close(), qui complète les plages non signalées, pose les CRC, msync et
+// ferme. Ne plus modifier une plage après son commit.
+// La méta est complétée (espaces JSON, entrée de bourrage TLV) pour que les
+// mots soient alignés sur 4 octets. Le destructeur appelle close().
+class T3PMapWriter {
+public:
+    T3PMapWriter();
+    ~T3PMapWriter();
+    T3PMapWriter(const T3PMapWriter&) = delete;
+    T3PMapWriter& operator=(const T3PMapWriter&) = delete;
+
+    bool open(const std::string& path,
+              SubwordMode sub, int w, int h,
+              uint64_t words_count,
+              const std::string& meta_json,
+              std::string* err = nullptr);
+
+    Word27* words() { return words_; }
+    uint64_t size() const { return n_; }
+    void commit(uint64_t begin, uint64_t n);
+    bool close(std::string* err = nullptr);
+
+private:
+    struct Out;
+    std::unique_ptr<Out> out_;
+    Word27* words_ = nullptr;
+    uint64_t n_ = 0;
+};
+
+// Tailles de frames connues à l’ouverture : index complet écrit d’emblée.
+// times != nullptr → fichier ver 7 (pts/flags, même validation que t3v_write_timed).
+class T3VMapWriter {
+public:
+    T3VMapWriter();
+    ~T3VMapWriter();
+    T3VMapWriter(const T3VMapWriter&) = delete;
+    T3VMapWriter& operator=(const T3VMapWriter&) = delete;
+
+    bool open(const std::string& path,
+              SubwordMode sub, int w, int h,
+              const std::vector<uint64_t>& frame_words,
+              const std::string& meta_json_global,
+              const std::vector<std::string>& metas_per_frame = {},
+              const std::vector<T3VFrameTime>* times = nullptr,
+              const T3VTimeBase& tb = T3VTimeBase{},
+              std::string* err = nullptr);
+
+    uint64_t frame_count() const { return index_.size(); }
+    uint64_t frame_words(uint64_t i) const { return index_[(size_t)i].words; }
+    Word27* frame(uint64_t i);
+    void commit(uint64_t i, uint64_t begin, uint64_t n);
+    bool close(std::string* err = nullptr);
+
+private:
+    struct Out;
+    std::unique_ptr<Out> out_;
+    std::vector<T3VFrameIndex> index_;
+};
+
+// ---------------------------- Vérification d’intégrité ---------------------
+struct T3VerifyReport {
+    std::string kind;             // "t3p" | "t3v" | "t3a"
+    uint64_t file_bytes = 0;
+    uint64_t units = 0;           // 1 (.t3p), frames (.t3v), entrées (.t3a)
+    uint64_t checked_bytes = 0;   // octets passés au CRC
+    std::vector<uint64_t> bad;    // unités corrompues (CRC ou bornes), croissantes
+    double seconds = 0.0;
+    bool ok() const { return bad.empty(); }
+    double gbps() const { return seconds > 0.0 ? (double)checked_bytes / seconds * 1e-9 : 0.0; }
+};
+
+// false : fichier illisible, format inconnu, header ou index corrompu (err) ;
+// true : rapport rempli (rep.bad liste les payloads invalides).
+// threads==0 → tous les cœurs.
+bool t3_verify(const std::string& path, T3VerifyReport& rep,
+               unsigned threads = 0, std::string* err = nullptr);
+
 } // namespace T3Container
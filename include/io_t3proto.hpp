@@ -21,6 +21,32 @@
 //   if BAL_PRESENT:  n_trits octets  (trits {-1,0,1} mappés {0,1,2})
 //   if PACK_PRESENT: n_bytes octets  (base-243 ; 5 trits → 1 octet)
 //
+//  FORMAT PROGRESSIF (LE, ver=2, flags bit2: PROGRESSIVE)
+//  ------------------------------------------------------
+//   magic, ver=2, profile, flags, width, height    (idem v1)
+//   n_trits(u64)  // somme des trits des sections base-243
+//   n_bytes(u64)  // taille totale du payload (sections)
+//   meta_len(u32), meta_json[meta_len]
+//   n_sec(u32), puis n_sec entrées de 28 octets :
+//     kind(u8) enc(u8) rsv(u16) n_items(u64) offset(u64, absolu) n_bytes(u64)
+//   payload : sections dans l’ordre de la table (priorité décroissante) :
+//     Sketch → LL (u8) → HL → LH → HH (Haar) | Details (AnisoRC)
+//     AnisoRC quadtree : QTree (structure) → LL (1 par feuille) → Details
+//   Un lecteur qui ne dispose que des K premiers octets (lecture par plage)
+//   exploite toutes les sections entièrement contenues dans ce préfixe.
+//
+//  FORMAT SÉQUENCE (LE, ver=3, flags bit3: SEQUENCE, profil HaarTernary)
+//  ---------------------------------------------------------------------
+//   magic, ver=3, profile, flags, width, height    (idem v1)
+//   n_trits(u64)  // somme des trits base-243 des trames
+//   n_bytes(u64)  // taille totale du payload (trames)
+//   meta_len(u32), meta_json[meta_len]  // "sequence":{n_frames, key_interval…}
+//   n_frames(u32), puis n_frames entrées de 32 octets :
+//     type(u8: 1=clé, 2=delta) rsv(u8) rsv(u16) n_coded(u32)
+//     n_trits(u64) offset(u64, absolu) n_bytes(u64)
+//   payload : trames dans l’ordre (format interne : proto_temporal.hpp).
+//   La table permet de sauter directement à une trame clé.
+//
 //  GARDE-FOUS
 //  ----------
 //  • ECC/RS GF(27) hors de ce fichier. Conversion balanced↔unbalanced stricte via helpers.
@@ -29,7 +55,13 @@
 //  API
 //  ---
 //   bool t3proto_write(path, profile, W,H, balanced*, packed*, meta_json);
-//   bool t3proto_read (path, profile, W,H, balanced*, packed*, meta_out );
+//   bool t3proto_read (path, profile, W,H, balanced*, packed*, meta_out );   // v1
+//   bool t3proto_write_progressive(path, profile, W,H, sections, meta_json); // v2
+//   bool t3proto_parse_progressive(buf, n, info, &need);  // préfixe mémoire
+//   bool t3proto_read_progressive (path, info, max_bytes); // préfixe fichier
+//   bool t3proto_write_sequence(path, profile, W,H, frames, meta_json);    // v3
+//   bool t3proto_read_sequence (path, info, load_payload=true);           // v3
+//   int  t3proto_peek_version(path);
 //   + utilitaires internes (IO LE, inférence n_trits).
 //
 //  EXEMPLES
@@ -47,18 +79,21 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <climits>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <cctype>
 
 #include "codec_profiles.hpp" // ProtoProfile + helpers trits
+#include "t3_meta.hpp"          // méta TLV (lecture directe)
 
 namespace t3proto
 {
 
 // ---- Flags
-enum : uint16_t { F_PACK_PRESENT = 1u<<0, F_BAL_PRESENT = 1u<<1 };
+enum : uint16_t { F_PACK_PRESENT = 1u<<0, F_BAL_PRESENT = 1u<<1, F_PROGRESSIVE = 1u<<2,
+                  F_SEQUENCE = 1u<<3 };
 
 // ---- IO LE helpers
 inline bool wr_u16(FILE* f, uint16_t v)
@@ -121,9 +156,10 @@ struct Header
     uint32_t meta_len;
 };
 
-// ---- Parsing minimal de meta JSON (sans dépendance)
+// ---- Parsing minimal de meta JSON (sans dépendance) ; méta TLV : lecture directe
 inline bool meta_find_int(const std::string& meta, const std::string& key, uint64_t& out)
 {
+    if(T3Meta::is_tlv(meta)) return T3Meta::find_uint(meta, key, out);
     auto pos = meta.find("\""+key+"\"");
     if(pos==std::string::npos) return false;
     pos = meta.find(':', pos);
@@ -162,6 +198,12 @@ inline uint64_t infer_ntrits_from_meta(ProtoProfile prof,
         if(s>0) return s;
     }
 
+    uint64_t ltree=0, ldet=0; // AnisoRC quadtree : [structure | détails]
+    if(meta_find_int(meta_json, "len_tree", ltree) && meta_find_int(meta_json, "len_details", ldet))
+    {
+        if(ltree+ldet>0) return ltree+ldet;
+    }
+
     uint64_t tpb=0, blockN=0;
     if(meta_find_int(meta_json, "trits_per_block", tpb) &&
             meta_find_int(meta_json, "block", blockN) && blockN>0)
@@ -351,4 +393,353 @@ inline bool t3proto_read(const std::string& path,
     return true;
 }
 
+// ============================================================================
+// v2 — layout progressif (sections + table)
+// ============================================================================
+
+constexpr size_t kFixedHeaderBytes = 4+1+1+2+4+4+8+8+4; // jusqu’à meta_len inclus
+constexpr size_t kSecEntryBytes    = 28;
+
+inline uint16_t ld_u16(const uint8_t* p)
+{
+    return uint16_t(p[0]|(uint16_t(p[1])<<8));
+}
+inline uint32_t ld_u32(const uint8_t* p)
+{
+    return uint32_t(p[0])|(uint32_t(p[1])<<8)|(uint32_t(p[2])<<16)|(uint32_t(p[3])<<24);
+}
+inline uint64_t ld_u64(const uint8_t* p)
+{
+    uint64_t v=0;
+    for(int i=7; i>=0; --i) v=(v<<8)|p[i];
+    return v;
+}
+
+struct ProgressiveInfo
+{
+    ProtoProfile profile = ProtoProfile::None;
+    uint32_t W=0, H=0;
+    uint64_t n_trits=0, n_bytes=0;
+    std::string meta;
+    std::vector<ProtoSection> sec;    // data remplie si la section est complète
+    std::vector<uint64_t> sec_offset; // offsets absolus dans le fichier
+    std::vector<uint64_t> sec_bytes;  // tailles sur disque
+    uint64_t header_bytes=0;          // header + meta + table
+    uint64_t file_bytes() const
+    {
+        return header_bytes + n_bytes;
+    }
+};
+
+// ---- WRITE (v2)
+inline bool t3proto_write_progressive(const std::string& path,
+                                      ProtoProfile profile,
+                                      uint32_t W, uint32_t H,
+                                      const std::vector<ProtoSection>& sections,
+                                      const std::string& meta_json)
+{
+    uint64_t ntr=0, nby=0;
+    for(const auto& S : sections)
+    {
+        if(S.enc==ProtoSecEnc::Base243) ntr += S.n_items;
+        nby += S.data.size();
+    }
+    const uint64_t hdr = kFixedHeaderBytes + meta_json.size() + 4
+                         + kSecEntryBytes*(uint64_t)sections.size();
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if(!f) return false;
+
+    const uint8_t ver=2, prof=(uint8_t)profile;
+    bool ok=true;
+    ok &= wr_bytes(f, "T3PT", 4);
+    ok &= wr_bytes(f, &ver, 1) && wr_bytes(f, &prof, 1);
+    ok &= wr_u16(f, F_PROGRESSIVE|F_PACK_PRESENT) && wr_u32(f,W) && wr_u32(f,H);
+    ok &= wr_u64(f, ntr) && wr_u64(f, nby);
+    ok &= wr_u32(f, (uint32_t)meta_json.size());
+    if(ok && !meta_json.empty()) ok &= wr_bytes(f, meta_json.data(), meta_json.size());
+    ok &= wr_u32(f, (uint32_t)sections.size());
+
+    uint64_t ofs = hdr;
+    for(const auto& S : sections)
+    {
+        if(!ok) break;
+        const uint8_t kind=(uint8_t)S.kind, enc=(uint8_t)S.enc;
+        ok &= wr_bytes(f, &kind, 1) && wr_bytes(f, &enc, 1) && wr_u16(f, 0);
+        ok &= wr_u64(f, S.n_items) && wr_u64(f, ofs) && wr_u64(f, (uint64_t)S.data.size());
+        ofs += S.data.size();
+    }
+    for(const auto& S : sections)
+    {
+        if(!ok) break;
+        if(!S.data.empty()) ok &= wr_bytes(f, S.data.data(), S.data.size());
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// ---- PARSE (v2) depuis un préfixe mémoire
+// false si invalide, ou si le préfixe ne couvre pas header+meta+table :
+// dans ce cas *need reçoit la taille minimale à fournir (0 si invalide).
+inline bool t3proto_parse_progressive(const uint8_t* buf, size_t n,
+                                      ProgressiveInfo& I,
+                                      uint64_t* need = nullptr)
+{
+    I = ProgressiveInfo{};
+    if(need) *need = kFixedHeaderBytes;
+    if(n < kFixedHeaderBytes) return false;
+    if(std::memcmp(buf,"T3PT",4)!=0 || buf[4]!=2)
+    {
+        if(need) *need = 0;
+        return false;
+    }
+    I.profile = (ProtoProfile)buf[5];
+    const uint16_t flags = ld_u16(buf+6);
+    I.W = ld_u32(buf+8);
+    I.H = ld_u32(buf+12);
+    I.n_trits = ld_u64(buf+16);
+    I.n_bytes = ld_u64(buf+24);
+    const uint32_t mlen = ld_u32(buf+32);
+    if(!(flags & F_PROGRESSIVE))
+    {
+        if(need) *need = 0;
+        return false;
+    }
+
+    size_t p = kFixedHeaderBytes;
+    if(need) *need = (uint64_t)p + mlen + 4;
+    if(n < p + mlen + 4) return false;
+    I.meta.assign((const char*)buf+p, mlen);
+    p += mlen;
+    const uint32_t nsec = ld_u32(buf+p);
+    p += 4;
+    if(need) *need = (uint64_t)p + kSecEntryBytes*(uint64_t)nsec;
+    if((uint64_t)n < (uint64_t)p + kSecEntryBytes*(uint64_t)nsec) return false;
+
+    I.header_bytes = (uint64_t)p + kSecEntryBytes*(uint64_t)nsec;
+    I.sec.resize(nsec);
+    I.sec_offset.resize(nsec);
+    I.sec_bytes.resize(nsec);
+    for(uint32_t i=0; i<nsec; ++i, p+=kSecEntryBytes)
+    {
+        ProtoSection& S = I.sec[i];
+        S.kind    = (ProtoSecKind)buf[p];
+        S.enc     = (ProtoSecEnc)buf[p+1];
+        S.n_items = ld_u64(buf+p+4);
+        I.sec_offset[i] = ld_u64(buf+p+12);
+        I.sec_bytes[i]  = ld_u64(buf+p+20);
+        const uint64_t end = I.sec_offset[i] + I.sec_bytes[i];
+        if(end < I.sec_offset[i] || I.sec_offset[i] < I.header_bytes)
+        {
+            if(need) *need = 0;
+            return false;
+        }
+        if(end <= (uint64_t)n)
+            S.data.assign(buf + I.sec_offset[i], buf + end);
+    }
+    if(need) *need = I.file_bytes();
+    return true;
+}
+
+// ---- Taille du fichier ouvert (position remise au début) ; false si inconnue
+inline bool file_size(FILE* f, uint64_t& n)
+{
+    if(std::fseek(f, 0, SEEK_END)!=0) return false;
+    const long e = std::ftell(f);
+    if(e<0 || std::fseek(f, 0, SEEK_SET)!=0) return false;
+    n = (uint64_t)e;
+    return true;
+}
+
+// ---- READ (v2) : header + meta + table toujours lus, puis payload borné :
+//      seules les sections contenues dans les max_bytes premiers octets du
+//      fichier sont chargées (max_bytes=0 → table seule, pour `info`).
+//      Tailles du header bornées par celle du fichier (entrée non fiable).
+inline bool t3proto_read_progressive(const std::string& path,
+                                     ProgressiveInfo& I,
+                                     uint64_t max_bytes = UINT64_MAX)
+{
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f) return false;
+    uint64_t fsz=0;
+    if(!file_size(f, fsz))
+    {
+        std::fclose(f);
+        return false;
+    }
+    std::vector<uint8_t> buf;
+    auto grow_to = [&](uint64_t want, uint64_t budget)
+    {
+        // étend le préfixe lu ; false si `want` dépasse le budget ou le fichier
+        const uint64_t lim = std::min<uint64_t>(std::min<uint64_t>(want, budget), fsz);
+        const size_t have = buf.size();
+        if(lim > have)
+        {
+            buf.resize((size_t)lim);
+            const size_t got = std::fread(buf.data()+have, 1, (size_t)lim-have, f);
+            buf.resize(have+got);
+        }
+        return (uint64_t)buf.size() >= want;
+    };
+
+    // 1) header fixe → meta → table (chaque étape donne la taille suivante)
+    bool ok=false;
+    uint64_t need = kFixedHeaderBytes;
+    while(grow_to(need, UINT64_MAX))
+    {
+        ok = t3proto_parse_progressive(buf.data(), buf.size(), I, &need);
+        if(ok || need==0 || need<=buf.size()) break;
+    }
+    // 2) payload annoncé plus grand que le fichier : rejet
+    if(ok && (I.header_bytes > fsz || I.n_bytes > fsz - I.header_bytes)) ok=false;
+    // 3) payload : autant de sections que le budget max_bytes le permet
+    if(ok && buf.size() < I.file_bytes())
+    {
+        grow_to(I.file_bytes(), std::max<uint64_t>(max_bytes, buf.size()));
+        ok = t3proto_parse_progressive(buf.data(), buf.size(), I, nullptr);
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// ============================================================================
+// v3 — séquence (trames clés + résidus temporels)
+// ============================================================================
+
+constexpr size_t kSeqEntryBytes = 32;
+
+struct SequenceInfo
+{
+    ProtoProfile profile = ProtoProfile::None;
+    uint32_t W=0, H=0;
+    uint64_t n_trits=0, n_bytes=0;
+    std::string meta;
+    std::vector<ProtoSeqFrame> frames;    // data vide si payload non chargé
+    std::vector<uint64_t> frame_offset;   // offsets absolus dans le fichier
+    std::vector<uint64_t> frame_bytes;    // tailles sur disque
+    uint64_t header_bytes=0;              // header + meta + table
+};
+
+// ---- WRITE (v3)
+inline bool t3proto_write_sequence(const std::string& path,
+                                   ProtoProfile profile,
+                                   uint32_t W, uint32_t H,
+                                   const std::vector<ProtoSeqFrame>& frames,
+                                   const std::string& meta_json)
+{
+    uint64_t ntr=0, nby=0;
+    for(const auto& F : frames)
+    {
+        ntr += F.n_trits;
+        nby += F.data.size();
+    }
+    const uint64_t hdr = kFixedHeaderBytes + meta_json.size() + 4
+                         + kSeqEntryBytes*(uint64_t)frames.size();
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if(!f) return false;
+
+    const uint8_t ver=3, prof=(uint8_t)profile;
+    bool ok=true;
+    ok &= wr_bytes(f, "T3PT", 4);
+    ok &= wr_bytes(f, &ver, 1) && wr_bytes(f, &prof, 1);
+    ok &= wr_u16(f, F_SEQUENCE|F_PACK_PRESENT) && wr_u32(f,W) && wr_u32(f,H);
+    ok &= wr_u64(f, ntr) && wr_u64(f, nby);
+    ok &= wr_u32(f, (uint32_t)meta_json.size());
+    if(ok && !meta_json.empty()) ok &= wr_bytes(f, meta_json.data(), meta_json.size());
+    ok &= wr_u32(f, (uint32_t)frames.size());
+
+    uint64_t ofs = hdr;
+    for(const auto& F : frames)
+    {
+        if(!ok) break;
+        const uint8_t type=(uint8_t)F.type;
+        ok &= wr_bytes(f, &type, 1) && wr_bytes(f, "\0", 1) && wr_u16(f, 0);
+        ok &= wr_u32(f, F.n_coded) && wr_u64(f, F.n_trits);
+        ok &= wr_u64(f, ofs) && wr_u64(f, (uint64_t)F.data.size());
+        ofs += F.data.size();
+    }
+    for(const auto& F : frames)
+    {
+        if(!ok) break;
+        if(!F.data.empty()) ok &= wr_bytes(f, F.data.data(), F.data.size());
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// ---- READ (v3) : header + meta + table ; trames si load_payload
+//      Méta, table et trames bornées par la taille du fichier (entrée non fiable)
+inline bool t3proto_read_sequence(const std::string& path,
+                                  SequenceInfo& I,
+                                  bool load_payload = true)
+{
+    I = SequenceInfo{};
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f) return false;
+
+    char magic[4];
+    uint8_t ver=0, prof=0;
+    uint16_t flags=0;
+    uint32_t mlen=0, nfr=0;
+    uint64_t fsz=0;
+    bool ok = file_size(f, fsz);
+    ok = ok && rd_bytes(f, magic, 4) && std::memcmp(magic,"T3PT",4)==0;
+    ok = ok && rd_bytes(f, &ver, 1) && ver==3 && rd_bytes(f, &prof, 1);
+    ok = ok && rd_u16(f, flags) && (flags & F_SEQUENCE);
+    ok = ok && rd_u32(f, I.W) && rd_u32(f, I.H);
+    ok = ok && rd_u64(f, I.n_trits) && rd_u64(f, I.n_bytes) && rd_u32(f, mlen);
+    ok = ok && kFixedHeaderBytes + (uint64_t)mlen + 4 <= fsz;
+    if(ok)
+    {
+        I.profile = (ProtoProfile)prof;
+        I.meta.assign(mlen, '\0');
+        ok = (mlen==0 || rd_bytes(f, I.meta.data(), mlen)) && rd_u32(f, nfr);
+    }
+    if(ok)
+    {
+        I.header_bytes = kFixedHeaderBytes + mlen + 4 + kSeqEntryBytes*(uint64_t)nfr;
+        ok = I.header_bytes <= fsz;
+    }
+    if(ok)
+    {
+        I.frames.resize(nfr);
+        I.frame_offset.resize(nfr);
+        I.frame_bytes.resize(nfr);
+    }
+    for(uint32_t i=0; ok && i<nfr; ++i)
+    {
+        uint8_t type=0, rsv=0;
+        uint16_t rsv16=0;
+        ProtoSeqFrame& F = I.frames[i];
+        ok = rd_bytes(f, &type, 1) && rd_bytes(f, &rsv, 1) && rd_u16(f, rsv16)
+             && rd_u32(f, F.n_coded) && rd_u64(f, F.n_trits)
+             && rd_u64(f, I.frame_offset[i]) && rd_u64(f, I.frame_bytes[i]);
+        F.type = (ProtoSeqFrameType)type;
+        ok = ok && (type==1 || type==2) && I.frame_offset[i] >= I.header_bytes
+             && I.frame_offset[i] <= fsz && I.frame_bytes[i] <= fsz - I.frame_offset[i]
+             && I.frame_offset[i] <= (uint64_t)LONG_MAX;
+    }
+    for(uint32_t i=0; ok && load_payload && i<nfr; ++i)
+    {
+        ProtoSeqFrame& F = I.frames[i];
+        F.data.resize((size_t)I.frame_bytes[i]);
+        ok = std::fseek(f, (long)I.frame_offset[i], SEEK_SET)==0
+             && (F.data.empty() || rd_bytes(f, F.data.data(), F.data.size()));
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// ---- Version du conteneur (0 si illisible)
+inline int t3proto_peek_version(const std::string& path)
+{
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f) return 0;
+    uint8_t b[5];
+    const bool ok = std::fread(b,1,5,f)==5 && std::memcmp(b,"T3PT",4)==0;
+    std::fclose(f);
+    return ok ? (int)b[4] : 0;
+}
+
 } // namespace t3proto
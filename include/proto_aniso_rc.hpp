@@ -28,6 +28,12 @@
 //    // A.trits (balanced) + A.block_LL (u8) + meta par bloc  → pack_base243(A.trits, A.bytes)
 //    // Reconstruction (option QA):
 //    ImageU8 recon; proto_aniso_rc_reconstruct(A, P, recon);
+//    // Débit cible (nnz) : analyse 1 passe puis ternarisation sur cache
+//    std::vector<float> z; std::vector<int8_t> sg;
+//    proto_aniso_rc_analyze(rgb, P, A, z, sg);
+//    rc_ternarize_cached(z, sg, rc_zthresh_for_nnz(z, target_nnz), A.trits);
+//    // Quadtree 64→32→16 (P.quadtree) : A.qt_trits + A.leaves, puis
+//    // proto_aniso_rc_decode_Y_qt(tree, details, leaf_LL, W,H, P, outY)
 //
 // ============================================================================
 
@@ -37,6 +43,7 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <functional>
 #include <string>
 
 #include "ternary_image_codec_v6_min.hpp"
@@ -50,6 +57,12 @@ struct AnisoRCParams {
     float tern_thresh_z = 1.2f;// seuil robust z-score pour ternarisation
     bool  keep_LL_u8 = true;   // stocker un DC par bloc en u8
     bool  normalize_proj = true;// normalise projections par longueur moyenne
+    // Quadtree adaptatif : racines qt_max×qt_max découpées (jusqu'à qt_min)
+    // tant que la variance Y du bloc dépasse qt_var_thresh. qt_max = qt_min×2^k.
+    bool  quadtree = false;
+    int   qt_max = 64;
+    int   qt_min = 16;
+    float qt_var_thresh = 256.f;  // σ ≈ 16 niveaux Y
     // Table d’angles (degrés). On en prend 'angles' premiers.
     // 0, 22.5, 45, 67.5, 90, 112.5, 135, 157.5
     std::vector<float> angle_table_deg = {0.f,22.5f,45.f,67.5f,90.f,112.5f,135.f,157.5f};
@@ -57,6 +70,8 @@ struct AnisoRCParams {
 
 // =============================== [1] Artéfacts ===============================
 
+struct RC_Leaf { int x0=0, y0=0, N=0; }; // bloc codé (feuille du quadtree)
+
 struct AnisoRCArtifacts {
     // Dimensions et discrétisation
     int W=0, H=0, N=0;       // image padded, taille bloc
@@ -75,7 +90,13 @@ struct AnisoRCArtifacts {
     //  - off_trits_per_block : nombre de trits consommés par bloc
     int proj_len = 0;
     int angles_used = 0;
-    size_t trits_per_block = 0;
+    size_t trits_per_block = 0;   // 0 en mode quadtree (taille variable)
+
+    // Quadtree : structure en trits (pré-ordre, racines en raster, enfants
+    // HG,HD,BG,BD ; 0 = feuille, +1 = découpé ; aucun trit à la taille qt_min).
+    // leaves = blocs codés dans l'ordre des trits/LL (bloc fixe : raster).
+    std::vector<int8_t> qt_trits;
+    std::vector<RC_Leaf> leaves;
 
     // Pour reconstruction approx (QA)
     //  On mémorise l’ordre de sortie des coefficients 1D (après Haar) : [LL | détails]
@@ -165,6 +186,12 @@ inline int rc_proj_len_for_block(int N){
     int R = (int)std::ceil( (float)N * 0.70710678f ); // ~N/√2
     return 2*R + 1;
 }
+// #détails ternarisés par angle : la projection (longueur impaire) est
+// complétée à une longueur paire avant Haar → (PL+1)/2 détails.
+inline int rc_details_len_for_block(int N){
+    const int PL = rc_proj_len_for_block(N);
+    return (PL + (PL & 1)) / 2;
+}
 
 inline void rc_block_projections_Y(const uint8_t* Yplane, int W, int H,
                                    int x0, int y0, int N,
@@ -201,17 +228,178 @@ inline void rc_block_projections_Y(const uint8_t* Yplane, int W, int H,
     }
 }
 
+// Table bin ρ par pixel et par angle pour une taille N (encode ET décode) :
+// plus de cos/sin/lround par pixel. Même arrondi que rc_block_projections_Y.
+struct RC_BackprojTable {
+    int N=0, angles=0, PL=0, Hlen=0;
+    std::vector<int16_t> bin;   // angles × N×N (−1 = hors projection)
+    std::vector<int32_t> hits;  // N×N : #angles contribuant au pixel
+    std::vector<int32_t> cnt;   // angles × PL : #pixels par bin ρ (normalisation)
+};
+
+inline void rc_build_backproj_table(int N, const std::vector<RC_Angle>& angs, RC_BackprojTable& tb){
+    tb.N=N; tb.angles=(int)angs.size();
+    tb.PL=rc_proj_len_for_block(N);
+    tb.Hlen=rc_details_len_for_block(N);
+    tb.bin.assign((size_t)tb.angles*N*N, (int16_t)-1);
+    tb.hits.assign((size_t)N*N, 0);
+    tb.cnt.assign((size_t)tb.angles*tb.PL, 0);
+    const float cx=(N-1)*0.5f, cy=(N-1)*0.5f;
+    const int R=(tb.PL-1)/2;
+    for(int a=0;a<tb.angles;++a){
+        int16_t* B=&tb.bin[(size_t)a*N*N];
+        for(int y=0;y<N;++y){
+            for(int x=0;x<N;++x){
+                int rho=(int)std::lround((x-cx)*angs[(size_t)a].c + (y-cy)*angs[(size_t)a].s);
+                int b=rho+R; if(b<0||b>=tb.PL) continue;
+                B[(size_t)y*N+x]=(int16_t)b;
+                tb.hits[(size_t)y*N+x]+=1;
+                tb.cnt[(size_t)a*tb.PL+b]+=1;
+            }
+        }
+    }
+}
+
+// Projections d'un bloc via la table : proj = angles × PL (à plat).
+// Identique à rc_block_projections_Y sur image paddée (bloc entièrement dedans).
+inline void rc_block_projections_tab(const uint8_t* Yplane, int W, int x0, int y0,
+                                     const RC_BackprojTable& tb, bool normalize_proj,
+                                     std::vector<int>& proj){
+    const int N=tb.N, PL=tb.PL;
+    proj.assign((size_t)tb.angles*PL, 0);
+    for(int y=0;y<N;++y){
+        const uint8_t* row=&Yplane[(size_t)(y0+y)*W + x0];
+        for(int x=0;x<N;++x){
+            const int v=row[x];
+            const size_t k=(size_t)y*N+x;
+            for(int a=0;a<tb.angles;++a){
+                const int16_t b=tb.bin[(size_t)a*N*N+k];
+                if(b>=0) proj[(size_t)a*PL+b]+=v;
+            }
+        }
+    }
+    if(normalize_proj){
+        for(size_t i=0;i<proj.size();++i){
+            const int c=tb.cnt[i];
+            if(c>0) proj[i]=(proj[i]+c/2)/c;
+        }
+    }
+}
+
+// =============================== [4b] Quadtree (variance, image intégrale) ===
+//
+// Image intégrale des moments Y et Y² à la granularité qt_min (cellules) :
+// variance de n'importe quel bloc du quadtree en O(1), pour ~1/256 de la
+// mémoire d'une intégrale pleine résolution. Un bloc N > qt_min est découpé
+// si var > qt_var_thresh : les zones plates gardent de grands blocs (peu de
+// trits par pixel), les zones texturées descendent à qt_min.
+
+struct RC_Integral {
+    int cell=1, GW=0, GH=0;
+    std::vector<uint64_t> S, S2; // (GW+1)×(GH+1), cumul des cellules
+    // W, H multiples de cell
+    void build(const uint8_t* Y, int W, int H, int cell_){
+        cell=cell_; GW=W/cell; GH=H/cell;
+        S.assign((size_t)(GW+1)*(GH+1), 0); S2.assign(S.size(), 0);
+        std::vector<uint64_t> cs((size_t)GW), cs2((size_t)GW);
+        for(int gy=0; gy<GH; ++gy){
+            std::fill(cs.begin(), cs.end(), 0); std::fill(cs2.begin(), cs2.end(), 0);
+            for(int y=gy*cell; y<(gy+1)*cell; ++y){
+                const uint8_t* row=&Y[(size_t)y*W];
+                for(int gx=0; gx<GW; ++gx){
+                    uint32_t s=0, s2=0;
+                    for(int x=gx*cell; x<(gx+1)*cell; ++x){ const uint32_t v=row[x]; s+=v; s2+=v*v; }
+                    cs[(size_t)gx]+=s; cs2[(size_t)gx]+=s2;
+                }
+            }
+            uint64_t rs=0, rs2=0;
+            for(int gx=0; gx<GW; ++gx){
+                rs+=cs[(size_t)gx]; rs2+=cs2[(size_t)gx];
+                S [(size_t)(gy+1)*(GW+1)+gx+1] = S [(size_t)gy*(GW+1)+gx+1] + rs;
+                S2[(size_t)(gy+1)*(GW+1)+gx+1] = S2[(size_t)gy*(GW+1)+gx+1] + rs2;
+            }
+        }
+    }
+    // Bloc N×N en (x0,y0) pixels, alignés sur cell
+    double var(int x0, int y0, int N) const {
+        const int cx=x0/cell, cy=y0/cell, cn=N/cell;
+        auto box=[&](const std::vector<uint64_t>& T){
+            const size_t a=(size_t)cy*(GW+1)+cx, b=(size_t)(cy+cn)*(GW+1)+cx;
+            return (double)(T[b+cn] - T[b] - T[a+cn] + T[a]);
+        };
+        const double n=(double)N*N, m=box(S)/n;
+        return box(S2)/n - m*m;
+    }
+};
+
+inline void rc_qt_split(const RC_Integral& I, int x0, int y0, int N, const AnisoRCParams& P,
+                        std::vector<int8_t>& tree, std::vector<RC_Leaf>& leaves){
+    if(N > P.qt_min){
+        const bool split = I.var(x0, y0, N) > (double)P.qt_var_thresh;
+        tree.push_back(split? +1 : 0);
+        if(split){
+            const int h=N/2;
+            rc_qt_split(I, x0,   y0,   h, P, tree, leaves);
+            rc_qt_split(I, x0+h, y0,   h, P, tree, leaves);
+            rc_qt_split(I, x0,   y0+h, h, P, tree, leaves);
+            rc_qt_split(I, x0+h, y0+h, h, P, tree, leaves);
+            return;
+        }
+    }
+    leaves.push_back({x0, y0, N});
+}
+
+// Y paddé W×H (multiples de qt_max) → trits de structure + feuilles
+inline void rc_qt_build(const uint8_t* Y, int W, int H, const AnisoRCParams& P,
+                        std::vector<int8_t>& tree, std::vector<RC_Leaf>& leaves){
+    RC_Integral I; I.build(Y, W, H, P.qt_min);
+    tree.clear(); leaves.clear();
+    for(int y0=0; y0<H; y0+=P.qt_max)
+        for(int x0=0; x0<W; x0+=P.qt_max)
+            rc_qt_split(I, x0, y0, P.qt_max, P, tree, leaves);
+}
+
+// Trits de structure → feuilles (même ordre que rc_qt_build). false si tronqué.
+inline bool rc_qt_parse(const int8_t* tree, size_t n_tree, int rootsX, int rootsY,
+                        int qt_max, int qt_min, std::vector<RC_Leaf>& leaves,
+                        size_t* n_used=nullptr){
+    leaves.clear();
+    size_t k=0;
+    bool ok=true;
+    auto node=[&](auto&& self, int x0, int y0, int N) -> void {
+        if(!ok) return;
+        if(N > qt_min){
+            if(k>=n_tree){ ok=false; return; }
+            if(tree[k++] > 0){
+                const int h=N/2;
+                self(self, x0,   y0,   h);
+                self(self, x0+h, y0,   h);
+                self(self, x0,   y0+h, h);
+                self(self, x0+h, y0+h, h);
+                return;
+            }
+        }
+        leaves.push_back({x0, y0, N});
+    };
+    for(int ry=0; ry<rootsY && ok; ++ry)
+        for(int rx=0; rx<rootsX && ok; ++rx)
+            node(node, rx*qt_max, ry*qt_max, qt_max);
+    if(n_used) *n_used=k;
+    return ok;
+}
+
 // =============================== [5] Ternarisation robuste ===================
 //
 // Sur un vecteur de détails 1D (après Haar), on calcule médiane & MAD, puis
 // z = (v - median)/(1.4826*MAD), seuil ±P.tern_thresh_z -> {-1,0,+1}.
 
-inline void rc_ternarize_details(const std::vector<int>& sig_haar,
-                                 float zth, std::vector<int8_t>& out_bal){
+// z-scores robustes des détails + signe (cache du contrôle de débit).
+inline void rc_detail_zscores(const std::vector<int>& sig_haar,
+                              std::vector<float>& z_out, std::vector<int8_t>& sign_out){
     const int L=(int)sig_haar.size();
     const int H = L/2; // détails = seconde moitié
-    out_bal.resize(H);
-    if(H==0){ out_bal.clear(); return; }
+    z_out.resize(H); sign_out.resize(H);
+    if(H==0) return;
 
     // médiane & MAD
     std::vector<double> D; D.reserve(H);
@@ -224,15 +412,38 @@ inline void rc_ternarize_details(const std::vector<int>& sig_haar,
     double mad = tmp[tmp.size()/2] + 1e-6;
 
     for(int i=0;i<H;++i){
-        double z = (std::abs((double)sig_haar[H+i]) - med) / (1.4826*mad);
-        int8_t b = (z > zth) ? ( (sig_haar[H+i]>0)? +1 : -1 ) : 0;
+        z_out[i]    = (float)((D[i] - med) / (1.4826*mad));
+        sign_out[i] = (sig_haar[H+i]>0)? +1 : -1;
+    }
+}
+
+// z > zth -> signe, sinon 0. Retourne le # de trits non nuls.
+inline size_t rc_ternarize_cached(const std::vector<float>& z, const std::vector<int8_t>& sign,
+                                  float zth, std::vector<int8_t>& out_bal){
+    out_bal.resize(z.size());
+    size_t nnz=0;
+    for(size_t i=0;i<z.size();++i){
+        int8_t b = (z[i] > zth) ? sign[i] : 0;
         out_bal[i] = b;
+        nnz += (b!=0);
     }
+    return nnz;
+}
+
+inline void rc_ternarize_details(const std::vector<int>& sig_haar,
+                                 float zth, std::vector<int8_t>& out_bal){
+    std::vector<float> z; std::vector<int8_t> sg;
+    rc_detail_zscores(sig_haar, z, sg);
+    rc_ternarize_cached(z, sg, zth, out_bal);
 }
 
 // =============================== [6] Encodage global =========================
 
-inline void proto_aniso_rc_encode(const ImageU8& rgb, const AnisoRCParams& P, AnisoRCArtifacts& A){
+// Passe d'analyse : remplit A (dims, LL) et le cache z-scores/signes de tous
+// les détails, dans l'ordre exact des trits. La ternarisation (seuil z) est
+// ensuite une passe bon marché : rc_ternarize_cached.
+inline void proto_aniso_rc_analyze(const ImageU8& rgb, const AnisoRCParams& P, AnisoRCArtifacts& A,
+                                   std::vector<float>& z_cache, std::vector<int8_t>& sign_cache){
     // 0) Préparer image Y et padding
     ImageU8 work = rgb;
     if(work.c!=3){ // on s'assure d'être en RGB
@@ -250,19 +461,21 @@ inline void proto_aniso_rc_encode(const ImageU8& rgb, const AnisoRCParams& P, An
         }
     }
 
-    const int N = P.block;
+    const int N = P.quadtree ? P.qt_max : P.block; // bloc de padding (racine)
     int W = (work.w + N-1)/N * N;
     int H = (work.h + N-1)/N * N;
     if(W!=work.w || H!=work.h){
-        ImageU8 padded; resize_rgb_nn(work, W, H, padded);
-        // ré-extraire Y
+        // Étirement NN du plan Y (même échantillonnage que resize_rgb_nn ; la
+        // conversion étant ponctuelle, Y(NN(rgb)) == NN(Y)) : 1 seule conversion.
+        std::vector<uint8_t> Ysrc; Ysrc.swap(Yplane);
         Yplane.assign((size_t)W*H,0);
+        std::vector<int> sxs((size_t)W);
+        for(int x=0;x<W;++x) sxs[(size_t)x]=std::clamp((int)((x+0.5)*(double)work.w/W), 0, work.w-1);
         for(int y=0;y<H;++y){
-            for(int x=0;x<W;++x){
-                const uint8_t* p=&padded.data[(size_t)(y*W+x)*3];
-                uint8_t Y,Cb,Cr; rgb_to_ycbcr(p[0],p[1],p[2],Y,Cb,Cr);
-                Yplane[(size_t)y*W+x]=Y;
-            }
+            const int sy=std::clamp((int)((y+0.5)*(double)work.h/H), 0, work.h-1);
+            const uint8_t* sp=&Ysrc[(size_t)sy*work.w];
+            uint8_t* dp=&Yplane[(size_t)y*W];
+            for(int x=0;x<W;++x) dp[x]=sp[sxs[(size_t)x]];
         }
     }
     A.W=W; A.H=H; A.N=N;
@@ -273,47 +486,76 @@ inline void proto_aniso_rc_encode(const ImageU8& rgb, const AnisoRCParams& P, An
     A.angles_used = (int)angs.size();
     A.proj_len    = rc_proj_len_for_block(N);
 
-    // 2) Tailles & buffers
-    if(P.keep_LL_u8) A.block_LL.assign((size_t)A.blocksX*A.blocksY, 0);
-    A.trits.clear();
-    // Pour estimer nombre de trits : par bloc, par angle, on retient H=proj_len/2 détails
-    A.trits_per_block = (size_t)A.angles_used * (A.proj_len/2);
-    A.trits.reserve((size_t)A.blocksX*A.blocksY * A.trits_per_block);
-
-    // 3) Parcours des blocs
-    for(int by=0; by<A.blocksY; ++by){
-        for(int bx=0; bx<A.blocksX; ++bx){
-            int x0=bx*N, y0=by*N;
+    // 2) Blocs codés : grille fixe (raster) ou feuilles du quadtree
+    A.qt_trits.clear(); A.leaves.clear();
+    if(P.quadtree){
+        rc_qt_build(Yplane.data(), W, H, P, A.qt_trits, A.leaves);
+        A.trits_per_block = 0;
+    } else {
+        A.leaves.reserve((size_t)A.blocksX*A.blocksY);
+        for(int by=0; by<A.blocksY; ++by)
+            for(int bx=0; bx<A.blocksX; ++bx) A.leaves.push_back({bx*N, by*N, N});
+        A.trits_per_block = (size_t)A.angles_used * rc_details_len_for_block(N);
+    }
 
-            // LL bloc = moyenne Y (rapide)
-            if(P.keep_LL_u8){
-                uint64_t sum=0;
-                for(int y=0;y<N;++y){
-                    const uint8_t* row=&Yplane[(size_t)(y0+y)*W + x0];
-                    for(int x=0;x<N;++x) sum += row[x];
-                }
-                A.block_LL[(size_t)by*A.blocksX + bx] = (uint8_t)((sum + (N*N/2)) / (N*N));
+    // 3) Tailles & buffers
+    if(P.keep_LL_u8) A.block_LL.assign(A.leaves.size(), 0);
+    A.trits.clear();
+    // Nombre de trits : par bloc, par angle, la moitié "détails" de la projection paire
+    size_t n_det=0;
+    for(const RC_Leaf& L : A.leaves) n_det += (size_t)A.angles_used * rc_details_len_for_block(L.N);
+    z_cache.clear(); sign_cache.clear();
+    z_cache.reserve(n_det);
+    sign_cache.reserve(n_det);
+    std::vector<float> z; std::vector<int8_t> sg;
+
+    // Tables bin ρ par taille de bloc (1 en bloc fixe, 1 par niveau en quadtree)
+    std::vector<RC_BackprojTable> tabs;
+    for(int n=N; ; n/=2){
+        tabs.emplace_back(); rc_build_backproj_table(n, angs, tabs.back());
+        if(!P.quadtree || n<=P.qt_min || (n&1)) break;
+    }
+    std::vector<int> proj, sig;
+
+    // 4) Parcours des blocs
+    for(size_t li=0; li<A.leaves.size(); ++li){
+        const int x0=A.leaves[li].x0, y0=A.leaves[li].y0, n=A.leaves[li].N;
+
+        // LL bloc = moyenne Y (rapide)
+        if(P.keep_LL_u8){
+            uint64_t sum=0;
+            for(int y=0;y<n;++y){
+                const uint8_t* row=&Yplane[(size_t)(y0+y)*W + x0];
+                for(int x=0;x<n;++x) sum += row[x];
             }
+            A.block_LL[li] = (uint8_t)((sum + (n*n/2)) / (n*n));
+        }
 
-            // Projections
-            std::vector<std::vector<int>> proj;
-            rc_block_projections_Y(Yplane.data(), W,H, x0,y0,N, angs, P.normalize_proj, proj);
-
-            // Pour chaque angle : Haar 1D + ternarisation des détails
-            for(int a=0;a<A.angles_used;++a){
-                std::vector<int> sig = proj[(size_t)a];
-                // Longueur de projection doit être paire pour Haar
-                if((sig.size() & 1) != 0) sig.push_back(sig.back());
-                rc_haar1d(sig);
-                std::vector<int8_t> bal;
-                rc_ternarize_details(sig, P.tern_thresh_z, bal);
-                // Append
-                A.trits.insert(A.trits.end(), bal.begin(), bal.end());
-            }
+        // Projections
+        size_t lvl=0; while(tabs[lvl].N>n) ++lvl;
+        const RC_BackprojTable& tb=tabs[lvl];
+        rc_block_projections_tab(Yplane.data(), W, x0,y0, tb, P.normalize_proj, proj);
+
+        // Pour chaque angle : Haar 1D + z-scores des détails
+        for(int a=0;a<A.angles_used;++a){
+            sig.assign(proj.begin()+(std::ptrdiff_t)a*tb.PL, proj.begin()+(std::ptrdiff_t)(a+1)*tb.PL);
+            // Longueur de projection doit être paire pour Haar
+            if((sig.size() & 1) != 0) sig.push_back(sig.back());
+            rc_haar1d(sig);
+            rc_detail_zscores(sig, z, sg);
+            // Append
+            z_cache.insert(z_cache.end(), z.begin(), z.end());
+            sign_cache.insert(sign_cache.end(), sg.begin(), sg.end());
         }
     }
 }
 
+inline void proto_aniso_rc_encode(const ImageU8& rgb, const AnisoRCParams& P, AnisoRCArtifacts& A){
+    std::vector<float> z; std::vector<int8_t> sg;
+    proto_aniso_rc_analyze(rgb, P, A, z, sg);
+    rc_ternarize_cached(z, sg, P.tern_thresh_z, A.trits);
+}
+
 // =============================== [7] Reconstruction approx (QA) ==============
 //
 // On reconstruit par rétro-projection simple :
@@ -322,6 +564,7 @@ inline void proto_aniso_rc_encode(const ImageU8& rgb, const AnisoRCParams& P, An
 //   3) On ajoute le DC du bloc (LL) si keep_LL_u8.
 //
 // NB: Reconstruction "qualitative", pas une vraie inverse stable (prototype).
+//     Bloc fixe uniquement ; quadtree → proto_aniso_rc_decode_Y_qt ([9]).
 
 inline void proto_aniso_rc_reconstruct(const AnisoRCArtifacts& A, const AnisoRCParams& P, ImageU8& outY){
     const int N=A.N, W=A.W, H=A.H;
@@ -330,7 +573,8 @@ inline void proto_aniso_rc_reconstruct(const AnisoRCArtifacts& A, const AnisoRCP
     // re-préparer angles (doit matcher l’encode)
     std::vector<RC_Angle> angs; rc_prepare_angles(P, angs);
     const int PL = A.proj_len;
-    const int Hlen = PL/2;
+    const int Hlen = rc_details_len_for_block(N);
+    const int SL = 2*Hlen; // longueur paire du signal 1D (cf. encode)
 
     // Un seuil fixe pour reposer les détails (prototype)
     const int T = 20;
@@ -345,12 +589,12 @@ inline void proto_aniso_rc_reconstruct(const AnisoRCArtifacts& A, const AnisoRCP
 
             // pour chaque angle : reconstruire une projection 1D approx
             for(int a=0;a<A.angles_used;++a){
-                // On reconstruit un vecteur sig de longueur PL :
-                std::vector<int> sig(PL, 0);
+                // On reconstruit un vecteur sig de longueur SL (paire) :
+                std::vector<int> sig(SL, 0);
                 // détails stockés : Hlen trits
                 for(int i=0;i<Hlen;++i){
                     int8_t b = A.trits[t_ofs + (size_t)i];
-                    sig[PL/2 + i] = (b==0? 0 : (b>0? +T : -T));
+                    sig[Hlen + i] = (b==0? 0 : (b>0? +T : -T));
                 }
                 t_ofs += (size_t)Hlen;
                 // Inverse Haar approx
@@ -390,9 +634,162 @@ inline void proto_aniso_rc_reconstruct(const AnisoRCArtifacts& A, const AnisoRCP
 // =============================== [8] Estimation taille & pack ================
 
 inline size_t proto_aniso_rc_estimated_trits(const AnisoRCArtifacts& A){
-    return (size_t)A.blocksX*A.blocksY * A.trits_per_block;
+    if(A.trits_per_block) return (size_t)A.blocksX*A.blocksY * A.trits_per_block;
+    size_t n = A.qt_trits.size(); // quadtree : structure + détails par feuille
+    for(const RC_Leaf& L : A.leaves) n += (size_t)A.angles_used * rc_details_len_for_block(L.N);
+    return n;
 }
 inline void proto_aniso_rc_pack(const AnisoRCArtifacts& A, std::vector<uint8_t>& out_bytes){
     rc_pack_base243(A.trits, out_bytes);
 }
 
+
+// =============================== [9] Décodage rapide (tables + parallèle) ====
+//
+// Chemin "production" du décodeur .t3proto (t3proto_tool decode) :
+//  • Table de rétro-projection calculée UNE fois par (N, angles) : bin ρ de
+//    chaque pixel pour chaque angle + #angles valides par pixel. Plus de
+//    cos/sin/lround dans la boucle chaude (RC_BackprojTable, section [4]).
+//  • Buffers (acc, signal 1D, scratch Haar) alloués par intervalle de blocs.
+//  • Blocs répartis sur les cœurs via T3Par::parallel_for.
+// Arithmétique identique à proto_aniso_rc_reconstruct() (QA).
+
+#include "t3_parallel.hpp"
+
+// Haar 1D inverse sans allocation (même formule que rc_haar1d_inv).
+inline void rc_haar1d_inv_span(int* s, int L, int* tmp){
+    const int H=L/2;
+    for(int i=0;i<H;++i){
+        int a=s[i], d=s[H+i];
+        tmp[2*i]   = a + (d>>1);
+        tmp[2*i+1] = a - (d - (d>>1));
+    }
+    std::copy(tmp, tmp+L, s);
+}
+
+// Un bloc : détails src (angles × Hlen, ou nullptr) → rétro-projection + DC,
+// écrit dans dst (pas de ligne `stride`). Scratch : acc N×N, sig/tmp 2*Hlen.
+inline void rc_decode_block(const RC_BackprojTable& tb, const int8_t* src, int DC,
+                            uint8_t* dst, size_t stride, int* acc, int* sig, int* tmp){
+    const int N=tb.N, SL=2*tb.Hlen;
+    const int T=20; // cf. reconstruction QA
+    const int lut[3] = { -T, 0, +T };
+    std::fill(acc, acc+(size_t)N*N, 0);
+    for(int a=0; src && a<tb.angles; ++a){
+        std::fill(sig, sig+tb.Hlen, 0);
+        for(int i=0;i<tb.Hlen;++i) sig[tb.Hlen+i]=lut[(*src++)+1];
+        rc_haar1d_inv_span(sig, SL, tmp);
+        const int16_t* B=&tb.bin[(size_t)a*N*N];
+        for(size_t k=0;k<(size_t)N*N;++k){
+            int16_t bi=B[k];
+            if(bi>=0) acc[k]+=sig[(size_t)bi];
+        }
+    }
+    for(int y=0;y<N;++y){
+        uint8_t* d=dst + (size_t)y*stride;
+        for(int x=0;x<N;++x){
+            size_t k=(size_t)y*N+x;
+            int v = (tb.hits[k]>0? acc[k]/tb.hits[k] : 0);
+            d[x]=(uint8_t)std::clamp(DC+v, 0, 255);
+        }
+    }
+}
+
+// trits : blocs consécutifs (ordre proto_aniso_rc_encode), angles × Hlen par bloc,
+//         ou nullptr (détails absents : aperçu DC seul).
+// block_LL : blocksX*blocksY octets ou nullptr (→ 128). Sortie Y (c=1) W×H paddés.
+inline bool proto_aniso_rc_decode_Y(const int8_t* trits, size_t n_trits,
+                                    const uint8_t* block_LL,
+                                    int W, int H, const AnisoRCParams& P,
+                                    ImageU8& outY, unsigned threads=0){
+    const int N=P.block;
+    if(N<2 || W<=0 || H<=0) return false;
+    const int bX=(W+N-1)/N, bY=(H+N-1)/N;
+    const int Wp=bX*N, Hp=bY*N;
+
+    std::vector<RC_Angle> angs; rc_prepare_angles(P, angs);
+    RC_BackprojTable tb; rc_build_backproj_table(N, angs, tb);
+    const size_t per_block=(size_t)tb.angles*tb.Hlen;
+    const size_t n_blocks=(size_t)bX*bY;
+    if(trits && n_trits < per_block*n_blocks) return false;
+
+    outY.w=Wp; outY.h=Hp; outY.c=1; outY.data.assign((size_t)Wp*Hp, 0);
+
+    const int SL = 2*tb.Hlen;
+    T3Par::parallel_for(n_blocks, [&](size_t b0, size_t b1){
+        std::vector<int> acc((size_t)N*N), sig((size_t)SL), tmp((size_t)SL);
+        for(size_t b=b0; b<b1; ++b){
+            const int by=(int)(b / (size_t)bX), bx=(int)(b % (size_t)bX);
+            rc_decode_block(tb, trits ? trits + b*per_block : nullptr,
+                            block_LL ? (int)block_LL[b] : 128,
+                            &outY.data[(size_t)by*N*Wp + (size_t)bx*N], (size_t)Wp,
+                            acc.data(), sig.data(), tmp.data());
+        }
+    }, threads);
+    return true;
+}
+
+// Quadtree : tree = trits de structure (rc_qt_build), trits = détails des
+// feuilles dans l'ordre (ou nullptr : DC seul), leaf_LL = 1 octet par feuille
+// (ou nullptr → 128). Une table de rétro-projection par taille de feuille.
+inline bool proto_aniso_rc_decode_Y_qt(const int8_t* tree, size_t n_tree,
+                                       const int8_t* trits, size_t n_trits,
+                                       const uint8_t* leaf_LL, size_t n_LL,
+                                       int W, int H, const AnisoRCParams& P,
+                                       ImageU8& outY, unsigned threads=0){
+    const int Nmax=P.qt_max, Nmin=P.qt_min;
+    if(Nmin<2 || Nmax<Nmin || W<=0 || H<=0) return false;
+    // Nmax = Nmin x 2^k (méta non fiable) : sinon des feuilles plus petites
+    // que la dernière table (48/16 → feuilles de 12)
+    int n0=Nmax;
+    while(n0>Nmin && (n0&1)==0) n0>>=1;
+    if(n0!=Nmin) return false;
+    const int rX=(W+Nmax-1)/Nmax, rY=(H+Nmax-1)/Nmax;
+    const int Wp=rX*Nmax, Hp=rY*Nmax;
+
+    std::vector<RC_Leaf> leaves;
+    if(!tree || !rc_qt_parse(tree, n_tree, rX, rY, Nmax, Nmin, leaves)) return false;
+    if(leaf_LL && n_LL!=leaves.size()) return false;
+
+    std::vector<RC_Angle> angs; rc_prepare_angles(P, angs);
+    std::vector<RC_BackprojTable> tabs; // niveau l : taille Nmax>>l
+    for(int n=Nmax; n>=Nmin; n/=2){ tabs.emplace_back(); rc_build_backproj_table(n, angs, tabs.back()); }
+    auto level_of=[&](int n){ int l=0; while((Nmax>>l)>n) ++l; return (size_t)l; };
+
+    std::vector<size_t> ofs(leaves.size()+1, 0);
+    for(size_t i=0;i<leaves.size();++i){
+        const RC_BackprojTable& tb=tabs[level_of(leaves[i].N)];
+        ofs[i+1]=ofs[i] + (size_t)tb.angles*tb.Hlen;
+    }
+    if(trits && n_trits < ofs.back()) return false;
+
+    outY.w=Wp; outY.h=Hp; outY.c=1; outY.data.assign((size_t)Wp*Hp, 0);
+
+    const int SLmax = 2*tabs[0].Hlen;
+    T3Par::parallel_for(leaves.size(), [&](size_t l0, size_t l1){
+        std::vector<int> acc((size_t)Nmax*Nmax), sig((size_t)SLmax), tmp((size_t)SLmax);
+        for(size_t i=l0; i<l1; ++i){
+            const RC_Leaf& L=leaves[i];
+            rc_decode_block(tabs[level_of(L.N)], trits ? trits + ofs[i] : nullptr,
+                            leaf_LL ? (int)leaf_LL[i] : 128,
+                            &outY.data[(size_t)L.y0*Wp + (size_t)L.x0], (size_t)Wp,
+                            acc.data(), sig.data(), tmp.data());
+        }
+    }, threads);
+    return true;
+}
+
+// =============================== [10] Contrôle de débit (1 passe) ===========
+// Sélection sur les z-scores en cache : seuil = (target_nnz+1)-ième plus grand
+// z, donc #{z > seuil} <= target_nnz. Les z sont à queue lourde (blocs plats :
+// MAD ~ 0) : un histogramme linéaire perd toute résolution, d'où nth_element
+// (exact, O(n)) plutôt que des bacs.
+
+inline float rc_zthresh_for_nnz(const std::vector<float>& z, uint64_t target_nnz){
+    std::vector<float> pos; pos.reserve(z.size());
+    for(float v : z) if(v > 0.f) pos.push_back(v);
+    if(pos.size() <= target_nnz) return 0.f; // tous les z > 0 tiennent dans la cible
+    auto k = pos.begin() + (std::ptrdiff_t)target_nnz;
+    std::nth_element(pos.begin(), k, pos.end(), std::greater<float>());
+    return *k;
+}
@@ -23,6 +23,11 @@
 //    pack_base243(A.sketch_trits, A.sketch_bytes);
 //    // ensuite: stocke les bytes, ou encapsule en .t3p/.t3v, puis ECC.
 //
+//    // Débit cible (nnz) : coefficients en cache, seuil choisi, 2e passe
+//    std::vector<int> coeffs; proto_tile_haar_coeffs(rgb, P, A, coeffs);
+//    P.thresh = proto_haar_thresh_for_nnz(coeffs, target_nnz);
+//    proto_haar_ternarize_coeffs(coeffs, P.thresh, A.tile_trits);
+//
 // ============================================================================
 
 #pragma once
@@ -63,8 +68,7 @@ struct ProtoArtifacts {
 // =============================== [1] Pack base-243 ==========================
 // 5 trits unbalanced ({0,1,2}) -> 1 octet [0..242]; on packe un nombre arbitraire de trits.
 
-inline uint8_t trit_bal_to_unb(int8_t b){ return (uint8_t)(b + 1); }
-inline int8_t  trit_unb_to_bal(uint8_t u){ return (int8_t)u - 1; }
+// trit_bal_to_unb / trit_unb_to_bal : fournis par le cœur (ternary_image_codec_v6_min.hpp)
 
 inline void pack_base243(const std::vector<int8_t>& trits_bal, std::vector<uint8_t>& out_bytes){
     out_bytes.clear();
@@ -157,8 +161,13 @@ inline void haar2d_int_inv(std::vector<int>& tile, int N){
 // =============================== [4] Tuilage + ternarisation ================
 // On prend Y (depuis RGB), on découpe en tuiles NxN, Haar2D, puis:
 //  - LL stocké u8 (option) ; LH/HL/HH -> trits balanced par seuil ±T.
+// Découpé en 2 passes : coefficients de détail (cache) puis ternarisation,
+// pour que le contrôle de débit ([9]) choisisse T sans refaire Haar.
 
-inline void proto_tile_haar_ternary(const ImageU8& rgb, const ProtoParams& P, ProtoArtifacts& A){
+// Passe 1 : remplit A (dims, LL) et coeffs = détails de toutes les tuiles,
+// dans l'ordre exact des trits (tuile par tuile, hors quadrant LL).
+inline void proto_tile_haar_coeffs(const ImageU8& rgb, const ProtoParams& P, ProtoArtifacts& A,
+                                   std::vector<int>& coeffs){
     // Extraire Y et pad à multiples de N
     const int N=P.tile;
     int W = (rgb.w + (N-1)) / N * N;
@@ -176,8 +185,8 @@ inline void proto_tile_haar_ternary(const ImageU8& rgb, const ProtoParams& P, Pr
     } else {
         A.tile_LL.clear();
     }
-    A.tile_trits.clear();
-    A.tile_trits.reserve((size_t)W*H); // upper bound
+    coeffs.clear();
+    coeffs.reserve((size_t)A.tilesX*A.tilesY*(size_t)(N*N - (N/2)*(N/2)));
 
     // Parcours tuiles
     for(int ty=0; ty<A.tilesY; ++ty){
@@ -203,20 +212,38 @@ inline void proto_tile_haar_ternary(const ImageU8& rgb, const ProtoParams& P, Pr
                 // Ici on s'en tient aux détails pour rester minimal.
             }
 
-            // Détails -> trits
+            // Détails (hors quadrant LL)
             for(int y=0;y<N;++y){
                 for(int x=0;x<N;++x){
                     bool inLL = (x < N/2) && (y < N/2);
                     if(inLL) continue;
-                    int c = T[(size_t)y*N+x];
-                    int8_t b = (std::abs(c) >= P.thresh) ? ( (c>0)? +1 : -1 ) : 0;
-                    A.tile_trits.push_back(b);
+                    coeffs.push_back(T[(size_t)y*N+x]);
                 }
             }
         }
     }
 }
 
+// Passe 2 : |c| >= thresh -> ±1, sinon 0. Retourne le # de trits non nuls.
+inline size_t proto_haar_ternarize_coeffs(const std::vector<int>& coeffs, int thresh,
+                                          std::vector<int8_t>& out_trits){
+    out_trits.resize(coeffs.size());
+    size_t nnz=0;
+    for(size_t i=0;i<coeffs.size();++i){
+        const int c = coeffs[i];
+        int8_t b = (std::abs(c) >= thresh) ? ( (c>0)? +1 : -1 ) : 0;
+        out_trits[i] = b;
+        nnz += (b!=0);
+    }
+    return nnz;
+}
+
+inline void proto_tile_haar_ternary(const ImageU8& rgb, const ProtoParams& P, ProtoArtifacts& A){
+    std::vector<int> coeffs;
+    proto_tile_haar_coeffs(rgb, P, A, coeffs);
+    proto_haar_ternarize_coeffs(coeffs, P.thresh, A.tile_trits);
+}
+
 // =============================== [5] Sketch spectral DCT léger ==============
 // Downscale -> DCT-II 2D (brute, taille sketchSize) -> bacs radiaux×angles -> ternarisation.
 
@@ -365,3 +392,200 @@ inline void proto_reconstruct_Y_from_tiles(const ProtoArtifacts& A, const ProtoP
     }
 }
 
+
+// =============================== [7] Décodage rapide (tuiles parallèles) ====
+// Chemin "production" du décodeur .t3proto (t3proto_tool decode) :
+//  • aucune allocation par tuile (scratch par intervalle de tuiles),
+//  • Haar inverse en place, colonnes vectorisées le long de x, lignes
+//    ré-entrelacées (SSE2 si disponible, sinon boucles auto-vectorisables),
+//  • tuiles réparties sur les cœurs via T3Par::parallel_for.
+// Même arithmétique que haar2d_int_inv() (résultats identiques au QA).
+// Différence volontaire : le quadrant LL entier reçoit la valeur LL de la
+// tuile (aperçu plus fidèle qu’un seul coefficient), 128 si LL absent.
+
+#include "t3_parallel.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+inline void haar2d_int_inv_fast(int* T, int N, int* tmp){
+    const int H=N/2;
+    // colonnes : paires de lignes (a,d) → lignes (2i, 2i+1), vectorisé sur x
+    for(int i=0;i<H;++i){
+        const int* a=&T[(size_t)i*N];
+        const int* d=&T[(size_t)(H+i)*N];
+        int* e=&tmp[(size_t)(2*i)*N];
+        int* o=&tmp[(size_t)(2*i+1)*N];
+        int x=0;
+#if defined(__SSE2__)
+        for(; x+4<=N; x+=4){
+            __m128i va=_mm_loadu_si128((const __m128i*)(a+x));
+            __m128i vd=_mm_loadu_si128((const __m128i*)(d+x));
+            __m128i vh=_mm_srai_epi32(vd,1);
+            _mm_storeu_si128((__m128i*)(e+x), _mm_add_epi32(va,vh));
+            _mm_storeu_si128((__m128i*)(o+x), _mm_sub_epi32(va,_mm_sub_epi32(vd,vh)));
+        }
+#endif
+        for(; x<N; ++x){
+            int dv=d[x], h=dv>>1;
+            e[x]=a[x]+h;
+            o[x]=a[x]-(dv-h);
+        }
+    }
+    // lignes : [A | D] → entrelacement (2i, 2i+1)
+    for(int y=0;y<N;++y){
+        const int* r=&tmp[(size_t)y*N];
+        int* out=&T[(size_t)y*N];
+        int i=0;
+#if defined(__SSE2__)
+        for(; i+4<=H; i+=4){
+            __m128i va=_mm_loadu_si128((const __m128i*)(r+i));
+            __m128i vd=_mm_loadu_si128((const __m128i*)(r+H+i));
+            __m128i vh=_mm_srai_epi32(vd,1);
+            __m128i ve=_mm_add_epi32(va,vh);
+            __m128i vo=_mm_sub_epi32(va,_mm_sub_epi32(vd,vh));
+            _mm_storeu_si128((__m128i*)(out+2*i),   _mm_unpacklo_epi32(ve,vo));
+            _mm_storeu_si128((__m128i*)(out+2*i+4), _mm_unpackhi_epi32(ve,vo));
+        }
+#endif
+        for(; i<H; ++i){
+            int dv=r[H+i], h=dv>>1;
+            out[2*i]   = r[i]+h;
+            out[2*i+1] = r[i]-(dv-h);
+        }
+    }
+}
+
+// Une tuile t (raster) : détails src (ordre proto_tile_haar_ternary) + LL
+// -> pixels de outY (déjà dimensionné). T, tmp : scratch N*N.
+inline void proto_haar_decode_tile(const int8_t* src, int LL, size_t t, int tilesX,
+                                   int N, int thresh, ImageU8& outY, int* T, int* tmp){
+    const int lut[3] = { -thresh, 0, +thresh };
+    const int ty=(int)(t / (size_t)tilesX), tx=(int)(t % (size_t)tilesX);
+    for(int y=0;y<N;++y){
+        int* row=&T[(size_t)y*N];
+        int x=0;
+        if(y<N/2){ for(; x<N/2; ++x) row[x]=LL; }
+        for(; x<N; ++x) row[x]=lut[(*src++)+1];
+    }
+    haar2d_int_inv_fast(T, N, tmp);
+    for(int y=0;y<N;++y){
+        const int* row=&T[(size_t)y*N];
+        uint8_t* dst=&outY.data[(size_t)(ty*N+y)*outY.w + (size_t)tx*N];
+        for(int x=0;x<N;++x) dst[x]=(uint8_t)std::clamp(row[x], 0, 255);
+    }
+}
+
+// trits : détails de toutes les tuiles (ordre proto_tile_haar_ternary).
+// tile_LL : tilesX*tilesY octets, ou nullptr (→ 128).
+// Sortie : plan Y (c=1) de (tilesX*N)×(tilesY*N). false si flux trop court.
+inline bool proto_haar_decode_Y(const int8_t* trits, size_t n_trits,
+                                const uint8_t* tile_LL,
+                                int tilesX, int tilesY, int N, int thresh,
+                                ImageU8& outY, unsigned threads=0){
+    if(N<2 || (N&1) || tilesX<=0 || tilesY<=0) return false;
+    const size_t per_tile = (size_t)N*N - (size_t)(N/2)*(N/2);
+    const size_t n_tiles  = (size_t)tilesX*tilesY;
+    if(n_trits < per_tile*n_tiles) return false;
+
+    const int W=tilesX*N, H=tilesY*N;
+    outY.w=W; outY.h=H; outY.c=1; outY.data.assign((size_t)W*H, 0);
+
+    T3Par::parallel_for(n_tiles, [&](size_t t0, size_t t1){
+        std::vector<int> T((size_t)N*N), tmp((size_t)N*N);
+        for(size_t t=t0; t<t1; ++t)
+            proto_haar_decode_tile(trits + t*per_tile, tile_LL ? (int)tile_LL[t] : 128,
+                                   t, tilesX, N, thresh, outY, T.data(), tmp.data());
+    }, threads);
+    return true;
+}
+
+// =============================== [8] Sous-bandes (layout progressif) ========
+// Le flux v1 entrelace, tuile par tuile, les détails en raster (hors LL).
+// Le layout progressif (.t3proto v2) les regroupe par sous-bande sur toute
+// l’image : HL (haut-droite), puis LH (bas-gauche), puis HH (bas-droite),
+// chacune (N/2)² trits par tuile en raster local.
+
+inline void proto_haar_split_subbands(const int8_t* tile_trits, size_t n_tiles, int N,
+                                      std::vector<int8_t>& HL,
+                                      std::vector<int8_t>& LH,
+                                      std::vector<int8_t>& HH){
+    const int h=N/2;
+    const size_t q=(size_t)h*h;
+    HL.resize(q*n_tiles); LH.resize(q*n_tiles); HH.resize(q*n_tiles);
+    const int8_t* src=tile_trits;
+    for(size_t t=0;t<n_tiles;++t){
+        int8_t* hl=&HL[t*q]; int8_t* lh=&LH[t*q]; int8_t* hh=&HH[t*q];
+        for(int y=0;y<h;++y){ std::memcpy(hl+(size_t)y*h, src, (size_t)h); src+=h; }
+        for(int y=0;y<h;++y){
+            std::memcpy(lh+(size_t)y*h, src,   (size_t)h);
+            std::memcpy(hh+(size_t)y*h, src+h, (size_t)h);
+            src+=N;
+        }
+    }
+}
+
+// Décodage depuis les sous-bandes ; une sous-bande nullptr (section absente
+// ou tronquée) est reconstruite à 0. tile_LL nullptr → 128.
+inline void proto_haar_decode_Y_subbands(const int8_t* HL, const int8_t* LH, const int8_t* HH,
+                                         const uint8_t* tile_LL,
+                                         int tilesX, int tilesY, int N, int thresh,
+                                         ImageU8& outY, unsigned threads=0){
+    const int h=N/2;
+    const size_t q=(size_t)h*h;
+    const size_t n_tiles=(size_t)tilesX*tilesY;
+    const int W=tilesX*N, H=tilesY*N;
+    outY.w=W; outY.h=H; outY.c=1; outY.data.assign((size_t)W*H, 0);
+
+    const int lut[3] = { -thresh, 0, +thresh };
+    auto put = [&](int* row, const int8_t* src){
+        if(!src){ std::fill(row, row+h, 0); return; }
+        for(int x=0;x<h;++x) row[x]=lut[src[x]+1];
+    };
+    T3Par::parallel_for(n_tiles, [&](size_t t0, size_t t1){
+        std::vector<int> T((size_t)N*N), tmp((size_t)N*N);
+        for(size_t t=t0; t<t1; ++t){
+            const int ty=(int)(t / (size_t)tilesX), tx=(int)(t % (size_t)tilesX);
+            const int LL = tile_LL ? (int)tile_LL[t] : 128;
+            for(int y=0;y<h;++y){
+                int* row=&T[(size_t)y*N];
+                std::fill(row, row+h, LL);
+                put(row+h, HL? HL+t*q+(size_t)y*h : nullptr);
+            }
+            for(int y=0;y<h;++y){
+                int* row=&T[(size_t)(h+y)*N];
+                put(row,   LH? LH+t*q+(size_t)y*h : nullptr);
+                put(row+h, HH? HH+t*q+(size_t)y*h : nullptr);
+            }
+            haar2d_int_inv_fast(T.data(), N, tmp.data());
+            for(int y=0;y<N;++y){
+                const int* row=&T[(size_t)y*N];
+                uint8_t* dst=&outY.data[(size_t)(ty*N+y)*W + (size_t)tx*N];
+                for(int x=0;x<N;++x) dst[x]=(uint8_t)std::clamp(row[x], 0, 255);
+            }
+        }
+    }, threads);
+}
+
+// =============================== [9] Contrôle de débit (1 passe) ============
+// Le pack base-243 est à longueur fixe : à géométrie donnée, le seul levier
+// de débit est la densité de trits non nuls (ce que voit un entropique aval).
+// Histogramme de |c| sur les coefficients en cache -> plus petit seuil T
+// (donc le plus de détail) tel que #{|c| >= T} <= target_nnz.
+
+inline int proto_haar_thresh_for_nnz(const std::vector<int>& coeffs, uint64_t target_nnz){
+    int maxabs = 0;
+    for(int c : coeffs) maxabs = std::max(maxabs, std::abs(c));
+    std::vector<uint64_t> hist((size_t)maxabs + 2, 0);
+    for(int c : coeffs) ++hist[(size_t)std::abs(c)];
+
+    // nnz(T) = somme des hist[m] pour m >= T (T >= 1 : 0 n'est jamais ±1)
+    uint64_t nnz = 0;
+    int T = maxabs + 1;
+    for(int t = maxabs; t >= 1; --t){
+        nnz += hist[(size_t)t];
+        if(nnz > target_nnz) break;
+        T = t;
+    }
+    return T;
+}
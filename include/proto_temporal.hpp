@@ -0,0 +1,361 @@
+// ============================================================================
+//  File: include/proto_temporal.hpp — Résidus ternaires temporels (Haar, séquences) (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • En vidéo, le prototype Haar code chaque trame seule : les zones
+//    statiques ré-émettent les mêmes tile_trits / tile_LL à chaque trame.
+//  • Mode séquence : trame clé (intra) toutes les K trames ; entre deux clés,
+//    chaque tuile est soit sautée ("identique à la trame précédente"), soit
+//    codée par différence :
+//      – détails : résidu ternaire chiffre à chiffre, d = (cur - prev) mod 3
+//        ramené dans {-1,0,1} (l’alphabet reste balanced, résidus ~0) ;
+//      – LL : delta u8 modulo 256.
+//  • Décodage exact : la trame reconstruite est identique au décodage intra
+//    de la même image (mêmes trits, même LL).
+//
+//  FORMAT D’UNE TRAME (octets, LE)
+//  -------------------------------
+//   Clé   : LL[n_tiles] (u8) | détails base-243 (n_tiles × per_tile trits)
+//   Delta : S0[nw] S1[nw] (u64, nw = ceil(n_tiles/64))
+//           | dLL[#S1==0] (u8) | résidus base-243 (#S0==0 × per_tile trits)
+//     Drapeaux de saut en tranches de bits ("bitsliced", 64 tuiles/mot) :
+//       S0 bit t = 1 : détails de la tuile t inchangés
+//       S1 bit t = 1 : LL de la tuile t inchangé
+//       (S0,S1) = (1,1) tuile sautée ; (1,0) LL seul ; (0,·) résidu.
+//     Bits au-delà de n_tiles = 1. Tuiles parcourues par ctz sur ~S.
+//
+//  API
+//  ---
+//   struct ProtoSeqPacket { key, n_coded, data };
+//   ProtoSeqEncoder E; E.P=...; E.key_interval=K;
+//   E.encode(rgb, packet, threads);          // 1 appel par trame
+//   ProtoSeqDecoder D; D.init(tilesX,tilesY,N,thresh);
+//   D.decode(key, n_coded, data, n, threads); // D.Y = plan Y paddé
+//
+//  NOTES
+//  -----
+//  • Encodeur : une tuile dont les pixels Y sont identiques à la trame
+//    précédente est sautée sans Haar ; les autres sont transformées puis
+//    comparées en trits. Tuiles réparties par mots de 64 (T3Par).
+//  • Décodeur : seules les tuiles non sautées passent par le Haar inverse,
+//    D.Y conserve les pixels des autres.
+//  • Seuil fixe (P.thresh) sur toute la séquence ; pas de sketch par trame.
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "proto_noentropy.hpp"
+#include "t3_parallel.hpp"
+
+// =============================== [0] Trits mod 3 / bits =====================
+
+inline int8_t trit_add3(int8_t a, int8_t d){
+    int v = a + d;
+    return (int8_t)(v > 1 ? v - 3 : (v < -1 ? v + 3 : v));
+}
+inline int8_t trit_sub3(int8_t a, int8_t b){
+    int v = a - b;
+    return (int8_t)(v > 1 ? v - 3 : (v < -1 ? v + 3 : v));
+}
+
+inline size_t seq_mask_words(size_t n_tiles){ return (n_tiles + 63) / 64; }
+
+inline int seq_ctz64(uint64_t w){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(w);
+#else
+    int n=0; while(!(w & 1u)){ w >>= 1; ++n; } return n;
+#endif
+}
+inline int seq_popcount64(uint64_t w){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+#else
+    int n=0; while(w){ w &= w-1; ++n; } return n;
+#endif
+}
+
+inline void seq_put_u64(uint8_t* p, uint64_t v){ for(int i=0;i<8;++i) p[i]=(uint8_t)(v>>(8*i)); }
+inline uint64_t seq_get_u64(const uint8_t* p){
+    uint64_t v=0; for(int i=7;i>=0;--i) v=(v<<8)|p[i]; return v;
+}
+
+// Pack base-243 de n trits balanced (pointeur) en fin de `out`
+inline void seq_pack_append(const int8_t* t, size_t n, std::vector<uint8_t>& out){
+    const size_t b0=out.size();
+    out.resize(b0 + (n+4)/5);
+    uint8_t* dst=&out[b0];
+    size_t i=0;
+    for(; i+5<=n; i+=5)
+        *dst++ = (uint8_t)((t[i]+1) + 3*((t[i+1]+1) + 3*((t[i+2]+1) + 3*((t[i+3]+1) + 3*(t[i+4]+1)))));
+    if(i<n){
+        uint32_t v=0;
+        for(size_t j=n; j-- > i; ) v = v*3 + (uint32_t)(t[j]+1);
+        *dst = (uint8_t)v;
+    }
+}
+inline void seq_unpack(const uint8_t* b, size_t n, int8_t* t){
+    for(size_t i=0;i<n;i+=5){
+        uint32_t v=b[i/5];
+        const size_t k=std::min<size_t>(5, n-i);
+        for(size_t j=0;j<k;++j){ t[i+j]=(int8_t)((int)(v%3u)-1); v/=3u; }
+    }
+}
+
+// =============================== [1] Tuile Haar depuis Y ====================
+// Même arithmétique que proto_tile_haar_coeffs + ternarisation (trame clé
+// identique au flux intra) : LL = T[0] borné, détails hors quadrant LL.
+
+inline void seq_haar_tile(const uint8_t* Y, int W, int tx, int ty, int N, int thresh,
+                          std::vector<int>& T, int8_t* trits, uint8_t& LL){
+    for(int y=0;y<N;++y){
+        const uint8_t* src=&Y[(size_t)(ty*N+y)*W + (size_t)tx*N];
+        for(int x=0;x<N;++x) T[(size_t)y*N+x]=(int)src[x];
+    }
+    haar2d_int(T, N);
+    LL = (uint8_t)std::clamp(T[0], 0, 255);
+    for(int y=0;y<N;++y){
+        for(int x=0;x<N;++x){
+            if((x < N/2) && (y < N/2)) continue;
+            const int c = T[(size_t)y*N+x];
+            *trits++ = (std::abs(c) >= thresh) ? ((c>0)? +1 : -1) : 0;
+        }
+    }
+}
+
+inline bool seq_tile_equal(const uint8_t* A, const uint8_t* B, int W, int tx, int ty, int N){
+    for(int y=0;y<N;++y){
+        const size_t o=(size_t)(ty*N+y)*W + (size_t)tx*N;
+        if(std::memcmp(A+o, B+o, (size_t)N)!=0) return false;
+    }
+    return true;
+}
+
+// =============================== [2] Encodeur ===============================
+
+struct ProtoSeqPacket {
+    bool key = true;
+    uint32_t n_coded = 0;        // tuiles avec détails (clé : toutes)
+    std::vector<uint8_t> data;   // trame sérialisée (format ci-dessus)
+};
+
+struct ProtoSeqStats {
+    uint64_t key=0, delta=0;           // # trames
+    uint64_t skipped=0, ll_only=0, coded=0; // # tuiles (trames delta)
+};
+
+struct ProtoSeqEncoder {
+    ProtoParams P;
+    int key_interval = 30;             // 1 clé toutes les K trames (<=0 : 1re seule)
+
+    int W=0, H=0, tilesX=0, tilesY=0, N=0; // dims paddées
+    size_t per_tile=0;
+    uint64_t frame=0;
+    ProtoSeqStats stats;
+
+    std::vector<uint8_t> Y, Yprev;     // plans Y paddés (courant / précédent)
+    std::vector<int8_t>  trits;        // état : détails de la trame précédente
+    std::vector<uint8_t> LL;           // état : LL de la trame précédente
+    std::vector<int8_t>  resid;        // scratch (n_tiles × per_tile)
+    std::vector<uint8_t> dLL;          // scratch (n_tiles)
+    std::vector<uint64_t> S0, S1;
+
+    // Y paddé (NN) comme proto_tile_haar_coeffs
+    void load_Y(const ImageU8& rgb){
+        ImageU8 work=rgb;
+        if(W!=rgb.w || H!=rgb.h) resize_rgb_nn(rgb, W, H, work);
+        Y.resize((size_t)W*H);
+        for(size_t i=0;i<Y.size();++i){
+            const uint8_t* p=&work.data[i*3];
+            uint8_t Cb,Cr; rgb_to_ycbcr(p[0],p[1],p[2],Y[i],Cb,Cr);
+        }
+    }
+
+    bool encode(const ImageU8& rgb, ProtoSeqPacket& out, unsigned threads=0){
+        out = ProtoSeqPacket{};
+        if(frame==0){
+            N = P.tile;
+            if(N<2 || (N&1) || rgb.w<=0 || rgb.h<=0) return false;
+            W = (rgb.w + (N-1)) / N * N;
+            H = (rgb.h + (N-1)) / N * N;
+            tilesX = W / N; tilesY = H / N;
+            per_tile = (size_t)N*N - (size_t)(N/2)*(N/2);
+        }
+        load_Y(rgb);
+        const size_t n_tiles=(size_t)tilesX*tilesY, nw=seq_mask_words(n_tiles);
+        const bool key = (frame==0) || (key_interval>0 && frame % (uint64_t)key_interval == 0);
+        out.key = key;
+
+        if(key){
+            trits.assign(n_tiles*per_tile, 0);
+            LL.assign(n_tiles, 0);
+            T3Par::parallel_for(n_tiles, [&](size_t t0, size_t t1){
+                std::vector<int> T((size_t)N*N);
+                for(size_t t=t0;t<t1;++t)
+                    seq_haar_tile(Y.data(), W, (int)(t%(size_t)tilesX), (int)(t/(size_t)tilesX),
+                                  N, P.thresh, T, &trits[t*per_tile], LL[t]);
+            }, threads);
+            out.n_coded = (uint32_t)n_tiles;
+            out.data = LL;
+            seq_pack_append(trits.data(), trits.size(), out.data);
+            ++stats.key;
+        } else {
+            resid.resize(n_tiles*per_tile);
+            dLL.resize(n_tiles);
+            S0.assign(nw, ~0ull);
+            S1.assign(nw, ~0ull);
+            // 1 mot = 64 tuiles : chaque tâche écrit ses propres mots S0/S1
+            T3Par::parallel_for(nw, [&](size_t w0, size_t w1){
+                std::vector<int> T((size_t)N*N);
+                std::vector<int8_t> cur(per_tile);
+                for(size_t w=w0; w<w1; ++w){
+                    uint64_t s0=~0ull, s1=~0ull;
+                    const size_t tend=std::min(n_tiles, (w+1)*64);
+                    for(size_t t=w*64; t<tend; ++t){
+                        const int tx=(int)(t%(size_t)tilesX), ty=(int)(t/(size_t)tilesX);
+                        if(seq_tile_equal(Y.data(), Yprev.data(), W, tx, ty, N)) continue;
+                        uint8_t ll=0;
+                        seq_haar_tile(Y.data(), W, tx, ty, N, P.thresh, T, cur.data(), ll);
+                        int8_t* prev=&trits[t*per_tile];
+                        const uint64_t bit=1ull<<(t-w*64);
+                        if(std::memcmp(cur.data(), prev, per_tile)!=0){
+                            s0 &= ~bit;
+                            int8_t* r=&resid[t*per_tile];
+                            for(size_t i=0;i<per_tile;++i) r[i]=trit_sub3(cur[i], prev[i]);
+                            std::memcpy(prev, cur.data(), per_tile);
+                        }
+                        if(ll != LL[t]){
+                            s1 &= ~bit;
+                            dLL[t]=(uint8_t)(ll - LL[t]);
+                            LL[t]=ll;
+                        }
+                    }
+                    S0[w]=s0; S1[w]=s1;
+                }
+            }, threads);
+
+            // Sérialisation : S0 | S1 | dLL | résidus
+            size_t n_ll=0, n_res=0;
+            for(size_t w=0;w<nw;++w){
+                n_ll  += (size_t)seq_popcount64(~S1[w]);
+                n_res += (size_t)seq_popcount64(~S0[w]);
+            }
+            out.data.resize(16*nw + n_ll);
+            for(size_t w=0;w<nw;++w){
+                seq_put_u64(&out.data[8*w], S0[w]);
+                seq_put_u64(&out.data[8*(nw+w)], S1[w]);
+            }
+            uint8_t* dl=&out.data[16*nw];
+            for(size_t w=0;w<nw;++w)
+                for(uint64_t m=~S1[w]; m; m&=m-1) *dl++ = dLL[w*64+(size_t)seq_ctz64(m)];
+            std::vector<int8_t> packed_res;
+            packed_res.reserve(n_res*per_tile);
+            for(size_t w=0;w<nw;++w)
+                for(uint64_t m=~S0[w]; m; m&=m-1){
+                    const int8_t* r=&resid[(w*64+(size_t)seq_ctz64(m))*per_tile];
+                    packed_res.insert(packed_res.end(), r, r+per_tile);
+                }
+            seq_pack_append(packed_res.data(), packed_res.size(), out.data);
+
+            out.n_coded = (uint32_t)n_res;
+            size_t n_skip=0;
+            for(size_t w=0;w<nw;++w) n_skip += (size_t)seq_popcount64(S0[w] & S1[w]);
+            n_skip -= nw*64 - n_tiles; // bits de bourrage
+            ++stats.delta;
+            stats.coded   += n_res;
+            stats.skipped += n_skip;
+            stats.ll_only += n_tiles - n_res - n_skip;
+        }
+        Yprev.swap(Y);
+        ++frame;
+        return true;
+    }
+};
+
+// =============================== [3] Décodeur ===============================
+
+struct ProtoSeqDecoder {
+    int tilesX=0, tilesY=0, N=0, thresh=0;
+    size_t per_tile=0;
+    bool have_key=false;
+    std::vector<int8_t>  trits;
+    std::vector<uint8_t> LL;
+    ImageU8 Y;                          // plan Y paddé (tilesX*N × tilesY*N)
+    std::vector<int8_t>  resid;         // scratch
+    std::vector<size_t>  ofs;           // scratch : 1er résidu de chaque mot
+
+    bool init(int tX, int tY, int n, int th){
+        if(n<2 || (n&1) || tX<=0 || tY<=0) return false;
+        tilesX=tX; tilesY=tY; N=n; thresh=th;
+        per_tile=(size_t)N*N - (size_t)(N/2)*(N/2);
+        have_key=false;
+        return true;
+    }
+
+    // false si la trame est incohérente (tailles) ou delta sans clé préalable
+    bool decode(bool key, uint32_t n_coded, const uint8_t* data, size_t n, unsigned threads=0){
+        const size_t n_tiles=(size_t)tilesX*tilesY, nw=seq_mask_words(n_tiles);
+        if(key){
+            if(n < n_tiles + (n_tiles*per_tile+4)/5) return false;
+            LL.assign(data, data+n_tiles);
+            trits.resize(n_tiles*per_tile);
+            seq_unpack(data+n_tiles, trits.size(), trits.data());
+            have_key=true;
+            return proto_haar_decode_Y(trits.data(), trits.size(), LL.data(),
+                                       tilesX, tilesY, N, thresh, Y, threads);
+        }
+        if(!have_key || n < 16*nw) return false;
+        const uint8_t* pS0=data;
+        const uint8_t* pS1=data+8*nw;
+        // Bits de bourrage du dernier mot (tuiles >= n_tiles) : toujours à 1
+        if(n_tiles & 63){
+            const uint64_t pad=~0ull << (n_tiles & 63);
+            if((seq_get_u64(pS0+8*(nw-1)) & pad)!=pad || (seq_get_u64(pS1+8*(nw-1)) & pad)!=pad)
+                return false;
+        }
+        ofs.resize(nw+1);
+        size_t n_ll=0, n_res=0;
+        for(size_t w=0;w<nw;++w){
+            ofs[w]=n_res;
+            n_res += (size_t)seq_popcount64(~seq_get_u64(pS0+8*w));
+            n_ll  += (size_t)seq_popcount64(~seq_get_u64(pS1+8*w));
+        }
+        ofs[nw]=n_res;
+        if(n_res!=n_coded || n < 16*nw + n_ll + (n_res*per_tile+4)/5) return false;
+
+        const uint8_t* dl=data+16*nw;
+        for(size_t w=0;w<nw;++w)
+            for(uint64_t m=~seq_get_u64(pS1+8*w); m; m&=m-1){
+                const size_t t=w*64+(size_t)seq_ctz64(m);
+                LL[t]=(uint8_t)(LL[t] + *dl++);
+            }
+        resid.resize(n_res*per_tile);
+        seq_unpack(dl, resid.size(), resid.data());
+
+        // Mots de 64 tuiles en parallèle : résidus puis Haar inverse des
+        // tuiles modifiées uniquement (Y garde les pixels des tuiles sautées)
+        T3Par::parallel_for(nw, [&](size_t w0, size_t w1){
+            std::vector<int> T((size_t)N*N), tmp((size_t)N*N);
+            for(size_t w=w0; w<w1; ++w){
+                const uint64_t s0=seq_get_u64(pS0+8*w), s1=seq_get_u64(pS1+8*w);
+                const int8_t* r=&resid[ofs[w]*per_tile];
+                for(uint64_t m=~s0; m; m&=m-1, r+=per_tile){
+                    int8_t* dst=&trits[(w*64+(size_t)seq_ctz64(m))*per_tile];
+                    for(size_t i=0;i<per_tile;++i) dst[i]=trit_add3(dst[i], r[i]);
+                }
+                for(uint64_t m=~(s0 & s1); m; m&=m-1){
+                    const size_t t=w*64+(size_t)seq_ctz64(m);
+                    proto_haar_decode_tile(&trits[t*per_tile], (int)LL[t], t, tilesX,
+                                           N, thresh, Y, T.data(), tmp.data());
+                }
+            }
+        }, threads);
+        return true;
+    }
+};
@@ -5,6 +5,8 @@
 //  OBJET
 //  -----
 //  • Décider l’accès lecture sur méta JSON (meta-only), sans lire le payload.
+//    Méta binaire TLV (t3_meta.hpp) acceptée aussi : lecture directe des
+//    champs du dictionnaire, sans analyse de texte.
 //  • Multi-domaines, hiérarchie limitée, proximité, TTL/Hops bornés.
 //  • Superposition “tiers bas” avec rotation ternaire équilibrée.
 //  • Préparation au 1er tour par le voisin ; acceptation au 2ᵉ tour seulement.
@@ -20,6 +22,8 @@
 #include <cctype>
 #include <algorithm>
 
+#include "t3_meta.hpp"
+
 namespace T3Security
 {
 
@@ -33,6 +37,7 @@ inline bool meta_find_key(const std::string& js, const std::string& key, size_t&
 }
 inline bool meta_find_str(const std::string& js, const std::string& key, std::string& out)
 {
+    if(T3Meta::is_tlv(js)) return T3Meta::find_str(js,key,out);
     size_t p;
     if(!meta_find_key(js,key,p)) return false;
     p = js.find(':', p);
@@ -46,6 +51,7 @@ inline bool meta_find_str(const std::string& js, const std::string& key, std::st
 }
 inline bool meta_find_uint(const std::string& js, const std::string& key, uint64_t& out)
 {
+    if(T3Meta::is_tlv(js)) return T3Meta::find_uint(js,key,out);
     size_t p;
     if(!meta_find_key(js,key,p)) return false;
     p = js.find(':', p);
@@ -125,33 +131,80 @@ struct BuildTag
     std::string route_origin;
 };
 
-inline BuildTag extract_build_from_meta(const std::string& meta)
+inline uint64_t type_hash_from_str(const std::string& s)
 {
-    BuildTag b{};
-    std::string s;
-    uint64_t v=0;
-    if(meta_find_str(meta,"domain", s))      b.domain = s;
-    if(meta_find_str(meta,"build_hash", s))  b.build_hash = s;
-    if(meta_find_str(meta,"type_hash", s))
+    if(s.rfind("fnv64:",0)==0)
     {
-        if(s.rfind("fnv64:",0)==0)
+        uint64_t val=0;
+        for(size_t i=6;i<s.size();++i)
         {
-            std::string hex = s.substr(6);
-            uint64_t val=0;
-            for(char c: hex)
-            {
-                val<<=4;
-                if(c>='0'&&c<='9') val|=(c-'0');
-                else if(c>='a'&&c<='f') val|=(10+(c-'a'));
-                else if(c>='A'&&c<='F') val|=(10+(c-'A'));
-            }
-            b.type_hash = val;
+            const char c=s[i];
+            val<<=4;
+            if(c>='0'&&c<='9') val|=(c-'0');
+            else if(c>='a'&&c<='f') val|=(10+(c-'a'));
+            else if(c>='A'&&c<='F') val|=(10+(c-'A'));
         }
-        else
+        return val;
+    }
+    return fnv1a64(s);
+}
+
+// Méta TLV : champs du dictionnaire lus par tag ; objet "route" imbriqué
+// (rare) cherché dans le résidu JSON seulement s’il existe.
+inline BuildTag extract_build_from_tlv(const T3Meta::MetaView& mv)
+{
+    BuildTag b{};
+    std::string_view sv;
+    uint64_t v=0;
+    const std::string rest(mv.residual());
+    // Clé absente du dictionnaire (valeur échappée ou de type inattendu,
+    // rangée au résidu) : même lecture texte que le chemin JSON
+    auto str = [&](int tag, const char* key, std::string& out)
+    {
+        if(mv.get_str(tag, sv)){ out.assign(sv.data(), sv.size()); return true; }
+        return !rest.empty() && meta_find_str(rest, key, out);
+    };
+    auto uint = [&](int tag, const char* key, uint64_t& out)
+    {
+        return mv.get_uint(tag, out) || (!rest.empty() && meta_find_uint(rest, key, out));
+    };
+    std::string s;
+    if(str(T3Meta::kDomain, "domain", s))          b.domain = s;
+    if(str(T3Meta::kBuildHash, "build_hash", s))   b.build_hash = s;
+    if(str(T3Meta::kTypeHash, "type_hash", s))     b.type_hash = type_hash_from_str(s);
+    if(uint(T3Meta::kVersion, "version", v))       b.version = v;
+    if(str(T3Meta::kClass, "class", s))            b.pclass = prox_from_str(s);
+    if(uint(T3Meta::kRadiusM, "radius_m", v))      b.radius_m = (uint32_t)v;
+    if(uint(T3Meta::kRouteTtl, "route_ttl", v))    b.route_ttl  = (uint8_t)std::min<uint64_t>(v,255);
+    if(uint(T3Meta::kRouteHops, "route_hops", v))  b.route_hops = (uint8_t)std::min<uint64_t>(v,255);
+    if(uint(T3Meta::kRoutePhase, "route_phase", v))b.route_phase= (uint8_t)std::min<uint64_t>(v,2);
+    if(str(T3Meta::kOrigin, "origin", s))          b.route_origin = s;
+    if(!rest.empty())
+    {
+        size_t pos;
+        if(meta_find_key(rest,"route", pos))
         {
-            b.type_hash = fnv1a64(s);
+            if(meta_find_uint(rest.substr(pos),"ttl", v))     b.route_ttl   = (uint8_t)std::min<uint64_t>(v,255);
+            if(meta_find_uint(rest.substr(pos),"hops", v))    b.route_hops  = (uint8_t)std::min<uint64_t>(v,255);
+            if(meta_find_uint(rest.substr(pos),"phase", v))   b.route_phase = (uint8_t)std::min<uint64_t>(v,2);
+            if(meta_find_str (rest.substr(pos),"origin", s))  b.route_origin= s;
         }
     }
+    if(b.type_hash==0) b.type_hash = fnv1a64(b.domain) ^ (b.version*0x9E3779B185EBCA87ull);
+    return b;
+}
+
+inline BuildTag extract_build_from_meta(const std::string& meta)
+{
+    T3Meta::MetaView mv;
+    if(mv.parse(meta)) return extract_build_from_tlv(mv);
+
+    BuildTag b{};
+    std::string s;
+    uint64_t v=0;
+    if(meta_find_str(meta,"domain", s))      b.domain = s;
+    if(meta_find_str(meta,"build_hash", s))  b.build_hash = s;
+    if(meta_find_str(meta,"type_hash", s))   b.type_hash = type_hash_from_str(s);
     if(meta_find_uint(meta,"version", v))     b.version = v;
     if(meta_find_str (meta,"class", s))       b.pclass = prox_from_str(s);
     if(meta_find_uint(meta,"radius_m", v))    b.radius_m = (uint32_t)v;
@@ -613,6 +666,13 @@ inline Decision decide(const Policy& pol, const std::string& meta)
 }
 
 // ------------------ Adaptateurs approve() pour t3p/t3v
+// Variante std::string (sûre pour une méta TLV, qui contient des octets nuls) :
+// à utiliser dans un ApproveMetaFn. Les adaptateurs char* ne voient que du JSON.
+inline bool approve_with_policy(const Policy& pol, const std::string& meta)
+{
+    Decision d = decide(pol, meta);
+    return (d==Decision::INTERNAL || d==Decision::COEXIST_ACCEPTED);
+}
 inline bool t3p_approve_with_policy(const char* meta_json, void* user)
 {
     if(!user || !meta_json) return false;
@@ -9,6 +9,10 @@
 //      - poser "route_next", "route_via",
 //      - gérer "route_phase" : 0→1 (tour 1: PREP), 1→2 (tour 2: ACCEPT).
 //  • Fonctions utilitaires get/set pour phase et sandbox.
+//  • Méta TLV (t3_meta.hpp) : get/set directs sur les entrées du dictionnaire,
+//    l’objet "route" imbriqué n’est cherché que dans le résidu JSON ; une clé
+//    hors dictionnaire (ou une chaîne à échapper) est posée dans le résidu,
+//    comme le ferait le chemin JSON.
 // ============================================================================
 
 #pragma once
@@ -21,23 +25,49 @@
 namespace T3Route {
 
 // ------------------ Getters best-effort
+// Texte JSON où chercher l’objet "route" imbriqué (résidu pour une méta TLV)
+inline std::string nested_scope(const std::string& js){
+    T3Meta::MetaView mv; if(!mv.parse(js)) return js;
+    return std::string(mv.residual());
+}
 inline uint64_t get_uint_best_effort(const std::string& js, const char* flat_key, const char* nested_key){
     uint64_t v=0; if(T3Security::meta_find_uint(js,flat_key,v)) return v;
-    size_t pos; if(T3Security::meta_find_key(js,"route",pos)) if(T3Security::meta_find_uint(js.substr(pos),nested_key,v)) return v;
+    const std::string sc=nested_scope(js);
+    size_t pos; if(T3Security::meta_find_key(sc,"route",pos)) if(T3Security::meta_find_uint(sc.substr(pos),nested_key,v)) return v;
     return 0;
 }
 inline std::string get_str_best_effort(const std::string& js, const char* flat_key, const char* nested_key){
     std::string s; if(T3Security::meta_find_str(js,flat_key,s)) return s;
-    size_t pos; if(T3Security::meta_find_key(js,"route",pos)) if(T3Security::meta_find_str(js.substr(pos),nested_key,s)) return s;
+    const std::string sc=nested_scope(js);
+    size_t pos; if(T3Security::meta_find_key(sc,"route",pos)) if(T3Security::meta_find_str(sc.substr(pos),nested_key,s)) return s;
     return {};
 }
 inline uint8_t get_phase_best_effort(const std::string& js){
     uint64_t p = get_uint_best_effort(js, "route_phase", "phase");
-    if(p>2) p=2; return (uint8_t)p;
+    if(p>2) p=2;
+    return (uint8_t)p;
 }
 
 // ------------------ Set/Insert naïfs
+// Méta TLV : membre posé dans le résidu JSON (set_json sur "{...}") ; l’entrée
+// du dictionnaire de même nom est retirée (elle masquerait le résidu).
+template<class F>
+inline void set_in_residual(std::string& tlv, const std::string& key, F set_json){
+    T3Meta::MetaView mv;
+    if(!mv.parse(tlv)) return;
+    std::string rest = mv.residual().empty() ? std::string("{}") : std::string(mv.residual());
+    set_json(rest);
+    const int tag = T3Meta::key_tag(key);
+    if(tag>0) T3Meta::erase_entry(tlv, (uint8_t)tag);
+    T3Meta::set_residual(tlv, rest);
+}
+
 inline void set_or_insert_uint(std::string& js, const std::string& key, uint64_t val){
+    if(T3Meta::is_tlv(js)){
+        if(!T3Meta::set_uint(js,key,val))
+            set_in_residual(js, key, [&](std::string& r){ set_or_insert_uint(r,key,val); });
+        return;
+    }
     size_t p;
     if(T3Security::meta_find_key(js,key,p)){
         p = js.find(':', p); if(p!=std::string::npos){ ++p; while(p<js.size() && (js[p]==' '||js[p]=='\t')) ++p;
@@ -54,6 +84,11 @@ inline void set_or_insert_uint(std::string& js, const std::string& key, uint64_t
     }
 }
 inline void set_or_insert_str(std::string& js, const std::string& key, const std::string& val){
+    if(T3Meta::is_tlv(js)){
+        if(!T3Meta::set_str(js,key,val))
+            set_in_residual(js, key, [&](std::string& r){ set_or_insert_str(r,key,val); });
+        return;
+    }
     size_t p;
     if(T3Security::meta_find_key(js,key,p)){
         p = js.find(':', p); if(p!=std::string::npos){
@@ -70,6 +105,11 @@ inline void set_or_insert_str(std::string& js, const std::string& key, const std
     }
 }
 inline void set_or_insert_bool(std::string& js, const std::string& key, bool val){
+    if(T3Meta::is_tlv(js)){
+        if(!T3Meta::set_bool(js,key,val))
+            set_in_residual(js, key, [&](std::string& r){ set_or_insert_bool(r,key,val); });
+        return;
+    }
     size_t p;
     if(T3Security::meta_find_key(js,key,p)){
         p = js.find(':', p); if(p!=std::string::npos){
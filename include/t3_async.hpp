@@ -0,0 +1,1098 @@
+// ============================================================================
+//  File: include/t3_async.hpp — API asynchrone (coroutines C++20) (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Servir de nombreux flux depuis une boucle d’événements sans bloquer :
+//    lecture .t3v, écriture .t3p/.t3v, décodage et écriture vidéo deviennent
+//    des opérations `co_await`-ables.
+//      auto fr = co_await reader.frame(i);          // Result<vector<Word27>>
+//      auto px = co_await codec.decode_words(span, sub);
+//  • Trois exécuteurs derrière une seule boucle :
+//      - EventLoop : les coroutines reprennent TOUJOURS sur le thread qui
+//        appelle run()/poll() (code utilisateur mono-thread, pas de verrou) ;
+//      - E/S : lectures positionnées via io_uring (Linux, appels système
+//        directs, sans liburing) ou pool de threads (pread) en repli ;
+//        les API bloquantes par chemin (t3p_write, t3v_write…) passent par
+//        le pool E/S ;
+//      - calcul : ordonnanceur partagé T3Par (décodage, CRC, encodage
+//        vidéo), dans la voie RuntimeOptions::cpu_lane.
+//
+//  API
+//  ---
+//   Runtime rt(opts);                        // boucle + pool E/S + backend E/S
+//   spawn(rt.loop(), task);                  // tâche détachée (Task<void>)
+//   rt.loop().run();                         // jusqu’à la fin des tâches
+//   T sync_wait(rt.loop(), Task<T>)          // outils / tests
+//   co_await rt.blocking(fn) / rt.compute(fn) / rt.read_at(fd, buf, n, off)
+//
+//   AsyncT3VReader r(rt); co_await r.open(path);  co_await r.frame(i);
+//   co_await t3p_write(rt, path, sub, w, h, words, meta)   → Status
+//   co_await t3p_read(rt, path, approve)                   → Result<vector<Word27>>
+//   co_await t3v_write(rt, path, sub, w, h, frames, meta_g, metas) → Status
+//   AsyncCodec c(rt);  co_await c.decode(p, W, H, span<const int8_t>, meta)
+//                      co_await c.decode_words(span<const Word27>, sub)
+//                      co_await c.encode_words(span<const PixelYCbCrQuant>, sub)
+//   AsyncVideoWriter v(rt); co_await v.open(path, cfg); co_await v.add_frame_*(…);
+//
+//  NOTES
+//  -----
+//  • C++20 requis (-std=c++20) ; le reste du projet reste en C++17.
+//  • Intégration epoll/kqueue : loop().wake_fd() (eventfd Linux, -1 ailleurs)
+//    devient lisible quand une reprise est prête → appeler loop().poll().
+//  • AsyncT3VReader lit header + index une fois, puis chaque frame en deux
+//    lectures positionnées : méta → approve_meta (sur la boucle) → payload +
+//    CRC (vérifié côté calcul). Jamais de payload lu sans approbation.
+//  • Les spans passés à AsyncCodec sont lus sur place (pas de copie) : ils
+//    doivent rester valides jusqu’à la reprise.
+//  • Calcul : pas de pool propre, les travaux vont dans l’ordonnanceur de
+//    T3Par ; les boucles parallèles des décodeurs s’y imbriquent et
+//    héritent de la voie → pas de sur-souscription quand N flux décodent.
+//    threads_per_job (défaut 0 = tout le pool) borne chaque décodage.
+//    Un flux « live » : cpu_lane = T3Par::Lane::Live ; un ré-encodage de
+//    fond : Lane::Batch.
+//  • Exceptions d’une tâche détachée : conservées, relancées par run().
+//  • BUILD : g++ -std=c++20 -O2 -Iinclude … -pthread
+// ============================================================================
+
+#pragma once
+#if !defined(__cpp_impl_coroutine) || __cplusplus < 202002L
+#error "t3_async.hpp : C++20 requis (-std=c++20)"
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <deque>
+#include <span>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <functional>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define T3ASYNC_POSIX 1
+#endif
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#if __has_include(<linux/io_uring.h>)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#define T3ASYNC_URING 1
+#endif
+#endif
+
+#include "ternary_image_codec_v6_min.hpp"
+#include "io_t3p_t3v.hpp"
+#include "codec_profiles.hpp"
+#include "io_image.hpp"
+#include "video_writer_ffmpeg.hpp"
+#include "t3_crc32.hpp"
+#include "t3_parallel.hpp"
+
+namespace T3Async {
+
+// ------------------------------- Résultats ----------------------------------
+struct Status {
+    bool ok = false;
+    std::string err;
+    explicit operator bool() const { return ok; }
+};
+template<class T>
+struct Result : Status {
+    T value{};
+};
+
+// ------------------------------ Exécuteurs ----------------------------------
+// Pool FIFO ; le destructeur termine les travaux déjà soumis puis joint.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0)
+    {
+        if(threads==0) threads = T3Par::hw_threads();
+        for(unsigned i=0; i<threads; ++i) th_.emplace_back([this]{ worker(); });
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for(auto& t: th_) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            q_.push_back(std::move(fn));
+        }
+        cv_.notify_one();
+    }
+    unsigned size() const { return (unsigned)th_.size(); }
+
+private:
+    void worker()
+    {
+        for(;;){
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [&]{ return stop_ || !q_.empty(); });
+                if(q_.empty()) return;
+                fn = std::move(q_.front());
+                q_.pop_front();
+            }
+            fn();
+        }
+    }
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> q_;
+    std::vector<std::thread> th_;
+    bool stop_ = false;
+};
+
+// Travaux de calcul : tâches de l’ordonnanceur partagé T3Par, dans une voie
+// fixe. wait_idle() attend la fin des travaux soumis par cet exécuteur.
+class CpuExec {
+public:
+    explicit CpuExec(T3Par::Lane lane) : lane_(lane) {}
+    ~CpuExec() { wait_idle(); }
+    CpuExec(const CpuExec&) = delete;
+    CpuExec& operator=(const CpuExec&) = delete;
+
+    void submit(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            ++inflight_;
+        }
+        T3Par::submit([this, fn = std::move(fn)]{
+            fn();
+            std::lock_guard<std::mutex> lk(mu_);
+            if(--inflight_==0) idle_.notify_all();
+        }, lane_);
+    }
+    void wait_idle()
+    {
+        std::unique_lock<std::mutex> lk(mu_);
+        idle_.wait(lk, [&]{ return inflight_==0; });
+    }
+    T3Par::Lane lane() const { return lane_; }
+
+private:
+    T3Par::Lane lane_;
+    std::mutex mu_;
+    std::condition_variable idle_;
+    size_t inflight_ = 0;
+};
+
+// Travaux exécutés un par un, dans l’ordre de soumission, sur un exécuteur
+// (ThreadPool / CpuExec) : écrivain vidéo, frames ordonnées sans thread dédié.
+template<class Exec>
+class Strand {
+public:
+    explicit Strand(Exec& ex) : ex_(ex) {}
+    ~Strand() { wait_idle(); }
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    void submit(std::function<void()> fn)
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        q_.push_back(std::move(fn));
+        if(!running_){
+            running_ = true;
+            ex_.submit([this]{ drain(); });
+        }
+    }
+    void wait_idle()
+    {
+        std::unique_lock<std::mutex> lk(mu_);
+        idle_.wait(lk, [&]{ return !running_; });
+    }
+
+private:
+    void drain()
+    {
+        for(;;){
+            std::function<void()> fn;
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                if(q_.empty()){
+                    running_ = false;
+                    idle_.notify_all();
+                    return;
+                }
+                fn = std::move(q_.front());
+                q_.pop_front();
+            }
+            fn();
+        }
+    }
+    Exec& ex_;
+    std::mutex mu_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> q_;
+    bool running_ = false;
+};
+
+// ----------------------------- Boucle d’événements --------------------------
+class EventLoop {
+public:
+    EventLoop()
+    {
+#if defined(__linux__)
+        efd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+    }
+    ~EventLoop()
+    {
+#if defined(__linux__)
+        if(efd_>=0) ::close(efd_);
+#endif
+    }
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Thread-safe : appelé par les pools / le backend à la complétion
+    void post(std::function<void()> fn)
+    {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            was_empty = q_.empty();
+            q_.push_back(std::move(fn));
+        }
+        cv_.notify_one();
+#if defined(__linux__)
+        if(was_empty && efd_>=0){ uint64_t one = 1; (void)!::write(efd_, &one, sizeof(one)); }
+#else
+        (void)was_empty;
+#endif
+    }
+    void post(std::coroutine_handle<> h) { post([h]{ h.resume(); }); }
+
+    // co_await loop.schedule() : reprise sur la boucle
+    auto schedule()
+    {
+        struct A {
+            EventLoop* l;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { l->post(h); }
+            void await_resume() const noexcept {}
+        };
+        return A{this};
+    }
+
+    // Exécute ce qui est prêt, sans attendre ; retourne le nombre de reprises
+    size_t poll()
+    {
+#if defined(__linux__)
+        if(efd_>=0){ uint64_t v; (void)!::read(efd_, &v, sizeof(v)); }
+#endif
+        std::deque<std::function<void()>> batch;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            batch.swap(q_);
+        }
+        for(auto& fn: batch) fn();
+        rethrow_pending();
+        return batch.size();
+    }
+
+    // Bloque jusqu’à ce que toutes les tâches spawn() soient finies (ou stop())
+    void run()
+    {
+        for(;;){
+            std::deque<std::function<void()>> batch;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [&]{ return !q_.empty() || stop_ || outstanding_==0; });
+                if(q_.empty()){
+                    stop_ = false;
+                    break;
+                }
+                batch.swap(q_);
+            }
+#if defined(__linux__)
+            if(efd_>=0){ uint64_t v; (void)!::read(efd_, &v, sizeof(v)); }
+#endif
+            for(auto& fn: batch) fn();
+            rethrow_pending();
+        }
+    }
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    int wake_fd() const { return efd_; }
+    size_t outstanding() const { std::lock_guard<std::mutex> lk(mu_); return outstanding_; }
+
+    // Comptage des tâches détachées (spawn)
+    void work_started() { std::lock_guard<std::mutex> lk(mu_); ++outstanding_; }
+    void work_finished()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            --outstanding_;
+        }
+        cv_.notify_all();
+    }
+    void set_error(std::exception_ptr e) { if(!error_) error_ = e; }
+
+private:
+    void rethrow_pending()
+    {
+        if(error_){
+            auto e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> q_;
+    size_t outstanding_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;    // touché seulement depuis le thread de la boucle
+    int efd_ = -1;
+};
+
+// --------------------------------- Task<T> ----------------------------------
+// Paresseuse : démarre au co_await, reprend l’appelant par transfert symétrique.
+template<class T = void> class Task;
+
+namespace detail {
+struct PromiseBase {
+    std::coroutine_handle<> cont;
+    std::exception_ptr ex;
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    struct Final {
+        bool await_ready() noexcept { return false; }
+        template<class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            auto c = h.promise().cont;
+            return c ? c : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    Final final_suspend() noexcept { return {}; }
+    void unhandled_exception() { ex = std::current_exception(); }
+};
+template<class T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+    Task<T> get_return_object();
+    template<class U> void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    T take()
+    {
+        if(ex) std::rethrow_exception(ex);
+        return std::move(*value);
+    }
+};
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void take() { if(ex) std::rethrow_exception(ex); }
+};
+} // namespace detail
+
+template<class T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(handle h) : h_(h) {}
+    Task(Task&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Task& operator=(Task&& o) noexcept
+    {
+        if(this!=&o){
+            if(h_) h_.destroy();
+            h_ = std::exchange(o.h_, {});
+        }
+        return *this;
+    }
+    ~Task() { if(h_) h_.destroy(); }
+
+    bool await_ready() const noexcept { return !h_ || h_.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept
+    {
+        h_.promise().cont = c;
+        return h_;
+    }
+    T await_resume() { return h_.promise().take(); }
+
+private:
+    handle h_{};
+};
+
+namespace detail {
+template<class T>
+Task<T> Promise<T>::get_return_object() { return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)}; }
+inline Task<void> Promise<void>::get_return_object() { return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)}; }
+
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+inline Detached run_detached(EventLoop& loop, Task<void> t)
+{
+    co_await loop.schedule();
+    try { co_await t; }
+    catch(...) { loop.set_error(std::current_exception()); }
+    loop.work_finished();
+}
+} // namespace detail
+
+// Tâche détachée : démarre à la prochaine itération de la boucle
+inline void spawn(EventLoop& loop, Task<void> t)
+{
+    loop.work_started();
+    detail::run_detached(loop, std::move(t));
+}
+
+template<class T>
+T sync_wait(EventLoop& loop, Task<T> t)
+{
+    if constexpr(std::is_void_v<T>){
+        spawn(loop, std::move(t));
+        loop.run();
+    } else {
+        std::optional<T> out;
+        auto wrap = [](Task<T> in, std::optional<T>* o) -> Task<void> { o->emplace(co_await in); };
+        spawn(loop, wrap(std::move(t), &out));
+        loop.run();
+        return std::move(*out);
+    }
+}
+
+// ------------------------------- Délestage ----------------------------------
+// fn() s’exécute sur `ex` (ThreadPool / CpuExec / Strand), la coroutine reprend sur la boucle.
+template<class Exec, class F>
+class OffloadAwaiter {
+public:
+    using R = std::invoke_result_t<F&>;
+    OffloadAwaiter(Exec& ex, EventLoop& loop, F fn) : ex_(ex), loop_(loop), fn_(std::move(fn)) {}
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        ex_.submit([this, h]{
+            try {
+                if constexpr(std::is_void_v<R>) fn_();
+                else res_.emplace(fn_());
+            } catch(...) { err_ = std::current_exception(); }
+            loop_.post(h);
+        });
+    }
+    R await_resume()
+    {
+        if(err_) std::rethrow_exception(err_);
+        if constexpr(!std::is_void_v<R>) return std::move(*res_);
+    }
+
+private:
+    using Slot = std::conditional_t<std::is_void_v<R>, char, R>;
+    Exec& ex_;
+    EventLoop& loop_;
+    F fn_;
+    std::optional<Slot> res_;
+    std::exception_ptr err_;
+};
+template<class Exec, class F>
+OffloadAwaiter<Exec, F> offload(Exec& ex, EventLoop& loop, F fn) { return {ex, loop, std::move(fn)}; }
+
+// ------------------------------- Backend E/S --------------------------------
+// read_at : done(octets lus | -errno), appelé sur un thread du backend.
+using IoDone = std::function<void(long)>;
+
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+    virtual void read_at(int fd, void* buf, size_t len, uint64_t off, IoDone done) = 0;
+    virtual const char* name() const = 0;
+};
+
+// pread() bloquant sur le pool E/S
+class ThreadIo final : public IoBackend {
+public:
+    explicit ThreadIo(ThreadPool& pool) : pool_(pool) {}
+    void read_at(int fd, void* buf, size_t len, uint64_t off, IoDone done) override
+    {
+#if defined(T3ASYNC_POSIX)
+        pool_.submit([=, done = std::move(done)]{
+            size_t tot = 0;
+            while(tot<len){
+                const ssize_t n = ::pread(fd, (char*)buf + tot, len - tot, (off_t)(off + tot));
+                if(n<0){
+                    if(errno==EINTR) continue;
+                    done(-(long)errno);
+                    return;
+                }
+                if(n==0) break;
+                tot += (size_t)n;
+            }
+            done((long)tot);
+        });
+#else
+        (void)fd; (void)buf; (void)len; (void)off;
+        done(-38 /*ENOSYS*/);
+#endif
+    }
+    const char* name() const override { return "threads"; }
+
+private:
+    ThreadPool& pool_;
+};
+
+#if defined(T3ASYNC_URING)
+// io_uring par appels système directs : IORING_OP_READV, un thread de
+// moissonnage (io_uring_enter GETEVENTS) qui appelle les `done`.
+// Lecture courte : le reste est resoumis par le moissonneur (comme la boucle
+// pread de ThreadIo) ; done reçoit len, sauf fin de fichier ou erreur.
+class UringIo final : public IoBackend {
+public:
+    UringIo() = default;
+    ~UringIo() { shutdown(); }
+    UringIo(const UringIo&) = delete;
+    UringIo& operator=(const UringIo&) = delete;
+
+    bool init(unsigned entries = 256, std::string* err = nullptr)
+    {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        fd_ = (int)::syscall(__NR_io_uring_setup, entries, &p);
+        if(fd_<0){
+            if(err) *err = std::string("io_uring_setup: ") + std::strerror(errno);
+            return false;
+        }
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if(single) sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ptr_ = single ? sq_ptr_
+                         : ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sq = ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if(sq_ptr_==MAP_FAILED || cq_ptr_==MAP_FAILED || sq==MAP_FAILED){
+            if(err) *err = "io_uring: mmap failed";
+            if(sq!=MAP_FAILED) ::munmap(sq, sqes_len_);
+            if(!single && cq_ptr_!=MAP_FAILED) ::munmap(cq_ptr_, cq_len_);
+            if(sq_ptr_!=MAP_FAILED) ::munmap(sq_ptr_, sq_len_);
+            sq_ptr_ = cq_ptr_ = nullptr;
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        single_ = single;
+        sqes_ = (io_uring_sqe*)sq;
+        char* s = (char*)sq_ptr_;
+        char* c = (char*)cq_ptr_;
+        sq_head_ = (unsigned*)(s + p.sq_off.head);
+        sq_tail_ = (unsigned*)(s + p.sq_off.tail);
+        sq_mask_ = *(unsigned*)(s + p.sq_off.ring_mask);
+        sq_array_ = (unsigned*)(s + p.sq_off.array);
+        cq_head_ = (unsigned*)(c + p.cq_off.head);
+        cq_tail_ = (unsigned*)(c + p.cq_off.tail);
+        cq_mask_ = *(unsigned*)(c + p.cq_off.ring_mask);
+        cqes_ = (io_uring_cqe*)(c + p.cq_off.cqes);
+        max_inflight_ = p.cq_entries;
+        reaper_ = std::thread([this]{ reap(); });
+        return true;
+    }
+
+    void read_at(int fd, void* buf, size_t len, uint64_t off, IoDone done) override
+    {
+        Op* op = new Op;
+        op->iov.iov_base = buf;
+        op->iov.iov_len = len;
+        op->done = std::move(done);
+        op->fd = fd;
+        op->off = off;
+        int e = 0;
+        if(!push(IORING_OP_READV, fd, op, off, e)){
+            op->done(-(long)e);
+            delete op;
+        }
+    }
+    const char* name() const override { return "io_uring"; }
+
+private:
+    struct Op {
+        iovec iov{};       // reste à lire
+        IoDone done;
+        int fd = -1;
+        uint64_t off = 0;  // position du reste
+        size_t got = 0;    // octets déjà reçus (lectures courtes)
+    };
+    // user_data == 0 : NOP d’arrêt du moissonneur.
+    // false (errno dans err) si le noyau n’a pas consommé la SQE : elle est
+    // retirée de l’anneau, rien n’est en vol, l’appelant termine l’opération.
+    // reserved : place en vol déjà tenue (resoumission par le moissonneur,
+    // qui ne doit pas attendre une place qu’il est seul à libérer).
+    bool push(uint8_t opcode, int fd, Op* op, uint64_t off, int& err, bool reserved = false)
+    {
+        std::unique_lock<std::mutex> lk(mu_);
+        if(!reserved){
+            room_.wait(lk, [&]{ return inflight_ < max_inflight_; });
+            ++inflight_;
+        }
+        const unsigned tail = *sq_tail_;
+        const unsigned idx = tail & sq_mask_;
+        io_uring_sqe* s = &sqes_[idx];
+        std::memset(s, 0, sizeof(*s));
+        s->opcode = opcode;
+        s->fd = fd;
+        if(op){
+            s->addr = (uint64_t)(uintptr_t)&op->iov;
+            s->len = 1;
+        }
+        s->off = off;
+        s->user_data = (uint64_t)(uintptr_t)op;
+        sq_array_[idx] = idx;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        // Sans SQPOLL, le noyau consomme la SQE pendant l’appel : l’anneau
+        // de soumission ne se remplit jamais (inflight_ borne la CQ).
+        err = EAGAIN;
+        for(int tries=0; tries<1000; ++tries){
+            const long r = ::syscall(__NR_io_uring_enter, fd_, 1u, 0u, 0u, nullptr, (size_t)0);
+            if(r>0) return true;
+            if(r<0) err = errno;
+            if(r<0 && err!=EINTR && err!=EAGAIN && err!=EBUSY) break;
+            std::this_thread::yield();
+        }
+        if(__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) return true;  // consommée malgré tout
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+        --inflight_;
+        lk.unlock();
+        room_.notify_all();
+        return false;
+    }
+    void reap()
+    {
+        std::vector<std::pair<Op*, long>> done;
+        std::vector<Op*> again;
+        unsigned backoff_ms = 0;
+        for(bool stop=false; !stop;){
+            const long r = ::syscall(__NR_io_uring_enter, fd_, 0u, 1u, (unsigned)IORING_ENTER_GETEVENTS, nullptr, (size_t)0);
+            // Erreur persistante : recul progressif (1 → 100 ms) au lieu de
+            // tourner à vide ; sortie si l’arrêt est demandé
+            if(r<0 && errno!=EINTR){
+                if(stopping_.load(std::memory_order_acquire)) break;
+                backoff_ms = std::min(100u, backoff_ms ? backoff_ms*2 : 1u);
+                std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+            } else backoff_ms = 0;
+            unsigned head = *cq_head_;
+            const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for(; head!=tail; ++head){
+                const io_uring_cqe& e = cqes_[head & cq_mask_];
+                Op* op = (Op*)(uintptr_t)e.user_data;
+                if(!op){
+                    stop = true;
+                    continue;
+                }
+                const long res = (long)e.res;
+                if(res>0 && (size_t)res < op->iov.iov_len && !stopping_.load(std::memory_order_acquire)){
+                    // Lecture courte : reste resoumis, la place en vol est gardée
+                    op->got += (size_t)res;
+                    op->off += (uint64_t)res;
+                    op->iov.iov_base = (char*)op->iov.iov_base + res;
+                    op->iov.iov_len -= (size_t)res;
+                    again.push_back(op);
+                }
+                else done.emplace_back(op, res<0 ? res : (long)op->got + res);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            if(!done.empty() || stop){
+                {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    inflight_ -= done.size() + (stop ? 1 : 0);
+                }
+                room_.notify_all();
+            }
+            for(Op* op: again){
+                int e = 0;
+                if(!push(IORING_OP_READV, op->fd, op, op->off, e, true)){
+                    op->done(-(long)e);
+                    delete op;
+                }
+            }
+            again.clear();
+            for(auto& d: done){
+                d.first->done(d.second);
+                delete d.first;
+            }
+            done.clear();
+        }
+    }
+    void shutdown()
+    {
+        if(fd_<0) return;
+        if(reaper_.joinable()){
+            stopping_.store(true, std::memory_order_release);
+            int e = 0;
+            if(!push(IORING_OP_NOP, -1, nullptr, 0, e)){
+                // Anneau inutilisable : le moissonneur peut rester bloqué dans
+                // io_uring_enter → détaché, anneau et descripteur abandonnés
+                reaper_.detach();
+                fd_ = -1;
+                return;
+            }
+            reaper_.join();
+        }
+        ::munmap(sqes_, sqes_len_);
+        if(!single_) ::munmap(cq_ptr_, cq_len_);
+        ::munmap(sq_ptr_, sq_len_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_len_ = 0, cq_len_ = 0, sqes_len_ = 0;
+    bool single_ = false;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    std::mutex mu_;
+    std::condition_variable room_;
+    size_t inflight_ = 0, max_inflight_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread reaper_;
+};
+#endif
+
+// -------------------------------- Runtime -----------------------------------
+enum class IoKind { Auto, Threads, Uring };
+
+struct RuntimeOptions {
+    unsigned io_threads = 4;       // appels bloquants + backend Threads
+    T3Par::Lane cpu_lane = T3Par::Lane::Normal;   // voie des travaux de calcul
+    IoKind   io = IoKind::Auto;    // Auto : io_uring si disponible, sinon threads
+    unsigned uring_entries = 256;
+    unsigned threads_per_job = 0;  // `threads` passé aux décodeurs (0 → T3Par)
+};
+
+class Runtime {
+public:
+    explicit Runtime(const RuntimeOptions& o = RuntimeOptions())
+        : opt_(o), io_pool_(o.io_threads ? o.io_threads : 1), cpu_(o.cpu_lane)
+    {
+#if defined(T3ASYNC_URING)
+        if(o.io!=IoKind::Threads){
+            auto u = std::make_unique<UringIo>();
+            if(u->init(o.uring_entries)) io_ = std::move(u);
+        }
+#endif
+        if(!io_) io_ = std::make_unique<ThreadIo>(io_pool_);
+    }
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    EventLoop&  loop()     { return loop_; }
+    ThreadPool& io_pool()  { return io_pool_; }
+    CpuExec&    cpu()      { return cpu_; }
+    IoBackend&  io()       { return *io_; }
+    const RuntimeOptions& options() const { return opt_; }
+
+    template<class F> auto blocking(F fn) { return offload(io_pool_, loop_, std::move(fn)); }
+    template<class F> auto compute(F fn)  { return offload(cpu_, loop_, std::move(fn)); }
+
+    // co_await rt.read_at(fd, buf, n, off) → octets lus ou -errno
+    auto read_at(int fd, void* buf, size_t len, uint64_t off)
+    {
+        struct A {
+            Runtime* rt; int fd; void* buf; size_t len; uint64_t off; long res = 0;
+            bool await_ready() const noexcept { return len==0; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                rt->io_->read_at(fd, buf, len, off, [this, h](long r){ res = r; rt->loop_.post(h); });
+            }
+            long await_resume() const noexcept { return res; }
+        };
+        return A{this, fd, buf, len, off};
+    }
+
+private:
+    // Ordre de destruction : backend, exécuteurs (travaux terminés), puis boucle
+    RuntimeOptions opt_;
+    EventLoop loop_;
+    ThreadPool io_pool_;
+    CpuExec cpu_;
+    std::unique_ptr<IoBackend> io_;
+};
+
+// ------------------------------ Lecteur .t3v --------------------------------
+// Header + index lus une fois ; frame(i) = 2 lectures positionnées.
+// Non thread-safe : une coroutine à la fois pendant open().
+class AsyncT3VReader {
+public:
+    explicit AsyncT3VReader(Runtime& rt) : rt_(rt) {}
+    ~AsyncT3VReader() { close(); }
+    AsyncT3VReader(const AsyncT3VReader&) = delete;
+    AsyncT3VReader& operator=(const AsyncT3VReader&) = delete;
+
+    void set_approve(T3Container::ApproveMetaFn fn) { approve_ = std::move(fn); }
+
+    Task<Status> open(std::string path)
+    {
+        close();
+        Status st;
+        st.ok = co_await rt_.blocking([&]{
+            uint64_t fc = 0;
+            return T3Container::t3v_read_header(path, sub_, w_, h_, meta_, fc, index_, &st.err, &tb_);
+        });
+        if(!st.ok) co_return st;
+        path_ = path;
+#if defined(T3ASYNC_POSIX)
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd_<0){
+            st.ok = false;
+            st.err = std::string("t3v: ") + std::strerror(errno);
+        }
+#endif
+        co_return st;
+    }
+    void close()
+    {
+#if defined(T3ASYNC_POSIX)
+        if(fd_>=0) ::close(fd_);
+#endif
+        fd_ = -1;
+        index_.clear();
+    }
+
+    Task<Result<std::vector<Word27>>> frame(uint64_t i)
+    {
+        Result<std::vector<Word27>> r;
+        if(i>=index_.size()){
+            r.err = "t3v: frame idx OOB";
+            co_return r;
+        }
+        if(fd_<0){   // sans descripteur POSIX : lecture bloquante sur le pool E/S
+            r.ok = co_await rt_.blocking([&]{
+                return T3Container::t3v_read_frame(path_, i, approve_, r.value, &r.err);
+            });
+            co_return r;
+        }
+        const T3Container::T3VFrameIndex fi = index_[(size_t)i];
+        std::string meta(fi.meta_len, '\0');
+        if(fi.meta_len){
+            const long n = co_await rt_.read_at(fd_, meta.data(), fi.meta_len, fi.offset);
+            if(n!=(long)fi.meta_len){
+                r.err = "t3v: read frame meta failed";
+                co_return r;
+            }
+        }
+        // === APPROVE META-ONLY === (sur la boucle, avant toute lecture payload)
+        if(approve_ && !approve_(meta)){
+            r.err = "t3v: meta not approved — frame payload not read";
+            co_return r;
+        }
+        // payload + CRC en une lecture : un mot de plus reçoit le CRC (4 o)
+        static_assert(sizeof(Word27)==4, "Word27 = u32 LE");
+        const size_t bytes = sizeof(Word27) * (size_t)fi.words;
+        r.value.resize((size_t)fi.words + 1);
+        const long n = co_await rt_.read_at(fd_, r.value.data(), bytes + 4, fi.offset + fi.meta_len);
+        if(n!=(long)(bytes + 4)){
+            r.value.clear();
+            r.err = n<0 ? std::string("t3v: ") + std::strerror((int)-n) : "t3v: read frame payload failed";
+            co_return r;
+        }
+        const uint8_t* c = (const uint8_t*)(r.value.data() + fi.words);
+        const uint32_t pl_crc = (uint32_t)c[0] | ((uint32_t)c[1] << 8) | ((uint32_t)c[2] << 16) | ((uint32_t)c[3] << 24);
+        r.value.resize((size_t)fi.words);
+        // CRC côté calcul au-delà de 64 Ko (la boucle reste disponible)
+        uint32_t got = 0;
+        if(bytes < (64u << 10)) got = T3Crc32::crc32(r.value.data(), bytes);
+        else got = co_await rt_.compute([&]{ return T3Crc32::crc32(r.value.data(), bytes); });
+        if(got!=pl_crc){   // frame vide : CRC attendu 0
+            r.value.clear();
+            r.err = fi.words ? "t3v: frame payload crc mismatch" : "t3v: empty frame crc mismatch";
+            co_return r;
+        }
+        r.ok = true;
+        co_return r;
+    }
+
+    SubwordMode sub() const { return sub_; }
+    int width() const { return w_; }
+    int height() const { return h_; }
+    uint64_t frame_count() const { return index_.size(); }
+    const std::vector<T3Container::T3VFrameIndex>& index() const { return index_; }
+    const std::string& meta() const { return meta_; }
+    const T3Container::T3VTimeBase& timebase() const { return tb_; }
+
+private:
+    Runtime& rt_;
+    T3Container::ApproveMetaFn approve_;
+    std::string path_, meta_;
+    SubwordMode sub_ = SubwordMode::S27;
+    int w_ = 0, h_ = 0;
+    std::vector<T3Container::T3VFrameIndex> index_;
+    T3Container::T3VTimeBase tb_;
+    int fd_ = -1;
+};
+
+// ---------------------- Conteneurs (API par chemin) -------------------------
+inline Task<Status> t3p_write(Runtime& rt, std::string path, SubwordMode sub, int w, int h,
+                              std::vector<Word27> words, std::string meta_json)
+{
+    Status st;
+    st.ok = co_await rt.blocking([&]{
+        return T3Container::t3p_write(path, sub, w, h, words, meta_json, &st.err);
+    });
+    co_return st;
+}
+
+inline Task<Result<std::vector<Word27>>> t3p_read(Runtime& rt, std::string path,
+                                                  T3Container::ApproveMetaFn approve)
+{
+    Result<std::vector<Word27>> r;
+    r.ok = co_await rt.blocking([&]{
+        return T3Container::t3p_read_payload(path, approve, r.value, &r.err);
+    });
+    co_return r;
+}
+
+inline Task<Status> t3v_write(Runtime& rt, std::string path, SubwordMode sub, int w, int h,
+                              std::vector<std::vector<Word27>> frames,
+                              std::string meta_json_global,
+                              std::vector<std::string> metas_per_frame)
+{
+    Status st;
+    st.ok = co_await rt.blocking([&]{
+        return T3Container::t3v_write(path, sub, w, h, frames, meta_json_global, metas_per_frame, &st.err);
+    });
+    co_return st;
+}
+
+// -------------------------------- Codec -------------------------------------
+class AsyncCodec {
+public:
+    explicit AsyncCodec(Runtime& rt) : rt_(rt) {}
+
+    // Proto (balanced + méta) → plan Y W×H
+    Task<Result<ImageU8>> decode(ProtoProfile p, uint32_t W, uint32_t H,
+                                 std::span<const int8_t> balanced, std::string meta_json)
+    {
+        Result<ImageU8> r;
+        const unsigned th = rt_.options().threads_per_job;
+        r.ok = co_await rt_.compute([&]{
+            return decode_prototype_ternary(p, W, H, balanced.data(), balanced.size(), meta_json, r.value, th);
+        });
+        if(!r.ok) r.err = "decode_prototype_ternary failed";
+        co_return r;
+    }
+
+    // Mots RAW (sous-mot) → pixels quantifiés
+    Task<Result<std::vector<PixelYCbCrQuant>>> decode_words(std::span<const Word27> words, SubwordMode sub)
+    {
+        Result<std::vector<PixelYCbCrQuant>> r;
+        r.ok = co_await rt_.compute([&]{
+            return decode_raw_words_to_pixels_subword(words.data(), words.size(), sub, r.value);
+        });
+        if(!r.ok) r.err = "decode_raw_words_to_pixels_subword failed";
+        co_return r;
+    }
+
+    Task<Result<std::vector<Word27>>> encode_words(std::span<const PixelYCbCrQuant> px, SubwordMode sub)
+    {
+        Result<std::vector<Word27>> r;
+        r.ok = co_await rt_.compute([&]{
+            return encode_raw_pixels_to_words_subword(px.data(), px.size(), sub, r.value);
+        });
+        if(!r.ok) r.err = "encode_raw_pixels_to_words_subword failed";
+        co_return r;
+    }
+
+private:
+    Runtime& rt_;
+};
+
+// ---------------------------- Écrivain vidéo --------------------------------
+// FFVideoWriter derrière un Strand de calcul : frames encodées dans l’ordre
+// d’appel, sans thread dédié par flux.
+class AsyncVideoWriter {
+public:
+    explicit AsyncVideoWriter(Runtime& rt) : rt_(rt), strand_(rt.cpu()) {}
+    ~AsyncVideoWriter()
+    {
+        strand_.wait_idle();
+        w_.close();
+    }
+    AsyncVideoWriter(const AsyncVideoWriter&) = delete;
+    AsyncVideoWriter& operator=(const AsyncVideoWriter&) = delete;
+
+    Task<bool> open(std::string path, FFVideoConfig cfg)
+    {
+        co_return co_await offload(strand_, rt_.loop(), [&]{ return w_.open(path, cfg); });
+    }
+    Task<bool> add_frame_rgb(ImageU8 img)
+    {
+        co_return co_await offload(strand_, rt_.loop(), [&]{ return w_.add_frame_rgb(img); });
+    }
+    Task<bool> add_frame_words(std::vector<Word27> words, SubwordMode sub, int w, int h)
+    {
+        co_return co_await offload(strand_, rt_.loop(), [&]{ return w_.add_frame_words(words, sub, w, h); });
+    }
+    Task<bool> add_frame_words_centered_in_canvas(std::vector<Word27> words, SubwordMode inner_sub)
+    {
+        co_return co_await offload(strand_, rt_.loop(), [&]{ return w_.add_frame_words_centered_in_canvas(words, inner_sub); });
+    }
+    Task<FFVideoStats> close()
+    {
+        co_return co_await offload(strand_, rt_.loop(), [&]{
+            w_.close();
+            return w_.stats();
+        });
+    }
+
+private:
+    Runtime& rt_;
+    Strand<CpuExec> strand_;
+    FFVideoWriter w_;
+};
+
+} // namespace T3Async
@@ -0,0 +1,248 @@
+// ============================================================================
+//  File: include/t3_chunkstore.hpp — Découpage en tuiles + hash 128 bits + cache (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Briques du magasin de chunks adressé par contenu (.t3k / .t3r, voir
+//    io_t3p_t3v.hpp) : une frame Word27 est découpée en tuiles fixes, chaque
+//    tuile est identifiée par le hash 128 bits de ses octets.
+//  • Deux frames (ou deux fichiers) qui partagent une zone identique alignée
+//    sur la grille (bandeaux letterbox, incrustations, plans répétés) partagent
+//    les chunks correspondants : stockés et écrits une seule fois.
+//  • Cache LRU de chunks (budget en octets) pour la relecture.
+//
+//  DÉCOUPAGE
+//  ---------
+//   • Payload raster (words == w*h) : tuiles tile_w × tile_h (tuiles de bord
+//     tronquées), ordre ligne par ligne ; tile_w==0 → bandes pleine largeur
+//     de tile_h lignes (blocs de lignes).
+//   • Autre payload : blocs linéaires de tile_w*tile_h mots.
+//   • Contenu d’un chunk = mots de la tuile, ligne par ligne (Word27 LE).
+//
+//  API
+//  ---
+//   T3Chunk::Hash128, hash128(data, n)        (MurmurHash3 x64-128)
+//   T3Chunk::Layout{tile_w,tile_h}, Grid, grid_for(n_words, w, h, L)
+//   T3Chunk::chunk_words(G, c), gather(words, G, c, out), scatter(chunk, n, G, c, words)
+//   T3Chunk::ChunkCache(budget_bytes) : get / put / clear / hits / misses
+//
+//  NOTES
+//  -----
+//  • Header-only ; hash non cryptographique (collision accidentelle ~2^-64
+//    pour 2^32 chunks) — le lecteur revérifie le hash de chaque chunk lu.
+//  • ChunkCache n’est pas thread-safe (un cache par lecteur).
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+
+#include "ternary_image_codec_v6_min.hpp" // Word27
+
+namespace T3Chunk {
+
+struct Hash128 {
+    uint64_t lo = 0, hi = 0;
+};
+inline bool operator==(const Hash128& a, const Hash128& b){ return a.lo==b.lo && a.hi==b.hi; }
+inline bool operator!=(const Hash128& a, const Hash128& b){ return !(a==b); }
+
+struct Hash128Hasher {
+    size_t operator()(const Hash128& h) const { return (size_t)(h.lo ^ (h.hi * 0x9E3779B97F4A7C15ull)); }
+};
+
+// MurmurHash3 x64-128 (domaine public, A. Appleby) ; lecture LE octet par octet
+inline Hash128 hash128(const void* data, size_t n, uint64_t seed = 0)
+{
+    auto rotl = [](uint64_t x, int r){ return (x << r) | (x >> (64 - r)); };
+    auto fmix = [](uint64_t k){
+        k ^= k >> 33; k *= 0xFF51AFD7ED558CCDull;
+        k ^= k >> 33; k *= 0xC4CEB9FE1A85EC53ull;
+        k ^= k >> 33; return k;
+    };
+    auto ld = [](const uint8_t* p, size_t m){
+        uint64_t v=0;
+        for(size_t i=m; i-- > 0; ) v = (v<<8) | p[i];
+        return v;
+    };
+    const uint8_t* p = (const uint8_t*)data;
+    const uint64_t c1 = 0x87C37B91114253D5ull, c2 = 0x4CF5AD432745937Full;
+    uint64_t h1 = seed, h2 = seed;
+    const size_t nblocks = n / 16;
+    for(size_t i=0; i<nblocks; ++i)
+    {
+        uint64_t k1 = ld(p + 16*i, 8), k2 = ld(p + 16*i + 8, 8);
+        k1 *= c1; k1 = rotl(k1,31); k1 *= c2; h1 ^= k1;
+        h1 = rotl(h1,27); h1 += h2; h1 = h1*5 + 0x52DCE729;
+        k2 *= c2; k2 = rotl(k2,33); k2 *= c1; h2 ^= k2;
+        h2 = rotl(h2,31); h2 += h1; h2 = h2*5 + 0x38495AB5;
+    }
+    const uint8_t* tail = p + 16*nblocks;
+    const size_t rem = n & 15;
+    uint64_t k1 = ld(tail, std::min<size_t>(rem, 8));
+    uint64_t k2 = rem > 8 ? ld(tail + 8, rem - 8) : 0;
+    if(rem > 8){ k2 *= c2; k2 = rotl(k2,33); k2 *= c1; h2 ^= k2; }
+    if(rem > 0){ k1 *= c1; k1 = rotl(k1,31); k1 *= c2; h1 ^= k1; }
+
+    h1 ^= (uint64_t)n; h2 ^= (uint64_t)n;
+    h1 += h2; h2 += h1;
+    h1 = fmix(h1); h2 = fmix(h2);
+    h1 += h2; h2 += h1;
+    return Hash128{h1, h2};
+}
+
+// ------------------------------- Découpage ----------------------------------
+struct Layout {
+    uint16_t tile_w = 64;  // 0 → bandes pleine largeur
+    uint16_t tile_h = 16;
+};
+
+struct Grid {
+    bool   raster = false;
+    size_t n_words = 0;
+    int    w = 0, h = 0;
+    int    tw = 0, th = 0;        // taille de tuile effective (raster)
+    size_t tiles_x = 0, tiles_y = 0;
+    size_t block = 0;             // mots par bloc (linéaire)
+    size_t n_chunks = 0;
+};
+
+inline Grid grid_for(size_t n_words, int w, int h, const Layout& L)
+{
+    Grid G;
+    G.n_words = n_words; G.w = w; G.h = h;
+    if(n_words == 0) return G;
+    const int th = std::max<int>(1, L.tile_h);
+    if(w > 0 && h > 0 && n_words == (size_t)w * (size_t)h)
+    {
+        G.raster = true;
+        G.tw = L.tile_w ? std::min<int>(L.tile_w, w) : w;
+        G.th = std::min(th, h);
+        G.tiles_x = ((size_t)w + G.tw - 1) / (size_t)G.tw;
+        G.tiles_y = ((size_t)h + G.th - 1) / (size_t)G.th;
+        G.n_chunks = G.tiles_x * G.tiles_y;
+    }
+    else
+    {
+        G.block = (size_t)std::max<int>(1, L.tile_w ? L.tile_w : 64) * (size_t)th;
+        G.n_chunks = (n_words + G.block - 1) / G.block;
+    }
+    return G;
+}
+
+// Rectangle de la tuile c (raster) : x0,y0,cw,ch
+inline void tile_rect(const Grid& G, size_t c, int& x0, int& y0, int& cw, int& ch)
+{
+    x0 = (int)(c % G.tiles_x) * G.tw;
+    y0 = (int)(c / G.tiles_x) * G.th;
+    cw = std::min(G.tw, G.w - x0);
+    ch = std::min(G.th, G.h - y0);
+}
+
+inline size_t chunk_words(const Grid& G, size_t c)
+{
+    if(c >= G.n_chunks) return 0;
+    if(!G.raster) return std::min(G.block, G.n_words - c*G.block);
+    int x0, y0, cw, ch;
+    tile_rect(G, c, x0, y0, cw, ch);
+    return (size_t)cw * (size_t)ch;
+}
+
+// Mots de la tuile c → out (ligne par ligne)
+inline void gather(const Word27* words, const Grid& G, size_t c, std::vector<Word27>& out)
+{
+    out.resize(chunk_words(G, c));
+    if(out.empty()) return;
+    if(!G.raster)
+    {
+        std::memcpy(out.data(), words + c*G.block, out.size()*sizeof(Word27));
+        return;
+    }
+    int x0, y0, cw, ch;
+    tile_rect(G, c, x0, y0, cw, ch);
+    for(int y=0; y<ch; ++y)
+        std::memcpy(out.data() + (size_t)y*cw, words + (size_t)(y0+y)*G.w + x0, (size_t)cw*sizeof(Word27));
+}
+
+// Chunk c (n mots) → position dans la frame ; false si la taille ne correspond pas
+inline bool scatter(const Word27* chunk, size_t n, const Grid& G, size_t c, Word27* words)
+{
+    if(n != chunk_words(G, c)) return false;
+    if(n == 0) return true;
+    if(!G.raster)
+    {
+        std::memcpy(words + c*G.block, chunk, n*sizeof(Word27));
+        return true;
+    }
+    int x0, y0, cw, ch;
+    tile_rect(G, c, x0, y0, cw, ch);
+    for(int y=0; y<ch; ++y)
+        std::memcpy(words + (size_t)(y0+y)*G.w + x0, chunk + (size_t)y*cw, (size_t)cw*sizeof(Word27));
+    return true;
+}
+
+// ------------------------------- Cache LRU ----------------------------------
+// Pointeurs rendus par get()/put() valides jusqu’au prochain put()/clear().
+class ChunkCache {
+public:
+    explicit ChunkCache(size_t budget_bytes = (size_t)64 << 20) : budget_(budget_bytes) {}
+
+    void set_budget(size_t bytes){ budget_ = bytes; evict(); }
+    size_t budget() const { return budget_; }
+    size_t bytes() const { return bytes_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+    const std::vector<uint8_t>* get(const Hash128& h)
+    {
+        auto it = map_.find(h);
+        if(it == map_.end()){ ++misses_; return nullptr; }
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return &it->second->second;
+    }
+
+    const std::vector<uint8_t>* put(const Hash128& h, std::vector<uint8_t>&& data)
+    {
+        auto it = map_.find(h);
+        if(it != map_.end())
+        {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return &it->second->second;
+        }
+        bytes_ += data.size();
+        lru_.emplace_front(h, std::move(data));
+        map_.emplace(h, lru_.begin());
+        evict();
+        return &lru_.front().second;
+    }
+
+    void clear(){ lru_.clear(); map_.clear(); bytes_ = 0; }
+
+private:
+    using Item = std::pair<Hash128, std::vector<uint8_t>>;
+
+    // Garde toujours l’entrée la plus récente (même au-delà du budget)
+    void evict()
+    {
+        while(bytes_ > budget_ && lru_.size() > 1)
+        {
+            bytes_ -= lru_.back().second.size();
+            map_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+    }
+
+    std::list<Item> lru_;
+    std::unordered_map<Hash128, std::list<Item>::iterator, Hash128Hasher> map_;
+    size_t bytes_ = 0, budget_;
+    uint64_t hits_ = 0, misses_ = 0;
+};
+
+} // namespace T3Chunk
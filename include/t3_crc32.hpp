@@ -0,0 +1,107 @@
+// ============================================================================
+//  File: include/t3_crc32.hpp — CRC-32 (0xEDB88320) par tranches de 8 octets (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • CRC-32 des conteneurs (.t3p/.t3v/.t3pl/.t3a/.t3k/.t3s) : même valeur que
+//    zlib crc32(), calculée 8 octets par itération (slicing-by-8, 8 tables
+//    de 256 entrées) au lieu d’un octet.
+//  • crc32_combine : CRC de A‖B depuis CRC(A), CRC(B) et |B| → un gros
+//    payload peut être découpé en morceaux vérifiés en parallèle.
+//
+//  API
+//  ---
+//   uint32_t T3Crc32::crc32(data, n)
+//   uint32_t T3Crc32::update(crc, data, n)        (crc = résultat précédent, 0 au départ)
+//   uint32_t T3Crc32::combine(crc_a, crc_b, len_b)
+//
+//  NOTES
+//  -----
+//  • Header-only ; tables construites une fois (static local, thread-safe).
+//  • Lecture octet par octet composée en mots : indépendant de l’endianness.
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace T3Crc32 {
+
+struct Tables {
+    uint32_t t[8][256];
+    Tables()
+    {
+        for(uint32_t i=0; i<256; ++i)
+        {
+            uint32_t c = i;
+            for(int k=0; k<8; ++k) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            t[0][i] = c;
+        }
+        for(int s=1; s<8; ++s)
+            for(uint32_t i=0; i<256; ++i)
+                t[s][i] = (t[s-1][i] >> 8) ^ t[0][t[s-1][i] & 0xFFu];
+    }
+};
+
+inline const Tables& tables()
+{
+    static const Tables T;
+    return T;
+}
+
+inline uint32_t update(uint32_t crc, const void* data, size_t n)
+{
+    const auto& T = tables().t;
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t c = ~crc;
+    for(; n >= 8; p += 8, n -= 8)
+    {
+        const uint32_t a = c ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+        const uint32_t b =      (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+        c = T[7][a & 0xFF] ^ T[6][(a >> 8) & 0xFF] ^ T[5][(a >> 16) & 0xFF] ^ T[4][a >> 24]
+          ^ T[3][b & 0xFF] ^ T[2][(b >> 8) & 0xFF] ^ T[1][(b >> 16) & 0xFF] ^ T[0][b >> 24];
+    }
+    while(n--) c = T[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return ~c;
+}
+
+inline uint32_t crc32(const void* data, size_t n) { return update(0, data, n); }
+
+// ------------------------------- Combinaison --------------------------------
+// Opérateur « décalage de n bits nuls » en matrice 32×32 sur GF(2) (méthode zlib).
+namespace detail {
+inline uint32_t gf2_times(const uint32_t* mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+    for(; vec; vec >>= 1, ++mat) if(vec & 1) sum ^= *mat;
+    return sum;
+}
+inline void gf2_square(uint32_t* sq, const uint32_t* mat)
+{
+    for(int i=0; i<32; ++i) sq[i] = gf2_times(mat, mat[i]);
+}
+} // namespace detail
+
+inline uint32_t combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b)
+{
+    if(len_b == 0) return crc_a;
+    uint32_t even[32], odd[32];
+    odd[0] = 0xEDB88320u;                  // 1 bit nul
+    for(int i=1; i<32; ++i) odd[i] = 1u << (i - 1);
+    detail::gf2_square(even, odd);         // 2 bits
+    detail::gf2_square(odd, even);         // 4 bits
+    do
+    {
+        detail::gf2_square(even, odd);     // 1 octet, puis 4, 16 …
+        if(len_b & 1) crc_a = detail::gf2_times(even, crc_a);
+        len_b >>= 1;
+        if(!len_b) break;
+        detail::gf2_square(odd, even);
+        if(len_b & 1) crc_a = detail::gf2_times(odd, crc_a);
+        len_b >>= 1;
+    } while(len_b);
+    return crc_a ^ crc_b;
+}
+
+} // namespace T3Crc32
@@ -0,0 +1,470 @@
+// ============================================================================
+//  File: include/t3_meta.hpp — Méta binaire TLV (dictionnaire fixe) + repli JSON (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Encodage compact des méta de conteneurs (.t3p/.t3v/.t3proto …) : les
+//    clés courantes (domain, build_hash, type_hash, route_*, n_trits, fps …)
+//    ont un identifiant 1 octet et une valeur typée ; le reste de l’objet
+//    JSON est conservé tel quel dans une entrée "résidu".
+//  • Lecture par vue (MetaView) : un seul passage sur les octets, aucune
+//    allocation, aucune analyse de texte pour les clés du dictionnaire
+//    → chemin d’approbation (T3Security) sans parsing JSON.
+//  • Même champ meta dans les conteneurs : le format est reconnu à son
+//    préfixe, un meta JSON reste accepté partout (repli).
+//
+//  FORMAT
+//  ------
+//   magic[4] = 0xB3 'T' '3' 'M', u8 ver=1
+//   entrées : { u8 tag, varint len, value[len] }    (varint = LEB128)
+//     tag 1..kKeys-1 : clé du dictionnaire (kDict[tag]) ; valeur selon type :
+//        U = varint, S = octets bruts (chaîne JSON sans échappement),
+//        B = 1 octet (0/1), N = texte d’un nombre JSON (ex. fps 29.97)
+//     tag 0x7F : résidu JSON "{...}" (membres hors dictionnaire ou de type
+//                inattendu, objets imbriqués)
+//     tag 0x7E : bourrage (ignoré ; alignement du payload par les écrivains)
+//   Les identifiants du dictionnaire sont figés (ajout en fin seulement).
+//
+//  API
+//  ---
+//   T3Meta::is_tlv(meta)
+//   T3Meta::MetaView v; v.parse(meta) ; v.get_uint(key,..) / v.get_str(key,..)
+//   T3Meta::encode_json(json, out_tlv)     (false si JSON non reconnu)
+//   T3Meta::to_json(meta)                  (TLV → JSON, JSON inchangé)
+//   T3Meta::find_uint / find_str(meta, "clé", out)   (TLV ou JSON)
+//   T3Meta::set_uint / set_str / set_bool(tlv, "clé", v)   (false : hors
+//        dictionnaire, type différent ou chaîne à échapper → résidu à l’appelant)
+//   T3Meta::set_residual(tlv, "{...}") / erase_entry(tlv, tag)
+//
+//  NOTES
+//  -----
+//  • Header-only. Les chaînes JSON avec échappements (\") vont au résidu.
+//  • Le magic commence par 0xB3 (jamais en tête d’un JSON) ; une méta TLV
+//    contient des octets nuls : utiliser les API std::string, pas char*.
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <string_view>
+
+namespace T3Meta {
+
+enum class Type : uint8_t { U, S, B, N };
+
+struct KeyDef {
+    const char* name;
+    Type type;
+};
+
+// Index = tag. Ne jamais renuméroter (ajouts en fin).
+constexpr KeyDef kDict[] = {
+    { "",               Type::S }, // 0 : réservé
+    { "domain",         Type::S },
+    { "build_hash",     Type::S },
+    { "type_hash",      Type::S },
+    { "version",        Type::U },
+    { "class",          Type::S },
+    { "radius_m",       Type::U },
+    { "route_ttl",      Type::U },
+    { "route_hops",     Type::U },
+    { "route_phase",    Type::U },
+    { "origin",         Type::S },
+    { "route_via",      Type::S },
+    { "route_next",     Type::S },
+    { "route_accepted", Type::B },
+    { "route_sandbox",  Type::B },
+    { "route_reason",   Type::S },
+    { "n_trits",        Type::U },
+    { "fps",            Type::N },
+    { "proto",          Type::S },
+    { "gen",            Type::S },
+    { "seq",            Type::S },
+    { "frame",          Type::U },
+    { "pts",            Type::U },
+};
+constexpr int kKeys = (int)(sizeof(kDict) / sizeof(kDict[0]));
+
+// Tags nommés (chemin rapide : pas de comparaison de chaînes)
+enum Tag : uint8_t {
+    kDomain = 1, kBuildHash, kTypeHash, kVersion, kClass, kRadiusM,
+    kRouteTtl, kRouteHops, kRoutePhase, kOrigin, kRouteVia, kRouteNext,
+    kRouteAccepted, kRouteSandbox, kRouteReason, kNTrits, kFps,
+    kProto, kGen, kSeq, kFrame, kPts
+};
+static_assert(kPts + 1 == kKeys, "T3Meta: Tag / kDict désalignés");
+constexpr uint8_t kTagResidual = 0x7F;
+constexpr uint8_t kTagPad = 0x7E;
+constexpr uint8_t kMagic[4] = { 0xB3, 'T', '3', 'M' };
+constexpr size_t kHeadBytes = 5;
+
+inline int key_tag(std::string_view name)
+{
+    for(int t=1; t<kKeys; ++t)
+        if(name == kDict[t].name) return t;
+    return -1;
+}
+
+inline bool is_tlv(const void* p, size_t n)
+{
+    return n >= kHeadBytes && std::memcmp(p, kMagic, 4) == 0 && ((const uint8_t*)p)[4] == 1;
+}
+inline bool is_tlv(const std::string& meta) { return is_tlv(meta.data(), meta.size()); }
+
+// ------------------------------- varint -------------------------------------
+inline void put_varint(std::string& o, uint64_t v)
+{
+    while(v >= 0x80){ o.push_back((char)(uint8_t)(v | 0x80)); v >>= 7; }
+    o.push_back((char)(uint8_t)v);
+}
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+    v = 0;
+    for(int s=0; s<64 && p<end; s+=7)
+    {
+        const uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << s;
+        if(!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// ------------------------------- Vue ----------------------------------------
+// Positions des valeurs dans le blob (valide tant que le blob vit).
+class MetaView {
+public:
+    bool parse(const void* data, size_t n)
+    {
+        *this = MetaView{};
+        if(!is_tlv(data, n)) return false;
+        const uint8_t* p = (const uint8_t*)data + kHeadBytes;
+        const uint8_t* end = (const uint8_t*)data + n;
+        while(p < end)
+        {
+            const uint8_t tag = *p++;
+            uint64_t len = 0;
+            if(!get_varint(p, end, len) || len > (uint64_t)(end - p)) return false;
+            if(tag > 0 && tag < kKeys){ val_[tag] = p; len_[tag] = (uint32_t)len; }
+            else if(tag == kTagResidual){ rest_ = std::string_view((const char*)p, (size_t)len); }
+            p += len; // tags inconnus (versions futures) ignorés
+        }
+        ok_ = true;
+        return true;
+    }
+    bool parse(const std::string& meta) { return parse(meta.data(), meta.size()); }
+
+    bool ok() const { return ok_; }
+    bool has(int tag) const { return tag > 0 && tag < kKeys && val_[tag]; }
+
+    bool get_uint(int tag, uint64_t& out) const
+    {
+        if(!has(tag)) return false;
+        if(kDict[tag].type == Type::B){ out = len_[tag] && val_[tag][0]; return true; }
+        if(kDict[tag].type != Type::U) return false;
+        const uint8_t* p = val_[tag];
+        return get_varint(p, p + len_[tag], out);
+    }
+    bool get_str(int tag, std::string_view& out) const
+    {
+        if(!has(tag) || kDict[tag].type == Type::U || kDict[tag].type == Type::B) return false;
+        out = std::string_view((const char*)val_[tag], len_[tag]);
+        return true;
+    }
+    bool get_uint(const char* key, uint64_t& out) const { return get_uint(key_tag(key), out); }
+    bool get_str(const char* key, std::string_view& out) const { return get_str(key_tag(key), out); }
+
+    // Texte JSON d’une valeur du dictionnaire (pour to_json)
+    std::string value_json(int tag) const
+    {
+        if(!has(tag)) return {};
+        switch(kDict[tag].type)
+        {
+        case Type::U: { uint64_t v = 0; get_uint(tag, v); return std::to_string(v); }
+        case Type::B: return (len_[tag] && val_[tag][0]) ? "true" : "false";
+        case Type::N: return std::string((const char*)val_[tag], len_[tag]);
+        default:      return "\"" + std::string((const char*)val_[tag], len_[tag]) + "\"";
+        }
+    }
+
+    std::string_view residual() const { return rest_; }
+
+private:
+    const uint8_t* val_[kKeys] = {};
+    uint32_t len_[kKeys] = {};
+    std::string_view rest_;
+    bool ok_ = false;
+};
+
+// ------------------------------- Encodage -----------------------------------
+namespace detail {
+
+inline void skip_ws(std::string_view s, size_t& i)
+{
+    while(i < s.size() && std::isspace((unsigned char)s[i])) ++i;
+}
+
+// Fin d’une valeur JSON (chaîne, nombre, littéral, objet, tableau) ; npos si invalide
+inline size_t value_end(std::string_view s, size_t i)
+{
+    if(i >= s.size()) return std::string_view::npos;
+    if(s[i] == '"')
+    {
+        for(++i; i < s.size(); ++i)
+        {
+            if(s[i] == '\\') ++i;
+            else if(s[i] == '"') return i + 1;
+        }
+        return std::string_view::npos;
+    }
+    if(s[i] == '{' || s[i] == '[')
+    {
+        int depth = 0;
+        for(; i < s.size(); ++i)
+        {
+            const char c = s[i];
+            if(c == '"'){ const size_t e = value_end(s, i); if(e == std::string_view::npos) return e; i = e - 1; }
+            else if(c == '{' || c == '[') ++depth;
+            else if((c == '}' || c == ']') && --depth == 0) return i + 1;
+        }
+        return std::string_view::npos;
+    }
+    const size_t b = i;
+    while(i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ']' && !std::isspace((unsigned char)s[i])) ++i;
+    return i > b ? i : std::string_view::npos;
+}
+
+inline bool is_uint_text(std::string_view v)
+{
+    if(v.empty() || v.size() > 19) return false;
+    for(char c : v) if(!std::isdigit((unsigned char)c)) return false;
+    return true;
+}
+inline bool is_number_text(std::string_view v)
+{
+    if(v.empty()) return false;
+    for(char c : v) if(!(std::isdigit((unsigned char)c) || c=='-' || c=='+' || c=='.' || c=='e' || c=='E')) return false;
+    return true;
+}
+
+inline void put_entry(std::string& o, uint8_t tag, std::string_view bytes)
+{
+    o.push_back((char)tag);
+    put_varint(o, bytes.size());
+    o.append(bytes.data(), bytes.size());
+}
+
+// Valeur JSON texte → octets TLV du type attendu ; false si type inattendu
+inline bool encode_value(Type t, std::string_view v, std::string& out)
+{
+    out.clear();
+    switch(t)
+    {
+    case Type::U:
+        if(!is_uint_text(v)) return false;
+        put_varint(out, std::stoull(std::string(v)));
+        return true;
+    case Type::B:
+        if(v == "true"){ out.push_back(1); return true; }
+        if(v == "false"){ out.push_back(0); return true; }
+        return false;
+    case Type::N:
+        if(!is_number_text(v)) return false;
+        out.assign(v.data(), v.size());
+        return true;
+    default:
+        if(v.size() < 2 || v.front() != '"' || v.back() != '"') return false;
+        v = v.substr(1, v.size() - 2);
+        if(v.find('\\') != std::string_view::npos) return false;
+        out.assign(v.data(), v.size());
+        return true;
+    }
+}
+
+} // namespace detail
+
+// Objet JSON → TLV (dictionnaire + résidu) ; false si `json` n’est pas un objet
+inline bool encode_json(const std::string& json, std::string& out)
+{
+    using namespace detail;
+    const std::string_view s(json);
+    size_t i = 0;
+    skip_ws(s, i);
+    if(i >= s.size() || s[i] != '{') return false;
+    ++i;
+
+    std::string dict, rest, bytes;
+    std::string_view vals[kKeys];
+    for(;;)
+    {
+        skip_ws(s, i);
+        if(i < s.size() && s[i] == '}') break;
+        const size_t ke = value_end(s, i);
+        if(ke == std::string_view::npos || s[i] != '"') return false;
+        const std::string_view key_json = s.substr(i, ke - i);
+        i = ke;
+        skip_ws(s, i);
+        if(i >= s.size() || s[i] != ':') return false;
+        ++i;
+        skip_ws(s, i);
+        const size_t ve = value_end(s, i);
+        if(ve == std::string_view::npos) return false;
+        const std::string_view val = s.substr(i, ve - i);
+        i = ve;
+
+        const int tag = key_tag(key_json.substr(1, key_json.size() - 2));
+        if(tag > 0 && !vals[tag].data() && encode_value(kDict[tag].type, val, bytes))
+            vals[tag] = val;
+        else
+        {
+            rest += rest.empty() ? "{" : ",";
+            rest.append(key_json.data(), key_json.size());
+            rest += ":";
+            rest.append(val.data(), val.size());
+        }
+        skip_ws(s, i);
+        if(i < s.size() && s[i] == ','){ ++i; continue; }
+        if(i < s.size() && s[i] == '}') break;
+        return false;
+    }
+
+    out.assign((const char*)kMagic, 4);
+    out.push_back(1);
+    for(int t=1; t<kKeys; ++t)
+    {
+        if(!vals[t].data()) continue;
+        encode_value(kDict[t].type, vals[t], bytes);
+        put_entry(out, (uint8_t)t, bytes);
+    }
+    if(!rest.empty()){ rest += "}"; put_entry(out, kTagResidual, rest); }
+    return true;
+}
+
+// TLV → JSON (clés du dictionnaire puis résidu) ; un meta JSON est rendu tel quel
+inline std::string to_json(const std::string& meta)
+{
+    MetaView v;
+    if(!v.parse(meta)) return meta;
+    std::string o = "{";
+    bool first = true;
+    for(int t=1; t<kKeys; ++t)
+    {
+        if(!v.has(t)) continue;
+        o += first ? "\"" : ",\"";
+        o += kDict[t].name;
+        o += "\":";
+        o += v.value_json(t);
+        first = false;
+    }
+    std::string_view r = v.residual();
+    if(r.size() > 2)
+    {
+        if(!first) o += ",";
+        o.append(r.data() + 1, r.size() - 2);
+    }
+    return o + "}";
+}
+
+// ------------------------------- Accès unifié -------------------------------
+// Recherche naïve historique dans un texte JSON (première occurrence de "clé")
+namespace detail {
+inline bool json_find_uint(std::string_view js, const std::string& key, uint64_t& out)
+{
+    size_t p = js.find("\"" + key + "\"");
+    if(p == std::string_view::npos || (p = js.find(':', p)) == std::string_view::npos) return false;
+    ++p;
+    while(p < js.size() && (js[p]==' ' || js[p]=='\t')) ++p;
+    uint64_t v = 0;
+    bool any = false;
+    while(p < js.size() && std::isdigit((unsigned char)js[p])){ any = true; v = v*10 + (uint64_t)(js[p]-'0'); ++p; }
+    if(any) out = v;
+    return any;
+}
+inline bool json_find_str(std::string_view js, const std::string& key, std::string& out)
+{
+    size_t p = js.find("\"" + key + "\"");
+    if(p == std::string_view::npos || (p = js.find(':', p)) == std::string_view::npos) return false;
+    if((p = js.find('"', p)) == std::string_view::npos) return false;
+    const size_t e = js.find('"', ++p);
+    if(e == std::string_view::npos) return false;
+    out.assign(js.data() + p, e - p);
+    return true;
+}
+} // namespace detail
+
+// TLV : dictionnaire puis résidu ; JSON : recherche texte
+inline bool find_uint(const std::string& meta, const std::string& key, uint64_t& out)
+{
+    MetaView v;
+    if(!v.parse(meta)) return detail::json_find_uint(meta, key, out);
+    const int tag = key_tag(key);
+    if(tag > 0 && v.get_uint(tag, out)) return true;
+    return detail::json_find_uint(v.residual(), key, out);
+}
+inline bool find_str(const std::string& meta, const std::string& key, std::string& out)
+{
+    MetaView v;
+    if(!v.parse(meta)) return detail::json_find_str(meta, key, out);
+    const int tag = key_tag(key);
+    std::string_view sv;
+    if(tag > 0 && v.get_str(tag, sv)){ out.assign(sv.data(), sv.size()); return true; }
+    return detail::json_find_str(v.residual(), key, out);
+}
+
+// ------------------------------- Mise à jour --------------------------------
+// Retire l’entrée `tag` (absente : blob inchangé) ; false si blob invalide
+inline bool erase_entry(std::string& tlv, uint8_t tag)
+{
+    if(!is_tlv(tlv)) return false;
+    std::string out(tlv.data(), kHeadBytes);
+    const uint8_t* p = (const uint8_t*)tlv.data() + kHeadBytes;
+    const uint8_t* end = (const uint8_t*)tlv.data() + tlv.size();
+    while(p < end)
+    {
+        const uint8_t* e0 = p;
+        const uint8_t t = *p++;
+        uint64_t len = 0;
+        if(!get_varint(p, end, len) || len > (uint64_t)(end - p)) return false;
+        p += len;
+        if(t != tag) out.append((const char*)e0, (size_t)(p - e0));
+    }
+    tlv.swap(out);
+    return true;
+}
+// Remplace/ajoute une entrée (tag) dans un blob TLV ; les autres sont recopiées.
+inline bool set_entry(std::string& tlv, uint8_t tag, std::string_view bytes)
+{
+    if(!erase_entry(tlv, tag)) return false;
+    detail::put_entry(tlv, tag, bytes);
+    return true;
+}
+inline bool set_uint(std::string& tlv, const std::string& key, uint64_t v)
+{
+    const int tag = key_tag(key);
+    if(tag <= 0 || kDict[tag].type != Type::U) return false;
+    std::string b;
+    put_varint(b, v);
+    return set_entry(tlv, (uint8_t)tag, b);
+}
+inline bool set_str(std::string& tlv, const std::string& key, const std::string& v)
+{
+    const int tag = key_tag(key);
+    if(tag <= 0 || kDict[tag].type != Type::S) return false;
+    if(v.find_first_of("\"\\") != std::string::npos) return false; // comme encode_json
+    return set_entry(tlv, (uint8_t)tag, v);
+}
+inline bool set_bool(std::string& tlv, const std::string& key, bool v)
+{
+    const int tag = key_tag(key);
+    if(tag <= 0 || kDict[tag].type != Type::B) return false;
+    return set_entry(tlv, (uint8_t)tag, std::string(1, v ? '\1' : '\0'));
+}
+inline bool set_residual(std::string& tlv, const std::string& json_object)
+{
+    return set_entry(tlv, kTagResidual, json_object);
+}
+
+} // namespace T3Meta
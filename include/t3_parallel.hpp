@@ -0,0 +1,444 @@
+// ============================================================================
+//  File: include/t3_parallel.hpp — Ordonnanceur partagé (vol de travail) (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Un seul point d’entrée pour les boucles parallèles des étages du codec
+//    (tuiles Haar, blocs AnisoRC, plans de trits, PNG, vérification CRC…) :
+//    T3Par::parallel_for(n, body).
+//  • Un seul pool de travailleurs pour tout le processus (hw_threads()-1,
+//    au moins 1, + le thread appelant) : les étages ne créent plus de threads,
+//    le parallélisme imbriqué (frames × tuiles) réutilise les mêmes cœurs
+//    au lieu de les sur-souscrire.
+//  • Vol de travail : une file par travailleur (LIFO local, vol FIFO chez
+//    les autres) + une file d’injection pour les threads externes.
+//  • Voies de priorité : Live (capture) > Normal > Batch (ré-encodage).
+//    Un travailleur prend toujours la voie la plus prioritaire disponible et
+//    exécute les tâches plus prioritaires entre deux tranches → une capture
+//    préempte un ré-encodage à la granularité d’une tranche.
+//  • Annulation coopérative (CancelToken) : les tranches non commencées
+//    sont sautées, parallel_for retourne false.
+//  • Exception levée par body : la première est gardée, les tranches non
+//    commencées sont abandonnées, puis elle est relancée chez l’appelant
+//    une fois toutes les tranches en cours terminées.
+//  • Statistiques par voie : profondeur de file, attente en file
+//    (soumission → début), durée des parallel_for, tranches annulées.
+//
+//  API
+//  ---
+//   unsigned T3Par::hw_threads();
+//   unsigned T3Par::concurrency();                 // travailleurs + appelant
+//   void     T3Par::configure(threads);            // avant la 1re utilisation
+//   bool     T3Par::parallel_for(n, body(begin,end), threads=0, grain=0);
+//     threads==0 → concurrency() ; sinon borne de concurrence de la boucle ;
+//     grain==0 → choisi automatiquement ; false si annulé ;
+//     relance la première exception de body.
+//   void     T3Par::submit(fn, lane)               // tâche isolée
+//   T3Par::Scope s(Lane::Live, &token);            // voie + jeton du thread
+//   LaneStats T3Par::lane_stats(lane) ; void T3Par::reset_stats();
+//
+//  NOTES
+//  -----
+//  • Header-only, dépend uniquement de la STL (<thread>, <atomic>, <mutex>).
+//  • body(begin,end) doit être thread-safe sur des intervalles disjoints.
+//  • Voie et jeton se propagent : une boucle lancée depuis une tranche (ou
+//    une tâche submit) hérite de la voie et du jeton de sa boucle parente.
+//  • En attente de ses tranches volées, l’appelant exécute d’autres tâches
+//    de même priorité ou plus (jamais Batch depuis Live).
+// ============================================================================
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace T3Par {
+
+inline unsigned hw_threads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1u;
+}
+
+enum class Lane : uint8_t { Live = 0, Normal = 1, Batch = 2 };
+constexpr int kLanes = 3;
+
+// Jeton partagé : cancel() depuis n’importe quel thread
+class CancelToken {
+public:
+    CancelToken() : f_(std::make_shared<std::atomic<bool>>(false)) {}
+    void cancel() { f_->store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return f_->load(std::memory_order_relaxed); }
+    const std::shared_ptr<std::atomic<bool>>& flag() const { return f_; }
+private:
+    std::shared_ptr<std::atomic<bool>> f_;
+};
+
+struct LaneStats {
+    uint64_t submitted = 0;         // tâches (aides de parallel_for + submit)
+    uint64_t executed = 0;
+    uint64_t queued = 0;            // profondeur de file actuelle
+    uint64_t jobs = 0;              // parallel_for terminés
+    uint64_t chunks_cancelled = 0;
+    double   wait_avg_us = 0, wait_max_us = 0;   // soumission → début
+    double   job_avg_us = 0, job_max_us = 0;     // durée des parallel_for
+};
+
+namespace detail {
+
+inline uint64_t now_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline void atomic_max(std::atomic<uint64_t>& a, uint64_t v)
+{
+    uint64_t cur = a.load(std::memory_order_relaxed);
+    while(v>cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+// Contexte du thread courant : voie + jeton hérités par les boucles imbriquées
+struct Ctx {
+    Lane lane = Lane::Normal;
+    std::shared_ptr<std::atomic<bool>> cancel;
+};
+inline Ctx& ctx()
+{
+    thread_local Ctx c;
+    return c;
+}
+inline int& worker_id()
+{
+    thread_local int id = -1;
+    return id;
+}
+inline std::atomic<unsigned>& configured_threads()
+{
+    static std::atomic<unsigned> n{0};
+    return n;
+}
+
+struct Task {
+    std::function<void()> fn;
+    uint64_t t_enq = 0;
+    Ctx ctx;
+};
+
+class Scheduler {
+public:
+    static Scheduler& get()
+    {
+        static Scheduler s(configured_threads().load() ? configured_threads().load() : hw_threads());
+        return s;
+    }
+    // Au moins un travailleur, pour que submit() progresse même sur 1 cœur
+    explicit Scheduler(unsigned threads)
+        : conc_(threads ? threads : 1), qs_(threads>1 ? threads-1 : 1)
+    {
+        for(size_t i=0; i<qs_.size(); ++i) workers_.emplace_back([this, i]{ worker((int)i); });
+    }
+    ~Scheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lk(sleep_mu_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for(auto& t: workers_) t.join();
+    }
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    unsigned concurrency() const { return conc_; }
+
+    void push(Lane l, std::function<void()> fn, const Ctx& c)
+    {
+        const int li = (int)l;
+        Task t{std::move(fn), now_ns(), c};
+        const int w = worker_id();
+        Queue& q = (w>=0) ? qs_[(size_t)w] : inj_;
+        pending_[li].fetch_add(1, std::memory_order_release);   // avant la file : jamais < 0
+        {
+            std::lock_guard<std::mutex> lk(q.mu);
+            q.q[li].push_back(std::move(t));
+        }
+        st_[li].submitted.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lk(sleep_mu_);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    // Exécute une tâche de voie <= max_lane (priorité >=) ; false si aucune
+    bool run_one(int max_lane)
+    {
+        Task t;
+        int li = 0;
+        if(!pop(max_lane, t, li)) return false;
+        const uint64_t wait = now_ns() - t.t_enq;
+        st_[li].executed.fetch_add(1, std::memory_order_relaxed);
+        st_[li].wait_sum_ns.fetch_add(wait, std::memory_order_relaxed);
+        atomic_max(st_[li].wait_max_ns, wait);
+        Ctx saved = ctx();
+        ctx() = t.ctx;
+        t.fn();
+        ctx() = saved;
+        return true;
+    }
+
+    bool higher_pending(Lane l) const
+    {
+        for(int li=0; li<(int)l; ++li) if(pending_[li].load(std::memory_order_acquire)) return true;
+        return false;
+    }
+
+    void note_job(Lane l, uint64_t ns, uint64_t cancelled)
+    {
+        auto& s = st_[(int)l];
+        s.jobs.fetch_add(1, std::memory_order_relaxed);
+        s.job_sum_ns.fetch_add(ns, std::memory_order_relaxed);
+        atomic_max(s.job_max_ns, ns);
+        if(cancelled) s.cancelled.fetch_add(cancelled, std::memory_order_relaxed);
+    }
+
+    LaneStats stats(Lane l) const
+    {
+        const auto& s = st_[(int)l];
+        LaneStats r;
+        r.submitted = s.submitted.load();
+        r.executed = s.executed.load();
+        r.queued = pending_[(int)l].load();
+        r.jobs = s.jobs.load();
+        r.chunks_cancelled = s.cancelled.load();
+        r.wait_avg_us = r.executed ? s.wait_sum_ns.load() / 1e3 / r.executed : 0;
+        r.wait_max_us = s.wait_max_ns.load() / 1e3;
+        r.job_avg_us = r.jobs ? s.job_sum_ns.load() / 1e3 / r.jobs : 0;
+        r.job_max_us = s.job_max_ns.load() / 1e3;
+        return r;
+    }
+    void reset_stats()
+    {
+        for(auto& s: st_){
+            s.submitted = 0; s.executed = 0; s.wait_sum_ns = 0; s.wait_max_ns = 0;
+            s.jobs = 0; s.job_sum_ns = 0; s.job_max_ns = 0; s.cancelled = 0;
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex mu;
+        std::deque<Task> q[kLanes];
+    };
+    struct Counters {
+        std::atomic<uint64_t> submitted{0}, executed{0}, wait_sum_ns{0}, wait_max_ns{0};
+        std::atomic<uint64_t> jobs{0}, job_sum_ns{0}, job_max_ns{0}, cancelled{0};
+    };
+
+    static bool take(Queue& q, int li, bool back, Task& t)
+    {
+        std::lock_guard<std::mutex> lk(q.mu);
+        auto& d = q.q[li];
+        if(d.empty()) return false;
+        if(back){ t = std::move(d.back()); d.pop_back(); }
+        else    { t = std::move(d.front()); d.pop_front(); }
+        return true;
+    }
+    // Voie la plus prioritaire d’abord : file locale (LIFO), injection, vol (FIFO)
+    bool pop(int max_lane, Task& t, int& li_out)
+    {
+        const int w = worker_id();
+        const size_t nw = qs_.size();
+        for(int li=0; li<=max_lane && li<kLanes; ++li){
+            if(!pending_[li].load(std::memory_order_acquire)) continue;
+            bool got = (w>=0 && take(qs_[(size_t)w], li, true, t)) || take(inj_, li, false, t);
+            for(size_t k=1; !got && k<=nw; ++k){
+                const size_t v = ((size_t)(w<0 ? 0 : w) + k) % nw;
+                if((int)v!=w) got = take(qs_[v], li, false, t);
+            }
+            if(got){
+                pending_[li].fetch_sub(1, std::memory_order_acq_rel);
+                li_out = li;
+                return true;
+            }
+        }
+        return false;
+    }
+    uint64_t total_pending() const
+    {
+        uint64_t s = 0;
+        for(const auto& p: pending_) s += p.load(std::memory_order_acquire);
+        return s;
+    }
+    void worker(int id)
+    {
+        worker_id() = id;
+        for(;;){
+            if(run_one(kLanes-1)) continue;
+            std::unique_lock<std::mutex> lk(sleep_mu_);
+            if(stop_) return;
+            sleep_cv_.wait_for(lk, std::chrono::milliseconds(5), [&]{ return stop_ || total_pending()>0; });
+            if(stop_ && total_pending()==0) return;
+        }
+    }
+
+    unsigned conc_;
+    std::vector<Queue> qs_;
+    Queue inj_;
+    std::atomic<uint64_t> pending_[kLanes] = {};
+    Counters st_[kLanes];
+    std::mutex sleep_mu_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+struct ForJob {
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t n = 0, grain = 1, chunks = 0;
+    Lane lane = Lane::Normal;
+    std::shared_ptr<std::atomic<bool>> cancel;
+    std::atomic<size_t> next{0}, done{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;          // 1re exception de body (sous mu)
+    std::mutex mu;
+    std::condition_variable cv;
+};
+
+// Réclame des tranches jusqu’à épuisement ; entre deux tranches, laisse
+// passer les tâches des voies plus prioritaires. Après une exception de
+// body, les tranches restantes sont comptées sans être exécutées.
+inline void run_chunks(ForJob& J, Scheduler& S)
+{
+    for(;;){
+        while(S.higher_pending(J.lane) && S.run_one((int)J.lane - 1)) {}
+        const size_t c = J.next.fetch_add(1, std::memory_order_relaxed);
+        if(c>=J.chunks) break;
+        if(J.failed.load(std::memory_order_acquire)){
+            // abandonnée : l’exception est relancée par l’appelant
+        } else if(J.cancel && J.cancel->load(std::memory_order_relaxed)){
+            J.skipped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            const size_t b = c*J.grain, e = std::min(J.n, b+J.grain);
+            try {
+                (*J.body)(b, e);
+            } catch(...) {
+                std::lock_guard<std::mutex> lk(J.mu);
+                if(!J.error) J.error = std::current_exception();
+                J.failed.store(true, std::memory_order_release);
+            }
+        }
+        if(J.done.fetch_add(1, std::memory_order_acq_rel) + 1 == J.chunks){
+            std::lock_guard<std::mutex> lk(J.mu);
+            J.cv.notify_all();
+        }
+    }
+}
+
+} // namespace detail
+
+inline unsigned concurrency() { return detail::Scheduler::get().concurrency(); }
+
+// Taille du pool (threads au total, appelant compris) ; sans effet après la
+// première utilisation de l’ordonnanceur.
+inline void configure(unsigned threads) { detail::configured_threads().store(threads); }
+
+// Voie et jeton du thread courant, restaurés à la destruction
+class Scope {
+public:
+    explicit Scope(Lane lane, const CancelToken* token = nullptr)
+        : saved_(detail::ctx())
+    {
+        detail::ctx().lane = lane;
+        if(token) detail::ctx().cancel = token->flag();
+    }
+    ~Scope() { detail::ctx() = saved_; }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    detail::Ctx saved_;
+};
+
+// Intervalles [begin,end) distribués dynamiquement sur au plus `threads`
+// exécutants du pool partagé (appelant compris).
+inline bool parallel_for(size_t n,
+                         const std::function<void(size_t, size_t)>& body,
+                         unsigned threads = 0,
+                         size_t grain = 0)
+{
+    const detail::Ctx& C = detail::ctx();
+    if(C.cancel && C.cancel->load(std::memory_order_relaxed)) return false;
+    if(n==0) return true;
+    auto& S = detail::Scheduler::get();
+    if(threads==0 || threads>S.concurrency()) threads = S.concurrency();
+    if(grain==0) grain = std::max<size_t>(1, n / ((size_t)threads * 8));
+    const size_t chunks = (n + grain - 1) / grain;
+    threads = (unsigned)std::min<size_t>(threads, chunks);
+
+    const uint64_t t0 = detail::now_ns();
+    if(threads<=1){
+        // Sur place ; tranche par tranche seulement si un jeton peut l’interrompre
+        uint64_t skipped = 0;
+        if(!C.cancel) body(0, n);
+        else for(size_t c=0; c<chunks; ++c){
+            if(C.cancel->load(std::memory_order_relaxed)){ skipped = chunks - c; break; }
+            body(c*grain, std::min(n, (c+1)*grain));
+        }
+        S.note_job(C.lane, detail::now_ns() - t0, skipped);
+        return skipped==0;
+    }
+
+    auto J = std::make_shared<detail::ForJob>();
+    J->body = &body;
+    J->n = n;
+    J->grain = grain;
+    J->chunks = chunks;
+    J->lane = C.lane;
+    J->cancel = C.cancel;
+    for(unsigned h=1; h<threads; ++h) S.push(J->lane, [J, &S]{ detail::run_chunks(*J, S); }, C);
+    detail::run_chunks(*J, S);
+    // Tranches encore en cours ailleurs : aider (même priorité ou plus), sinon attendre
+    while(J->done.load(std::memory_order_acquire) < chunks){
+        if(S.run_one((int)J->lane)) continue;
+        std::unique_lock<std::mutex> lk(J->mu);
+        J->cv.wait_for(lk, std::chrono::microseconds(200),
+                       [&]{ return J->done.load(std::memory_order_acquire) >= chunks; });
+    }
+    const uint64_t skipped = J->skipped.load();
+    S.note_job(J->lane, detail::now_ns() - t0, skipped);
+    if(J->failed.load(std::memory_order_acquire)){
+        // Sortie du job : une aide encore en file peut libérer J plus tard
+        std::exception_ptr e;
+        {
+            std::lock_guard<std::mutex> lk(J->mu);
+            e = std::move(J->error);
+        }
+        std::rethrow_exception(e);
+    }
+    return skipped==0;
+}
+
+// Tâche isolée sur le pool (voie et jeton courants transmis à la tâche)
+inline void submit(std::function<void()> fn, Lane lane)
+{
+    detail::Ctx c = detail::ctx();
+    c.lane = lane;
+    detail::Scheduler::get().push(lane, std::move(fn), c);
+}
+inline void submit(std::function<void()> fn) { submit(std::move(fn), detail::ctx().lane); }
+
+inline LaneStats lane_stats(Lane l) { return detail::Scheduler::get().stats(l); }
+inline void reset_stats() { detail::Scheduler::get().reset_stats(); }
+
+} // namespace T3Par
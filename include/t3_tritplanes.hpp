@@ -0,0 +1,150 @@
+// ============================================================================
+//  File: include/t3_tritplanes.hpp — Plans de trits Word27 (raffinement progressif) (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//  • Découpe une image Word27 (1 pixel = code 13 trits Y|Cb|Cr) en 13 "plans
+//    de trits" : le plan p contient le chiffre base-3 n° kPlaneDigit[p] de
+//    chaque pixel, sur toute l’image.
+//  • Ordre des plans = du plus significatif au moins significatif, en
+//    alternant Y / Cb / Cr :
+//        Y4 Cb3 Cr3 | Y3 Cb2 Cr2 | Y2 Cb1 Cr1 | Y1 Cb0 Cr0 | Y0
+//  • Chaque plan est packé base-243 (5 trits/octet, trit 0 = poids faible),
+//    comme les flux .t3proto.
+//  • Reconstruction depuis les K premiers plans : chiffres manquants = 1
+//    (milieu de {0,1,2}) → valeur au centre de l’intervalle encore possible.
+//
+//  FORMAT DU CODE (rappel cœur)
+//  ----------------------------
+//   code = Y + 243*(Cb+40 + 81*(Cr+40))
+//   chiffres 0..4 = Y, 5..8 = Cb, 9..12 = Cr
+//
+//  API
+//  ---
+//   T3Planes::kPlanes, kPlaneDigit[], plane_name(p)
+//   T3Planes::plane_bytes(n_words)
+//   T3Planes::pack_plane(words, n, digit, out_bytes)
+//   T3Planes::pack_all_planes(words, planes[13], threads=0)
+//   T3Planes::rebuild_words(planes (K premiers), K, n, out_words, threads=0)
+//
+//  NOTES
+//  -----
+//  • Header-only ; le conteneur disque (.t3pl) est dans io_t3p_t3v.
+//  • Après 3 plans (~1/13 du volume) on obtient déjà une image grossière
+//    (Y à 81 niveaux près, chroma à 27 niveaux près).
+// ============================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#include "ternary_image_codec_v6_min.hpp" // Word27
+#include "t3_parallel.hpp"
+
+namespace T3Planes {
+
+constexpr int kPlanes = 13;
+constexpr int kPlaneDigit[kPlanes] = { 4, 8, 12, 3, 7, 11, 2, 6, 10, 1, 5, 9, 0 };
+constexpr uint32_t kPow3[kPlanes] = { 1u, 3u, 9u, 27u, 81u, 243u, 729u, 2187u, 6561u,
+                                      19683u, 59049u, 177147u, 531441u };
+
+inline const char* plane_name(int p)
+{
+    static const char* names[kPlanes] = { "Y4","Cb3","Cr3","Y3","Cb2","Cr2",
+                                          "Y2","Cb1","Cr1","Y1","Cb0","Cr0","Y0" };
+    return (p>=0 && p<kPlanes) ? names[p] : "?";
+}
+
+inline size_t plane_bytes(size_t n_words)
+{
+    return (n_words + 4) / 5;
+}
+
+// Octet base-243 → 5 chiffres (table construite une fois)
+inline const std::array<std::array<uint8_t,5>,243>& b243_digits()
+{
+    static const auto T = []
+    {
+        std::array<std::array<uint8_t,5>,243> t{};
+        for(int v=0; v<243; ++v)
+        {
+            int x=v;
+            for(int j=0; j<5; ++j)
+            {
+                t[(size_t)v][(size_t)j]=(uint8_t)(x%3);
+                x/=3;
+            }
+        }
+        return t;
+    }();
+    return T;
+}
+
+// Plan d’un chiffre (0..12) → octets base-243
+inline void pack_plane(const Word27* w, size_t n, int digit, std::vector<uint8_t>& out)
+{
+    out.assign(plane_bytes(n), 0);
+    const uint32_t p = kPow3[digit];
+    size_t i=0, b=0;
+    for(; i+5<=n; i+=5, ++b)
+    {
+        uint32_t v=0;
+        for(int j=4; j>=0; --j) v = v*3 + (w[i+(size_t)j].u / p) % 3u;
+        out[b]=(uint8_t)v;
+    }
+    if(i<n)
+    {
+        uint32_t v=0;
+        for(size_t j=n; j-- > i; ) v = v*3 + (w[j].u / p) % 3u;
+        out[b]=(uint8_t)v;
+    }
+}
+
+// Les 13 plans dans l’ordre de priorité (plans répartis sur les cœurs)
+inline void pack_all_planes(const std::vector<Word27>& words,
+                            std::vector<std::vector<uint8_t>>& planes,
+                            unsigned threads = 0)
+{
+    planes.assign(kPlanes, {});
+    T3Par::parallel_for(kPlanes, [&](size_t p0, size_t p1)
+    {
+        for(size_t p=p0; p<p1; ++p)
+            pack_plane(words.data(), words.size(), kPlaneDigit[p], planes[p]);
+    }, threads, 1);
+}
+
+// Reconstruction depuis les K premiers plans (planes[0..K-1], ordre kPlaneDigit).
+// Chiffres absents → 1 (centre de l’intervalle).
+inline void rebuild_words(const std::vector<const uint8_t*>& planes, int K,
+                          size_t n, std::vector<Word27>& out,
+                          unsigned threads = 0)
+{
+    K = std::clamp(K, 0, kPlanes);
+    uint32_t fill=0;
+    for(int p=K; p<kPlanes; ++p) fill += kPow3[kPlaneDigit[p]];
+    out.assign(n, Word27{});
+
+    const auto& D = b243_digits();
+    const size_t groups = plane_bytes(n);
+    T3Par::parallel_for(groups, [&](size_t g0, size_t g1)
+    {
+        for(size_t g=g0; g<g1; ++g)
+        {
+            const size_t i0=g*5, m=std::min<size_t>(5, n-i0);
+            uint32_t acc[5]= {fill,fill,fill,fill,fill};
+            for(int p=0; p<K; ++p)
+            {
+                const auto& d = D[planes[(size_t)p][g] % 243u];
+                const uint32_t pw = kPow3[kPlaneDigit[p]];
+                for(int j=0; j<5; ++j) acc[j] += d[(size_t)j]*pw;
+            }
+            for(size_t j=0; j<m; ++j) out[i0+j].u = acc[j];
+        }
+    }, threads);
+}
+
+} // namespace T3Planes
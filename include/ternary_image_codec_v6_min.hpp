@@ -6,6 +6,8 @@
 //  -----
 //  • Définir les types de base (Word27, PixelYCbCrQuant).
 //  • Enum SubwordMode ∈ {S27,S24,S21,S18,S15} et résolutions standard.
+//  • Placement raster d’un payload (w×h ou canevas S27 plein) et pas de
+//    décimation 1/k, partagés par les lecteurs décimés (conteneurs, PNG).
 //  • Ponts d’API pour le RAW adaptable N (balanced) : encode/decode subword.
 //  • Outils balanced↔unbalanced au niveau TRIT (sans exposer le GF(27) interne).
 //
@@ -63,6 +65,33 @@ inline StdRes std_res_for(SubwordMode m){
     }
 }
 
+// Payload de n mots (1 pixel = 1 mot, raster) pour une image w×h : w*h mots
+// (ou plus), ou canevas S27 plein d’une image sub (embed centré, fenêtre
+// centrale). false si aucun des deux.
+struct WordRaster { uint64_t stride=0; int x0=0, y0=0; bool canvas=false; };
+
+inline bool word_raster_for(uint64_t n_words, SubwordMode sub, int w, int h, WordRaster& r){
+    r = WordRaster{};
+    if(w<=0 || h<=0) return false;
+    const StdRes big = std_res_for(SubwordMode::S27);
+    if(n_words!=(uint64_t)w*h && sub!=SubwordMode::S27 && n_words==(uint64_t)big.w*big.h){
+        if(w>big.w || h>big.h) return false;
+        r.stride=(uint64_t)big.w; r.x0=(big.w-w)/2; r.y0=(big.h-h)/2; r.canvas=true;
+        return true;
+    }
+    if(n_words<(uint64_t)w*h) return false;
+    r.stride=(uint64_t)w;
+    return true;
+}
+
+// Aperçu 1/k : ceil(n/k) échantillons, centre du bloc k (borné au dernier)
+inline int decimated_dim(int n, int k){
+    return k<=1 ? n : (n+k-1)/k;
+}
+inline int decimated_pick(int i, int k, int n){
+    return std::min(i*k + k/2, n-1);
+}
+
 // ======================== Balanced ↔ Unbalanced (trit) ======================
 
 inline uint8_t trit_bal_to_unb(int8_t t_bal){
@@ -124,6 +153,15 @@ bool decode_raw_words_to_pixels_subword(const std::vector<Word27>& in_words,
                                         SubwordMode sub,
                                         std::vector<PixelYCbCrQuant>& out_px);
 
+// Variantes sans copie (span/buffer appelant) : px[0..n) / in_words[0..n)
+bool encode_raw_pixels_to_words_subword(const PixelYCbCrQuant* px, size_t n,
+                                        SubwordMode sub,
+                                        std::vector<Word27>& out_words);
+
+bool decode_raw_words_to_pixels_subword(const Word27* in_words, size_t n,
+                                        SubwordMode sub,
+                                        std::vector<PixelYCbCrQuant>& out_px);
+
 // ============================= Sanity helpers ===============================
 
 inline bool is_valid_subword(SubwordMode m){
@@ -1,6 +1,9 @@
 // ============================================================================
 //  File: include/video_writer_ffmpeg.hpp  Writer vido (FFmpeg, optionnel)
 //  MAJ: helper gnrique de centrage en canevas (pas seulement S27).
+//  MAJ: FFLadderWriter  chelle de proxies (un dcodage, N encodeurs en
+//       parallle, rduction par surface de barreau en barreau).
+//  MAJ: add_frame_words dcode en dcim si la sortie est la source / k.
 // ============================================================================
 #pragma once
 #include <string>
@@ -9,6 +12,11 @@
 #include <memory>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #include "ternary_image_codec_v6_min.hpp"
 #include "io_image.hpp"
@@ -23,6 +31,7 @@ struct FFVideoConfig
     std::string preset = "medium";
     int         gop = 50;
     bool        yuv444 = false;
+    bool        decimate_box = false; // rduction entire des words : moyenne kk (sinon point central)
 };
 struct FFVideoStats
 {
@@ -132,6 +141,15 @@ public:
     // RAW-N direct (pas de centrage)
     bool add_frame_words(const std::vector<Word27>& words, SubwordMode sub, int w, int h)
     {
+        // Sortie = source / k (k entier) : dcodage dcim (1 mot sur k),
+        // mme pixel que resize_rgb_nn ; moyenne kk si cfg.decimate_box
+        const int k = ctx_ && ctx_->width>0 ? w/ctx_->width : 0;
+        if(k>1 && w==k*ctx_->width && h==k*ctx_->height && words.size()==(size_t)w*h)
+        {
+            ImageU8 img;
+            if(!words_to_rgb_decimated(words.data(), words.size(), sub, w, h, k, cfg_.decimate_box, img)) return false;
+            return add_frame_rgb(img);
+        }
         std::vector<PixelYCbCrQuant> q;
         if(!decode_raw_words_to_pixels_subword(words, sub, q)) return false;
         if((int)q.size()<w*h) return false;
@@ -286,6 +304,196 @@ public:
 };
 #endif
 
+// == chelle de proxies (un dcodage, N sorties) =============================
+// FFLadderWriter : chaque frame est dcode une seule fois (words -> RGB), puis
+// rduite de proche en proche (8K -> 4K -> 1080p ...) par resize_rgb_area, du
+// plus grand barreau au plus petit. Chaque barreau a son FFVideoWriter dans un
+// thread ddi, aliment par une file borne (queue_frames) : l'appelant est
+// frein par le barreau le plus lent, la mmoire reste borne. Les images de
+// mme taille sont partages (shared_ptr<const ImageU8>, pas de copie).
+struct FFLadderRung
+{
+    std::string   out_path;
+    FFVideoConfig cfg;          // cfg.width/height = taille du barreau
+};
+
+class FFLadderWriter
+{
+public:
+    FFLadderWriter() = default;
+    FFLadderWriter(const FFLadderWriter&) = delete;
+    FFLadderWriter& operator=(const FFLadderWriter&) = delete;
+    ~FFLadderWriter()
+    {
+        close();
+    }
+
+    bool open(const std::vector<FFLadderRung>& rungs, size_t queue_frames = 2)
+    {
+        close();
+        if(rungs.empty()) return false;
+        cap_ = std::max<size_t>(1, queue_frames);
+        std::vector<size_t> order(rungs.size());
+        for(size_t i=0; i<order.size(); ++i) order[i]=i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            return (int64_t)rungs[a].cfg.width*rungs[a].cfg.height > (int64_t)rungs[b].cfg.width*rungs[b].cfg.height;
+        });
+        for(size_t i: order)
+        {
+            const FFLadderRung& r = rungs[i];
+            if(r.cfg.width<=0 || r.cfg.height<=0)
+            {
+                std::cerr<<"[FFLadderWriter] taille invalide: "<<r.out_path<<"\n";
+                close();
+                return false;
+            }
+            std::unique_ptr<Lane> L(new Lane);
+            L->index = i;
+            L->w = r.cfg.width;
+            L->h = r.cfg.height;
+            if(!L->wr.open(r.out_path, r.cfg))
+            {
+                close();
+                return false;
+            }
+            lanes_.push_back(std::move(L));
+        }
+        stats_.assign(rungs.size(), FFVideoStats{});
+        for(auto& L: lanes_)
+        {
+            Lane* p = L.get();
+            p->th = std::thread([this, p]
+            {
+                run(*p);
+            });
+        }
+        return true;
+    }
+
+    // Image pleine rsolution (RGB8) ; rduite puis distribue  chaque barreau
+    bool add_frame_rgb(ImageU8 img)
+    {
+        if(lanes_.empty() || img.c!=3) return false;
+        std::shared_ptr<const ImageU8> full = std::make_shared<const ImageU8>(std::move(img));
+        std::shared_ptr<const ImageU8> prev = full;
+        for(auto& L: lanes_)
+        {
+            std::shared_ptr<const ImageU8> cur;
+            if(prev->w==L->w && prev->h==L->h) cur = prev;
+            else
+            {
+                // rduction depuis le barreau prcdent s'il le couvre, sinon depuis la source
+                const ImageU8& from = (prev->w>=L->w && prev->h>=L->h) ? *prev : *full;
+                std::shared_ptr<ImageU8> out = std::make_shared<ImageU8>();
+                resize_rgb_area(from, L->w, L->h, *out);
+                cur = std::move(out);
+            }
+            if(!push(*L, cur)) return false;
+            prev = std::move(cur);
+        }
+        return true;
+    }
+    // RAW-N : un seul dcodage words -> RGB pour tous les barreaux
+    bool add_frame_words(const std::vector<Word27>& words, SubwordMode sub, int w, int h)
+    {
+        std::vector<PixelYCbCrQuant> q;
+        if(!decode_raw_words_to_pixels_subword(words, sub, q)) return false;
+        if((int)q.size()<w*h) return false;
+        ImageU8 img;
+        quant_stream_to_rgb(q, w, h, img);
+        return add_frame_rgb(std::move(img));
+    }
+
+    // Vide les files, ferme les writers ; false si un barreau a chou
+    bool close()
+    {
+        bool ok = true;
+        for(auto& L: lanes_)
+        {
+            {
+                std::lock_guard<std::mutex> lk(L->m);
+                L->done = true;
+            }
+            L->cv.notify_all();
+        }
+        for(auto& L: lanes_)
+        {
+            if(L->th.joinable()) L->th.join();
+            else L->wr.close();
+            if(L->failed) ok = false;
+            if(L->index < stats_.size()) stats_[L->index] = L->stats;
+        }
+        lanes_.clear();
+        return ok;
+    }
+    // Statistiques par barreau, dans l'ordre de open() (valides aprs close())
+    const std::vector<FFVideoStats>& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct Lane
+    {
+        size_t index = 0;
+        int    w = 0, h = 0;
+        FFVideoWriter wr;
+        std::thread th;
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<std::shared_ptr<const ImageU8>> q;
+        bool done = false;
+        bool failed = false;
+        FFVideoStats stats{};
+    };
+
+    bool push(Lane& L, std::shared_ptr<const ImageU8> img)
+    {
+        std::unique_lock<std::mutex> lk(L.m);
+        L.cv.wait(lk, [&]
+        {
+            return L.q.size()<cap_ || L.failed;
+        });
+        if(L.failed) return false;
+        L.q.push_back(std::move(img));
+        lk.unlock();
+        L.cv.notify_all();
+        return true;
+    }
+    void run(Lane& L)
+    {
+        for(;;)
+        {
+            std::shared_ptr<const ImageU8> img;
+            {
+                std::unique_lock<std::mutex> lk(L.m);
+                L.cv.wait(lk, [&]
+                {
+                    return !L.q.empty() || L.done;
+                });
+                if(L.q.empty()) break;
+                img = std::move(L.q.front());
+                L.q.pop_front();
+            }
+            L.cv.notify_all();
+            if(!L.failed && !L.wr.add_frame_rgb(*img))
+            {
+                std::lock_guard<std::mutex> lk(L.m);
+                L.failed = true;
+                L.q.clear();
+            }
+            if(L.failed) L.cv.notify_all();
+        }
+        L.stats = L.wr.stats();
+        L.wr.close();
+    }
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<FFVideoStats> stats_;
+    size_t cap_ = 2;
+};
+
 // == Helpers haut-niveau =====================================================
 inline bool write_video_from_words_sequence(const std::string& out_path,
         const FFVideoConfig& cfg,
@@ -347,3 +555,24 @@ inline bool write_video_centered_in_canvas_from_rawN_sequence(const std::string&
     return false;
 #endif
 }
+// chelle complte depuis une squence RAW-N (un dcodage par frame)
+inline bool write_video_ladder_from_words_sequence(const std::vector<FFLadderRung>& rungs,
+        const std::vector<std::vector<Word27>>& frames,
+        SubwordMode sub, int w, int h,
+        std::vector<FFVideoStats>* out_stats=nullptr)
+{
+    FFLadderWriter wr;
+    if(!wr.open(rungs)) return false;
+    bool ok = true;
+    for(const auto& f: frames)
+    {
+        if(!wr.add_frame_words(f, sub, w, h))
+        {
+            ok = false;
+            break;
+        }
+    }
+    if(!wr.close()) ok = false;
+    if(out_stats) *out_stats = wr.stats();
+    return ok;
+}
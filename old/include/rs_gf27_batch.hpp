@@ -0,0 +1,189 @@
+// ============================================================================
+//  File: include/rs_gf27_batch.hpp  — RS(26,k) GF(27) encoder, batched (SIMD)
+//  Encodes 16 (SSSE3) / 32 (AVX2) codewords in lockstep:
+//   - parity = M·data, M (r×k) = systematic parity matrix of RSCodec
+//     (linear code → column i = parity of unit vector e_i);
+//   - symbols transposed into lanes (lane = codeword, row = symbol index);
+//   - GF(27) product by constant M[m][i] = 2 pshufb (entries 0..15 / 16..26),
+//     tables return the product already split in trits;
+//   - trits accumulated in bytes (≤ 2k < 256), reduced mod 3 once per parity.
+//  Output written in place: out + c*out_stride = [data(k) | parity(r)], so a
+//  band buffer can be filled directly. Scalar path (same tables) otherwise.
+//  Standalone (no dependency on the core); symbols must be in 0..26.
+// ============================================================================
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+struct RSBatchEncoder
+{
+#if defined(__AVX2__)
+    static constexpr int LANES=32;
+#else
+    static constexpr int LANES=16;
+#endif
+    int n=0,k=0,r=0;
+    // tab[((m*k+i)*3+j)*32 + x] = trit j of M[m][i]·x  (x<16: "lo", x≥16: "hi")
+    std::vector<uint8_t> tab;
+
+    // mul: 27×27 GF(27) product table ; parity: r×k row-major
+    bool init(int n_,int k_,const uint8_t* mul,const uint8_t* parity)
+    {
+        if(n_<=0 || k_<=0 || k_>=n_ || n_>26 || !mul || !parity) return false;
+        n=n_;
+        k=k_;
+        r=n-k;
+        tab.assign((size_t)r*k*3*32,0);
+        for(int m=0; m<r; ++m) for(int i=0; i<k; ++i)
+        {
+            const uint8_t c=parity[m*k+i];
+            uint8_t* t=&tab[(size_t)(m*k+i)*3*32];
+            for(int x=0; x<27; ++x)
+            {
+                const uint8_t p=mul[c*27+x];
+                t[x]=p%3;
+                t[32+x]=(p/3)%3;
+                t[64+x]=p/9;
+            }
+        }
+        return true;
+    }
+
+    // count codewords : data + c*data_stride (k symbols) → out + c*out_stride (n symbols)
+    void encode(const uint8_t* data,size_t data_stride,uint8_t* out,size_t out_stride,size_t count) const
+    {
+        if(!r) return;
+        alignas(32) uint8_t xs[26][LANES];   // data, transposed
+        alignas(32) uint8_t ps[26][LANES];   // parity, transposed
+        for(size_t c0=0; c0<count; c0+=LANES)
+        {
+            const int L=(int)std::min<size_t>(LANES,count-c0);
+            for(int l=0; l<L; ++l)
+            {
+                const uint8_t* d=data+(c0+l)*data_stride;
+                for(int i=0; i<k; ++i) xs[i][l]=d[i];
+            }
+            for(int l=L; l<LANES; ++l) for(int i=0; i<k; ++i) xs[i][l]=0;
+            parity_lanes(xs,ps);
+            for(int l=0; l<L; ++l)
+            {
+                uint8_t* o=out+(c0+l)*out_stride;
+                const uint8_t* d=data+(c0+l)*data_stride;
+                if(o!=d) std::memmove(o,d,(size_t)k);
+                for(int m=0; m<r; ++m) o[k+m]=ps[m][l];
+            }
+        }
+    }
+
+private:
+#if defined(__AVX2__)
+    void parity_lanes(const uint8_t (*xs)[LANES],uint8_t (*ps)[LANES]) const
+    {
+        const __m256i c70=_mm256_set1_epi8(0x70), c16=_mm256_set1_epi8(16), m15=_mm256_set1_epi8(15);
+        const __m256i mod3=_mm256_broadcastsi128_si256(_mm_setr_epi8(0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0));
+        __m256i ilo[26],ihi[26];
+        for(int i=0; i<k; ++i)
+        {
+            const __m256i x=_mm256_load_si256((const __m256i*)xs[i]);
+            ilo[i]=_mm256_adds_epu8(x,c70);   // x<16 → x+0x70, else bit 7 set → 0
+            ihi[i]=_mm256_sub_epi8(x,c16);    // x<16 → negative → 0
+        }
+        auto red=[&](__m256i a)
+        {
+            a=_mm256_add_epi8(_mm256_and_si256(a,m15),_mm256_and_si256(_mm256_srli_epi16(a,4),m15));
+            a=_mm256_add_epi8(_mm256_and_si256(a,m15),_mm256_and_si256(_mm256_srli_epi16(a,4),m15));
+            return _mm256_shuffle_epi8(mod3,a);
+        };
+        for(int m=0; m<r; ++m)
+        {
+            __m256i a0=_mm256_setzero_si256(), a1=a0, a2=a0;
+            const uint8_t* t=&tab[(size_t)m*k*3*32];
+            for(int i=0; i<k; ++i, t+=96)
+            {
+                auto lk=[&](const uint8_t* q)
+                {
+                    const __m256i lo=_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)q));
+                    const __m256i hi=_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(q+16)));
+                    return _mm256_or_si256(_mm256_shuffle_epi8(lo,ilo[i]),_mm256_shuffle_epi8(hi,ihi[i]));
+                };
+                a0=_mm256_add_epi8(a0,lk(t));
+                a1=_mm256_add_epi8(a1,lk(t+32));
+                a2=_mm256_add_epi8(a2,lk(t+64));
+            }
+            const __m256i t0=red(a0), t1=red(a1), t2=red(a2);
+            const __m256i t1x3=_mm256_add_epi8(_mm256_add_epi8(t1,t1),t1);
+            const __m256i t2x3=_mm256_add_epi8(_mm256_add_epi8(t2,t2),t2);
+            const __m256i t2x9=_mm256_add_epi8(_mm256_add_epi8(t2x3,t2x3),t2x3);
+            _mm256_store_si256((__m256i*)ps[m],_mm256_add_epi8(t0,_mm256_add_epi8(t1x3,t2x9)));
+        }
+    }
+#elif defined(__SSSE3__)
+    void parity_lanes(const uint8_t (*xs)[LANES],uint8_t (*ps)[LANES]) const
+    {
+        const __m128i c70=_mm_set1_epi8(0x70), c16=_mm_set1_epi8(16), m15=_mm_set1_epi8(15);
+        const __m128i mod3=_mm_setr_epi8(0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0);
+        __m128i ilo[26],ihi[26];
+        for(int i=0; i<k; ++i)
+        {
+            const __m128i x=_mm_load_si128((const __m128i*)xs[i]);
+            ilo[i]=_mm_adds_epu8(x,c70);
+            ihi[i]=_mm_sub_epi8(x,c16);
+        }
+        auto red=[&](__m128i a)
+        {
+            a=_mm_add_epi8(_mm_and_si128(a,m15),_mm_and_si128(_mm_srli_epi16(a,4),m15));
+            a=_mm_add_epi8(_mm_and_si128(a,m15),_mm_and_si128(_mm_srli_epi16(a,4),m15));
+            return _mm_shuffle_epi8(mod3,a);
+        };
+        for(int m=0; m<r; ++m)
+        {
+            __m128i a0=_mm_setzero_si128(), a1=a0, a2=a0;
+            const uint8_t* t=&tab[(size_t)m*k*3*32];
+            for(int i=0; i<k; ++i, t+=96)
+            {
+                auto lk=[&](const uint8_t* q)
+                {
+                    return _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)q),ilo[i]),
+                                        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(q+16)),ihi[i]));
+                };
+                a0=_mm_add_epi8(a0,lk(t));
+                a1=_mm_add_epi8(a1,lk(t+32));
+                a2=_mm_add_epi8(a2,lk(t+64));
+            }
+            const __m128i t0=red(a0), t1=red(a1), t2=red(a2);
+            const __m128i t1x3=_mm_add_epi8(_mm_add_epi8(t1,t1),t1);
+            const __m128i t2x3=_mm_add_epi8(_mm_add_epi8(t2,t2),t2);
+            const __m128i t2x9=_mm_add_epi8(_mm_add_epi8(t2x3,t2x3),t2x3);
+            _mm_store_si128((__m128i*)ps[m],_mm_add_epi8(t0,_mm_add_epi8(t1x3,t2x9)));
+        }
+    }
+#else
+    void parity_lanes(const uint8_t (*xs)[LANES],uint8_t (*ps)[LANES]) const
+    {
+        for(int m=0; m<r; ++m)
+        {
+            unsigned a0[LANES]= {0}, a1[LANES]= {0}, a2[LANES]= {0};
+            const uint8_t* t=&tab[(size_t)m*k*3*32];
+            for(int i=0; i<k; ++i, t+=96)
+            {
+                for(int l=0; l<LANES; ++l)
+                {
+                    const uint8_t x=xs[i][l];
+                    a0[l]+=t[x];
+                    a1[l]+=t[32+x];
+                    a2[l]+=t[64+x];
+                }
+            }
+            for(int l=0; l<LANES; ++l) ps[m][l]=(uint8_t)(a0[l]%3 + 3*(a1[l]%3) + 9*(a2[l]%3));
+        }
+    }
+#endif
+};
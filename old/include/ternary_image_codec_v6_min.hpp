@@ -2,7 +2,8 @@
 //  File: include/ternary_image_codec_v6_min.hpp  (part 1/2)
 //  Minimal core for the v6 codec (compact docs). Provides:
 //   - GF(27) arithmetic (p(x)=x^3+2x+1)
-//   - RS(26,k) encoder/decoder (k∈{24,22,20,18})
+//   - RS(26,k) encoder/decoder (k∈{24,22,20,18}), batched SIMD encoder,
+//     erasure decoder (known positions, cached Vandermonde inverses)
 //   - Superframe header (27 symbols) with ternary CRC-12
 //   - RAW <-> Word27 packing (2 pixels/word example)
 //   - Subword modes (S27/S24/S21/S18/S15), centering helpers
@@ -16,6 +17,10 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "rs_gf27_batch.hpp"
 
 // ---- Base trits/symbols ----
 using UTrit = uint8_t;   // 0..2
@@ -417,6 +422,7 @@ struct GF27Tables
     std::array<int16_t,27> log{};
     std::array<GF27,27*27> mul{};
     std::array<GF27,27> inv{};
+    std::array<GF27,27*27> add{}, sub{};
     GF27 primitive=0;
 };
 struct GF27Context
@@ -455,7 +461,12 @@ struct GF27Context
             tab.log[ tab.exp[i] ]=i;
         }
         for(int i=26; i<26*3; ++i) tab.exp[i]=tab.exp[i-26];
-        for(int a=0; a<27; ++a) for(int b=0; b<27; ++b) tab.mul[a*27+b]=gf27_mul_poly((GF27)a,(GF27)b);
+        for(int a=0; a<27; ++a) for(int b=0; b<27; ++b)
+        {
+            tab.mul[a*27+b]=gf27_mul_poly((GF27)a,(GF27)b);
+            tab.add[a*27+b]=gf27_add((GF27)a,(GF27)b);
+            tab.sub[a*27+b]=gf27_sub((GF27)a,(GF27)b);
+        }
         tab.inv[0]=0;
         for(int a=1; a<27; ++a)
         {
@@ -466,10 +477,10 @@ struct GF27Context
     }
     inline GF27 add(GF27 a,GF27 b) const
     {
-        return gf27_add(a,b);
+        return tab.add[a*27+b];
     } inline GF27 sub(GF27 a,GF27 b) const
     {
-        return gf27_sub(a,b);
+        return tab.sub[a*27+b];
     } inline GF27 mul(GF27 a,GF27 b) const
     {
         return tab.mul[a*27+b];
@@ -491,7 +502,17 @@ struct RSCodec
 {
     GF27Context* gf=nullptr;
     RSParams params{};
-    std::vector<GF27> g;
+    std::vector<GF27> g;    // ascending, roots α^1..α^r
+    std::vector<GF27> gd;   // g/g[0] descending = monic, roots α^-1..α^-r
+    RSBatchEncoder batch;
+    // Erasure patterns → V^-1 (f×f), keyed by 26-bit position mask; shared by
+    // copies of the codec, filled at init (bursts) then on demand.
+    struct ErasureCache
+    {
+        std::mutex mu;
+        std::unordered_map<uint32_t,std::vector<GF27>> inv;
+    };
+    std::shared_ptr<ErasureCache> ecache;
     void init(GF27Context* c, RSParams p)
     {
         gf=c;
@@ -513,6 +534,27 @@ struct RSCodec
             }
             g.swap(ng);
         }
+        // encode_block divides with index 0 = highest degree; decode_block reads
+        // index i as x^i, so roots α^j there are roots α^-j of the reversed word.
+        const GF27 inv0=gf->inv(g[0]);
+        gd.resize(g.size());
+        for(size_t j=0; j<g.size(); ++j) gd[j]=gf->mul(g[j],inv0);
+        build_batch();
+        build_erasure_cache();
+    }
+    // Parity matrix (linear code): column i = parity of unit vector e_i
+    void build_batch()
+    {
+        const int n=params.n,k=params.k,r=n-k;
+        std::vector<GF27> M((size_t)r*k), e(k,0), c(n,0);
+        for(int i=0; i<k; ++i)
+        {
+            e[i]=1;
+            encode_block(e.data(),c.data());
+            for(int m=0; m<r; ++m) M[(size_t)m*k+i]=c[k+m];
+            e[i]=0;
+        }
+        batch.init(n,k,gf->tab.mul.data(),M.data());
     }
     bool encode_block(const GF27* data_k, GF27* out_n) const
     {
@@ -525,12 +567,13 @@ struct RSCodec
             if(coef==0) continue;
             for(int j=0; j<=r; ++j)
             {
-                GF27 prod=gf->mul(g[j],coef);
+                GF27 prod=gf->mul(gd[j],coef);
                 T[i+j]=gf->sub(T[i+j],prod);
             }
         }
+        // codeword = data·x^r − remainder (sign matters in characteristic 3)
         for(int i=0; i<params.k; ++i) out_n[i]=data_k[i];
-        for(int i=0; i<r; ++i) out_n[params.k+i]=T[params.k+i];
+        for(int i=0; i<r; ++i) out_n[params.k+i]=gf->sub((GF27)0,T[params.k+i]);
         return true;
     }
     GF27 poly_eval(const std::vector<GF27>& p, GF27 x) const
@@ -543,30 +586,13 @@ struct RSCodec
         }
         return acc;
     }
-    bool decode_block(GF27* inout_n, GF27* out_k) const
+    // Berlekamp-Massey on S[0..len-1] → connection polynomial sigma, returns L
+    int berlekamp_massey(const GF27* S,int len,std::vector<GF27>& sigma) const
     {
-        const int n=params.n,k=params.k,r=n-k,t=r/2;
-        std::vector<GF27> S(r,0);
-        bool all0=true;
-        for(int j=0; j<r; ++j)
-        {
-            GF27 acc=0;
-            for(int i=0; i<n; ++i)
-            {
-                GF27 xpow=gf->pow_alpha(((j+1)*i)%26);
-                acc=gf->add(acc, gf->mul(inout_n[i],xpow));
-            }
-            S[j]=acc;
-            if(acc!=0) all0=false;
-        }
-        if(all0)
-        {
-            for(int i=0; i<k; ++i) out_k[i]=inout_n[i];
-            return true;
-        }
-        std::vector<GF27> sigma(1,1), B(1,1);
+        sigma.assign(1,1);
+        std::vector<GF27> B(1,1);
         int L=0,m=1;
-        for(int nS=0; nS<r; ++nS)
+        for(int nS=0; nS<len; ++nS)
         {
             GF27 delta=S[nS];
             for(int i=1; i<=L; ++i) if(i<(int)sigma.size()) delta=gf->add(delta, gf->mul(sigma[i], S[nS-i]));
@@ -603,63 +629,202 @@ struct RSCodec
                 m+=1;
             }
         }
-        std::vector<GF27> Sx(r+1,0);
-        for(int j=0; j<r; ++j) Sx[j]=S[j];
-        std::vector<GF27> Omega(Sx.size()+sigma.size()-1,0);
-        for(size_t i=0; i<Sx.size(); ++i) for(size_t j=0; j<sigma.size(); ++j) Omega[i+j]=gf->add(Omega[i+j], gf->mul(Sx[i],sigma[j]));
-        if((int)Omega.size()>r) Omega.resize(r);
-        std::vector<int> err_pos;
-        err_pos.reserve(t);
-        for(int i=0; i<n; ++i)
+        return L;
+    }
+    // Decoder stages (public: timed separately by bench_ecc)
+    // S[j] = c(α^(j+1)), j<r
+    void syndromes(const GF27* c, GF27* S) const
+    {
+        const int n=params.n,r=n-params.k;
+        for(int j=0; j<r; ++j)
         {
-            GF27 x=gf->pow_alpha((-i)%26);
             GF27 acc=0;
-            for(int d=(int)sigma.size()-1; d>=0; --d)
+            for(int i=0; i<n; ++i) if(c[i]) acc=gf->add(acc, gf->mul(c[i], gf->tab.exp[((j+1)*i)%26]));
+            S[j]=acc;
+        }
+    }
+    // Chien: positions i with σ(α^-i)=0 (index i ↔ x^i)
+    int chien_search(const std::vector<GF27>& sigma,int* pos) const
+    {
+        int cnt=0;
+        for(int i=0; i<params.n; ++i) if(poly_eval(sigma,gf->pow_alpha(-i))==0) pos[cnt++]=i;
+        return cnt;
+    }
+    // Forney: Ω = S·σ mod x^r, c_i -= −Ω(X_i^-1)/σ'(X_i^-1)
+    bool forney_correct(GF27* c,const GF27* S,const std::vector<GF27>& sigma,const int* pos,int npos) const
+    {
+        const int r=params.n-params.k;
+        std::vector<GF27> Omega(r,0);
+        for(int i=0; i<r; ++i) for(size_t j=0; j<sigma.size() && i+(int)j<r; ++j) Omega[i+j]=gf->add(Omega[i+j], gf->mul(S[i],sigma[j]));
+        // σ'(x): i·σ_i x^(i-1), i taken mod 3
+        std::vector<GF27> sigmap((sigma.size()>1)?sigma.size()-1:1,0);
+        for(size_t i=1; i<sigma.size(); ++i)
+            sigmap[i-1]=(i%3==0)?0:(i%3==1)?sigma[i]:gf->add(sigma[i],sigma[i]);
+        for(int q=0; q<npos; ++q)
+        {
+            const GF27 Xin=gf->pow_alpha(-pos[q]);
+            const GF27 den=poly_eval(sigmap,Xin);
+            if(den==0) return false;
+            GF27 mag=gf->mul( gf->sub((GF27)0,poly_eval(Omega,Xin)), gf->inv(den) );
+            c[pos[q]]=gf->sub(c[pos[q]],mag);
+        }
+        return true;
+    }
+    bool decode_block(GF27* inout_n, GF27* out_k) const
+    {
+        const int n=params.n,k=params.k,r=n-k,t=r/2;
+        GF27 S[26];
+        syndromes(inout_n,S);
+        bool all0=true;
+        for(int j=0; j<r; ++j) if(S[j]) all0=false;
+        if(!all0)
+        {
+            std::vector<GF27> sigma;
+            const int L=berlekamp_massey(S,r,sigma);
+            int pos[26];
+            const int ne=chien_search(sigma,pos);
+            if(ne>t || ne!=L) return false;
+            if(!forney_correct(inout_n,S,sigma,pos,ne)) return false;
+        }
+        for(int i=0; i<k; ++i) out_k[i]=inout_n[i];
+        return true;
+    }
+
+    // ---- Erasure decoding (known positions: lost rows, CRC-failed words) ----
+    // f erasures + e errors, 2e+f ≤ r. Erasures only: e = V^-1·S[0..f-1] with
+    // V[j][q]=α^((j+1)p_q), then S[f..r-1] must agree. Otherwise (f+2 ≤ r):
+    // Forney syndromes Γ·S, BM, Ψ=ΛΓ, Chien + Forney on all positions.
+    // Gauss-Jordan on [V | I]; pos sorted, distinct, < 26 → V invertible
+    bool erasure_inverse(const int* pos,int f,std::vector<GF27>& Vi) const
+    {
+        const int w=2*f;
+        std::vector<GF27> A((size_t)f*w,0);
+        for(int j=0; j<f; ++j)
+        {
+            for(int q=0; q<f; ++q) A[j*w+q]=gf->tab.exp[((j+1)*pos[q])%26];
+            A[j*w+f+j]=1;
+        }
+        for(int c=0; c<f; ++c)
+        {
+            int pv=c;
+            while(pv<f && !A[pv*w+c]) ++pv;
+            if(pv==f) return false;
+            if(pv!=c) for(int x=0; x<w; ++x) std::swap(A[pv*w+x],A[c*w+x]);
+            const GF27 iv=gf->inv(A[c*w+c]);
+            for(int x=0; x<w; ++x) A[c*w+x]=gf->mul(A[c*w+x],iv);
+            for(int j=0; j<f; ++j)
             {
-                acc=gf->mul(acc,x);
-                acc=gf->add(acc, sigma[d]);
+                const GF27 m=A[j*w+c];
+                if(j==c || !m) continue;
+                for(int x=0; x<w; ++x) A[j*w+x]=gf->sub(A[j*w+x], gf->mul(m,A[c*w+x]));
             }
-            if(acc==0) err_pos.push_back(i);
         }
-        if((int)err_pos.size()>t) return false;
-        std::vector<GF27> sigmap((sigma.size()>1)?sigma.size()-1:1,0);
-        if(sigma.size()>=2)
+        Vi.resize((size_t)f*f);
+        for(int j=0; j<f; ++j) for(int q=0; q<f; ++q) Vi[j*f+q]=A[j*w+f+q];
+        return true;
+    }
+    // Contiguous bursts (lost rows of an interleaved band) of length 1..r
+    void build_erasure_cache()
+    {
+        ecache=std::make_shared<ErasureCache>();
+        const int n=params.n,r=n-params.k;
+        int pos[26];
+        for(int f=1; f<=r; ++f) for(int s0=0; s0+f<=n; ++s0)
         {
-            for(size_t i=1; i<sigma.size(); ++i)
+            uint32_t mask=0;
+            for(int q=0; q<f; ++q)
             {
-                int im=(int)(i%3);
-                if(im==0) sigmap[i-1]=0;
-                else if(im==1) sigmap[i-1]=sigma[i];
-                else
-                {
-                    GF27 a=sigma[i];
-                    UTrit a0=a%3,a1=(a/3)%3,a2=(a/9)%3;
-                    auto m2=[&](UTrit t)->UTrit{ return (UTrit)((2*t)%3); };
-                    sigmap[i-1]=(GF27)(m2(a0)+3*m2(a1)+9*m2(a2));
-                }
+                pos[q]=s0+q;
+                mask|=1u<<pos[q];
             }
+            erasure_inverse(pos,f,ecache->inv[mask]);
         }
-        for(int pos: err_pos)
+    }
+    // Copy of V^-1 for a sorted pattern (cache bounded: cleared when full)
+    bool erasure_inverse_cached(const int* pos,int f,GF27* Vi) const
+    {
+        uint32_t mask=0;
+        for(int q=0; q<f; ++q) mask|=1u<<pos[q];
+        std::lock_guard<std::mutex> lk(ecache->mu);
+        auto it=ecache->inv.find(mask);
+        if(it==ecache->inv.end())
         {
-            GF27 Xin=gf->pow_alpha((-pos)%26);
-            GF27 num=0, den=0;
-            for(int d=(int)Omega.size()-1; d>=0; --d)
+            std::vector<GF27> v;
+            if(!erasure_inverse(pos,f,v)) return false;
+            if(ecache->inv.size()>=4096) ecache->inv.clear();
+            it=ecache->inv.emplace(mask,std::move(v)).first;
+        }
+        std::copy(it->second.begin(),it->second.end(),Vi);
+        return true;
+    }
+    bool decode_block_erasures(GF27* inout_n, GF27* out_k, const int* eras, int n_eras) const
+    {
+        const int n=params.n,k=params.k,r=n-k;
+        int pos[26], f=0;
+        uint32_t seen=0;
+        for(int i=0; i<n_eras; ++i)
+        {
+            const int p=eras[i];
+            if(p<0 || p>=n || (seen>>p&1u)) continue;
+            seen|=1u<<p;
+        }
+        for(int p=0; p<n; ++p) if(seen>>p&1u) pos[f++]=p;
+        if(f==0) return decode_block(inout_n,out_k);
+        if(f>r) return false;
+        GF27 S[26];
+        syndromes(inout_n,S);
+        bool all0=true;
+        for(int j=0; j<r; ++j) if(S[j]) all0=false;
+        if(!all0)
+        {
+            GF27 Vi[26*26], e[26];
+            if(!erasure_inverse_cached(pos,f,Vi)) return false;
+            for(int q=0; q<f; ++q)
             {
-                num=gf->mul(num,Xin);
-                num=gf->add(num,Omega[d]);
+                GF27 acc=0;
+                for(int j=0; j<f; ++j) acc=gf->add(acc, gf->mul(Vi[q*f+j],S[j]));
+                e[q]=acc;
             }
-            for(int d=(int)sigmap.size()-1; d>=0; --d)
+            bool ok=true;
+            for(int j=f; j<r && ok; ++j)
             {
-                den=gf->mul(den,Xin);
-                den=gf->add(den,sigmap[d]);
+                GF27 acc=0;
+                for(int q=0; q<f; ++q) acc=gf->add(acc, gf->mul(e[q], gf->tab.exp[((j+1)*pos[q])%26]));
+                ok=(acc==S[j]);
             }
-            if(den==0) return false;
-            GF27 mag=gf->mul( gf->sub((GF27)0,num), gf->inv(den) );
-            inout_n[pos]=gf->add(inout_n[pos],mag);
+            if(ok) for(int q=0; q<f; ++q) inout_n[pos[q]]=gf->sub(inout_n[pos[q]],e[q]);
+            else if(f+2>r || !decode_errors_erasures(inout_n,pos,f,S)) return false;
         }
         for(int i=0; i<k; ++i) out_k[i]=inout_n[i];
         return true;
     }
+    bool decode_errors_erasures(GF27* c, const int* pos, int f, const GF27* S) const
+    {
+        const int n=params.n,r=n-params.k;
+        // Γ(x) = Π(1 − α^p x)
+        std::vector<GF27> G(1,1);
+        for(int q=0; q<f; ++q)
+        {
+            const GF27 X=gf->tab.exp[pos[q]%26];
+            G.push_back(0);
+            for(int i=(int)G.size()-1; i>=1; --i) G[i]=gf->sub(G[i], gf->mul(G[i-1],X));
+        }
+        // Forney syndromes T = Γ·S mod x^r ; BM on T[f..r-1]
+        std::vector<GF27> T(r,0);
+        for(int i=0; i<=f; ++i) for(int j=0; i+j<r; ++j) T[i+j]=gf->add(T[i+j], gf->mul(G[i],S[j]));
+        std::vector<GF27> lam;
+        const int L=berlekamp_massey(T.data()+f,r-f,lam);
+        if(2*L+f>r) return false;
+        std::vector<GF27> psi(lam.size()+G.size()-1,0);
+        for(size_t i=0; i<lam.size(); ++i) for(size_t j=0; j<G.size(); ++j) psi[i+j]=gf->add(psi[i+j], gf->mul(lam[i],G[j]));
+        int ep[26];
+        const int ne=chien_search(psi,ep);
+        if(ne!=L+f || !forney_correct(c,S,psi,ep,ne)) return false;
+        GF27 chk[26];
+        syndromes(c,chk);
+        for(int j=0; j<r; ++j) if(chk[j]) return false;
+        return true;
+    }
 };
 
 // ---- RAW packing example (2 pixels/word) ----
@@ -1049,11 +1214,27 @@ inline bool encode_profile_from_raw(const std::vector<Word27>& in,std::vector<Wo
         return true;
     }
     std::vector<GF27> sy;
-    sy.reserve(in.size()*8);
+    sy.reserve(in.size()*9);
     std::array<UTrit,3> carry{};
     int clen=0;
-    for(const auto& w:in)
+    // 3 words = 3×26 trits = exactly 26 symbols: no carry on the bulk
+    const size_t n3=in.size()/3*3;
+    sy.resize(n3/3*26);
+    for(size_t wi=0,o=0; wi<n3; wi+=3,o+=26)
     {
+        UTrit T[81];
+        for(int q=0; q<3; ++q) for(int s=0; s<9; ++s)
+            {
+                const GF27 v=in[wi+q].sym[s];
+                T[q*26+s*3]=v%3;
+                T[q*26+s*3+1]=(v/3)%3;
+                T[q*26+s*3+2]=v/9;   // trit 26 of word q: overwritten by word q+1
+            }
+        for(int j=0; j<26; ++j) sy[o+j]=pack3(T[3*j],T[3*j+1],T[3*j+2]);
+    }
+    for(size_t wi=n3; wi<in.size(); ++wi)
+    {
+        const Word27& w=in[wi];
         std::array<UTrit,27> T{};
         for(int s=0; s<9; ++s)
         {
@@ -1085,7 +1266,11 @@ inline bool encode_profile_from_raw(const std::vector<Word27>& in,std::vector<Wo
         interleave2D_boustrophedon(sy,ectx.cfg.tile);
     }
     std::array<std::vector<GF27>,9> bands;
-    for(size_t i=0; i<sy.size(); ++i) bands[i%9].push_back(sy[i]);
+    for(int b=0; b<9; ++b)
+    {
+        bands[b].resize(sy.size()/9 + ((size_t)b<sy.size()%9 ? 1 : 0));
+        for(size_t j=0; j<bands[b].size(); ++j) bands[b][j]=sy[j*9+b];
+    }
     auto rsc_for=[&](int b)->RSCodec* { switch(ectx.cfg.uep.band_profile[b]%4)
 {
 case 0:
@@ -1098,23 +1283,38 @@ default:
     return &ectx.rs_p4;
 }
                                   };
-std::vector<GF27> body;
-for(int b=0; b<9; ++b)
+    // Full codewords only (tail < k dropped, as before); batch encoder fills
+    // [data|parity] straight into the band's slice of body.
+    size_t body_len=0;
+    for(int b=0; b<9; ++b) body_len+=(bands[b].size()/rsc_for(b)->params.k)*rsc_for(b)->params.n;
+    std::vector<GF27> body(body_len);
+    size_t off=0;
+    for(int b=0; b<9; ++b)
     {
         RSCodec* r=rsc_for(b);
         RSParams p=r->params;
-        size_t j=0;
-        while(j+p.k<=bands[b].size())
+        const size_t cw=bands[b].size()/p.k;
+        r->batch.encode(bands[b].data(),p.k,body.data()+off,p.n,cw);
+        off+=cw*p.n;
+    }
+    // scramble_symbol via tables: state step and per-trit offset
+    GF27 scr[3][27];
+    uint32_t nxt[3];
+    for(uint32_t o=0; o<3; ++o)
+    {
+        nxt[o]=((ectx.cfg.seed.a*o)+ectx.cfg.seed.b)%3;
+        for(int v=0; v<27; ++v)
         {
-            GF27 kbuf[26] {}, nbuf[26] {};
-            for(int i=0; i<p.k; ++i) kbuf[i]=bands[b][j+i];
-            r->encode_block(kbuf,nbuf);
-            for(int i=0; i<p.n; ++i) body.push_back(nbuf[i]);
-            j+=p.k;
+            auto d=unpack3((GF27)v);
+            scr[o][v]=pack3((UTrit)((d[0]+o)%3),(UTrit)((d[1]+o)%3),(UTrit)((d[2]+o)%3));
         }
     }
     uint32_t st=ectx.cfg.seed.s0%3;
-    for(auto& s:body) s=scramble_symbol(s,ectx.cfg.seed,st);
+    for(auto& s:body)
+    {
+        st=nxt[st];
+        s=scr[st][s];
+    }
     if(ectx.cfg.beacon.enabled && ectx.cfg.beacon.words_period>0)
     {
         std::vector<GF27> sy2;
@@ -1205,6 +1405,70 @@ inline bool selftest_rs_unit()
     }
     return true;
 }
+// Batched encoder vs scalar encode_block (all profiles, partial lane group)
+inline bool selftest_rs_batch()
+{
+    GF27Context gf;
+    gf.init();
+    std::mt19937 rng(7);
+    for(ProfileID pid:
+            {
+                ProfileID::P1_RS26_24,ProfileID::P2_RS26_22,ProfileID::P3_RS26_20,ProfileID::P4_RS26_18
+            })
+    {
+        RSCodec rs;
+        rs.init(&gf, rs_params_for(pid));
+        const int n=rs.params.n,k=rs.params.k;
+        const size_t cw=3*RSBatchEncoder::LANES+5;
+        std::vector<GF27> data(cw*k), ref(cw*n), got(cw*n);
+        for(auto& x:data) x=(GF27)(rng()%27);
+        for(size_t c=0; c<cw; ++c) rs.encode_block(&data[c*k],&ref[c*n]);
+        rs.batch.encode(data.data(),k,got.data(),n,cw);
+        if(got!=ref) return false;
+    }
+    return true;
+}
+// Erasures (random + bursts), mixed erasures+errors, cache reuse
+inline bool selftest_rs_erasures()
+{
+    GF27Context gf;
+    gf.init();
+    std::mt19937 rng(11);
+    for(ProfileID pid:
+            {
+                ProfileID::P1_RS26_24,ProfileID::P2_RS26_22,ProfileID::P3_RS26_20,ProfileID::P4_RS26_18
+            })
+    {
+        RSCodec rs;
+        rs.init(&gf, rs_params_for(pid));
+        const int n=rs.params.n,k=rs.params.k,r=n-k;
+        std::vector<GF27> data(k), code(n), rx(n), outk(k);
+        for(int it=0; it<200; ++it)
+        {
+            for(auto& x:data) x=(GF27)(rng()%27);
+            rs.encode_block(data.data(),code.data());
+            const int f=(int)(rng()%(r+1)), e=(r-f)/2;
+            std::vector<int> perm(n);
+            for(int i=0; i<n; ++i) perm[i]=i;
+            if(it&1)
+            {
+                const int s0=(int)(rng()%(n-f+1));
+                for(int i=0; i<n; ++i) perm[i]=(s0+i)%n;
+            }
+            else std::shuffle(perm.begin(),perm.end(),rng);
+            rx=code;
+            for(int q=0; q<f+e; ++q) rx[perm[q]]=gf.add(rx[perm[q]],(GF27)(1+rng()%26));
+            if(!rs.decode_block_erasures(rx.data(),outk.data(),perm.data(),f)) return false;
+            if(outk!=data) return false;
+        }
+        // too many erasures → failure, not garbage
+        std::vector<int> all(n);
+        for(int i=0; i<n; ++i) all[i]=i;
+        rx=code;
+        if(rs.decode_block_erasures(rx.data(),outk.data(),all.data(),r+1)) return false;
+    }
+    return true;
+}
 inline bool selftest_api_roundtrip()
 {
     std::vector<PixelYCbCrQuant> px(64);
@@ -0,0 +1,295 @@
+// ============================================================================
+//  File: src/bench_ecc.cpp
+//  ECC stress bench: encoded superframes (encode_profile_from_raw) through a
+//  noisy channel, then descramble + RS decode per codeword. Reports, per
+//  profile: decode MB/s, codeword / superframe success, miscorrections and
+//  the syndrome/BM/Chien/Forney time split.
+//  Channel (per transmitted body symbol, header not hit):
+//   --ser p        iid symbol errors (random non-zero delta)
+//   --burst p      burst start probability, --burst-len L corrupted symbols
+//   --era p        erasure start probability, --era-len L lost symbols
+//                  (positions known → decode_block_erasures)
+//  P5 = RS(26,22) + 2D tile: codewords as rows (tile.w=26), sent column by
+//  column over --depth rows, so a burst hits ≤ ceil(L/depth) symbols/cw.
+//  MB/s counts body symbols (1 byte each) through deinterleave+descramble+RS.
+//  Usage: bench_ecc [--words 8192] [--frames 8] [--ser 0.002] [--burst 0]
+//         [--burst-len 16] [--era 0] [--era-len 8] [--depth 26] [--seed 1]
+//         [--profiles 1,2,3,4,5] [--csv]
+//  Build: g++ -std=c++17 -O2 -Iinclude src/bench_ecc.cpp -o bench_ecc
+// ============================================================================
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include "ternary_image_codec_v6_min.hpp"
+
+struct BenchCfg
+{
+    size_t words=8192, frames=8;
+    double ser=0.002, burst=0, era=0;
+    int burst_len=16, era_len=8, depth=26;
+    uint32_t seed=1;
+    std::vector<int> profiles{1,2,3,4,5};
+    bool csv=false;
+};
+struct BenchRow
+{
+    std::string name;
+    uint64_t syms=0, cw=0, cw_ok=0, cw_fail=0, cw_mis=0, sf=0, sf_ok=0;
+    double dec_s=0, t_syn=0, t_bm=0, t_chien=0, t_forney=0, t_eras=0;
+};
+using BClock=std::chrono::steady_clock;
+static double secs(BClock::time_point a,BClock::time_point b)
+{
+    return std::chrono::duration<double>(b-a).count();
+}
+
+// Body layout of encode_profile_from_raw: bands 0..8 back to back, full codewords
+static std::vector<RSCodec*> body_codecs(size_t raw_words,EncoderContext& e)
+{
+    const size_t nsy=(raw_words*26+2)/3;
+    std::vector<RSCodec*> cws;
+    for(int b=0; b<9; ++b)
+    {
+        RSCodec* r=(e.cfg.uep.band_profile[b]%4==0)?&e.rs_p1:(e.cfg.uep.band_profile[b]%4==1)?&e.rs_p2:
+                   (e.cfg.uep.band_profile[b]%4==2)?&e.rs_p3:&e.rs_p4;
+        const size_t len=nsy/9+((size_t)b<nsy%9?1:0);
+        cws.insert(cws.end(),len/r->params.k,r);
+    }
+    return cws;
+}
+// Codeword-column interleave: symbol i of cw c (group of `depth`) → i*D+c
+static void tile_perm(size_t ncw,int depth,std::vector<uint32_t>& tx_of)
+{
+    tx_of.resize(ncw*26);
+    for(size_t g0=0; g0<ncw; g0+=depth)
+    {
+        const size_t D=std::min<size_t>(depth,ncw-g0);
+        for(size_t c=0; c<D; ++c) for(int i=0; i<26; ++i) tx_of[(g0+c)*26+i]=(uint32_t)(g0*26+i*D+c);
+    }
+}
+
+static void run_profile(int pid,const BenchCfg& bc,BenchRow& row)
+{
+    EncoderContext e;
+    const bool tile=(pid==5);
+    e.cfg.profile=tile?ProfileID::P5_RS26_22_2D:(ProfileID)(pid-1);
+    uep_uniform(e.cfg.uep,(uint8_t)(tile?1:pid-1));
+    row.name=tile?"P5_RS26_22_2D":(pid==1?"P1_RS26_24":pid==2?"P2_RS26_22":pid==3?"P3_RS26_20":"P4_RS26_18");
+    if(tile) row.name+="/d"+std::to_string(bc.depth);
+    std::mt19937 rng(bc.seed*977u+(uint32_t)pid);
+    std::uniform_real_distribution<double> U(0.0,1.0);
+    const std::vector<RSCodec*> cws=body_codecs(bc.words,e);
+    const size_t ncw=cws.size(), nb=ncw*26;
+    std::vector<uint32_t> tx_of;
+    if(tile) tile_perm(ncw,bc.depth,tx_of);
+    // descramble tables (inverse of scramble_symbol, same state walk)
+    GF27 dsc[3][27];
+    uint32_t nxt[3];
+    for(uint32_t o=0; o<3; ++o)
+    {
+        nxt[o]=((e.cfg.seed.a*o)+e.cfg.seed.b)%3;
+        for(int v=0; v<27; ++v)
+        {
+            auto d=unpack3((GF27)v);
+            dsc[o][v]=pack3((UTrit)((d[0]+3-o)%3),(UTrit)((d[1]+3-o)%3),(UTrit)((d[2]+3-o)%3));
+        }
+    }
+    std::vector<Word27> raw(bc.words), prof;
+    std::vector<GF27> ref(nb), clean(nb), rx(nb), cw(nb), stage(nb);
+    std::vector<uint8_t> lost(nb), lost_cw(nb);
+    for(size_t f=0; f<bc.frames; ++f)
+    {
+        for(auto& w:raw) for(auto& s:w.sym) s=(GF27)(rng()%27);
+        encode_profile_from_raw(raw,prof,e);
+        for(size_t i=0, st=e.cfg.seed.s0%3; i<nb; ++i)
+        {
+            ref[i]=prof[(52+i)/9].sym[(52+i)%9];
+            st=nxt[st];
+            clean[i]=dsc[st][ref[i]];
+        }
+        // transmit order
+        if(tile) for(size_t i=0; i<nb; ++i) rx[tx_of[i]]=ref[i];
+        else rx=ref;
+        std::fill(lost.begin(),lost.end(),0);
+        for(size_t i=0; i<nb; ++i)
+        {
+            if(bc.ser>0 && U(rng)<bc.ser) rx[i]=(GF27)((rx[i]+1+rng()%26)%27);
+            if(bc.burst>0 && U(rng)<bc.burst)
+                for(size_t j=i; j<std::min(nb,i+(size_t)bc.burst_len); ++j) rx[j]=(GF27)((rx[j]+1+rng()%26)%27);
+            if(bc.era>0 && U(rng)<bc.era)
+                for(size_t j=i; j<std::min(nb,i+(size_t)bc.era_len); ++j)
+                {
+                    lost[j]=1;
+                    rx[j]=0;
+                }
+        }
+        // ---- timed decode ----
+        std::vector<GF27> outk(26);
+        uint64_t ok=0, fail=0, mis=0;
+        const auto t0=BClock::now();
+        if(tile) for(size_t i=0; i<nb; ++i)
+            {
+                cw[i]=rx[tx_of[i]];
+                lost_cw[i]=lost[tx_of[i]];
+            }
+        else
+        {
+            std::memcpy(cw.data(),rx.data(),nb);
+            std::memcpy(lost_cw.data(),lost.data(),nb);
+        }
+        uint32_t st=e.cfg.seed.s0%3;
+        for(size_t i=0; i<nb; ++i)
+        {
+            st=nxt[st];
+            cw[i]=dsc[st][cw[i]];
+        }
+        std::memcpy(stage.data(),cw.data(),nb);
+        int eras[26];
+        for(size_t c=0; c<ncw; ++c)
+        {
+            GF27* v=&cw[c*26];
+            int ne=0;
+            for(int i=0; i<26; ++i) if(lost_cw[c*26+i]) eras[ne++]=i;
+            const bool res=ne?cws[c]->decode_block_erasures(v,outk.data(),eras,ne):cws[c]->decode_block(v,outk.data());
+            if(!res) ++fail;
+            else if(std::memcmp(v,&clean[c*26],26)) ++mis;
+            else ++ok;
+        }
+        const auto t1=BClock::now();
+        row.dec_s+=secs(t0,t1);
+        // ---- stage split on the same received codewords ----
+        // errors-only stages (decode_block path); erasure codewords timed apart
+        std::vector<GF27> S((size_t)ncw*26);
+        std::vector<uint8_t> dirty(ncw,0);
+        auto a=BClock::now();
+        for(size_t c=0; c<ncw; ++c)
+        {
+            cws[c]->syndromes(&stage[c*26],&S[c*26]);
+            for(int j=0; j<26-cws[c]->params.k; ++j) dirty[c]|=(S[c*26+j]!=0);
+        }
+        auto b=BClock::now();
+        row.t_syn+=secs(a,b);
+        std::vector<std::vector<GF27>> sig(ncw);
+        std::vector<int> L(ncw,0), np(ncw,0), pos(ncw*26);
+        a=BClock::now();
+        for(size_t c=0; c<ncw; ++c)
+        {
+            bool er=false;
+            for(int i=0; i<26; ++i) er|=(lost_cw[c*26+i]!=0);
+            if(er)
+            {
+                dirty[c]=2;
+                continue;
+            }
+            if(dirty[c]) L[c]=cws[c]->berlekamp_massey(&S[c*26],26-cws[c]->params.k,sig[c]);
+        }
+        b=BClock::now();
+        row.t_bm+=secs(a,b);
+        a=BClock::now();
+        for(size_t c=0; c<ncw; ++c) if(dirty[c]==1) np[c]=cws[c]->chien_search(sig[c],&pos[c*26]);
+        b=BClock::now();
+        row.t_chien+=secs(a,b);
+        a=BClock::now();
+        for(size_t c=0; c<ncw; ++c)
+            if(dirty[c]==1 && np[c]==L[c] && 2*L[c]<=26-cws[c]->params.k)
+                cws[c]->forney_correct(&stage[c*26],&S[c*26],sig[c],&pos[c*26],np[c]);
+        b=BClock::now();
+        row.t_forney+=secs(a,b);
+        a=BClock::now();
+        for(size_t c=0; c<ncw; ++c) if(dirty[c]==2)
+            {
+                int ne=0;
+                for(int i=0; i<26; ++i) if(lost_cw[c*26+i]) eras[ne++]=i;
+                cws[c]->decode_block_erasures(&stage[c*26],outk.data(),eras,ne);
+            }
+        b=BClock::now();
+        row.t_eras+=secs(a,b);
+        row.syms+=nb;
+        row.cw+=ncw;
+        row.cw_ok+=ok;
+        row.cw_fail+=fail;
+        row.cw_mis+=mis;
+        row.sf+=1;
+        row.sf_ok+=(ok==ncw);
+    }
+}
+
+static bool parse_profiles(const char* s,std::vector<int>& out)
+{
+    out.clear();
+    for(const char* p=s; *p;)
+    {
+        char* end=nullptr;
+        const long v=std::strtol(p,&end,10);
+        if(end==p || v<1 || v>5) return false;
+        out.push_back((int)v);
+        p=(*end==',')?end+1:end;
+        if(*end && *end!=',') return false;
+    }
+    return !out.empty();
+}
+
+int main(int argc,char** argv)
+{
+    BenchCfg bc;
+    for(int i=1; i<argc; ++i)
+    {
+        const std::string a=argv[i];
+        const bool has=(i+1<argc);
+        if(a=="--words" && has) bc.words=(size_t)std::max(3L,std::atol(argv[++i]));
+        else if(a=="--frames" && has) bc.frames=(size_t)std::max(1L,std::atol(argv[++i]));
+        else if(a=="--ser" && has) bc.ser=std::atof(argv[++i]);
+        else if(a=="--burst" && has) bc.burst=std::atof(argv[++i]);
+        else if(a=="--burst-len" && has) bc.burst_len=std::max(1,std::atoi(argv[++i]));
+        else if(a=="--era" && has) bc.era=std::atof(argv[++i]);
+        else if(a=="--era-len" && has) bc.era_len=std::max(1,std::atoi(argv[++i]));
+        else if(a=="--depth" && has) bc.depth=std::max(1,std::atoi(argv[++i]));
+        else if(a=="--seed" && has) bc.seed=(uint32_t)std::strtoul(argv[++i],nullptr,10);
+        else if(a=="--profiles" && has)
+        {
+            if(!parse_profiles(argv[++i],bc.profiles))
+            {
+                std::fprintf(stderr,"bad --profiles (expected e.g. 1,2,5)\n");
+                return 2;
+            }
+        }
+        else if(a=="--csv") bc.csv=true;
+        else
+        {
+            std::fprintf(stderr,"Usage: %s [--words 8192] [--frames 8] [--ser 0.002] [--burst 0] [--burst-len 16]\n"
+                         "       [--era 0] [--era-len 8] [--depth 26] [--seed 1] [--profiles 1,2,3,4,5] [--csv]\n",argv[0]);
+            return 2;
+        }
+    }
+    if(bc.csv) std::printf("profile,MBps,cw,cw_ok_pct,cw_fail,cw_mis,sf_ok_pct,syn_pct,bm_pct,chien_pct,forney_pct,eras_pct\n");
+    else
+    {
+        std::printf("channel: ser=%g burst=%g x%d era=%g x%d | %zu words x %zu frames\n",
+                    bc.ser,bc.burst,bc.burst_len,bc.era,bc.era_len,bc.words,bc.frames);
+        std::printf("%-20s %8s %9s %8s %7s %6s %7s | %5s %5s %5s %6s %5s\n","profile","MB/s","cw","cw_ok%","fail","mis","sf_ok%",
+                    "syn%","bm%","chien%","forney%","eras%");
+    }
+    for(int pid:bc.profiles)
+    {
+        BenchRow r;
+        run_profile(pid,bc,r);
+        const double mbps=r.dec_s>0?r.syms/r.dec_s/1e6:0;
+        const double st=r.t_syn+r.t_bm+r.t_chien+r.t_forney+r.t_eras;
+        auto pc=[&](double x)
+        {
+            return st>0?100.0*x/st:0.0;
+        };
+        const double okp=r.cw?100.0*r.cw_ok/r.cw:0, sfp=r.sf?100.0*r.sf_ok/r.sf:0;
+        if(bc.csv)
+            std::printf("%s,%.2f,%llu,%.4f,%llu,%llu,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f\n",r.name.c_str(),mbps,(unsigned long long)r.cw,okp,
+                        (unsigned long long)r.cw_fail,(unsigned long long)r.cw_mis,sfp,pc(r.t_syn),pc(r.t_bm),pc(r.t_chien),pc(r.t_forney),pc(r.t_eras));
+        else
+            std::printf("%-20s %8.2f %9llu %8.4f %7llu %6llu %7.2f | %5.1f %5.1f %6.1f %7.1f %5.1f\n",r.name.c_str(),mbps,(unsigned long long)r.cw,okp,
+                        (unsigned long long)r.cw_fail,(unsigned long long)r.cw_mis,sfp,pc(r.t_syn),pc(r.t_bm),pc(r.t_chien),pc(r.t_forney),pc(r.t_eras));
+    }
+    return 0;
+}
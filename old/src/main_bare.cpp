@@ -5,4 +5,4 @@
 #include <cstdio>
 #include "ternary_image_codec_v6_min.hpp"
 
-int main(){ bool ok1=selftest_rs_unit(); bool ok2=selftest_api_roundtrip(); std::printf("RS:%s API:%s\n", ok1?"OK":"FAIL", ok2?"OK":"FAIL"); return (ok1&&ok2)?0:1; }
+int main(){ bool ok1=selftest_rs_unit(); bool ok2=selftest_api_roundtrip(); bool ok3=selftest_rs_batch(); bool ok4=selftest_rs_erasures(); std::printf("RS:%s API:%s RSBATCH:%s RSERAS:%s\n", ok1?"OK":"FAIL", ok2?"OK":"FAIL", ok3?"OK":"FAIL", ok4?"OK":"FAIL"); return (ok1&&ok2&&ok3&&ok4)?0:1; }
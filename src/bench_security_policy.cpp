@@ -0,0 +1,370 @@
+// ============================================================================
+//  File: src/bench_security_policy.cpp  Dbit du moteur d'approbation (DOC+)
+//  Project: Ternary Image/Video Codec v6
+//
+//  OBJET
+//  -----
+//   Mesurer les dcisions/s du moteur T3Security (meta-only) : politiques
+//    synthtiques de 10  100k rgles (memberships / coexist / redirects) et
+//    corpus de mta varies (domaines, profondeur, champs route plats ou
+//    imbriqus, JSON et TLV).
+//   Oprations chronomtres : decide_ex (JSON, TLV), t3p/t3v_approve_with_policy,
+//    mutations de mta T3Route (PREP, ACCEPT, mark_sandbox).
+//   Par opration : dcisions/s, latence p50/p99 (ns), allocations/dcision.
+//
+//  USAGE
+//  -----
+//   ./bench_security_policy [--rules 10,100,1000,10000,100000] [--metas 2000]
+//                           [--ms 300] [--seed 1] [--json]
+//
+//  BUILD (exemple)
+//  ---------------
+//   g++ -std=c++17 -O2 -Iinclude src/bench_security_policy.cpp -o bench_security_policy
+//
+//  NOTES
+//  -----
+//   * Dbit : boucle serre sur le corpus pendant --ms ms (au moins un passage).
+//   * Latence : passe spare, un appel chronomtr  la fois (steady_clock,
+//     cot de l'horloge inclus, ~20-30 ns) ; 200  20000 chantillons selon --ms.
+//   * Allocations : operator new global compt (mono-thread).
+//   * decide_ex fait tourner le rotor / le cache de prparation de la
+//     politique : chaque opration part d'une copie frache.
+//   * Rpartition du corpus : 1/4 membres, 1/4 coexistants, 1/4 redirigs
+//     (route_ttl > 0), 1/4 inconnus partageant une racine (superposition).
+// ============================================================================
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <new>
+
+#include "security_policy.hpp"
+#include "security_route_helper.hpp"
+#include "t3_meta.hpp"
+
+using namespace T3Security;
+
+// ------------------------- Comptage des allocations ---------------------------
+// Toutes les formes remplaces (scalaire / tableau, taille, aligne) sur
+// malloc / aligned_alloc + free. Les delete ne sont pas inlins : GCC y
+// verrait free() face  operator new (-Wmismatched-new-delete).
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static uint64_t g_allocs = 0;
+
+static void* counted_alloc(std::size_t n)
+{
+    ++g_allocs;
+    if(void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+static void* counted_alloc(std::size_t n, std::align_val_t al)
+{
+    ++g_allocs;
+    const std::size_t a = std::max<std::size_t>((std::size_t)al, sizeof(void*));
+    if(void* p = std::aligned_alloc(a, (n + a - 1) / a * a + (n ? 0 : a))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n)                        { return counted_alloc(n); }
+void* operator new[](std::size_t n)                      { return counted_alloc(n); }
+void* operator new(std::size_t n, std::align_val_t a)    { return counted_alloc(n, a); }
+void* operator new[](std::size_t n, std::align_val_t a)  { return counted_alloc(n, a); }
+
+BENCH_NOINLINE void operator delete(void* p) noexcept                                      { std::free(p); }
+BENCH_NOINLINE void operator delete[](void* p) noexcept                                    { std::free(p); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t) noexcept                         { std::free(p); }
+BENCH_NOINLINE void operator delete[](void* p, std::size_t) noexcept                       { std::free(p); }
+BENCH_NOINLINE void operator delete(void* p, std::align_val_t) noexcept                    { std::free(p); }
+BENCH_NOINLINE void operator delete[](void* p, std::align_val_t) noexcept                  { std::free(p); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t) noexcept       { std::free(p); }
+BENCH_NOINLINE void operator delete[](void* p, std::size_t, std::align_val_t) noexcept     { std::free(p); }
+
+// ------------------------------ Gnration ------------------------------------
+static constexpr int kRoots = 64;
+
+static std::string hex_prefix(std::mt19937_64& rng, int n)
+{
+    static const char* H = "0123456789abcdef";
+    std::string s;
+    for(int i=0; i<n; ++i) s.push_back(H[rng() & 15]);
+    return s;
+}
+
+// Tiers : N/3 memberships, N/3 coexist, le reste en redirects
+static Policy make_policy(size_t n_rules, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    Policy P = Policy::make_default();
+    const size_t nm = n_rules/3, nc = n_rules/3, nr = n_rules - nm - nc;
+    P.memberships.reserve(nm);
+    for(size_t i=0; i<nm; ++i)
+        P.memberships.push_back({"org"+std::to_string(i%kRoots)+"/s"+std::to_string(i)+"/", hex_prefix(rng, 2), 0});
+    P.coexist_allow.reserve(nc);
+    for(size_t i=0; i<nc; ++i)
+        P.coexist_allow.push_back({"ext"+std::to_string(i%kRoots)+"/s"+std::to_string(i)+"/", "", 500, ProxClass::Near});
+    P.redirects.reserve(nr);
+    for(size_t i=0; i<nr; ++i)
+        P.redirects.push_back({"rd"+std::to_string(i%kRoots)+"/s"+std::to_string(i)+"/", "org"+std::to_string(i%kRoots)+"/", 1, 3});
+    P.max_depth = 6;
+    return P;
+}
+
+static std::string route_fields(std::mt19937_64& rng, unsigned ttl)
+{
+    const unsigned hops = (unsigned)(rng()%3), phase = (unsigned)(rng()%2);
+    switch(rng()%3)
+    {
+    case 0:
+        return ttl ? ", \"route_ttl\": "+std::to_string(ttl) : std::string();
+    case 1:
+        return ", \"route_ttl\": "+std::to_string(ttl)+", \"route_hops\": "+std::to_string(hops)
+               +", \"route_phase\": "+std::to_string(phase)+", \"origin\": \"gw"+std::to_string(rng()%16)+"\"";
+    default:
+        return ", \"route\": { \"ttl\": "+std::to_string(ttl)+", \"hops\": "+std::to_string(hops)
+               +", \"phase\": "+std::to_string(phase)+", \"origin\": \"gw"+std::to_string(rng()%16)+"\" }";
+    }
+}
+
+static std::vector<std::string> make_corpus(const Policy& P, size_t n, uint64_t seed)
+{
+    static const char* kClass[] = { "local", "near", "far", "unknown" };
+    std::mt19937_64 rng(seed ^ 0x5EC0A11CE5ull);
+    std::vector<std::string> out;
+    out.reserve(n);
+    for(size_t i=0; i<n; ++i)
+    {
+        std::string domain, hash = hex_prefix(rng, 16);
+        unsigned ttl = 0;
+        const int kind = (int)(i % 4);
+        if(kind==0 && !P.memberships.empty())
+        {
+            const auto& m = P.memberships[(size_t)(rng() % P.memberships.size())];
+            domain = m.domain_prefix;
+            hash = m.hash_prefix_hex + hash.substr(m.hash_prefix_hex.size());
+        }
+        else if(kind==1 && !P.coexist_allow.empty())
+            domain = P.coexist_allow[(size_t)(rng() % P.coexist_allow.size())].domain_prefix;
+        else if(kind==2 && !P.redirects.empty())
+        {
+            domain = P.redirects[(size_t)(rng() % P.redirects.size())].from_domain_prefix;
+            ttl = 1 + (unsigned)(rng()%3);
+        }
+        else
+        {
+            domain = "org"+std::to_string(rng()%kRoots)+"/x"+std::to_string(rng()%1000)+"/";
+            ttl = (unsigned)(rng()%3);
+        }
+        const int extra = (int)(rng()%4); // profondeur 2..5
+        for(int d=0; d<extra; ++d) domain += "n"+std::to_string(rng()%100)+"/";
+        domain += "cam"+std::to_string(rng()%50);
+
+        std::string js = "{ \"domain\": \""+domain+"\", \"build_hash\": \""+hash+"\", \"version\": "
+                         +std::to_string(1+rng()%9)+", \"class\": \""+kClass[rng()%4]+"\", \"radius_m\": "
+                         +std::to_string(rng()%800);
+        if(rng()%2) js += ", \"type_hash\": \"fnv64:"+hex_prefix(rng, 16)+"\"";
+        js += route_fields(rng, ttl);
+        if(rng()%4==0) js += ", \"note\": \"capture "+std::to_string(rng()%10000)+"\"";
+        js += " }";
+        out.push_back(std::move(js));
+    }
+    return out;
+}
+
+// ------------------------------- Mesure ---------------------------------------
+struct OpResult
+{
+    std::string op;
+    size_t rules = 0;
+    uint64_t calls = 0;
+    double seconds = 0.0;
+    double p50_ns = 0.0, p99_ns = 0.0;
+    double allocs_per_call = 0.0;
+    double per_s() const { return seconds>0.0 ? (double)calls/seconds : 0.0; }
+};
+
+static volatile uint64_t g_sink = 0;
+
+template<class Fn>
+static OpResult run_op(const char* name, size_t rules, size_t n, double budget_ms, Fn&& fn)
+{
+    using clk = std::chrono::steady_clock;
+    OpResult R;
+    R.op = name;
+    R.rules = rules;
+    uint64_t sink = 0;
+
+    // Dbit + allocations (au moins un passage complet sur le corpus)
+    const uint64_t a0 = g_allocs;
+    const auto t0 = clk::now();
+    double el = 0.0;
+    do
+    {
+        for(size_t i=0; i<n; ++i) sink += fn(i);
+        R.calls += n;
+        el = std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+    }
+    while(el < budget_ms);
+    R.seconds = el * 1e-3;
+    R.allocs_per_call = (double)(g_allocs - a0) / (double)R.calls;
+
+    // Latence : un appel chronomtr  la fois, budget spar
+    std::vector<double> lat;
+    lat.reserve(std::min<size_t>(n*4, 20000));
+    const auto t1 = clk::now();
+    for(size_t k=0; lat.size()<lat.capacity(); ++k)
+    {
+        const auto s = clk::now();
+        sink += fn(k % n);
+        lat.push_back(std::chrono::duration<double, std::nano>(clk::now() - s).count());
+        if(lat.size() >= 200 && std::chrono::duration<double, std::milli>(clk::now() - t1).count() > budget_ms) break;
+    }
+    std::sort(lat.begin(), lat.end());
+    if(!lat.empty())
+    {
+        R.p50_ns = lat[lat.size()/2];
+        R.p99_ns = lat[std::min(lat.size()-1, (size_t)(lat.size()*0.99))];
+    }
+    g_sink = g_sink + sink;
+    return R;
+}
+
+static bool parse_list(const char* s, std::vector<size_t>& out)
+{
+    out.clear();
+    while(*s)
+    {
+        char* e = nullptr;
+        const unsigned long long v = std::strtoull(s, &e, 10);
+        if(e==s || v==0) return false;
+        out.push_back((size_t)v);
+        s = (*e==',') ? e+1 : e;
+        if(*e && *e!=',') return false;
+    }
+    return !out.empty();
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> rules_list = { 10, 100, 1000, 10000, 100000 };
+    size_t n_metas = 2000;
+    double budget_ms = 300.0;
+    uint64_t seed = 1;
+    bool json = false;
+    for(int i=1; i<argc; ++i)
+    {
+        const std::string a = argv[i];
+        if(a=="--rules" && i+1<argc)
+        {
+            if(!parse_list(argv[++i], rules_list))
+            {
+                std::cerr<<"[bench] --rules expects N[,N...]\n";
+                return 2;
+            }
+        }
+        else if(a=="--metas" && i+1<argc) n_metas = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if(a=="--ms" && i+1<argc) budget_ms = std::max(1.0, std::atof(argv[++i]));
+        else if(a=="--seed" && i+1<argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if(a=="--json") json = true;
+        else
+        {
+            std::cerr<<"Usage: "<<argv[0]<<" [--rules 10,100,1000,10000,100000] [--metas 2000] [--ms 300] [--seed 1] [--json]\n";
+            return 2;
+        }
+    }
+
+    std::vector<OpResult> all;
+    for(size_t nr : rules_list)
+    {
+        const Policy base = make_policy(nr, seed);
+        const std::vector<std::string> corpus = make_corpus(base, n_metas, seed + nr);
+        std::vector<std::string> tlv(corpus.size());
+        for(size_t i=0; i<corpus.size(); ++i)
+            if(!T3Meta::encode_json(corpus[i], tlv[i])) tlv[i] = corpus[i];
+        const size_t n = corpus.size();
+
+        {
+            Policy P = base;
+            all.push_back(run_op("decide_ex/json", nr, n, budget_ms, [&](size_t i)
+            {
+                return (uint64_t)decide_ex(P, corpus[i]).decision;
+            }));
+        }
+        {
+            Policy P = base;
+            all.push_back(run_op("decide_ex/tlv", nr, n, budget_ms, [&](size_t i)
+            {
+                return (uint64_t)decide_ex(P, tlv[i]).decision;
+            }));
+        }
+        {
+            Policy P = base;
+            all.push_back(run_op("t3p_approve", nr, n, budget_ms, [&](size_t i)
+            {
+                return (uint64_t)t3p_approve_with_policy(corpus[i].c_str(), &P);
+            }));
+        }
+        {
+            Policy P = base;
+            all.push_back(run_op("t3v_approve", nr, n, budget_ms, [&](size_t i)
+            {
+                return (uint64_t)t3v_approve_with_policy((uint64_t)i, corpus[i].c_str(), &P);
+            }));
+        }
+        std::string out;
+        all.push_back(run_op("route_prep", nr, n, budget_ms, [&](size_t i)
+        {
+            return (uint64_t)T3Route::prepare_redirect_meta_prep(corpus[i], "gw0/", 2, out) + out.size();
+        }));
+        all.push_back(run_op("route_accept", nr, n, budget_ms, [&](size_t i)
+        {
+            return (uint64_t)T3Route::prepare_redirect_meta_accept(corpus[i], "gw0/", "org1/", 1, out) + out.size();
+        }));
+        all.push_back(run_op("mark_sandbox", nr, n, budget_ms, [&](size_t i)
+        {
+            out = corpus[i];
+            T3Route::mark_sandbox(out);
+            return (uint64_t)out.size();
+        }));
+    }
+
+    if(json)
+    {
+        std::cout<<"{\n  \"metas\": "<<n_metas<<", \"budget_ms\": "<<budget_ms<<", \"seed\": "<<seed<<",\n  \"results\": [\n";
+        for(size_t i=0; i<all.size(); ++i)
+        {
+            const OpResult& r = all[i];
+            std::cout<<"    { \"op\": \""<<r.op<<"\", \"rules\": "<<r.rules<<", \"calls\": "<<r.calls
+                     <<", \"per_s\": "<<std::fixed<<std::setprecision(0)<<r.per_s()
+                     <<", \"p50_ns\": "<<r.p50_ns<<", \"p99_ns\": "<<r.p99_ns
+                     <<", \"allocs_per_call\": "<<std::setprecision(2)<<r.allocs_per_call<<" }"
+                     <<(i+1<all.size()? ",":"")<<"\n";
+        }
+        std::cout<<"  ]\n}\n";
+        return 0;
+    }
+    std::cout<<"metas="<<n_metas<<"  budget="<<budget_ms<<" ms  seed="<<seed<<"\n"
+             <<std::left<<std::setw(8)<<"rules"<<std::setw(16)<<"op"
+             <<std::right<<std::setw(14)<<"calls/s"<<std::setw(12)<<"p50 ns"<<std::setw(12)<<"p99 ns"
+             <<std::setw(12)<<"allocs"<<"\n";
+    for(const OpResult& r : all)
+    {
+        std::cout<<std::left<<std::setw(8)<<r.rules<<std::setw(16)<<r.op
+                 <<std::right<<std::fixed<<std::setprecision(0)<<std::setw(14)<<r.per_s()
+                 <<std::setw(12)<<r.p50_ns<<std::setw(12)<<r.p99_ns
+                 <<std::setprecision(2)<<std::setw(12)<<r.allocs_per_call<<"\n";
+    }
+    return 0;
+}
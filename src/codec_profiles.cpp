@@ -4,10 +4,16 @@
 // ============================================================================
 
 #include "codec_profiles.hpp"
+#include "io_image.hpp"   // ImageU8
+#include "io_t3proto.hpp" // t3proto::meta_find_int
+
+#include <sstream>
+#include <algorithm>
 
 // Profils compilables (au choix, OFF par dfaut)
 #ifdef PROTO_HAAR_TERNARY
 #include "proto_noentropy.hpp"
+#include "proto_temporal.hpp"
 #endif
 #ifdef PROTO_ANISO_RC
 #include "proto_aniso_rc.hpp"
@@ -38,6 +44,205 @@ bool has_profile(ProtoProfile p)
         return false;
     }
 }
+
+#ifdef PROTO_HAAR_TERNARY
+ProtoParams haar_params(const ProtoConfig& cfg)
+{
+    ProtoParams P; // dfauts du proto_noentropy
+    if(cfg.haar_tile        > 0) P.tile        = cfg.haar_tile;
+    if(cfg.haar_thresh      > 0) P.thresh      = cfg.haar_thresh;
+    if(cfg.haar_sketchSize  > 0) P.sketchSize  = cfg.haar_sketchSize;
+    if(cfg.haar_sketchDown  > 0) P.sketchDown  = cfg.haar_sketchDown;
+    if(cfg.haar_radialBins  > 0) P.radialBins  = cfg.haar_radialBins;
+    if(cfg.haar_angleBins   > 0) P.angleBins   = cfg.haar_angleBins;
+    P.keep_LL_u8 = cfg.haar_keep_LL_u8;
+    return P;
+}
+void haar_params_json(std::ostream& m, const ProtoParams& P)
+{
+    m << "\"proto\":\"HaarTernary\","
+      << "\"version\":\"" << kVer_Haar << "\","
+      << "\"params\":{"
+      << "\"tile\":"<<P.tile<<",\"thresh\":"<<P.thresh<<","
+      << "\"sketchSize\":"<<P.sketchSize<<",\"sketchDown\":"<<P.sketchDown<<","
+      << "\"radialBins\":"<<P.radialBins<<",\"angleBins\":"<<P.angleBins<<","
+      << "\"keep_LL_u8\":"<<(P.keep_LL_u8? "true":"false")
+      << "},";
+}
+#endif
+#ifdef PROTO_ANISO_RC
+AnisoRCParams rc_params(const ProtoConfig& cfg)
+{
+    AnisoRCParams P;
+    if(cfg.rc_block   > 0)   P.block  = cfg.rc_block;
+    if(cfg.rc_angles  > 0)   P.angles = cfg.rc_angles;
+    if(cfg.rc_tern_z  > 0.f) P.tern_thresh_z = cfg.rc_tern_z;
+    P.keep_LL_u8  = cfg.rc_keep_LL_u8;
+    P.normalize_proj = cfg.rc_normalize;
+    if(cfg.rc_quadtree)
+    {
+        P.quadtree = true;
+        if(cfg.rc_qt_max > 0)   P.qt_max = cfg.rc_qt_max;
+        if(cfg.rc_qt_min > 0)   P.qt_min = cfg.rc_qt_min;
+        if(cfg.rc_qt_var > 0.f) P.qt_var_thresh = cfg.rc_qt_var;
+        // qt_max = qt_min x 2^k ; sinon on retombe sur le dfaut 64->16
+        int n = P.qt_max;
+        while(n > P.qt_min && (n & 1)==0) n >>= 1;
+        if(P.qt_min < 4 || n != P.qt_min)
+        {
+            P.qt_max = AnisoRCParams{}.qt_max;
+            P.qt_min = AnisoRCParams{}.qt_min;
+        }
+        P.block = P.qt_max; // padding  la racine
+    }
+    return P;
+}
+void rc_params_json(std::ostream& m, const AnisoRCParams& P)
+{
+    m << "\"proto\":\"AnisoRC\","
+      << "\"version\":\"" << kVer_Aniso << "\","
+      << "\"params\":{"
+      << "\"block\":"<<P.block<<",\"angles\":"<<P.angles<<","
+      << "\"z_thresh\":"<<P.tern_thresh_z<<","
+      << "\"keep_LL_u8\":"<<(P.keep_LL_u8? "true":"false")<<","
+      << "\"normalize_proj\":"<<(P.normalize_proj? "true":"false");
+    if(P.quadtree)
+        m << ",\"quadtree\":true,\"qt_max\":"<<P.qt_max<<",\"qt_min\":"<<P.qt_min
+          << ",\"qt_var\":"<<P.qt_var_thresh;
+    m << "},";
+}
+// Paramtres de dcodage AnisoRC depuis la meta (bloc fixe ou quadtree)
+AnisoRCParams rc_params_from_meta(const std::string& meta_json)
+{
+    AnisoRCParams P;
+    uint64_t block=0, angles=0, qmax=0, qmin=0, lt=0;
+    if(t3proto::meta_find_int(meta_json, "block",  block)  && block>=2) P.block  = (int)block;
+    if(t3proto::meta_find_int(meta_json, "angles", angles) && angles>0) P.angles = (int)angles;
+    if(t3proto::meta_find_int(meta_json, "len_tree", lt))
+    {
+        P.quadtree = true;
+        if(t3proto::meta_find_int(meta_json, "qt_max", qmax) && qmax>=2) P.qt_max = (int)qmax;
+        if(t3proto::meta_find_int(meta_json, "qt_min", qmin) && qmin>=2) P.qt_min = (int)qmin;
+    }
+    return P;
+}
+#endif
+
+#if defined(PROTO_HAAR_TERNARY) || defined(PROTO_ANISO_RC)
+// Contrle de dbit : cible de trits non nuls sur n dtails
+struct RateCtl
+{
+    bool     active = false;
+    uint64_t target = 0, nnz = 0, n = 0;
+};
+RateCtl rate_ctl(const ProtoConfig& cfg, size_t n_details)
+{
+    RateCtl R;
+    R.n = n_details;
+    if(cfg.target_nnz > 0)
+    {
+        R.active = true;
+        R.target = std::min<uint64_t>(cfg.target_nnz, n_details);
+    }
+    else if(cfg.target_density > 0.f)
+    {
+        R.active = true;
+        R.target = (uint64_t)(std::min(1.0, (double)cfg.target_density) * (double)n_details + 0.5);
+    }
+    return R;
+}
+void rate_json(std::ostream& m, const RateCtl& R)
+{
+    if(!R.active) return;
+    m << "\"rate\":{"
+      << "\"target_nnz\":"<<R.target<<",\"nnz\":"<<R.nnz<<",\"n_details\":"<<R.n<<","
+      << "\"density\":"<<(R.n? (double)R.nnz/(double)R.n : 0.0)
+      << "},";
+}
+#endif
+
+#ifdef PROTO_HAAR_TERNARY
+// Tuiles Haar -> A.tile_trits ; seuil choisi (dbit cible) report dans P.thresh
+RateCtl haar_tiles(const ImageU8& rgb, const ProtoConfig& cfg, ProtoParams& P, ProtoArtifacts& A)
+{
+    std::vector<int> coeffs;
+    proto_tile_haar_coeffs(rgb, P, A, coeffs);
+    RateCtl R = rate_ctl(cfg, coeffs.size());
+    if(R.active) P.thresh = proto_haar_thresh_for_nnz(coeffs, R.target);
+    R.nnz = proto_haar_ternarize_coeffs(coeffs, P.thresh, A.tile_trits);
+    return R;
+}
+#endif
+#ifdef PROTO_ANISO_RC
+// Blocs AnisoRC -> A.trits ; seuil z choisi report dans P.tern_thresh_z
+RateCtl rc_blocks(const ImageU8& rgb, const ProtoConfig& cfg, AnisoRCParams& P, AnisoRCArtifacts& A)
+{
+    std::vector<float> z;
+    std::vector<int8_t> sg;
+    proto_aniso_rc_analyze(rgb, P, A, z, sg);
+    RateCtl R = rate_ctl(cfg, z.size());
+    if(R.active) P.tern_thresh_z = rc_zthresh_for_nnz(z, R.target);
+    R.nnz = rc_ternarize_cached(z, sg, P.tern_thresh_z, A.trits);
+    return R;
+}
+#endif
+
+#if defined(PROTO_HAAR_TERNARY) || defined(PROTO_ANISO_RC)
+ProtoSection trit_section(ProtoSecKind k, const std::vector<int8_t>& t)
+{
+    ProtoSection S;
+    S.kind = k;
+    S.enc = ProtoSecEnc::Base243;
+    S.n_items = t.size();
+    pack_base243_from_balanced(t, S.data);
+    return S;
+}
+ProtoSection u8_section(ProtoSecKind k, const std::vector<uint8_t>& v)
+{
+    ProtoSection S;
+    S.kind = k;
+    S.enc = ProtoSecEnc::U8;
+    S.n_items = v.size();
+    S.data = v;
+    return S;
+}
+// Section complte de ce type (nullptr si absente ou tronque)
+const ProtoSection* find_section(const std::vector<ProtoSection>& v, ProtoSecKind k)
+{
+    for(const auto& S : v)
+        if(S.kind==k && !S.data.empty()) return &S;
+    return nullptr;
+}
+// Trits d'une section, vrifis contre le nombre attendu
+bool section_trits(const ProtoSection* S, size_t expect, std::vector<int8_t>& out)
+{
+    out.clear();
+    if(!S) return false;
+    if(S->enc!=ProtoSecEnc::Base243 || S->n_items!=expect || S->data.size()<(expect+4)/5) return false;
+    unpack_base243_to_balanced(S->data, (size_t)expect, out);
+    return true;
+}
+
+// Plan Y padd (multiple de N, tir NN  l'encodage) -> WH d'origine
+void resize_y_nn(const ImageU8& src, int dstW, int dstH, ImageU8& dst)
+{
+    dst.w=dstW;
+    dst.h=dstH;
+    dst.c=1;
+    dst.data.assign((size_t)dstW*dstH, 0);
+    if(src.w<=0||src.h<=0) return;
+    std::vector<int> sxs((size_t)dstW);
+    for(int x=0; x<dstW; ++x)
+        sxs[(size_t)x]=std::clamp((int)((x+0.5)*(double)src.w/dstW), 0, src.w-1);
+    for(int y=0; y<dstH; ++y)
+    {
+        int sy=std::clamp((int)((y+0.5)*(double)src.h/dstH), 0, src.h-1);
+        const uint8_t* sp=&src.data[(size_t)sy*src.w];
+        uint8_t* dp=&dst.data[(size_t)y*dstW];
+        for(int x=0; x<dstW; ++x) dp[x]=sp[sxs[(size_t)x]];
+    }
+}
+#endif
 } // anon
 
 bool encode_prototype_available(ProtoProfile p)
@@ -84,17 +289,10 @@ bool encode_prototype_ternary(const ImageU8& rgb,
     if(cfg.profile==ProtoProfile::HaarTernary)
     {
 #ifdef PROTO_HAAR_TERNARY
-        ProtoParams P; // dfauts du proto_noentropy
-        if(cfg.haar_tile        > 0) P.tile        = cfg.haar_tile;
-        if(cfg.haar_thresh      > 0) P.thresh      = cfg.haar_thresh;
-        if(cfg.haar_sketchSize  > 0) P.sketchSize  = cfg.haar_sketchSize;
-        if(cfg.haar_sketchDown  > 0) P.sketchDown  = cfg.haar_sketchDown;
-        if(cfg.haar_radialBins  > 0) P.radialBins  = cfg.haar_radialBins;
-        if(cfg.haar_angleBins   > 0) P.angleBins   = cfg.haar_angleBins;
-        P.keep_LL_u8 = cfg.haar_keep_LL_u8;
+        ProtoParams P = haar_params(cfg);
 
         ProtoArtifacts A;
-        proto_tile_haar_ternary(rgb, P, A);
+        const RateCtl R = haar_tiles(rgb, cfg, P, A);
         proto_spectral_sketch(rgb, P, A);
 
         // Concat ordre: [tiles_details | sketch]
@@ -120,16 +318,10 @@ bool encode_prototype_ternary(const ImageU8& rgb,
                              : (ntr + 4) / 5;
 
         std::ostringstream m;
-        m << "{"
-          << "\"proto\":\"HaarTernary\","
-          << "\"version\":\"" << kVer_Haar << "\","
-          << "\"params\":{"
-          << "\"tile\":"<<P.tile<<",\"thresh\":"<<P.thresh<<","
-          << "\"sketchSize\":"<<P.sketchSize<<",\"sketchDown\":"<<P.sketchDown<<","
-          << "\"radialBins\":"<<P.radialBins<<",\"angleBins\":"<<P.angleBins<<","
-          << "\"keep_LL_u8\":"<<(P.keep_LL_u8? "true":"false")
-          << "},"
-          << "\"layout\":{"
+        m << "{";
+        haar_params_json(m, P);
+        rate_json(m, R);
+        m << "\"layout\":{"
           << "\"order\":\"tiles_then_sketch\","
           << "\"ofs_tiles\":"<<ofs_tiles<<",\"len_tiles\":"<<len_tiles<<","
           << "\"ofs_sketch\":"<<ofs_sketch<<",\"len_sketch\":"<<len_sketch<<","
@@ -139,7 +331,8 @@ bool encode_prototype_ternary(const ImageU8& rgb,
           << "\"n_trits\":"<<ntr<<",\"tail_trits\":"<<tail<<",\"packed_bytes\":"<<pbytes
           << ",\"exact_n_trits\":true"
           << "}"
-          meta_json = m.str();
+          << "}";
+        meta_json = m.str();
 
         return true;
 #else
@@ -151,17 +344,14 @@ bool encode_prototype_ternary(const ImageU8& rgb,
     if(cfg.profile==ProtoProfile::AnisoRC)
     {
 #ifdef PROTO_ANISO_RC
-        AnisoRCParams P;
-        if(cfg.rc_block   > 0)   P.block  = cfg.rc_block;
-        if(cfg.rc_angles  > 0)   P.angles = cfg.rc_angles;
-        if(cfg.rc_tern_z  > 0.f) P.tern_thresh_z = cfg.rc_tern_z;
-        P.keep_LL_u8  = cfg.rc_keep_LL_u8;
-        P.normalize_proj = cfg.rc_normalize;
+        AnisoRCParams P = rc_params(cfg);
 
         AnisoRCArtifacts A;
-        proto_aniso_rc_encode(rgb, P, A);
+        const RateCtl R = rc_blocks(rgb, cfg, P, A);
 
-        balanced_trits = A.trits; // dj balanced {-1,0,1}
+        // Quadtree : [structure | dtails des feuilles]
+        balanced_trits = A.qt_trits;
+        balanced_trits.insert(balanced_trits.end(), A.trits.begin(), A.trits.end());
 
         if(packed_base243 && cfg.pack_base243)
         {
@@ -175,25 +365,25 @@ bool encode_prototype_ternary(const ImageU8& rgb,
                              : (ntr + 4) / 5;
 
         std::ostringstream m;
-        m << "{"
-          << "\"proto\":\"AnisoRC\","
-          << "\"version\":\"" << kVer_Aniso << "\","
-          << "\"params\":{"
-          << "\"block\":"<<P.block<<",\"angles\":"<<P.angles<<","
-          << "\"z_thresh\":"<<P.tern_thresh_z<<","
-          << "\"keep_LL_u8\":"<<(P.keep_LL_u8? "true":"false")<<","
-          << "\"normalize_proj\":"<<(P.normalize_proj? "true":"false")
-          << "},"
-          << "\"layout\":{"
-          << "\"order\":\"trits_only\","
-          << "\"trits_per_block\":"<<A.trits_per_block<<","
-          << "\"balanced\":true"
+        m << "{";
+        rc_params_json(m, P);
+        rate_json(m, R);
+        m << "\"layout\":{";
+        if(P.quadtree)
+            m << "\"order\":\"qtree_then_details\","
+              << "\"len_tree\":"<<A.qt_trits.size()<<",\"n_leaves\":"<<A.leaves.size()<<","
+              << "\"len_details\":"<<A.trits.size()<<",";
+        else
+            m << "\"order\":\"trits_only\","
+              << "\"trits_per_block\":"<<A.trits_per_block<<",";
+        m << "\"balanced\":true"
           << "},"
           << "\"counts\":{"
           << "\"n_trits\":"<<ntr<<",\"tail_trits\":"<<tail<<",\"packed_bytes\":"<<pbytes
           << ",\"exact_n_trits\":true"
           << "}"
-          meta_json = m.str();
+          << "}";
+        meta_json = m.str();
 
         return true;
 #else
@@ -203,3 +393,418 @@ bool encode_prototype_ternary(const ImageU8& rgb,
 
     return false;
 }
+
+bool decode_prototype_ternary(ProtoProfile p,
+                              uint32_t W, uint32_t H,
+                              const int8_t* balanced, size_t n_balanced,
+                              const std::string& meta_json,
+                              ImageU8& outY,
+                              unsigned threads)
+{
+    outY = ImageU8{};
+    if(W==0 || H==0 || !balanced || n_balanced==0) return false;
+    if(!has_profile(p)) return false;
+
+    // ----- HAAR TERNAIRE ----------------------------------------------------
+    if(p==ProtoProfile::HaarTernary)
+    {
+#ifdef PROTO_HAAR_TERNARY
+        uint64_t tile=0, thresh=0, len_tiles=0;
+        if(!t3proto::meta_find_int(meta_json, "tile", tile) || tile<2) return false;
+        if(!t3proto::meta_find_int(meta_json, "thresh", thresh)) thresh = ProtoParams{}.thresh;
+        const int N  = (int)tile;
+        const int tX = ((int)W + N-1)/N, tY = ((int)H + N-1)/N;
+        const size_t need = (size_t)tX*tY * (size_t)(3*N*N/4);
+        if(t3proto::meta_find_int(meta_json, "len_tiles", len_tiles) && len_tiles!=need) return false;
+
+        ImageU8 Yp;
+        if(!proto_haar_decode_Y(balanced, n_balanced, nullptr,
+                                tX, tY, N, (int)thresh, Yp, threads))
+            return false;
+        resize_y_nn(Yp, (int)W, (int)H, outY);
+        return true;
+#else
+        (void)meta_json; (void)threads;
+        return false;
+#endif
+    }
+
+    // ----- ANISO RC ---------------------------------------------------------
+    if(p==ProtoProfile::AnisoRC)
+    {
+#ifdef PROTO_ANISO_RC
+        const AnisoRCParams P = rc_params_from_meta(meta_json);
+
+        ImageU8 Yp;
+        if(P.quadtree)
+        {
+            uint64_t lt=0;
+            t3proto::meta_find_int(meta_json, "len_tree", lt);
+            if(lt > n_balanced) return false;
+            if(!proto_aniso_rc_decode_Y_qt(balanced, (size_t)lt,
+                                           balanced+lt, n_balanced-(size_t)lt,
+                                           nullptr, 0, (int)W, (int)H, P, Yp, threads))
+                return false;
+        }
+        else if(!proto_aniso_rc_decode_Y(balanced, n_balanced, nullptr,
+                                         (int)W, (int)H, P, Yp, threads))
+            return false;
+        resize_y_nn(Yp, (int)W, (int)H, outY);
+        return true;
+#else
+        (void)meta_json; (void)threads;
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+bool decode_prototype_ternary(ProtoProfile p,
+                              uint32_t W, uint32_t H,
+                              const std::vector<int8_t>& balanced,
+                              const std::string& meta_json,
+                              ImageU8& outY,
+                              unsigned threads)
+{
+    return decode_prototype_ternary(p, W, H, balanced.data(), balanced.size(), meta_json, outY, threads);
+}
+
+// ----- Layout progressif (.t3proto v2) --------------------------------------
+
+const char* proto_section_name(ProtoSecKind k)
+{
+    switch(k)
+    {
+    case ProtoSecKind::Sketch:
+        return "sketch";
+    case ProtoSecKind::LL:
+        return "ll";
+    case ProtoSecKind::DetHL:
+        return "hl";
+    case ProtoSecKind::DetLH:
+        return "lh";
+    case ProtoSecKind::DetHH:
+        return "hh";
+    case ProtoSecKind::Details:
+        return "details";
+    case ProtoSecKind::QTree:
+        return "qtree";
+    default:
+        return "?";
+    }
+}
+
+bool encode_prototype_progressive(const ImageU8& rgb,
+                                  const ProtoConfig& cfg,
+                                  std::vector<ProtoSection>& out,
+                                  std::string& meta_json)
+{
+    out.clear();
+    meta_json.clear();
+    if(cfg.profile==ProtoProfile::None) return false;
+    if(!has_profile(cfg.profile))       return false;
+
+    std::ostringstream m;
+    m << "{";
+
+    // ----- HAAR TERNAIRE : sketch | LL | HL | LH | HH -----------------------
+    if(cfg.profile==ProtoProfile::HaarTernary)
+    {
+#ifdef PROTO_HAAR_TERNARY
+        ProtoParams P = haar_params(cfg);
+        ProtoArtifacts A;
+        const RateCtl R = haar_tiles(rgb, cfg, P, A);
+        proto_spectral_sketch(rgb, P, A);
+
+        const size_t n_tiles = (size_t)A.tilesX*A.tilesY;
+        std::vector<int8_t> HL, LH, HH;
+        proto_haar_split_subbands(A.tile_trits.data(), n_tiles, A.N, HL, LH, HH);
+
+        out.push_back(trit_section(ProtoSecKind::Sketch, A.sketch_trits));
+        if(!A.tile_LL.empty()) out.push_back(u8_section(ProtoSecKind::LL, A.tile_LL));
+        out.push_back(trit_section(ProtoSecKind::DetHL, HL));
+        out.push_back(trit_section(ProtoSecKind::DetLH, LH));
+        out.push_back(trit_section(ProtoSecKind::DetHH, HH));
+
+        haar_params_json(m, P);
+        rate_json(m, R);
+        m << "\"layout\":{\"order\":\"progressive\","
+          << "\"tilesX\":"<<A.tilesX<<",\"tilesY\":"<<A.tilesY<<","
+          << "\"len_tiles\":"<<A.tile_trits.size()<<",\"len_sketch\":"<<A.sketch_trits.size()
+          << "},";
+#else
+        (void)rgb;
+        return false;
+#endif
+    }
+
+    // ----- ANISO RC : LL | dtails ------------------------------------------
+    if(cfg.profile==ProtoProfile::AnisoRC)
+    {
+#ifdef PROTO_ANISO_RC
+        AnisoRCParams P = rc_params(cfg);
+        AnisoRCArtifacts A;
+        const RateCtl R = rc_blocks(rgb, cfg, P, A);
+
+        if(P.quadtree) out.push_back(trit_section(ProtoSecKind::QTree, A.qt_trits));
+        if(!A.block_LL.empty()) out.push_back(u8_section(ProtoSecKind::LL, A.block_LL));
+        out.push_back(trit_section(ProtoSecKind::Details, A.trits));
+
+        rc_params_json(m, P);
+        rate_json(m, R);
+        m << "\"layout\":{\"order\":\"progressive\","
+          << "\"blocksX\":"<<A.blocksX<<",\"blocksY\":"<<A.blocksY<<",";
+        if(P.quadtree)
+            m << "\"len_tree\":"<<A.qt_trits.size()<<",\"n_leaves\":"<<A.leaves.size()<<","
+              << "\"len_details\":"<<A.trits.size();
+        else
+            m << "\"trits_per_block\":"<<A.trits_per_block;
+        m << "},";
+#else
+        (void)rgb;
+        return false;
+#endif
+    }
+
+    uint64_t ntr=0;
+    for(const auto& S : out)
+        if(S.enc==ProtoSecEnc::Base243) ntr += S.n_items;
+    m << "\"counts\":{\"n_trits\":"<<ntr<<",\"exact_n_trits\":true}"
+      << "}";
+    meta_json = m.str();
+    return !out.empty();
+}
+
+bool decode_prototype_progressive(ProtoProfile p,
+                                  uint32_t W, uint32_t H,
+                                  const std::vector<ProtoSection>& sections,
+                                  const std::string& meta_json,
+                                  ImageU8& outY,
+                                  unsigned threads)
+{
+    outY = ImageU8{};
+    if(W==0 || H==0) return false;
+    if(!has_profile(p)) return false;
+
+    if(p==ProtoProfile::HaarTernary)
+    {
+#ifdef PROTO_HAAR_TERNARY
+        uint64_t tile=0, thresh=0;
+        if(!t3proto::meta_find_int(meta_json, "tile", tile) || tile<2 || (tile&1)) return false;
+        if(!t3proto::meta_find_int(meta_json, "thresh", thresh)) thresh = ProtoParams{}.thresh;
+        const int N  = (int)tile;
+        const int tX = ((int)W + N-1)/N, tY = ((int)H + N-1)/N;
+        const size_t n_tiles = (size_t)tX*tY;
+        const size_t q = (size_t)(N/2)*(N/2)*n_tiles;
+
+        const ProtoSection* LL = find_section(sections, ProtoSecKind::LL);
+        if(LL && LL->data.size()!=n_tiles) LL = nullptr;
+        std::vector<int8_t> hl, lh, hh;
+        const bool has_hl = section_trits(find_section(sections, ProtoSecKind::DetHL), q, hl);
+        const bool has_lh = section_trits(find_section(sections, ProtoSecKind::DetLH), q, lh);
+        const bool has_hh = section_trits(find_section(sections, ProtoSecKind::DetHH), q, hh);
+
+        ImageU8 Yp;
+        proto_haar_decode_Y_subbands(has_hl? hl.data() : nullptr,
+                                     has_lh? lh.data() : nullptr,
+                                     has_hh? hh.data() : nullptr,
+                                     LL? LL->data.data() : nullptr,
+                                     tX, tY, N, (int)thresh, Yp, threads);
+        resize_y_nn(Yp, (int)W, (int)H, outY);
+        return true;
+#else
+        (void)sections; (void)meta_json; (void)threads;
+        return false;
+#endif
+    }
+
+    if(p==ProtoProfile::AnisoRC)
+    {
+#ifdef PROTO_ANISO_RC
+        const AnisoRCParams P = rc_params_from_meta(meta_json);
+        if(P.quadtree)
+        {
+            // Structure indispensable ; LL / dtails optionnels (prfixe)
+            uint64_t lt=0, ld=0, nl=0;
+            t3proto::meta_find_int(meta_json, "len_tree", lt);
+            t3proto::meta_find_int(meta_json, "len_details", ld);
+            t3proto::meta_find_int(meta_json, "n_leaves", nl);
+            std::vector<int8_t> tree, det;
+            if(!section_trits(find_section(sections, ProtoSecKind::QTree), (size_t)lt, tree)) return false;
+            const ProtoSection* LL = find_section(sections, ProtoSecKind::LL);
+            if(LL && LL->data.size()!=nl) LL = nullptr;
+            const bool has_det = section_trits(find_section(sections, ProtoSecKind::Details), (size_t)ld, det);
+
+            ImageU8 Yp;
+            if(!proto_aniso_rc_decode_Y_qt(tree.data(), tree.size(),
+                                           has_det? det.data() : nullptr, det.size(),
+                                           LL? LL->data.data() : nullptr, LL? LL->data.size() : 0,
+                                           (int)W, (int)H, P, Yp, threads))
+                return false;
+            resize_y_nn(Yp, (int)W, (int)H, outY);
+            return true;
+        }
+        uint64_t tpb=0;
+        if(!t3proto::meta_find_int(meta_json, "trits_per_block", tpb)) return false;
+        const int N = P.block;
+        const size_t n_blocks = (size_t)(((int)W + N-1)/N) * (size_t)(((int)H + N-1)/N);
+
+        const ProtoSection* LL = find_section(sections, ProtoSecKind::LL);
+        if(LL && LL->data.size()!=n_blocks) LL = nullptr;
+        std::vector<int8_t> det;
+        const bool has_det = section_trits(find_section(sections, ProtoSecKind::Details),
+                                           (size_t)tpb*n_blocks, det);
+
+        ImageU8 Yp;
+        if(!proto_aniso_rc_decode_Y(has_det? det.data() : nullptr, det.size(),
+                                    LL? LL->data.data() : nullptr,
+                                    (int)W, (int)H, P, Yp, threads))
+            return false;
+        resize_y_nn(Yp, (int)W, (int)H, outY);
+        return true;
+#else
+        (void)sections; (void)meta_json; (void)threads;
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+// ----- Squence Haar (.t3proto v3) ----------------------------------------
+
+bool encode_prototype_sequence(const std::function<bool(size_t, ImageU8&)>& next_frame,
+                               const ProtoConfig& cfg,
+                               uint32_t& W, uint32_t& H,
+                               std::vector<ProtoSeqFrame>& out_frames,
+                               std::string& meta_json,
+                               unsigned threads)
+{
+    out_frames.clear();
+    meta_json.clear();
+    W=H=0;
+    if(cfg.profile!=ProtoProfile::HaarTernary || !has_profile(cfg.profile)) return false;
+#ifdef PROTO_HAAR_TERNARY
+    ProtoSeqEncoder E;
+    E.P = haar_params(cfg);
+    E.key_interval = cfg.seq_key_interval;
+
+    ImageU8 rgb;
+    for(size_t i=0; next_frame(i, rgb); ++i)
+    {
+        if(i==0)
+        {
+            W=(uint32_t)rgb.w;
+            H=(uint32_t)rgb.h;
+        }
+        else if(rgb.w!=(int)W || rgb.h!=(int)H) return false;
+
+        ProtoSeqPacket pk;
+        if(!E.encode(rgb, pk, threads)) return false;
+        ProtoSeqFrame F;
+        F.type    = pk.key ? ProtoSeqFrameType::Key : ProtoSeqFrameType::Delta;
+        F.n_coded = pk.n_coded;
+        F.n_trits = (uint64_t)pk.n_coded * E.per_tile;
+        F.data    = std::move(pk.data);
+        out_frames.push_back(std::move(F));
+    }
+    if(out_frames.empty()) return false;
+
+    const uint64_t n_tiles = (uint64_t)E.tilesX*E.tilesY;
+    std::ostringstream m;
+    m << "{";
+    haar_params_json(m, E.P);
+    m << "\"sequence\":{"
+      << "\"n_frames\":"<<out_frames.size()<<",\"key_interval\":"<<E.key_interval<<","
+      << "\"n_key\":"<<E.stats.key<<",\"n_delta\":"<<E.stats.delta<<","
+      << "\"tiles_per_frame\":"<<n_tiles<<","
+      << "\"tiles_skipped\":"<<E.stats.skipped<<",\"tiles_ll_only\":"<<E.stats.ll_only<<","
+      << "\"tiles_coded\":"<<E.stats.coded
+      << "},"
+      << "\"layout\":{"
+      << "\"order\":\"key_delta_frames\","
+      << "\"tilesX\":"<<E.tilesX<<",\"tilesY\":"<<E.tilesY<<",\"per_tile\":"<<E.per_tile
+      << "}"
+      << "}";
+    meta_json = m.str();
+    return true;
+#else
+    (void)next_frame; (void)threads;
+    return false;
+#endif
+}
+
+bool decode_prototype_sequence(ProtoProfile p,
+                               uint32_t W, uint32_t H,
+                               const std::vector<ProtoSeqFrame>& frames,
+                               const std::string& meta_json,
+                               const std::function<bool(size_t, const ImageU8&)>& sink,
+                               unsigned threads)
+{
+    if(W==0 || H==0 || frames.empty()) return false;
+    if(p!=ProtoProfile::HaarTernary || !has_profile(p)) return false;
+#ifdef PROTO_HAAR_TERNARY
+    uint64_t tile=0, thresh=0;
+    if(!t3proto::meta_find_int(meta_json, "tile", tile) || tile<2) return false;
+    if(!t3proto::meta_find_int(meta_json, "thresh", thresh)) thresh = ProtoParams{}.thresh;
+    const int N  = (int)tile;
+    const int tX = ((int)W + N-1)/N, tY = ((int)H + N-1)/N;
+
+    ProtoSeqDecoder D;
+    if(!D.init(tX, tY, N, (int)thresh)) return false;
+    const bool padded = (tX*N!=(int)W || tY*N!=(int)H);
+    ImageU8 outY;
+    for(size_t i=0; i<frames.size(); ++i)
+    {
+        const ProtoSeqFrame& F = frames[i];
+        if(!D.decode(F.type==ProtoSeqFrameType::Key, F.n_coded,
+                     F.data.data(), F.data.size(), threads))
+            return false;
+        if(padded) resize_y_nn(D.Y, (int)W, (int)H, outY);
+        if(!sink(i, padded? outY : D.Y)) break;
+    }
+    return true;
+#else
+    (void)meta_json; (void)sink; (void)threads;
+    return false;
+#endif
+}
+
+// ----- Packing base-243 (5 trits/octet, trit 0 = chiffre de poids faible) ----
+void pack_base243_from_balanced(const std::vector<int8_t>& balanced,
+                                std::vector<uint8_t>& out_bytes)
+{
+    out_bytes.clear();
+    out_bytes.reserve((balanced.size()+4)/5);
+    uint32_t v=0, p=1;
+    int k=0;
+    for(int8_t b : balanced)
+    {
+        v += (uint32_t)trit_bal_to_unb(b) * p;
+        p *= 3;
+        if(++k==5)
+        {
+            out_bytes.push_back((uint8_t)v);
+            v=0; p=1; k=0;
+        }
+    }
+    if(k) out_bytes.push_back((uint8_t)v);
+}
+
+void unpack_base243_to_balanced(const std::vector<uint8_t>& bytes,
+                                size_t n_trits,
+                                std::vector<int8_t>& out_balanced)
+{
+    out_balanced.resize(n_trits);
+    size_t i=0;
+    for(size_t bi=0; i<n_trits; ++bi)
+    {
+        uint32_t v = (bi<bytes.size()? bytes[bi] : 0u);
+        for(int j=0; j<5 && i<n_trits; ++j, ++i)
+        {
+            out_balanced[i] = trit_unb_to_bal((uint8_t)(v%3));
+            v/=3;
+        }
+    }
+}
@@ -0,0 +1,246 @@
+// ============================================================================
+//  File: src/io_fastdecode.cpp  Dcodeurs JPEG/PNG rapides (optionnels) (DOC+)
+// ============================================================================
+
+#include "io_fastdecode.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <csetjmp>
+#include <vector>
+#include <algorithm>
+
+using namespace TernaryIO;
+
+static void setErr(std::string* e, const char* msg)
+{
+    if(e) *e = msg;
+}
+
+#if TERNARY_HAVE_FAST_DECODE
+// Garde-fou dimensions (w*h*3 sans dbordement, 1 Gpx max)
+static bool dims_ok(uint64_t w, uint64_t h)
+{
+    return w>0 && h>0 && w<=0x7FFFFFFF && h<=0x7FFFFFFF && w*h <= (1ull<<30);
+}
+#endif
+
+// ---------------- JPEG : libjpeg
+#if defined(TERNARY_USE_LIBJPEG)
+#include <jpeglib.h>
+namespace {
+struct JpegErr
+{
+    jpeg_error_mgr pub;
+    std::jmp_buf jb;
+};
+void jpeg_err_exit(j_common_ptr c)
+{
+    std::longjmp(reinterpret_cast<JpegErr*>(c->err)->jb, 1);
+}
+}
+static bool decode_jpeg(const std::string& path, int min_w, int min_h,
+                        const RgbAllocFn& alloc, int& w, int& h,
+                        const char** be, std::string* err)
+{
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f)
+    {
+        setErr(err, "libjpeg: open failed");
+        return false;
+    }
+    jpeg_decompress_struct cinfo;
+    JpegErr je;
+    cinfo.err = jpeg_std_error(&je.pub);
+    je.pub.error_exit = jpeg_err_exit;
+    if(setjmp(je.jb))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        std::fclose(f);
+        setErr(err, "libjpeg: decode failed");
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, f);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    // Rduction DCT 1/8, 1/4, 1/2 (libjpeg 6b+) tant que la sortie couvre min_w x min_h
+    if(min_w>0 && min_h>0)
+    {
+        for(unsigned d : { 8u, 4u, 2u })
+        {
+            if((cinfo.image_width + d-1)/d >= (unsigned)min_w && (cinfo.image_height + d-1)/d >= (unsigned)min_h)
+            {
+                cinfo.scale_num = 1;
+                cinfo.scale_denom = d;
+                break;
+            }
+        }
+    }
+    jpeg_start_decompress(&cinfo);
+    uint8_t* dst = nullptr;
+    if(cinfo.output_components==3 && dims_ok(cinfo.output_width, cinfo.output_height))
+        dst = alloc((int)cinfo.output_width, (int)cinfo.output_height);
+    if(!dst)
+    {
+        jpeg_destroy_decompress(&cinfo);
+        std::fclose(f);
+        setErr(err, "libjpeg: unsupported image");
+        return false;
+    }
+    // Lignes dcodes en place, plusieurs  la fois (chemin SIMD de turbo)
+    const size_t stride = (size_t)cinfo.output_width*3;
+    JSAMPROW rows[16];
+    while(cinfo.output_scanline < cinfo.output_height)
+    {
+        const JDIMENSION n = std::min<JDIMENSION>(16, cinfo.output_height - cinfo.output_scanline);
+        for(JDIMENSION i=0; i<n; ++i) rows[i] = dst + (size_t)(cinfo.output_scanline + i)*stride;
+        jpeg_read_scanlines(&cinfo, rows, n);
+    }
+    w=(int)cinfo.output_width;
+    h=(int)cinfo.output_height;
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    std::fclose(f);
+    if(be) *be = "libjpeg";
+    return true;
+}
+#endif
+
+// ---------------- PNG : libpng
+#if defined(TERNARY_USE_LIBPNG)
+#include <png.h>
+static bool decode_png(const std::string& path, const RgbAllocFn& alloc, int& w, int& h,
+                       const char** be, std::string* err)
+{
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f)
+    {
+        setErr(err, "libpng: open failed");
+        return false;
+    }
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if(!info)
+    {
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        std::fclose(f);
+        setErr(err, "libpng: init failed");
+        return false;
+    }
+    std::vector<png_bytep> rows;
+    if(setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_read_struct(&png, &info, nullptr);
+        std::fclose(f);
+        setErr(err, "libpng: decode failed");
+        return false;
+    }
+    png_init_io(png, f);
+    png_read_info(png, info);
+    const png_uint_32 W = png_get_image_width(png, info), H = png_get_image_height(png, info);
+    const int ct = png_get_color_type(png, info);
+    // Normalisation -> RGB8 (alpha ignor, comme stbi_load(..., 3))
+    png_set_strip_16(png);
+    png_set_packing(png);
+    if(ct==PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(png);
+    if(ct==PNG_COLOR_TYPE_GRAY || ct==PNG_COLOR_TYPE_GRAY_ALPHA)
+    {
+        png_set_expand_gray_1_2_4_to_8(png);
+        png_set_gray_to_rgb(png);
+    }
+    png_set_strip_alpha(png);
+    png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+    uint8_t* dst = nullptr;
+    if(png_get_rowbytes(png, info)==(size_t)W*3 && dims_ok(W, H)) dst = alloc((int)W, (int)H);
+    if(!dst)
+    {
+        png_destroy_read_struct(&png, &info, nullptr);
+        std::fclose(f);
+        setErr(err, "libpng: unsupported image");
+        return false;
+    }
+    rows.resize(H);
+    for(png_uint_32 y=0; y<H; ++y) rows[y] = dst + (size_t)y*W*3;
+    png_read_image(png, rows.data());
+    png_read_end(png, nullptr);
+    png_destroy_read_struct(&png, &info, nullptr);
+    std::fclose(f);
+    w=(int)W;
+    h=(int)H;
+    if(be) *be = "libpng";
+    return true;
+}
+#endif
+
+// ---------------- Implmentations publiques
+
+const char* TernaryIO::fast_decode_backends()
+{
+    return ""
+#if defined(TERNARY_USE_LIBJPEG)
+           "libjpeg"
+#endif
+#if defined(TERNARY_USE_LIBJPEG) && defined(TERNARY_USE_LIBPNG)
+           ","
+#endif
+#if defined(TERNARY_USE_LIBPNG)
+           "libpng"
+#endif
+           ;
+}
+
+bool TernaryIO::decode_rgb8_fast(const std::string& path,
+                                 const RgbAllocFn& alloc,
+                                 int& out_w, int& out_h,
+                                 const char** out_backend,
+                                 std::string* err)
+{
+    return decode_rgb8_fast_scaled(path, 0, 0, alloc, out_w, out_h, out_backend, err);
+}
+
+bool TernaryIO::decode_rgb8_fast_scaled(const std::string& path,
+                                        int min_w, int min_h,
+                                        const RgbAllocFn& alloc,
+                                        int& out_w, int& out_h,
+                                        const char** out_backend,
+                                        std::string* err)
+{
+    out_w = out_h = 0;
+    uint8_t sig[8] = {0};
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f)
+    {
+        setErr(err, "open failed");
+        return false;
+    }
+    const size_t n = std::fread(sig, 1, sizeof(sig), f);
+    std::fclose(f);
+
+    static const uint8_t kPng[8] = { 0x89,'P','N','G','\r','\n',0x1A,'\n' };
+    if(n>=3 && sig[0]==0xFF && sig[1]==0xD8 && sig[2]==0xFF)
+    {
+#if defined(TERNARY_USE_LIBJPEG)
+        return decode_jpeg(path, min_w, min_h, alloc, out_w, out_h, out_backend, err);
+#else
+        setErr(err, "JPEG fast decode disabled (compile without TERNARY_USE_LIBJPEG)");
+        return false;
+#endif
+    }
+    if(n==8 && std::memcmp(sig, kPng, 8)==0)
+    {
+#if defined(TERNARY_USE_LIBPNG)
+        return decode_png(path, alloc, out_w, out_h, out_backend, err);
+#else
+        setErr(err, "PNG fast decode disabled (compile without TERNARY_USE_LIBPNG)");
+        return false;
+#endif
+    }
+    (void)min_w;
+    (void)min_h;
+    (void)alloc;
+    (void)out_backend;
+    setErr(err, "not a JPEG/PNG file");
+    return false;
+}
@@ -3,9 +3,33 @@
 // ============================================================================
 
 #include "io_t3p_t3v.hpp"
+#include "t3_tritplanes.hpp"
+#include "t3_parallel.hpp"
+#include "t3_meta.hpp"
+#include "t3_crc32.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define T3A_HAVE_MMAP 1
+#else
+#define T3A_HAVE_MMAP 0
+#endif
 
 namespace {
 
@@ -16,20 +40,7 @@ struct File {
 };
 
 static uint32_t crc32_acc(const void* data, size_t n){
-    // CRC32 min (polynme 0xEDB88320)  implmentation simplifie
-    static uint32_t table[256]; static bool init=false;
-    if(!init){
-        for(uint32_t i=0;i<256;++i){
-            uint32_t c=i;
-            for(int k=0;k<8;++k) c = (c&1)? (0xEDB88320u ^ (c>>1)) : (c>>1);
-            table[i]=c;
-        }
-        init=true;
-    }
-    uint32_t c=0xFFFFFFFFu;
-    const uint8_t* p=(const uint8_t*)data;
-    for(size_t i=0;i<n;++i) c = table[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
-    return c ^ 0xFFFFFFFFu;
+    return T3Crc32::crc32(data, n);
 }
 
 template<typename T>
@@ -47,20 +58,42 @@ static bool read_bytes(FILE* f, void* p, size_t n){
     return std::fread(p, 1, n, f)==n;
 }
 
-} // namespace
-
-using namespace T3Container;
+// Srialisation LE sur tampon (tables, rpertoires, index)
+static void put_u16(std::vector<uint8_t>& o, uint16_t v){ o.push_back((uint8_t)v); o.push_back((uint8_t)(v>>8)); }
+static void put_u32(std::vector<uint8_t>& o, uint32_t v){ for(int i=0;i<4;++i) o.push_back((uint8_t)(v>>(8*i))); }
+static void put_u64(std::vector<uint8_t>& o, uint64_t v){ for(int i=0;i<8;++i) o.push_back((uint8_t)(v>>(8*i))); }
+static uint16_t ld_u16(const uint8_t* p){ return (uint16_t)(p[0]|(p[1]<<8)); }
+static uint32_t ld_u32(const uint8_t* p){ return (uint32_t)p[0]|((uint32_t)p[1]<<8)|((uint32_t)p[2]<<16)|((uint32_t)p[3]<<24); }
+static uint64_t ld_u64(const uint8_t* p){ uint64_t v=0; for(int i=7;i>=0;--i) v=(v<<8)|p[i]; return v; }
 
-// =============================== .t3p =======================================
+// CRC des headers logiques : structures mises  zro avant remplissage
+// (octets de bourrage dterministes, sinon le CRC dpend de la pile).
+static uint32_t t3p_hdr_crc(uint8_t ver, uint8_t subu, uint16_t W, uint16_t H,
+                            uint32_t meta_len, uint64_t words_count){
+    struct HdrCrcBuf {
+        uint8_t ver, subu;
+        uint16_t W, H;
+        uint32_t meta_len;
+        uint64_t words_count;
+    } b;
+    std::memset(&b, 0, sizeof(b));
+    b.ver=ver; b.subu=subu; b.W=W; b.H=H; b.meta_len=meta_len; b.words_count=words_count;
+    return crc32_acc(&b, sizeof(b));
+}
+static uint32_t t3v_hdr_crc(uint8_t ver, uint8_t subu, uint16_t W, uint16_t H,
+                            uint64_t frame_count, uint32_t meta_g_len){
+    struct HdrBuf { uint8_t ver,subu; uint16_t W,H; uint64_t frame_count; uint32_t meta_g_len; } hb;
+    std::memset(&hb, 0, sizeof(hb));
+    hb.ver=ver; hb.subu=subu; hb.W=W; hb.H=H; hb.frame_count=frame_count; hb.meta_g_len=meta_g_len;
+    return crc32_acc(&hb, sizeof(hb));
+}
 
-bool t3p_write(const std::string& path,
-               SubwordMode sub, int w, int h,
-               const std::vector<Word27>& words,
-               const std::string& meta_json,
-               std::string* err)
+// Blob T3P6 complet sur un flux ouvert (fichier .t3p ou entre d'archive .t3a)
+static bool t3p_put(FILE* f,
+                    SubwordMode sub, int w, int h,
+                    const std::vector<Word27>& words,
+                    const std::string& meta_json)
 {
-    File fp; if(!fp.open(path, "wb")){ if(err)*err=strerror(errno); return false; }
-
     const char magic[4] = {'T','3','P','6'};
     uint8_t ver = 6;
     uint8_t subu = (uint8_t)sub;
@@ -69,42 +102,51 @@ bool t3p_write(const std::string& path,
     uint64_t words_count = (uint64_t)words.size();
 
     // Header sans CRC
-    if(!write_bytes(fp.f, magic, 4)) goto io_err;
-    if(!write_le(fp.f, ver)) goto io_err;
-    if(!write_le(fp.f, subu)) goto io_err;
-    if(!write_le(fp.f, W)) goto io_err;
-    if(!write_le(fp.f, H)) goto io_err;
-    if(!write_le(fp.f, meta_len)) goto io_err;
-    if(!write_le(fp.f, words_count)) goto io_err;
+    if(!write_bytes(f, magic, 4)) return false;
+    if(!write_le(f, ver)) return false;
+    if(!write_le(f, subu)) return false;
+    if(!write_le(f, W)) return false;
+    if(!write_le(f, H)) return false;
+    if(!write_le(f, meta_len)) return false;
+    if(!write_le(f, words_count)) return false;
 
     // CRC du header logique (hors magic/ver)
     {
-        struct HdrCrcBuf {
-            uint8_t ver, subu;
-            uint16_t W, H;
-            uint32_t meta_len;
-            uint64_t words_count;
-        } b{ver, subu, W, H, meta_len, words_count};
-        uint32_t hdr_crc = crc32_acc(&b, sizeof(b));
-        if(!write_le(fp.f, hdr_crc)) goto io_err;
+        uint32_t hdr_crc = t3p_hdr_crc(ver, subu, W, H, meta_len, words_count);
+        if(!write_le(f, hdr_crc)) return false;
     }
 
     // META (plaintext JSON)
     if(meta_len){
-        if(!write_bytes(fp.f, meta_json.data(), meta_len)) goto io_err;
+        if(!write_bytes(f, meta_json.data(), meta_len)) return false;
     }
 
     // Payload mots (LE)
     if(words_count){
-        if(!write_bytes(fp.f, words.data(), sizeof(Word27)*words.size())) goto io_err;
+        if(!write_bytes(f, words.data(), sizeof(Word27)*words.size())) return false;
         uint32_t pl_crc = crc32_acc(words.data(), sizeof(Word27)*words.size());
-        if(!write_le(fp.f, pl_crc)) goto io_err;
+        if(!write_le(f, pl_crc)) return false;
     } else {
-        uint32_t pl_crc = 0; if(!write_le(fp.f, pl_crc)) goto io_err;
+        uint32_t pl_crc = 0; if(!write_le(f, pl_crc)) return false;
     }
 
     return true;
-io_err:
+}
+
+} // namespace
+
+namespace T3Container {
+
+// =============================== .t3p =======================================
+
+bool t3p_write(const std::string& path,
+               SubwordMode sub, int w, int h,
+               const std::vector<Word27>& words,
+               const std::string& meta_json,
+               std::string* err)
+{
+    File fp; if(!fp.open(path, "wb")){ if(err)*err=strerror(errno); return false; }
+    if(t3p_put(fp.f, sub, w, h, words, meta_json)) return true;
     if(err)*err="t3p_write: I/O error";
     return false;
 }
@@ -117,11 +159,13 @@ bool t3p_read_header(const std::string& path,
 {
     out_meta_json.clear(); out_words_count=0; out_w=out_h=0; out_sub=SubwordMode::S27;
 
+    char magic[4];
+    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint32_t meta_len=0; uint64_t words_count=0;
+    uint32_t hdr_crc=0;
     File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
-    char magic[4]; if(!read_bytes(fp.f, magic, 4)) goto io_err;
+    if(!read_bytes(fp.f, magic, 4)) goto io_err;
     if(std::memcmp(magic, "T3P6", 4)!=0){ if(err)*err="t3p: bad magic"; return false; }
 
-    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint32_t meta_len=0; uint64_t words_count=0;
     if(!read_le(fp.f, ver)) goto io_err;
     if(!read_le(fp.f, subu)) goto io_err;
     if(!read_le(fp.f, W)) goto io_err;
@@ -129,16 +173,8 @@ bool t3p_read_header(const std::string& path,
     if(!read_le(fp.f, meta_len)) goto io_err;
     if(!read_le(fp.f, words_count)) goto io_err;
 
-    uint32_t hdr_crc=0; if(!read_le(fp.f, hdr_crc)) goto io_err;
-    {
-        struct HdrCrcBuf {
-            uint8_t ver, subu;
-            uint16_t W, H;
-            uint32_t meta_len;
-            uint64_t words_count;
-        } b{ver, subu, W, H, meta_len, words_count};
-        if(crc32_acc(&b, sizeof(b)) != hdr_crc){ if(err)*err="t3p: header crc mismatch"; return false; }
-    }
+    if(!read_le(fp.f, hdr_crc)) goto io_err;
+    if(t3p_hdr_crc(ver, subu, W, H, meta_len, words_count) != hdr_crc){ if(err)*err="t3p: header crc mismatch"; return false; }
 
     out_sub = (SubwordMode)subu; out_w=W; out_h=H; out_words_count=words_count;
 
@@ -160,11 +196,14 @@ bool t3p_read_payload(const std::string& path,
 {
     out_words.clear();
 
+    std::string meta;
+    char magic[4];
+    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint32_t meta_len=0; uint64_t words_count=0;
+    uint32_t hdr_crc=0;
     File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
-    char magic[4]; if(!read_bytes(fp.f, magic, 4)) goto io_err;
+    if(!read_bytes(fp.f, magic, 4)) goto io_err;
     if(std::memcmp(magic, "T3P6", 4)!=0){ if(err)*err="t3p: bad magic"; return false; }
 
-    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint32_t meta_len=0; uint64_t words_count=0;
     if(!read_le(fp.f, ver)) goto io_err;
     if(!read_le(fp.f, subu)) goto io_err;
     if(!read_le(fp.f, W)) goto io_err;
@@ -172,18 +211,9 @@ bool t3p_read_payload(const std::string& path,
     if(!read_le(fp.f, meta_len)) goto io_err;
     if(!read_le(fp.f, words_count)) goto io_err;
 
-    uint32_t hdr_crc=0; if(!read_le(fp.f, hdr_crc)) goto io_err;
-    {
-        struct HdrCrcBuf {
-            uint8_t ver, subu;
-            uint16_t W, H;
-            uint32_t meta_len;
-            uint64_t words_count;
-        } b{ver, subu, W, H, meta_len, words_count};
-        if(crc32_acc(&b, sizeof(b)) != hdr_crc){ if(err)*err="t3p: header crc mismatch"; return false; }
-    }
+    if(!read_le(fp.f, hdr_crc)) goto io_err;
+    if(t3p_hdr_crc(ver, subu, W, H, meta_len, words_count) != hdr_crc){ if(err)*err="t3p: header crc mismatch"; return false; }
 
-    std::string meta;
     if(meta_len){
         meta.resize(meta_len);
         if(!read_bytes(fp.f, meta.data(), meta_len)) goto io_err;
@@ -217,19 +247,51 @@ io_err:
 // =============================== .t3v =======================================
 // v6-min : header global + index simple (offset/words/meta_len par frame)
 
-bool t3v_write(const std::string& path,
-               SubwordMode sub, int w, int h,
-               const std::vector<std::vector<Word27>>& frames,
-               const std::string& meta_json_global,
-               const std::vector<std::string>& metas_per_frame,
-               std::string* err)
+namespace {
+// Index srialis : ver 6 = entres seules ; ver 7 = timebase + entres + CRC
+static void t3v_index_bytes(uint8_t ver, const T3VTimeBase& tb,
+                            const std::vector<T3VFrameIndex>& index,
+                            std::vector<uint8_t>& o)
+{
+    o.clear();
+    if(ver>=7){ put_u32(o, tb.num); put_u32(o, tb.den); }
+    for(const auto& e : index){
+        put_u64(o, e.offset); put_u64(o, e.words); put_u32(o, e.meta_len);
+        if(ver>=7){ put_u32(o, e.flags); put_u64(o, (uint64_t)e.pts); }
+    }
+    if(ver>=7) put_u32(o, crc32_acc(o.data(), o.size()));
+}
+
+// Cl "fps" de la mta globale (fichiers ver 6)
+static double t3v_meta_fps(const std::string& m)
+{
+    T3Meta::MetaView mv;
+    std::string_view sv;
+    if(mv.parse(m)) return mv.get_str(T3Meta::kFps, sv) ? std::atof(std::string(sv).c_str()) : 0.0;
+    size_t k=m.find("\"fps\"");
+    if(k==std::string::npos || (k=m.find(':', k))==std::string::npos) return 0.0;
+    return std::atof(m.c_str()+k+1);
+}
+
+static bool t3v_put(const std::string& path,
+                    SubwordMode sub, int w, int h,
+                    const std::vector<std::vector<Word27>>& frames,
+                    const std::vector<T3VFrameTime>* times,
+                    const T3VTimeBase& tb,
+                    const std::string& meta_json_global,
+                    const std::vector<std::string>& metas_per_frame,
+                    std::string* err)
 {
     File fp; if(!fp.open(path, "wb")){ if(err)*err=strerror(errno); return false; }
 
     const char magic[4] = {'T','3','V','6'};
-    uint8_t ver=6, subu=(uint8_t)sub; uint16_t W=(uint16_t)w, H=(uint16_t)h;
+    uint8_t ver=times? 7 : 6, subu=(uint8_t)sub; uint16_t W=(uint16_t)w, H=(uint16_t)h;
     uint64_t frame_count = (uint64_t)frames.size();
     uint32_t meta_g_len  = (uint32_t)meta_json_global.size();
+    const uint32_t hdr_crc = t3v_hdr_crc(ver, subu, W, H, frame_count, meta_g_len);
+    long idx_pos = 0;
+    std::vector<T3Container::T3VFrameIndex> index(frames.size());
+    std::vector<uint8_t> idx_bytes;
 
     // Header
     if(!write_bytes(fp.f, magic, 4)) goto io_err;
@@ -241,30 +303,25 @@ bool t3v_write(const std::string& path,
     if(!write_le(fp.f, meta_g_len)) goto io_err;
 
     // CRC header
-    struct HdrBuf { uint8_t ver,subu; uint16_t W,H; uint64_t frame_count; uint32_t meta_g_len; }
-    hb{ver,subu,W,H,frame_count,meta_g_len};
-    uint32_t hdr_crc = crc32_acc(&hb, sizeof(hb));
     if(!write_le(fp.f, hdr_crc)) goto io_err;
 
     // Meta globale
     if(meta_g_len && !write_bytes(fp.f, meta_json_global.data(), meta_g_len)) goto io_err;
 
     // Placeholder index (sera rcrit ensuite)
-    const long idx_pos = std::ftell(fp.f);
-    std::vector<T3Container::T3VFrameIndex> index(frames.size());
+    idx_pos = std::ftell(fp.f);
     for(size_t i=0;i<frames.size();++i){
-        uint64_t off=0, words=frames[i].size(); uint32_t ml= (metas_per_frame.size()==frames.size()) ? (uint32_t)metas_per_frame[i].size() : 0;
-        if(!write_le(fp.f, off)) goto io_err; // offset placeholder
-        if(!write_le(fp.f, words)) goto io_err;
-        if(!write_le(fp.f, ml)) goto io_err;
+        index[i].words = (uint64_t)frames[i].size();
+        index[i].meta_len = (metas_per_frame.size()==frames.size()) ? (uint32_t)metas_per_frame[i].size() : 0;
+        if(times){ index[i].pts=(*times)[i].pts; index[i].flags=(*times)[i].flags; }
     }
+    t3v_index_bytes(ver, tb, index, idx_bytes);
+    if(!write_bytes(fp.f, idx_bytes.data(), idx_bytes.size())) goto io_err;
 
     // Frames data
     for(size_t i=0;i<frames.size();++i){
         index[i].offset = (uint64_t)std::ftell(fp.f);
         const std::string metaF = (metas_per_frame.size()==frames.size()) ? metas_per_frame[i] : std::string();
-        index[i].meta_len = (uint32_t)metaF.size();
-        index[i].words    = (uint64_t)frames[i].size();
 
         // Ecrire meta frame
         if(index[i].meta_len){
@@ -280,35 +337,65 @@ bool t3v_write(const std::string& path,
         }
     }
 
-    // Rcrire lindex avec offsets complets
+    // Rcrire l'index avec offsets complets
+    t3v_index_bytes(ver, tb, index, idx_bytes);
     std::fseek(fp.f, idx_pos, SEEK_SET);
-    for(size_t i=0;i<index.size();++i){
-        if(!write_le(fp.f, index[i].offset)) goto io_err;
-        if(!write_le(fp.f, index[i].words))  goto io_err;
-        if(!write_le(fp.f, index[i].meta_len)) goto io_err;
-    }
+    if(!write_bytes(fp.f, idx_bytes.data(), idx_bytes.size())) goto io_err;
     return true;
 
 io_err:
     if(err)*err="t3v_write: I/O error";
     return false;
 }
+} // namespace
+
+bool t3v_write(const std::string& path,
+               SubwordMode sub, int w, int h,
+               const std::vector<std::vector<Word27>>& frames,
+               const std::string& meta_json_global,
+               const std::vector<std::string>& metas_per_frame,
+               std::string* err)
+{
+    return t3v_put(path, sub, w, h, frames, nullptr, T3VTimeBase{}, meta_json_global, metas_per_frame, err);
+}
+
+bool t3v_write_timed(const std::string& path,
+                     SubwordMode sub, int w, int h,
+                     const std::vector<std::vector<Word27>>& frames,
+                     const std::vector<T3VFrameTime>& times,
+                     const T3VTimeBase& tb,
+                     const std::string& meta_json_global,
+                     const std::vector<std::string>& metas_per_frame,
+                     std::string* err)
+{
+    if(times.size()!=frames.size()){ if(err)*err="t3v_write: times.size() != frames.size()"; return false; }
+    if(tb.num==0 || tb.den==0){ if(err)*err="t3v_write: invalid timebase"; return false; }
+    for(size_t i=1;i<times.size();++i){
+        if(times[i].pts < times[i-1].pts){ if(err)*err="t3v_write: pts must be non-decreasing"; return false; }
+    }
+    return t3v_put(path, sub, w, h, frames, &times, tb, meta_json_global, metas_per_frame, err);
+}
 
 bool t3v_read_header(const std::string& path,
                      SubwordMode& out_sub, int& out_w, int& out_h,
                      std::string& out_meta_json_global,
                      uint64_t& out_frame_count,
                      std::vector<T3VFrameIndex>& out_index,
-                     std::string* err)
+                     std::string* err,
+                     T3VTimeBase* out_tb)
 {
     out_meta_json_global.clear(); out_index.clear();
     out_sub=SubwordMode::S27; out_w=out_h=0; out_frame_count=0;
 
+    char magic[4];
+    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint64_t frame_count=0; uint32_t meta_g_len=0;
+    uint32_t hdr_crc=0;
+    T3VTimeBase tb;
+    std::vector<uint8_t> ib;
     File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
-    char magic[4]; if(!read_bytes(fp.f, magic, 4)) goto io_err;
+    if(!read_bytes(fp.f, magic, 4)) goto io_err;
     if(std::memcmp(magic, "T3V6", 4)!=0){ if(err)*err="t3v: bad magic"; return false; }
 
-    uint8_t ver=0, subu=0; uint16_t W=0,H=0; uint64_t frame_count=0; uint32_t meta_g_len=0;
     if(!read_le(fp.f, ver)) goto io_err;
     if(!read_le(fp.f, subu)) goto io_err;
     if(!read_le(fp.f, W)) goto io_err;
@@ -316,10 +403,9 @@ bool t3v_read_header(const std::string& path,
     if(!read_le(fp.f, frame_count)) goto io_err;
     if(!read_le(fp.f, meta_g_len)) goto io_err;
 
-    uint32_t hdr_crc=0; if(!read_le(fp.f, hdr_crc)) goto io_err;
-    struct HdrBuf { uint8_t ver,subu; uint16_t W,H; uint64_t frame_count; uint32_t meta_g_len; }
-    hb{ver,subu,W,H,frame_count,meta_g_len};
-    if(crc32_acc(&hb, sizeof(hb)) != hdr_crc){ if(err)*err="t3v: header crc mismatch"; return false; }
+    if(!read_le(fp.f, hdr_crc)) goto io_err;
+    if(t3v_hdr_crc(ver, subu, W, H, frame_count, meta_g_len) != hdr_crc){ if(err)*err="t3v: header crc mismatch"; return false; }
+    if(ver!=6 && ver!=7){ if(err)*err="t3v: unsupported version"; return false; }
 
     out_sub=(SubwordMode)subu; out_w=W; out_h=H; out_frame_count=frame_count;
 
@@ -328,12 +414,31 @@ bool t3v_read_header(const std::string& path,
         if(!read_bytes(fp.f, out_meta_json_global.data(), meta_g_len)) goto io_err;
     }
 
-    out_index.resize((size_t)frame_count);
-    for(size_t i=0;i<out_index.size();++i){
-        if(!read_le(fp.f, out_index[i].offset)) goto io_err;
-        if(!read_le(fp.f, out_index[i].words))  goto io_err;
-        if(!read_le(fp.f, out_index[i].meta_len)) goto io_err;
+    // Index lu d'un bloc puis dcod (ver 7 : CRC vrifi)
+    {
+        const size_t ebytes = (ver>=7) ? 32 : 20;
+        const size_t extra  = (ver>=7) ? 12 : 0;
+        ib.resize(extra + ebytes*(size_t)frame_count);
+        if(!read_bytes(fp.f, ib.data(), ib.size())) goto io_err;
+        const uint8_t* p = ib.data();
+        if(ver>=7){
+            if(crc32_acc(p, ib.size()-4) != ld_u32(p+ib.size()-4)){ if(err)*err="t3v: index crc mismatch"; return false; }
+            tb.num=ld_u32(p); tb.den=ld_u32(p+4);
+            p+=8;
+        }
+        else{
+            const double fps = t3v_meta_fps(out_meta_json_global);
+            if(fps>0.0){ tb.num=1000; tb.den=(uint32_t)(fps*1000.0 + 0.5); }
+        }
+        out_index.resize((size_t)frame_count);
+        for(size_t i=0;i<out_index.size();++i, p+=ebytes){
+            T3VFrameIndex& e = out_index[i];
+            e.offset=ld_u64(p); e.words=ld_u64(p+8); e.meta_len=ld_u32(p+16);
+            if(ver>=7){ e.flags=ld_u32(p+20); e.pts=(int64_t)ld_u64(p+24); }
+            else{ e.flags=T3V_FRAME_KEY; e.pts=(int64_t)i; }
+        }
     }
+    if(out_tb) *out_tb=tb;
     return true;
 
 io_err:
@@ -341,6 +446,36 @@ io_err:
     return false;
 }
 
+long t3v_seek_time(const std::vector<T3VFrameIndex>& index,
+                   const T3VTimeBase& tb, double t_seconds,
+                   bool key_only)
+{
+    if(index.empty() || tb.num==0) return -1;
+    const int64_t t_pts = (int64_t)std::floor((long double)t_seconds * tb.den / tb.num + 1e-9L);
+    auto it = std::upper_bound(index.begin(), index.end(), t_pts,
+                               [](int64_t t, const T3VFrameIndex& e){ return t < e.pts; });
+    long i = (it==index.begin()) ? 0 : (long)(it - index.begin()) - 1;
+    if(key_only){
+        long k=i;
+        while(k>0 && !(index[(size_t)k].flags & T3V_FRAME_KEY)) --k;
+        if(index[(size_t)k].flags & T3V_FRAME_KEY) i=k;
+    }
+    return i;
+}
+
+bool t3v_seek_time(const std::string& path, double t_seconds,
+                   uint64_t& out_frame_idx, bool key_only, std::string* err)
+{
+    SubwordMode sub; int W=0,H=0; std::string meta; uint64_t fc=0;
+    std::vector<T3VFrameIndex> idx;
+    T3VTimeBase tb;
+    if(!t3v_read_header(path, sub, W, H, meta, fc, idx, err, &tb)) return false;
+    const long i = t3v_seek_time(idx, tb, t_seconds, key_only);
+    if(i<0){ if(err)*err="t3v: empty video"; return false; }
+    out_frame_idx=(uint64_t)i;
+    return true;
+}
+
 bool t3v_read_frame(const std::string& path,
                     uint64_t frame_idx,
                     const ApproveMetaFn& approve_meta,
@@ -387,3 +522,1992 @@ bool t3v_read_frame(const std::string& path,
 
     return true;
 }
+
+// Montage .t3v : blocs frame copis tels quels, header + index rcrits.
+
+namespace {
+struct T3VSrc {
+    std::string path;
+    uint8_t ver=6;
+    SubwordMode sub=SubwordMode::S27;
+    int w=0, h=0;
+    std::string meta;
+    std::vector<T3VFrameIndex> index;
+    T3VTimeBase tb;
+    uint64_t begin=0, end=0; // frames retenues
+};
+
+// Mme fichier (st_dev/st_ino : chemins relatifs, liens) ; sans stat(), chemins
+static bool t3v_same_file(const std::string& a, const std::string& b){
+#if T3A_HAVE_MMAP
+    struct stat sa, sb;
+    if(::stat(a.c_str(), &sa)!=0 || ::stat(b.c_str(), &sb)!=0) return false;
+    return sa.st_dev==sb.st_dev && sa.st_ino==sb.st_ino;
+#else
+    return a==b;
+#endif
+}
+
+static uint64_t t3v_block_end(const T3VFrameIndex& e){
+    return e.offset + e.meta_len + e.words*sizeof(Word27) + 4;
+}
+
+static bool t3v_open_src(const std::string& path, T3VSrc& s, std::string* err){
+    s.path=path;
+    uint64_t n=0;
+    if(!t3v_read_header(path, s.sub, s.w, s.h, s.meta, n, s.index, err, &s.tb)) return false;
+    File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+    char magic[4];
+    if(!read_bytes(fp.f, magic, 4) || !read_le(fp.f, s.ver)){ if(err)*err="t3v: I/O error"; return false; }
+    std::fseek(fp.f, 0, SEEK_END);
+    const long size = std::ftell(fp.f);
+    for(const auto& e : s.index){
+        if(size<0 || t3v_block_end(e) > (uint64_t)size){ if(err)*err="t3v: frame block out of range ("+path+")"; return false; }
+    }
+    s.begin=0; s.end=n;
+    return true;
+}
+
+// pts de tb_in vers tb_out (arrondi)
+static int64_t t3v_rescale(int64_t pts, const T3VTimeBase& in, const T3VTimeBase& out){
+    if(in.num==out.num && in.den==out.den) return pts;
+    const long double t = (long double)pts * in.num * out.den / ((long double)in.den * out.num);
+    return (int64_t)std::llround(t);
+}
+
+// Copie de n octets in[src] -> out[dst] ; copy_file_range d'abord (reflink
+// selon le systme de fichiers), repli lecture/criture par tampon.
+static bool copy_block(FILE* in, FILE* out, uint64_t src, uint64_t dst, uint64_t n,
+                       bool& kernel, std::vector<uint8_t>& buf){
+#if defined(__linux__)
+    {
+        loff_t si=(loff_t)src, di=(loff_t)dst;
+        uint64_t left=n;
+        while(left){
+            const ssize_t r = copy_file_range(fileno(in), &si, fileno(out), &di, (size_t)std::min<uint64_t>(left, (uint64_t)1<<30), 0);
+            if(r<=0) break;
+            left-=(uint64_t)r;
+        }
+        if(!left){ kernel=true; return true; }
+        // Non support (EXDEV, ENOSYS, EINVAL...) : reprise en copie classique
+        src=(uint64_t)si; dst=(uint64_t)di; n=left;
+    }
+#endif
+    buf.resize((size_t)1<<20);
+    if(std::fseek(in, (long)src, SEEK_SET)!=0 || std::fseek(out, (long)dst, SEEK_SET)!=0) return false;
+    while(n){
+        const size_t k=(size_t)std::min<uint64_t>(n, buf.size());
+        if(!read_bytes(in, buf.data(), k) || !write_bytes(out, buf.data(), k)) return false;
+        n-=k;
+    }
+    return std::fflush(out)==0;
+}
+
+static bool t3v_splice(std::vector<T3VSrc>& srcs, const std::string& out,
+                       T3VEditStats* stats, std::string* err){
+    const T3VSrc& s0=srcs.front();
+    uint8_t ver=6;
+    for(const auto& s : srcs) if(s.ver>=7) ver=7;
+    const T3VTimeBase tb = s0.tb;
+
+    // Index de sortie : blocs  la suite, pts rebass
+    std::vector<T3VFrameIndex> index;
+    std::string meta_g=s0.meta;
+    const uint64_t head_bytes = 4+1+1+2+2+8+4+4 + meta_g.size();
+    uint64_t n=0;
+    for(const auto& s : srcs) n+=s.end-s.begin;
+    const uint64_t idx_bytes = (ver>=7) ? 8 + 32*n + 4 : 20*n;
+    uint64_t ofs = head_bytes + idx_bytes;
+    int64_t next_pts=0;
+    for(const auto& s : srcs){
+        if(s.begin==s.end) continue;
+        const int64_t shift = next_pts - t3v_rescale(s.index[(size_t)s.begin].pts, s.tb, tb);
+        for(uint64_t i=s.begin;i<s.end;++i){
+            T3VFrameIndex e=s.index[(size_t)i];
+            e.pts = t3v_rescale(e.pts, s.tb, tb) + shift;
+            const uint64_t len = t3v_block_end(e) - e.offset;
+            e.offset=ofs; ofs+=len;
+            index.push_back(e);
+        }
+        // Fichier suivant : une dure de frame aprs la dernire
+        const size_t last=index.size()-1;
+        const int64_t step = (s.end-s.begin>=2) ? index[last].pts - index[last-1].pts
+                                                 : std::max<int64_t>(1, t3v_rescale(1, s.tb, tb));
+        next_pts = index[last].pts + std::max<int64_t>(1, step);
+    }
+
+    std::vector<uint8_t> head, ib;
+    head.insert(head.end(), {'T','3','V','6', ver, (uint8_t)s0.sub});
+    put_u16(head, (uint16_t)s0.w); put_u16(head, (uint16_t)s0.h);
+    put_u64(head, n); put_u32(head, (uint32_t)meta_g.size());
+    put_u32(head, t3v_hdr_crc(ver, (uint8_t)s0.sub, (uint16_t)s0.w, (uint16_t)s0.h, n, (uint32_t)meta_g.size()));
+    head.insert(head.end(), meta_g.begin(), meta_g.end());
+    t3v_index_bytes(ver, tb, index, ib);
+    head.insert(head.end(), ib.begin(), ib.end());
+
+    // criture  ct puis rename() : un chec ne laisse jamais `out`  moiti crit
+    const std::string tmp = out + ".tmp";
+    File fo; if(!fo.open(tmp, "wb")){ if(err)*err=strerror(errno); return false; }
+    auto fail = [&](const std::string& m){
+        if(err)*err=m;
+        std::fclose(fo.f); fo.f=nullptr;
+        std::remove(tmp.c_str());
+        return false;
+    };
+    if(!write_bytes(fo.f, head.data(), head.size()) || std::fflush(fo.f)!=0) return fail("t3v_edit: I/O error");
+
+    // Blocs : plages contigus dans la source copies d'un seul appel
+    T3VEditStats st; st.frames=n;
+    std::vector<uint8_t> buf;
+    size_t k=0;
+    for(const auto& s : srcs){
+        File fi; if(!fi.open(s.path, "rb")) return fail(strerror(errno));
+        uint64_t i=s.begin;
+        while(i<s.end){
+            const uint64_t src=s.index[(size_t)i].offset, dst=index[k].offset;
+            uint64_t j=i+1, src_end=t3v_block_end(s.index[(size_t)i]);
+            while(j<s.end && s.index[(size_t)j].offset==src_end){ src_end=t3v_block_end(s.index[(size_t)j]); ++j; }
+            bool kernel=false;
+            if(!copy_block(fi.f, fo.f, src, dst, src_end-src, kernel, buf)) return fail("t3v_edit: copy failed");
+            st.kernel_copy = st.kernel_copy || kernel;
+            st.bytes += src_end-src;
+            k += (size_t)(j-i); i=j;
+        }
+    }
+    const bool closed = std::fclose(fo.f)==0;
+    fo.f=nullptr;
+    if(!closed){ std::remove(tmp.c_str()); if(err)*err="t3v_edit: I/O error"; return false; }
+    if(std::rename(tmp.c_str(), out.c_str())!=0){
+        std::remove(tmp.c_str());
+        if(err)*err="t3v_edit: rename failed";
+        return false;
+    }
+    if(stats) *stats=st;
+    return true;
+}
+} // namespace
+
+bool t3v_cut(const std::string& in, uint64_t begin, uint64_t end,
+             const std::string& out, T3VEditStats* stats, std::string* err)
+{
+    std::vector<T3VSrc> srcs(1);
+    if(t3v_same_file(in, out)){ if(err)*err="t3v_cut: output is the input"; return false; }
+    if(!t3v_open_src(in, srcs[0], err)) return false;
+    if(begin>end || end>srcs[0].end){ if(err)*err="t3v_cut: range out of bounds"; return false; }
+    srcs[0].begin=begin; srcs[0].end=end;
+    return t3v_splice(srcs, out, stats, err);
+}
+
+bool t3v_concat(const std::vector<std::string>& inputs, const std::string& out,
+                T3VEditStats* stats, std::string* err)
+{
+    if(inputs.empty()){ if(err)*err="t3v_concat: no input"; return false; }
+    std::vector<T3VSrc> srcs(inputs.size());
+    for(size_t i=0;i<inputs.size();++i){
+        if(inputs[i]==out || t3v_same_file(inputs[i], out)){ if(err)*err="t3v_concat: output is also an input"; return false; }
+        if(!t3v_open_src(inputs[i], srcs[i], err)) return false;
+        if(srcs[i].sub!=srcs[0].sub || srcs[i].w!=srcs[0].w || srcs[i].h!=srcs[0].h){
+            if(err)*err="t3v_concat: sub/w/h mismatch ("+inputs[i]+")"; return false;
+        }
+    }
+    return t3v_splice(srcs, out, stats, err);
+}
+
+// =============================== .t3pl ======================================
+// Plans de trits (T3Planes) : table des plans dans le header, 1 CRC par plan.
+
+namespace {
+struct T3PLHead {
+    uint8_t ver=1, subu=0; uint16_t W=0, H=0; uint8_t n_planes=0, rsv=0;
+    uint32_t meta_len=0; uint64_t words_count=0;
+};
+static constexpr size_t kT3PLHeadBytes  = 1+1+2+2+1+1+4+8; // aprs magic
+static constexpr size_t kT3PLEntryBytes = 1+3+8+4+4;
+
+// Header (hors magic) + table srialiss : base du CRC header
+static void t3pl_serialize_head(const T3PLHead& h, const std::vector<T3PLPlaneIndex>& planes,
+                                std::vector<uint8_t>& out)
+{
+    out.clear();
+    auto put = [&](const void* p, size_t n){ const uint8_t* b=(const uint8_t*)p; out.insert(out.end(), b, b+n); };
+    put(&h.ver,1); put(&h.subu,1); put(&h.W,2); put(&h.H,2);
+    put(&h.n_planes,1); put(&h.rsv,1); put(&h.meta_len,4); put(&h.words_count,8);
+    const uint8_t z[3]={0,0,0};
+    for(const auto& e : planes){
+        put(&e.digit,1); put(z,3); put(&e.offset,8); put(&e.bytes,4); put(&e.crc32,4);
+    }
+}
+// 1 mot par pixel : w*h, ou canevas S27 plein d'une image sub (embed centr)
+static bool t3pl_words_ok(SubwordMode sub, int w, int h, uint64_t n)
+{
+    WordRaster R;
+    return w<=0xFFFF && h<=0xFFFF && word_raster_for(n, sub, w, h, R) && (R.canvas || n==(uint64_t)w*h);
+}
+} // namespace
+
+bool t3pl_write(const std::string& path,
+                SubwordMode sub, int w, int h,
+                const std::vector<Word27>& words,
+                const std::string& meta_json,
+                std::string* err)
+{
+    if(!t3pl_words_ok(sub, w, h, (uint64_t)words.size())){
+        if(err)*err="t3pl_write: words.size() does not match w*h"; return false;
+    }
+    std::vector<std::vector<uint8_t>> planes;
+    T3Planes::pack_all_planes(words, planes);
+
+    T3PLHead hd;
+    hd.subu=(uint8_t)sub; hd.W=(uint16_t)w; hd.H=(uint16_t)h;
+    hd.n_planes=(uint8_t)T3Planes::kPlanes;
+    hd.meta_len=(uint32_t)meta_json.size(); hd.words_count=(uint64_t)words.size();
+
+    std::vector<T3PLPlaneIndex> index((size_t)T3Planes::kPlanes);
+    uint64_t ofs = 4 + kT3PLHeadBytes + kT3PLEntryBytes*index.size() + 4 + hd.meta_len;
+    for(size_t p=0;p<index.size();++p){
+        index[p].digit  = (uint8_t)T3Planes::kPlaneDigit[p];
+        index[p].offset = ofs;
+        index[p].bytes  = (uint32_t)planes[p].size();
+        index[p].crc32  = crc32_acc(planes[p].data(), planes[p].size());
+        ofs += planes[p].size();
+    }
+    std::vector<uint8_t> head;
+    t3pl_serialize_head(hd, index, head);
+    const uint32_t hdr_crc = crc32_acc(head.data(), head.size());
+
+    File fp; if(!fp.open(path, "wb")){ if(err)*err=strerror(errno); return false; }
+    if(!write_bytes(fp.f, "T3PL", 4)) goto io_err;
+    if(!write_bytes(fp.f, head.data(), head.size())) goto io_err;
+    if(!write_le(fp.f, hdr_crc)) goto io_err;
+    if(hd.meta_len && !write_bytes(fp.f, meta_json.data(), hd.meta_len)) goto io_err;
+    for(const auto& pl : planes){
+        if(!pl.empty() && !write_bytes(fp.f, pl.data(), pl.size())) goto io_err;
+    }
+    return true;
+
+io_err:
+    if(err)*err="t3pl_write: I/O error";
+    return false;
+}
+
+bool t3pl_read_header(const std::string& path,
+                      SubwordMode& out_sub, int& out_w, int& out_h,
+                      std::string& out_meta_json,
+                      uint64_t& out_words_count,
+                      std::vector<T3PLPlaneIndex>& out_planes,
+                      std::string* err)
+{
+    out_meta_json.clear(); out_planes.clear();
+    out_sub=SubwordMode::S27; out_w=out_h=0; out_words_count=0;
+
+    char magic[4];
+    T3PLHead hd;
+    uint8_t rsv3[3];
+    uint32_t hdr_crc=0;
+    std::vector<uint8_t> head;
+    File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+    if(!read_bytes(fp.f, magic, 4)) goto io_err;
+    if(std::memcmp(magic, "T3PL", 4)!=0){ if(err)*err="t3pl: bad magic"; return false; }
+
+    if(!read_le(fp.f, hd.ver) || !read_le(fp.f, hd.subu)) goto io_err;
+    if(!read_le(fp.f, hd.W) || !read_le(fp.f, hd.H)) goto io_err;
+    if(!read_le(fp.f, hd.n_planes) || !read_le(fp.f, hd.rsv)) goto io_err;
+    if(!read_le(fp.f, hd.meta_len) || !read_le(fp.f, hd.words_count)) goto io_err;
+    if(hd.ver!=1 || hd.n_planes>T3Planes::kPlanes){ if(err)*err="t3pl: unsupported version/planes"; return false; }
+
+    out_planes.resize(hd.n_planes);
+    for(auto& e : out_planes){
+        if(!read_le(fp.f, e.digit) || !read_bytes(fp.f, rsv3, 3)) goto io_err;
+        if(!read_le(fp.f, e.offset) || !read_le(fp.f, e.bytes) || !read_le(fp.f, e.crc32)) goto io_err;
+    }
+    if(!read_le(fp.f, hdr_crc)) goto io_err;
+    t3pl_serialize_head(hd, out_planes, head);
+    if(crc32_acc(head.data(), head.size()) != hdr_crc){
+        out_planes.clear();
+        if(err)*err="t3pl: header crc mismatch";
+        return false;
+    }
+    for(size_t p=0;p<out_planes.size();++p){
+        if(out_planes[p].digit != (uint8_t)T3Planes::kPlaneDigit[p]){
+            out_planes.clear();
+            if(err)*err="t3pl: unexpected plane order";
+            return false;
+        }
+    }
+
+    out_sub=(SubwordMode)hd.subu; out_w=hd.W; out_h=hd.H; out_words_count=hd.words_count;
+    if(hd.meta_len){
+        out_meta_json.resize(hd.meta_len);
+        if(!read_bytes(fp.f, out_meta_json.data(), hd.meta_len)) goto io_err;
+    }
+    return true;
+
+io_err:
+    if(err)*err="t3pl_read_header: I/O error";
+    return false;
+}
+
+bool t3pl_read(const std::string& path,
+               const ApproveMetaFn& approve_meta,
+               int max_planes,
+               std::vector<Word27>& out_words,
+               int* out_planes_read,
+               std::string* err)
+{
+    out_words.clear();
+    if(out_planes_read) *out_planes_read=0;
+
+    SubwordMode sub; int W=0,H=0; std::string meta; uint64_t n=0;
+    std::vector<T3PLPlaneIndex> idx;
+    if(!t3pl_read_header(path, sub, W, H, meta, n, idx, err)) return false;
+
+    // === APPROVE META-ONLY ===
+    if(approve_meta && !approve_meta(meta)){
+        if(err)*err="t3pl: meta not approved - payload not read";
+        return false;
+    }
+
+    // words_count et tailles de plans vrifis avant toute allocation
+    const size_t pbytes = T3Planes::plane_bytes((size_t)n);
+    if(!t3pl_words_ok(sub, W, H, n)){ if(err)*err="t3pl: words_count does not match w*h"; return false; }
+    for(const auto& e : idx){
+        if(e.bytes != pbytes){ if(err)*err="t3pl: plane size does not match words_count"; return false; }
+    }
+
+    File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+    const int want = std::min<int>(max_planes<0? T3Planes::kPlanes : max_planes, (int)idx.size());
+    std::vector<std::vector<uint8_t>> planes;
+    std::vector<const uint8_t*> ptrs;
+    for(int p=0;p<want;++p){
+        const T3PLPlaneIndex& e = idx[(size_t)p];
+        std::vector<uint8_t> buf(e.bytes);
+        // Fichier tronqu (livraison partielle) ou plan corrompu : arrt propre,
+        // les plans suivants sont remplacs par le centre d'intervalle.
+        if(std::fseek(fp.f, (long)e.offset, SEEK_SET)!=0) break;
+        if(!read_bytes(fp.f, buf.data(), buf.size())) break;
+        if(crc32_acc(buf.data(), buf.size()) != e.crc32) break;
+        planes.push_back(std::move(buf));
+    }
+    for(const auto& pl : planes) ptrs.push_back(pl.data());
+
+    T3Planes::rebuild_words(ptrs, (int)ptrs.size(), (size_t)n, out_words);
+    if(out_planes_read) *out_planes_read=(int)ptrs.size();
+    return true;
+}
+
+// =============================== .t3a =======================================
+// Archive de blobs .t3p : header (pointeur de rpertoire) | blobs | rpertoire.
+
+namespace {
+static constexpr size_t kT3AHeadBytes  = 32;
+static constexpr size_t kT3AEntryBytes = 48;
+static constexpr size_t kT3PHeadBytes  = 4+1+1+2+2+4+8+4; // T3P6 jusqu'au CRC header
+
+struct T3AHead {
+    uint64_t dir_offset=0, dir_bytes=0;
+    uint32_t dir_crc=0, n_entries=0;
+};
+static void t3a_serialize_head(const T3AHead& h, uint8_t out[kT3AHeadBytes]){
+    std::vector<uint8_t> o;
+    o.insert(o.end(), {'T','3','A','1', 1, 0, 0, 0});
+    put_u64(o, h.dir_offset); put_u64(o, h.dir_bytes);
+    put_u32(o, h.dir_crc);    put_u32(o, h.n_entries);
+    std::memcpy(out, o.data(), kT3AHeadBytes);
+}
+static bool t3a_parse_head(const uint8_t* p, size_t n, T3AHead& h){
+    if(n < kT3AHeadBytes || std::memcmp(p, "T3A1", 4)!=0 || p[4]!=1) return false;
+    h.dir_offset=ld_u64(p+8); h.dir_bytes=ld_u64(p+16);
+    h.dir_crc=ld_u32(p+24);   h.n_entries=ld_u32(p+28);
+    return true;
+}
+
+// Header T3P6 d'un blob mmoire (CRC header vrifi) -> champs d'entre
+static bool t3p_blob_head(const uint8_t* p, size_t n, T3AEntry& e, uint64_t& words_count){
+    if(n < kT3PHeadBytes || std::memcmp(p, "T3P6", 4)!=0) return false;
+    const uint16_t W=ld_u16(p+6), H=ld_u16(p+8);
+    const uint32_t meta_len=ld_u32(p+10);
+    const uint64_t wc=ld_u64(p+14);
+    if(t3p_hdr_crc(p[4], p[5], W, H, meta_len, wc) != ld_u32(p+22)) return false;
+    // wc born par la taille du blob avant multiplication (somme sans dbordement)
+    if(wc > ((uint64_t)n - kT3PHeadBytes)/sizeof(Word27)) return false;
+    if((uint64_t)n != kT3PHeadBytes + meta_len + wc*sizeof(Word27) + 4) return false;
+    e.sub=(SubwordMode)p[5]; e.w=W; e.h=H;
+    e.meta_len=meta_len; e.meta_offset=kT3PHeadBytes; // relatif au blob
+    words_count=wc;
+    return true;
+}
+
+// Rpertoire : entres | n_slots + slots | noms
+static void t3a_build_dir(const std::vector<T3AEntry>& entries, std::vector<uint8_t>& out){
+    out.clear();
+    size_t n_slots=8;
+    while(n_slots < 2*entries.size()) n_slots<<=1;
+    std::vector<uint32_t> slots(n_slots, 0);
+    uint32_t name_ofs=0;
+    for(size_t i=0;i<entries.size();++i){
+        const T3AEntry& e=entries[i];
+        put_u64(out, e.name_hash); put_u64(out, e.offset); put_u64(out, e.bytes);
+        put_u64(out, e.meta_offset); put_u32(out, e.meta_len);
+        put_u16(out, e.w); put_u16(out, e.h);
+        out.push_back((uint8_t)e.sub); out.push_back(0);
+        put_u16(out, (uint16_t)e.name.size()); put_u32(out, name_ofs);
+        name_ofs += (uint32_t)e.name.size();
+        size_t s=(size_t)e.name_hash & (n_slots-1);
+        while(slots[s]) s=(s+1) & (n_slots-1);
+        slots[s]=(uint32_t)i+1;
+    }
+    put_u32(out, (uint32_t)n_slots);
+    for(uint32_t v : slots) put_u32(out, v);
+    for(const auto& e : entries) out.insert(out.end(), e.name.begin(), e.name.end());
+}
+
+// Dcoupe d'un rpertoire (bornes vrifies) ; entre i  dir + 48*i
+static bool t3a_split_dir(const uint8_t* dir, size_t n, size_t n_entries,
+                          const uint8_t*& slots, size_t& n_slots,
+                          const uint8_t*& names, size_t& names_len){
+    const size_t ebytes = kT3AEntryBytes*n_entries;
+    if(n < ebytes + 4) return false;
+    n_slots = ld_u32(dir+ebytes);
+    if(n_slots==0 || (n_slots & (n_slots-1)) || n_slots < n_entries
+       || n < ebytes + 4 + 4*n_slots) return false;
+    slots = dir + ebytes + 4;
+    names = slots + 4*n_slots;
+    names_len = n - (ebytes + 4 + 4*n_slots);
+    return true;
+}
+static bool t3a_dir_entry(const uint8_t* dir, size_t i, const uint8_t* names, size_t names_len,
+                          T3AEntry& e){
+    const uint8_t* p = dir + kT3AEntryBytes*i;
+    e.name_hash=ld_u64(p); e.offset=ld_u64(p+8); e.bytes=ld_u64(p+16);
+    e.meta_offset=ld_u64(p+24); e.meta_len=ld_u32(p+32);
+    e.w=ld_u16(p+36); e.h=ld_u16(p+38); e.sub=(SubwordMode)p[40];
+    const size_t nl=ld_u16(p+42), no=ld_u32(p+44);
+    if(no + nl > names_len) return false;
+    e.name.assign((const char*)names + no, nl);
+    return true;
+}
+} // namespace
+
+uint64_t t3a_name_hash(const std::string& name)
+{
+    uint64_t h=1469598103934665603ull;           // FNV-1a 64
+    for(unsigned char c : name){ h^=c; h*=1099511628211ull; }
+    return h;
+}
+
+// ------------------------------- Lecteur ------------------------------------
+
+T3AReader::~T3AReader(){ close(); }
+
+void T3AReader::close()
+{
+#if T3A_HAVE_MMAP
+    if(mapped_ && base_) munmap((void*)base_, len_);
+#endif
+    base_=nullptr; len_=0; mapped_=false;
+    heap_.clear(); heap_.shrink_to_fit();
+    dir_=slots_=names_=nullptr;
+    n_=n_slots_=names_len_=0;
+}
+
+bool T3AReader::open(const std::string& path, std::string* err)
+{
+    close();
+#if T3A_HAVE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd<0){ if(err)*err=strerror(errno); return false; }
+    struct stat st{};
+    if(fstat(fd, &st)!=0 || st.st_size < (off_t)kT3AHeadBytes){
+        ::close(fd); if(err)*err="t3a: file too small";
+        return false;
+    }
+    void* m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(m==MAP_FAILED){ if(err)*err=strerror(errno); return false; }
+    base_=(const uint8_t*)m; len_=(size_t)st.st_size; mapped_=true;
+#else
+    {
+        File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+        std::fseek(fp.f, 0, SEEK_END);
+        const long n = std::ftell(fp.f);
+        std::fseek(fp.f, 0, SEEK_SET);
+        heap_.resize(n>0? (size_t)n : 0);
+        if(!heap_.empty() && !read_bytes(fp.f, heap_.data(), heap_.size())){
+            if(err)*err="t3a: I/O error";
+            return false;
+        }
+        base_=heap_.data(); len_=heap_.size();
+    }
+#endif
+    T3AHead hd;
+    if(!t3a_parse_head(base_, len_, hd)){ close(); if(err)*err="t3a: bad header"; return false; }
+    if(hd.n_entries==0 && hd.dir_offset==0) return true; // archive vide
+    if(hd.dir_offset < kT3AHeadBytes || hd.dir_offset > (uint64_t)len_
+       || hd.dir_bytes > (uint64_t)len_ - hd.dir_offset){
+        close(); if(err)*err="t3a: directory out of range";
+        return false;
+    }
+    dir_ = base_ + hd.dir_offset;
+    if(crc32_acc(dir_, (size_t)hd.dir_bytes) != hd.dir_crc){
+        close(); if(err)*err="t3a: directory crc mismatch";
+        return false;
+    }
+    if(!t3a_split_dir(dir_, (size_t)hd.dir_bytes, hd.n_entries, slots_, n_slots_, names_, names_len_)){
+        close(); if(err)*err="t3a: bad directory";
+        return false;
+    }
+    n_=hd.n_entries;
+    return true;
+}
+
+T3AEntry T3AReader::entry(size_t i) const
+{
+    T3AEntry e;
+    if(i<n_) t3a_dir_entry(dir_, i, names_, names_len_, e);
+    return e;
+}
+
+long T3AReader::find(const std::string& name) const
+{
+    if(n_==0) return -1;
+    const uint64_t h = t3a_name_hash(name);
+    size_t s=(size_t)h & (n_slots_-1);
+    for(size_t probe=0; probe<n_slots_; ++probe, s=(s+1) & (n_slots_-1)){
+        const uint32_t v = ld_u32(slots_ + 4*s);
+        if(v==0 || v>n_) return -1;
+        const uint8_t* p = dir_ + kT3AEntryBytes*(v-1);
+        if(ld_u64(p)!=h) continue;
+        const size_t nl=ld_u16(p+42), no=ld_u32(p+44);
+        if(nl==name.size() && no+nl<=names_len_ && std::memcmp(names_+no, name.data(), nl)==0)
+            return (long)(v-1);
+    }
+    return -1;
+}
+
+const uint8_t* T3AReader::blob(size_t i, size_t* n) const
+{
+    if(n) *n=0;
+    if(i>=n_) return nullptr;
+    const uint8_t* p = dir_ + kT3AEntryBytes*i;
+    const uint64_t ofs=ld_u64(p+8), bytes=ld_u64(p+16);
+    if(ofs > (uint64_t)len_ || bytes > (uint64_t)len_ - ofs) return nullptr;
+    if(n) *n=(size_t)bytes;
+    return base_ + ofs;
+}
+
+std::string T3AReader::meta(size_t i) const
+{
+    if(i>=n_) return {};
+    const uint8_t* p = dir_ + kT3AEntryBytes*i;
+    const uint64_t mo=ld_u64(p+24), ml=ld_u32(p+32);
+    if(mo + ml > (uint64_t)len_) return {};
+    return std::string((const char*)base_ + mo, (size_t)ml);
+}
+
+bool T3AReader::read_payload(size_t i, const ApproveMetaFn& approve_meta,
+                             std::vector<Word27>& out_words, std::string* err) const
+{
+    out_words.clear();
+    size_t n=0;
+    const uint8_t* b = blob(i, &n);
+    T3AEntry e; uint64_t wc=0;
+    if(!b || !t3p_blob_head(b, n, e, wc)){ if(err)*err="t3a: bad entry"; return false; }
+
+    // === APPROVE META-ONLY ===
+    if(approve_meta && !approve_meta(std::string((const char*)b + kT3PHeadBytes, e.meta_len))){
+        if(err)*err="t3a: meta not approved - payload not read";
+        return false;
+    }
+    const uint8_t* w = b + kT3PHeadBytes + e.meta_len;
+    const size_t wbytes = (size_t)wc*sizeof(Word27);
+    const uint32_t pl_crc = ld_u32(w + wbytes);
+    if((wc ? crc32_acc(w, wbytes) : 0u) != pl_crc){ if(err)*err="t3a: payload crc mismatch"; return false; }
+    out_words.resize((size_t)wc);
+    if(wbytes) std::memcpy(out_words.data(), w, wbytes);
+    return true;
+}
+
+bool T3AReader::extract_t3p(size_t i, const std::string& out_path, std::string* err) const
+{
+    size_t n=0;
+    const uint8_t* b = blob(i, &n);
+    if(!b){ if(err)*err="t3a: bad entry"; return false; }
+    File fp; if(!fp.open(out_path, "wb")){ if(err)*err=strerror(errno); return false; }
+    if(!write_bytes(fp.f, b, n)){ if(err)*err="t3a: I/O error"; return false; }
+    return true;
+}
+
+// ------------------------------- crivain -----------------------------------
+
+T3AWriter::~T3AWriter()
+{
+    if(f_){
+        if(dirty_) commit(nullptr);
+        std::fclose(f_);
+    }
+}
+
+bool T3AWriter::open(const std::string& path, std::string* err)
+{
+    entries_.clear(); index_.clear(); dirty_=false;
+    f_ = std::fopen(path.c_str(), "r+b");
+    if(!f_){
+        // Nouvelle archive : header vide
+        f_ = std::fopen(path.c_str(), "w+b");
+        if(!f_){ if(err)*err=strerror(errno); return false; }
+        uint8_t head[kT3AHeadBytes];
+        t3a_serialize_head(T3AHead{}, head);
+        if(!write_bytes(f_, head, kT3AHeadBytes)){ if(err)*err="t3a_write: I/O error"; return false; }
+        end_ = kT3AHeadBytes;
+        return true;
+    }
+    uint8_t head[kT3AHeadBytes];
+    T3AHead hd;
+    if(!read_bytes(f_, head, kT3AHeadBytes) || !t3a_parse_head(head, kT3AHeadBytes, hd)){
+        if(err)*err="t3a: bad header";
+        return false;
+    }
+    std::fseek(f_, 0, SEEK_END);
+    end_ = (uint64_t)std::ftell(f_);
+    if(hd.dir_offset==0) return true;
+    if(hd.dir_offset < kT3AHeadBytes || hd.dir_offset > end_ || hd.dir_bytes > end_ - hd.dir_offset){
+        if(err)*err="t3a: directory out of range";
+        return false;
+    }
+
+    // Reprise : rpertoire courant recharg ; les octets au-del (ajout
+    // interrompu) seront recouverts par les prochains blobs.
+    std::vector<uint8_t> dir((size_t)hd.dir_bytes);
+    const uint8_t *slots=nullptr, *names=nullptr;
+    size_t n_slots=0, names_len=0;
+    if(std::fseek(f_, (long)hd.dir_offset, SEEK_SET)!=0 || !read_bytes(f_, dir.data(), dir.size())
+       || crc32_acc(dir.data(), dir.size())!=hd.dir_crc
+       || !t3a_split_dir(dir.data(), dir.size(), hd.n_entries, slots, n_slots, names, names_len)){
+        if(err)*err="t3a: bad directory";
+        return false;
+    }
+    entries_.resize(hd.n_entries);
+    for(size_t i=0;i<entries_.size();++i){
+        if(!t3a_dir_entry(dir.data(), i, names, names_len, entries_[i])){
+            if(err)*err="t3a: bad directory";
+            return false;
+        }
+        index_.emplace(entries_[i].name, i);
+    }
+    end_ = hd.dir_offset + hd.dir_bytes;
+    return true;
+}
+
+bool T3AWriter::append_entry(T3AEntry e, std::string* err)
+{
+    e.name_hash = t3a_name_hash(e.name);
+    e.meta_offset += e.offset;
+    auto it = index_.find(e.name);
+    if(it!=index_.end()){
+        entries_[it->second]=std::move(e);
+        dirty_=true;
+        return true;
+    }
+    if(e.name.size() > 0xFFFFu){ if(err)*err="t3a: name too long"; return false; }
+    index_.emplace(e.name, entries_.size());
+    entries_.push_back(std::move(e));
+    dirty_=true;
+    return true;
+}
+
+bool T3AWriter::add(const std::string& name,
+                    SubwordMode sub, int w, int h,
+                    const std::vector<Word27>& words,
+                    const std::string& meta_json,
+                    std::string* err)
+{
+    if(!f_){ if(err)*err="t3a: not open"; return false; }
+    if(std::fseek(f_, (long)end_, SEEK_SET)!=0 || !t3p_put(f_, sub, w, h, words, meta_json)){
+        if(err)*err="t3a_write: I/O error";
+        return false;
+    }
+    T3AEntry e;
+    e.name=name; e.offset=end_;
+    e.bytes = kT3PHeadBytes + meta_json.size() + words.size()*sizeof(Word27) + 4;
+    e.meta_offset=kT3PHeadBytes; e.meta_len=(uint32_t)meta_json.size();
+    e.w=(uint16_t)w; e.h=(uint16_t)h; e.sub=sub;
+    end_ += e.bytes;
+    return append_entry(std::move(e), err);
+}
+
+bool T3AWriter::add_t3p_file(const std::string& name, const std::string& t3p_path, std::string* err)
+{
+    if(!f_){ if(err)*err="t3a: not open"; return false; }
+    std::vector<uint8_t> buf;
+    {
+        File fp; if(!fp.open(t3p_path, "rb")){ if(err)*err=strerror(errno); return false; }
+        std::fseek(fp.f, 0, SEEK_END);
+        const long n = std::ftell(fp.f);
+        std::fseek(fp.f, 0, SEEK_SET);
+        buf.resize(n>0? (size_t)n : 0);
+        if(!buf.empty() && !read_bytes(fp.f, buf.data(), buf.size())){ if(err)*err="t3a: I/O error"; return false; }
+    }
+    T3AEntry e; uint64_t wc=0;
+    if(!t3p_blob_head(buf.data(), buf.size(), e, wc)){ if(err)*err="t3a: not a valid .t3p: "+t3p_path; return false; }
+    if(std::fseek(f_, (long)end_, SEEK_SET)!=0 || !write_bytes(f_, buf.data(), buf.size())){
+        if(err)*err="t3a_write: I/O error";
+        return false;
+    }
+    e.name=name; e.offset=end_; e.bytes=buf.size();
+    end_ += e.bytes;
+    return append_entry(std::move(e), err);
+}
+
+bool T3AWriter::commit(std::string* err)
+{
+    if(!f_){ if(err)*err="t3a: not open"; return false; }
+    std::vector<uint8_t> dir;
+    t3a_build_dir(entries_, dir);
+    T3AHead hd;
+    hd.dir_offset=end_; hd.dir_bytes=dir.size();
+    hd.dir_crc=crc32_acc(dir.data(), dir.size());
+    hd.n_entries=(uint32_t)entries_.size();
+    uint8_t head[kT3AHeadBytes];
+    t3a_serialize_head(hd, head);
+
+    // 1) rpertoire en fin de fichier, 2) bascule du header
+    if(std::fseek(f_, (long)end_, SEEK_SET)!=0 || !write_bytes(f_, dir.data(), dir.size())
+       || std::fflush(f_)!=0
+       || std::fseek(f_, 0, SEEK_SET)!=0 || !write_bytes(f_, head, kT3AHeadBytes)
+       || std::fflush(f_)!=0){
+        if(err)*err="t3a_commit: I/O error";
+        return false;
+    }
+    end_ += dir.size();
+    dirty_=false;
+    return true;
+}
+
+// ========================== .t3k / .t3r (chunks) ============================
+// Magasin adress par contenu : pack d'enregistrements + index (refcounts).
+
+namespace {
+static constexpr size_t kT3KHeadBytes = 16;
+static constexpr size_t kT3KRecBytes  = 8+8+4;
+static constexpr size_t kT3KIdxEntry  = 32;
+static constexpr size_t kT3KIdxHead   = 4+4+8+8+8;
+
+static void t3k_serialize_head(uint64_t gen, uint8_t out[kT3KHeadBytes]){
+    std::vector<uint8_t> o;
+    o.insert(o.end(), {'T','3','K','1', 1, 0, 0, 0});
+    put_u64(o, gen);
+    std::memcpy(out, o.data(), kT3KHeadBytes);
+}
+
+static bool read_whole(const std::string& path, std::vector<uint8_t>& buf){
+    File fp; if(!fp.open(path, "rb")) return false;
+    std::fseek(fp.f, 0, SEEK_END);
+    const long n = std::ftell(fp.f);
+    std::fseek(fp.f, 0, SEEK_SET);
+    buf.resize(n>0? (size_t)n : 0);
+    return buf.empty() || read_bytes(fp.f, buf.data(), buf.size());
+}
+
+// Fichier crit  ct puis renomm (remplacement atomique sous POSIX)
+static bool write_replace(const std::string& path, const std::vector<uint8_t>& data){
+    const std::string tmp = path + ".tmp";
+    {
+        File fp; if(!fp.open(tmp, "wb")) return false;
+        if(!write_bytes(fp.f, data.data(), data.size()) || std::fflush(fp.f)!=0) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str())==0;
+}
+
+struct T3KIdx {
+    uint64_t gen=0, pack_end=0;
+    std::vector<std::pair<T3Chunk::Hash128, uint64_t>> keys; // hash, offset
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;        // bytes, refs
+};
+static bool t3k_parse_idx(const std::vector<uint8_t>& b, T3KIdx& x){
+    if(b.size() < kT3KIdxHead + 4 || std::memcmp(b.data(), "T3KI", 4)!=0 || b[4]!=1) return false;
+    if(crc32_acc(b.data()+4, b.size()-8) != ld_u32(b.data()+b.size()-4)) return false;
+    x.gen=ld_u64(b.data()+8); x.pack_end=ld_u64(b.data()+16);
+    const uint64_t n=ld_u64(b.data()+24);
+    if(n > (b.size() - kT3KIdxHead - 4) / kT3KIdxEntry) return false;
+    x.keys.resize((size_t)n); x.sizes.resize((size_t)n);
+    for(size_t i=0;i<(size_t)n;++i){
+        const uint8_t* p = b.data() + kT3KIdxHead + kT3KIdxEntry*i;
+        x.keys[i] = { T3Chunk::Hash128{ld_u64(p), ld_u64(p+8)}, ld_u64(p+16) };
+        x.sizes[i] = { ld_u32(p+24), ld_u32(p+28) };
+    }
+    return true;
+}
+
+static void t3r_serialize(const T3RInfo& I, std::vector<uint8_t>& o){
+    o.clear();
+    o.insert(o.end(), {'T','3','R','1', 1, (uint8_t)I.sub});
+    put_u16(o, (uint16_t)I.w); put_u16(o, (uint16_t)I.h);
+    put_u16(o, I.layout.tile_w); put_u16(o, I.layout.tile_h);
+    put_u32(o, (uint32_t)I.frames.size()); put_u32(o, (uint32_t)I.meta_json.size());
+    o.insert(o.end(), I.meta_json.begin(), I.meta_json.end());
+    for(const auto& F : I.frames){
+        put_u32(o, (uint32_t)F.meta.size()); put_u64(o, F.words);
+        put_u32(o, (uint32_t)F.refs.size()); put_u32(o, F.payload_crc32);
+        o.insert(o.end(), F.meta.begin(), F.meta.end());
+        for(const auto& r : F.refs){ put_u64(o, r.lo); put_u64(o, r.hi); }
+    }
+    put_u32(o, crc32_acc(o.data()+4, o.size()-4));
+}
+} // namespace
+
+bool t3r_read_header(const std::string& path, T3RInfo& out, std::string* err)
+{
+    out = T3RInfo{};
+    std::vector<uint8_t> b;
+    if(!read_whole(path, b)){ if(err)*err=strerror(errno); return false; }
+    if(b.size() < 26 || std::memcmp(b.data(), "T3R1", 4)!=0 || b[4]!=1){ if(err)*err="t3r: bad header"; return false; }
+    if(crc32_acc(b.data()+4, b.size()-8) != ld_u32(b.data()+b.size()-4)){ if(err)*err="t3r: crc mismatch"; return false; }
+
+    const uint8_t* p = b.data();
+    const size_t end = b.size()-4;
+    size_t k = 22;
+    out.sub=(SubwordMode)p[5]; out.w=ld_u16(p+6); out.h=ld_u16(p+8);
+    out.layout.tile_w=ld_u16(p+10); out.layout.tile_h=ld_u16(p+12);
+    const uint32_t n_frames=ld_u32(p+14), meta_len=ld_u32(p+18);
+    if(meta_len > end-k){ if(err)*err="t3r: truncated"; return false; }
+    out.meta_json.assign((const char*)p+k, meta_len); k+=meta_len;
+    for(uint32_t i=0;i<n_frames;++i){
+        if(end-k < 20){ if(err)*err="t3r: truncated"; return false; }
+        T3RFrame F;
+        const uint32_t ml=ld_u32(p+k); F.words=ld_u64(p+k+4);
+        const uint32_t nc=ld_u32(p+k+12); F.payload_crc32=ld_u32(p+k+16);
+        k+=20;
+        if(ml > end-k || (uint64_t)nc*16 > end-k-ml){ if(err)*err="t3r: truncated"; return false; }
+        F.meta.assign((const char*)p+k, ml); k+=ml;
+        F.refs.resize(nc);
+        for(auto& r : F.refs){ r.lo=ld_u64(p+k); r.hi=ld_u64(p+k+8); k+=16; }
+        out.frames.push_back(std::move(F));
+    }
+    return true;
+}
+
+// ------------------------------- Magasin ------------------------------------
+
+T3ChunkStore::~T3ChunkStore(){ close(); }
+
+void T3ChunkStore::close()
+{
+    if(f_) std::fclose(f_);
+    f_=nullptr; end_=0;
+    map_.clear();
+    cache_.clear();
+}
+
+bool T3ChunkStore::open(const std::string& pack_path, std::string* err)
+{
+    close();
+    path_ = pack_path;
+    const std::string idx = path_ + ".idx";
+    f_ = std::fopen(path_.c_str(), "r+b");
+    if(!f_){
+        f_ = std::fopen(path_.c_str(), "w+b");
+        if(!f_){ if(err)*err=strerror(errno); return false; }
+        uint8_t head[kT3KHeadBytes];
+        t3k_serialize_head(0, head);
+        if(!write_bytes(f_, head, kT3KHeadBytes)){ if(err)*err="t3k: I/O error"; close(); return false; }
+        end_ = kT3KHeadBytes;
+        return commit(err);
+    }
+    uint8_t head[kT3KHeadBytes];
+    if(!read_bytes(f_, head, kT3KHeadBytes) || std::memcmp(head, "T3K1", 4)!=0 || head[4]!=1){
+        if(err)*err="t3k: bad header";
+        close();
+        return false;
+    }
+    const uint64_t gen = ld_u64(head+8);
+
+    std::vector<uint8_t> b;
+    T3KIdx x;
+    bool ok = read_whole(idx, b) && t3k_parse_idx(b, x);
+    if(!ok || x.gen!=gen){
+        // gc interrompu aprs la bascule du pack : on termine avec .idx.gc
+        std::vector<uint8_t> g;
+        T3KIdx y;
+        if(read_whole(idx + ".gc", g) && t3k_parse_idx(g, y) && y.gen==gen
+           && std::rename((idx + ".gc").c_str(), idx.c_str())==0){
+            x=std::move(y);
+            ok=true;
+        }
+        else ok=false;
+    }
+    else std::remove((idx + ".gc").c_str()); // gc interrompu avant la bascule
+    std::remove((path_ + ".gc").c_str());
+    if(!ok){ if(err)*err="t3k: index missing or corrupt"; close(); return false; }
+
+    std::fseek(f_, 0, SEEK_END);
+    if((uint64_t)std::ftell(f_) < x.pack_end || x.pack_end < kT3KHeadBytes){
+        if(err)*err="t3k: pack shorter than index";
+        close();
+        return false;
+    }
+    end_ = x.pack_end;
+    map_.reserve(x.keys.size());
+    for(size_t i=0;i<x.keys.size();++i){
+        Loc L; L.offset=x.keys[i].second; L.bytes=x.sizes[i].first; L.refs=x.sizes[i].second;
+        if(L.offset + L.bytes > end_){ if(err)*err="t3k: index out of range"; close(); return false; }
+        map_.emplace(x.keys[i].first, L);
+    }
+    return true;
+}
+
+// Index courant -> <pack>.idx (point de validation)
+bool T3ChunkStore::commit(std::string* err)
+{
+    uint8_t head[kT3KHeadBytes];
+    if(std::fflush(f_)!=0 || std::fseek(f_, 0, SEEK_SET)!=0 || !read_bytes(f_, head, kT3KHeadBytes)){
+        if(err)*err="t3k: I/O error";
+        return false;
+    }
+    std::vector<uint8_t> o;
+    o.reserve(kT3KIdxHead + kT3KIdxEntry*map_.size() + 4);
+    o.insert(o.end(), {'T','3','K','I', 1, 0, 0, 0});
+    put_u64(o, ld_u64(head+8)); put_u64(o, end_); put_u64(o, map_.size());
+    for(const auto& kv : map_){
+        put_u64(o, kv.first.lo); put_u64(o, kv.first.hi);
+        put_u64(o, kv.second.offset); put_u32(o, kv.second.bytes); put_u32(o, kv.second.refs);
+    }
+    put_u32(o, crc32_acc(o.data()+4, o.size()-4));
+    if(!write_replace(path_ + ".idx", o)){ if(err)*err="t3k_commit: I/O error"; return false; }
+    return true;
+}
+
+bool T3ChunkStore::put_frames(const std::string& t3r_path, SubwordMode sub, int w, int h,
+                              const std::vector<const std::vector<Word27>*>& frames,
+                              const std::string& meta_g, const std::vector<std::string>& metas,
+                              T3KStats* stats, std::string* err)
+{
+    if(!f_){ if(err)*err="t3k: not open"; return false; }
+    T3KStats st;
+    T3RInfo I;
+    I.sub=sub; I.w=w; I.h=h; I.layout=layout_; I.meta_json=meta_g;
+    I.frames.resize(frames.size());
+
+    std::vector<std::vector<Word27>> bufs;
+    bool io_ok = true;
+    for(size_t f=0; f<frames.size() && io_ok; ++f){
+        const std::vector<Word27>& words = *frames[f];
+        T3RFrame& F = I.frames[f];
+        F.meta = (metas.size()==frames.size()) ? metas[f] : std::string();
+        F.words = words.size();
+        F.payload_crc32 = crc32_acc(words.data(), sizeof(Word27)*words.size());
+
+        // Dcoupe + hash des tuiles (en parallle), puis criture squentielle
+        const T3Chunk::Grid G = T3Chunk::grid_for(words.size(), w, h, layout_);
+        bufs.resize(G.n_chunks);
+        F.refs.resize(G.n_chunks);
+        T3Par::parallel_for(G.n_chunks, [&](size_t c0, size_t c1){
+            for(size_t c=c0; c<c1; ++c){
+                T3Chunk::gather(words.data(), G, c, bufs[c]);
+                F.refs[c] = T3Chunk::hash128(bufs[c].data(), bufs[c].size()*sizeof(Word27));
+            }
+        });
+        for(size_t c=0; c<G.n_chunks; ++c){
+            const uint32_t nb = (uint32_t)(bufs[c].size()*sizeof(Word27));
+            st.chunks++; st.bytes_in += nb;
+            auto it = map_.find(F.refs[c]);
+            if(it!=map_.end()){ it->second.refs++; continue; }
+
+            std::vector<uint8_t> rec;
+            put_u64(rec, F.refs[c].lo); put_u64(rec, F.refs[c].hi); put_u32(rec, nb);
+            if(std::fseek(f_, (long)end_, SEEK_SET)!=0 || !write_bytes(f_, rec.data(), rec.size())
+               || !write_bytes(f_, bufs[c].data(), nb)){
+                io_ok=false;
+                break;
+            }
+            Loc L; L.offset=end_+kT3KRecBytes; L.bytes=nb; L.refs=1;
+            map_.emplace(F.refs[c], L);
+            end_ += kT3KRecBytes + nb;
+            st.chunks_new++; st.bytes_written += kT3KRecBytes + nb;
+        }
+    }
+    // chec : retour  l'tat valid (index sur disque)
+    if(!io_ok || !commit(err)){
+        const std::string p = path_;
+        if(!io_ok && err) *err="t3k_write: I/O error";
+        open(p, nullptr);
+        return false;
+    }
+
+    // Rfrences comptes avant l'criture du .t3r : un crash ici ne laisse
+    // que des refs en trop (jamais un .t3r vers des chunks librs).
+    std::vector<uint8_t> o;
+    t3r_serialize(I, o);
+    File fp;
+    if(!fp.open(t3r_path, "wb") || !write_bytes(fp.f, o.data(), o.size())){
+        if(err)*err="t3r_write: I/O error";
+        for(const auto& F : I.frames)
+            for(const auto& r : F.refs) map_[r].refs--;
+        commit(nullptr);
+        return false;
+    }
+    if(stats) *stats=st;
+    return true;
+}
+
+bool T3ChunkStore::put_image(const std::string& t3r_path,
+                             SubwordMode sub, int w, int h,
+                             const std::vector<Word27>& words,
+                             const std::string& meta_json,
+                             T3KStats* stats, std::string* err)
+{
+    return put_frames(t3r_path, sub, w, h, {&words}, std::string(), {meta_json}, stats, err);
+}
+
+bool T3ChunkStore::put_video(const std::string& t3r_path,
+                             SubwordMode sub, int w, int h,
+                             const std::vector<std::vector<Word27>>& frames,
+                             const std::string& meta_json_global,
+                             const std::vector<std::string>& metas_per_frame,
+                             T3KStats* stats, std::string* err)
+{
+    std::vector<const std::vector<Word27>*> ptrs;
+    ptrs.reserve(frames.size());
+    for(const auto& f : frames) ptrs.push_back(&f);
+    return put_frames(t3r_path, sub, w, h, ptrs, meta_json_global, metas_per_frame, stats, err);
+}
+
+bool T3ChunkStore::release(const std::string& t3r_path, std::string* err)
+{
+    if(!f_){ if(err)*err="t3k: not open"; return false; }
+    T3RInfo I;
+    if(!t3r_read_header(t3r_path, I, err)) return false;
+
+    // Vrification complte avant toute dcrmentation
+    std::unordered_map<T3Chunk::Hash128, uint32_t, T3Chunk::Hash128Hasher> dec;
+    for(const auto& F : I.frames)
+        for(const auto& r : F.refs) dec[r]++;
+    for(const auto& kv : dec){
+        auto it = map_.find(kv.first);
+        if(it==map_.end() || it->second.refs < kv.second){
+            if(err)*err="t3k: container references unknown chunks (other store?)";
+            return false;
+        }
+    }
+    for(const auto& kv : dec) map_[kv.first].refs -= kv.second;
+    if(!commit(err)) return false;
+    std::remove(t3r_path.c_str());
+    return true;
+}
+
+bool T3ChunkStore::gc(uint64_t* reclaimed_bytes, std::string* err)
+{
+    if(reclaimed_bytes) *reclaimed_bytes=0;
+    if(!f_){ if(err)*err="t3k: not open"; return false; }
+    uint8_t head[kT3KHeadBytes];
+    if(std::fseek(f_, 0, SEEK_SET)!=0 || !read_bytes(f_, head, kT3KHeadBytes)){ if(err)*err="t3k: I/O error"; return false; }
+    const uint64_t gen = ld_u64(head+8) + 1;
+
+    // Chunks vivants dans l'ordre du pack (lecture squentielle)
+    std::vector<std::pair<T3Chunk::Hash128, Loc>> live;
+    for(const auto& kv : map_) if(kv.second.refs) live.emplace_back(kv.first, kv.second);
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b){ return a.second.offset < b.second.offset; });
+
+    const std::string tmp = path_ + ".gc";
+    uint64_t end = kT3KHeadBytes;
+    {
+        File fp; if(!fp.open(tmp, "wb")){ if(err)*err=strerror(errno); return false; }
+        t3k_serialize_head(gen, head);
+        if(!write_bytes(fp.f, head, kT3KHeadBytes)){ if(err)*err="t3k_gc: I/O error"; return false; }
+        std::vector<uint8_t> buf, rec;
+        for(auto& e : live){
+            buf.resize(e.second.bytes);
+            if(std::fseek(f_, (long)e.second.offset, SEEK_SET)!=0 || !read_bytes(f_, buf.data(), buf.size())){
+                if(err)*err="t3k_gc: I/O error";
+                return false;
+            }
+            if(T3Chunk::hash128(buf.data(), buf.size()) != e.first){
+                if(err)*err="t3k_gc: chunk hash mismatch (pack corrupt)";
+                return false;
+            }
+            rec.clear();
+            put_u64(rec, e.first.lo); put_u64(rec, e.first.hi); put_u32(rec, e.second.bytes);
+            if(!write_bytes(fp.f, rec.data(), rec.size()) || !write_bytes(fp.f, buf.data(), buf.size())){
+                if(err)*err="t3k_gc: I/O error";
+                return false;
+            }
+            e.second.offset = end + kT3KRecBytes;
+            end += kT3KRecBytes + buf.size();
+        }
+        if(std::fflush(fp.f)!=0){ if(err)*err="t3k_gc: I/O error"; return false; }
+    }
+
+    // Index de la nouvelle gnration, puis bascule : pack, index
+    std::vector<uint8_t> o;
+    o.insert(o.end(), {'T','3','K','I', 1, 0, 0, 0});
+    put_u64(o, gen); put_u64(o, end); put_u64(o, live.size());
+    for(const auto& e : live){
+        put_u64(o, e.first.lo); put_u64(o, e.first.hi);
+        put_u64(o, e.second.offset); put_u32(o, e.second.bytes); put_u32(o, e.second.refs);
+    }
+    put_u32(o, crc32_acc(o.data()+4, o.size()-4));
+    const std::string idx = path_ + ".idx";
+    if(!write_replace(idx + ".gc", o)){ if(err)*err="t3k_gc: I/O error"; return false; }
+
+    const uint64_t old_end = end_;
+    std::fclose(f_); f_=nullptr;
+    if(std::rename(tmp.c_str(), path_.c_str())!=0
+       || std::rename((idx + ".gc").c_str(), idx.c_str())!=0){
+        if(err)*err="t3k_gc: rename failed";
+        const std::string p = path_;
+        open(p, nullptr);
+        return false;
+    }
+    const std::string p = path_;
+    if(!open(p, err)) return false;
+    if(reclaimed_bytes) *reclaimed_bytes = old_end - end_;
+    return true;
+}
+
+const std::vector<uint8_t>* T3ChunkStore::get_chunk(const T3Chunk::Hash128& h, std::string* err)
+{
+    if(const std::vector<uint8_t>* hit = cache_.get(h)) return hit;
+    auto it = map_.find(h);
+    if(!f_ || it==map_.end()){ if(err)*err="t3k: missing chunk"; return nullptr; }
+    std::vector<uint8_t> buf(it->second.bytes);
+    if(std::fseek(f_, (long)it->second.offset, SEEK_SET)!=0 || !read_bytes(f_, buf.data(), buf.size())){
+        if(err)*err="t3k: I/O error";
+        return nullptr;
+    }
+    if(T3Chunk::hash128(buf.data(), buf.size()) != h){ if(err)*err="t3k: chunk hash mismatch"; return nullptr; }
+    return cache_.put(h, std::move(buf));
+}
+
+bool T3ChunkStore::read_frame(const T3RInfo& info, size_t i,
+                              const ApproveMetaFn& approve_meta,
+                              std::vector<Word27>& out_words,
+                              std::string* err)
+{
+    out_words.clear();
+    if(i>=info.frames.size()){ if(err)*err="t3r: frame index out of range"; return false; }
+    const T3RFrame& F = info.frames[i];
+
+    // === APPROVE META-ONLY ===
+    if(approve_meta && !approve_meta(F.meta)){
+        if(err)*err="t3r: meta not approved - payload not read";
+        return false;
+    }
+    const T3Chunk::Grid G = T3Chunk::grid_for((size_t)F.words, info.w, info.h, info.layout);
+    if(F.refs.size()!=G.n_chunks){ if(err)*err="t3r: chunk count mismatch"; return false; }
+    out_words.resize((size_t)F.words);
+    for(size_t c=0; c<G.n_chunks; ++c){
+        const std::vector<uint8_t>* d = get_chunk(F.refs[c], err);
+        if(!d || d->size()%sizeof(Word27)
+           || !T3Chunk::scatter((const Word27*)d->data(), d->size()/sizeof(Word27), G, c, out_words.data())){
+            if(d && err) *err="t3r: chunk size mismatch";
+            out_words.clear();
+            return false;
+        }
+    }
+    if(crc32_acc(out_words.data(), sizeof(Word27)*out_words.size()) != F.payload_crc32){
+        if(err)*err="t3r: payload crc mismatch";
+        out_words.clear();
+        return false;
+    }
+    return true;
+}
+
+size_t T3ChunkStore::dead_chunks() const
+{
+    size_t n=0;
+    for(const auto& kv : map_) n += kv.second.refs==0;
+    return n;
+}
+
+uint64_t T3ChunkStore::live_bytes() const
+{
+    uint64_t n=0;
+    for(const auto& kv : map_) if(kv.second.refs) n += kv.second.bytes;
+    return n;
+}
+
+// =============================== .t3s =======================================
+// Vido rpartie : manifeste (index unifi) + segments .t3g, 1 thread/disque.
+
+namespace {
+static constexpr size_t kT3GHeadBytes  = 16;
+static constexpr size_t kT3SFrameEntry = 24;
+
+// Chemin de segment relatif -> relatif au dossier du manifeste
+static std::string t3s_resolve(const std::string& manifest, const std::string& seg){
+    if(seg.empty() || seg[0]=='/' || seg[0]=='\\' || (seg.size()>1 && seg[1]==':')) return seg;
+    const size_t sl = manifest.find_last_of("/\\");
+    return (sl==std::string::npos) ? seg : manifest.substr(0, sl+1) + seg;
+}
+
+static void t3g_serialize_head(uint16_t seg, uint64_t set_id, uint8_t out[kT3GHeadBytes]){
+    std::vector<uint8_t> o;
+    o.insert(o.end(), {'T','3','G','1', 1, 0});
+    put_u16(o, seg); put_u64(o, set_id);
+    std::memcpy(out, o.data(), kT3GHeadBytes);
+}
+} // namespace
+
+// ------------------------------- crivain -----------------------------------
+
+struct T3SWriter::Lane {
+    std::FILE* f = nullptr;
+    std::vector<char> buf;               // tampon stdio (grandes critures)
+    std::thread th;
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::pair<std::vector<Word27>, std::string>> q;
+    size_t cap = 4;
+    uint64_t end = kT3GHeadBytes;        // offset du prochain bloc (thread appelant)
+    bool stop = false;
+    std::atomic<bool> failed{false};
+
+    void run(){
+        for(;;){
+            std::pair<std::vector<Word27>, std::string> job;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [&]{ return stop || !q.empty(); });
+                if(q.empty()) return;
+                job = std::move(q.front());
+                q.pop_front();
+            }
+            cv.notify_all();
+            if(failed.load(std::memory_order_relaxed)) continue;
+            const std::vector<Word27>& w = job.first;
+            const uint32_t pl_crc = w.empty() ? 0u : crc32_acc(w.data(), sizeof(Word27)*w.size());
+            if((!job.second.empty() && !write_bytes(f, job.second.data(), job.second.size()))
+               || (!w.empty() && !write_bytes(f, w.data(), sizeof(Word27)*w.size()))
+               || !write_le(f, pl_crc))
+                failed=true;
+        }
+    }
+};
+
+T3SWriter::T3SWriter() = default;
+
+T3SWriter::~T3SWriter()
+{
+    if(open_) close(nullptr);
+}
+
+bool T3SWriter::fail(std::string* err)
+{
+    for(auto& L : lanes_){
+        {
+            std::lock_guard<std::mutex> lk(L->m);
+            L->stop=true;
+        }
+        L->cv.notify_all();
+        if(L->th.joinable()) L->th.join();
+        if(L->f) std::fclose(L->f);
+        L->f=nullptr;
+    }
+    lanes_.clear();
+    open_=false;
+    if(err && err->empty()) *err="t3s_write: I/O error";
+    return false;
+}
+
+bool T3SWriter::open(const std::string& manifest_path,
+                     const std::vector<std::string>& segment_paths,
+                     SubwordMode sub, int w, int h,
+                     const std::string& meta_json_global,
+                     std::string* err,
+                     size_t queue_frames)
+{
+    if(open_) close(nullptr);
+    if(segment_paths.empty() || segment_paths.size() > 0xFFFFu){ if(err)*err="t3s: need 1..65535 segments"; return false; }
+    manifest_=manifest_path; paths_=segment_paths;
+    sub_=sub; w_=w; h_=h; meta_g_=meta_json_global;
+    index_.clear();
+    set_id_ = ((uint64_t)std::random_device{}() << 32)
+              ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    open_=true;
+
+    for(size_t s=0; s<paths_.size(); ++s){
+        lanes_.emplace_back(new Lane);
+        Lane& L = *lanes_.back();
+        L.cap = std::max<size_t>(1, queue_frames);
+        const std::string p = t3s_resolve(manifest_, paths_[s]);
+        L.f = std::fopen(p.c_str(), "wb");
+        if(!L.f){ if(err)*err=p + ": " + strerror(errno); return fail(err); }
+        L.buf.resize((size_t)4 << 20);
+        std::setvbuf(L.f, L.buf.data(), _IOFBF, L.buf.size());
+        uint8_t head[kT3GHeadBytes];
+        t3g_serialize_head((uint16_t)s, set_id_, head);
+        if(!write_bytes(L.f, head, kT3GHeadBytes)) return fail(err);
+        L.th = std::thread([&L]{ L.run(); });
+    }
+    return true;
+}
+
+bool T3SWriter::add_frame(std::vector<Word27>&& words, const std::string& meta, std::string* err)
+{
+    if(!open_){ if(err)*err="t3s: not open"; return false; }
+    const uint16_t s = (uint16_t)(index_.size() % lanes_.size());
+    Lane& L = *lanes_[s];
+    if(L.failed){ if(err)*err="t3s_write: I/O error on " + paths_[s]; return false; }
+
+    T3SFrameIndex e;
+    e.seg=s; e.offset=L.end; e.words=words.size(); e.meta_len=(uint32_t)meta.size();
+    L.end += meta.size() + words.size()*sizeof(Word27) + 4;
+    index_.push_back(e);
+    {
+        std::unique_lock<std::mutex> lk(L.m);
+        L.cv.wait(lk, [&]{ return L.q.size() < L.cap; });
+        L.q.emplace_back(std::move(words), meta);
+    }
+    L.cv.notify_all();
+    return true;
+}
+
+bool T3SWriter::add_frame(const std::vector<Word27>& words, const std::string& meta, std::string* err)
+{
+    return add_frame(std::vector<Word27>(words), meta, err);
+}
+
+bool T3SWriter::close(std::string* err)
+{
+    if(!open_){ if(err)*err="t3s: not open"; return false; }
+    bool ok = true;
+    for(auto& L : lanes_){
+        {
+            std::lock_guard<std::mutex> lk(L->m);
+            L->stop=true;
+        }
+        L->cv.notify_all();
+        L->th.join();
+        if(std::fclose(L->f)!=0 || L->failed) ok=false;
+        L->f=nullptr;
+    }
+    lanes_.clear();
+    open_=false;
+    if(!ok){ if(err)*err="t3s_write: segment I/O error"; return false; }
+
+    std::vector<uint8_t> o;
+    o.reserve(64 + meta_g_.size() + kT3SFrameEntry*index_.size());
+    o.insert(o.end(), {'T','3','S','1', 1, (uint8_t)sub_});
+    put_u16(o, (uint16_t)w_); put_u16(o, (uint16_t)h_);
+    put_u16(o, (uint16_t)paths_.size()); put_u64(o, set_id_);
+    put_u64(o, index_.size()); put_u32(o, (uint32_t)meta_g_.size());
+    o.insert(o.end(), meta_g_.begin(), meta_g_.end());
+    for(const auto& p : paths_){
+        put_u16(o, (uint16_t)p.size());
+        o.insert(o.end(), p.begin(), p.end());
+    }
+    for(const auto& e : index_){
+        put_u64(o, e.offset); put_u64(o, e.words); put_u32(o, e.meta_len);
+        put_u16(o, e.seg); put_u16(o, 0);
+    }
+    put_u32(o, crc32_acc(o.data()+4, o.size()-4));
+    if(!write_replace(manifest_, o)){ if(err)*err="t3s_write: manifest I/O error"; return false; }
+    return true;
+}
+
+// ------------------------------- Lecteur ------------------------------------
+
+T3SReader::~T3SReader(){ close(); }
+
+void T3SReader::close()
+{
+    for(std::FILE* f : files_) if(f) std::fclose(f);
+    files_.clear(); paths_.clear(); index_.clear(); meta_g_.clear();
+    w_=h_=0; set_id_=0;
+}
+
+bool T3SReader::open(const std::string& manifest_path, std::string* err)
+{
+    close();
+    std::vector<uint8_t> b;
+    if(!read_whole(manifest_path, b)){ if(err)*err=strerror(errno); return false; }
+    if(b.size() < 38 || std::memcmp(b.data(), "T3S1", 4)!=0 || b[4]!=1){ if(err)*err="t3s: bad header"; return false; }
+    if(crc32_acc(b.data()+4, b.size()-8) != ld_u32(b.data()+b.size()-4)){ if(err)*err="t3s: manifest crc mismatch"; return false; }
+
+    const uint8_t* p = b.data();
+    const size_t end = b.size()-4;
+    sub_=(SubwordMode)p[5]; w_=ld_u16(p+6); h_=ld_u16(p+8);
+    const size_t n_seg=ld_u16(p+10);
+    set_id_=ld_u64(p+12);
+    const uint64_t n_frames=ld_u64(p+20);
+    const uint32_t meta_len=ld_u32(p+28);
+    size_t k=32;
+    if(meta_len > end-k){ close(); if(err)*err="t3s: truncated"; return false; }
+    meta_g_.assign((const char*)p+k, meta_len); k+=meta_len;
+    for(size_t s=0; s<n_seg; ++s){
+        if(end-k < 2 || ld_u16(p+k) > end-k-2){ close(); if(err)*err="t3s: truncated"; return false; }
+        const size_t pl=ld_u16(p+k);
+        paths_.push_back(t3s_resolve(manifest_path, std::string((const char*)p+k+2, pl)));
+        k+=2+pl;
+    }
+    if(n_frames > (end-k)/kT3SFrameEntry){ close(); if(err)*err="t3s: truncated"; return false; }
+    index_.resize((size_t)n_frames);
+    for(auto& e : index_){
+        e.offset=ld_u64(p+k); e.words=ld_u64(p+k+8); e.meta_len=ld_u32(p+k+16); e.seg=ld_u16(p+k+20);
+        k+=kT3SFrameEntry;
+        if(e.seg>=n_seg){ close(); if(err)*err="t3s: bad segment index"; return false; }
+    }
+    files_.assign(n_seg, nullptr);
+    return true;
+}
+
+std::FILE* T3SReader::segment(uint16_t s, std::string* err)
+{
+    if(files_[s]) return files_[s];
+    std::FILE* f = std::fopen(paths_[s].c_str(), "rb");
+    if(!f){ if(err)*err=paths_[s] + ": " + strerror(errno); return nullptr; }
+    uint8_t head[kT3GHeadBytes];
+    if(!read_bytes(f, head, kT3GHeadBytes) || std::memcmp(head, "T3G1", 4)!=0
+       || ld_u16(head+6)!=s || ld_u64(head+8)!=set_id_){
+        std::fclose(f);
+        if(err)*err="t3s: segment does not belong to this set: " + paths_[s];
+        return nullptr;
+    }
+    files_[s]=f;
+    return f;
+}
+
+bool T3SReader::read_frame(uint64_t frame_idx,
+                           const ApproveMetaFn& approve_meta,
+                           std::vector<Word27>& out_words,
+                           std::string* err)
+{
+    out_words.clear();
+    if(frame_idx >= index_.size()){ if(err)*err="t3s: frame idx OOB"; return false; }
+    const T3SFrameIndex& fi = index_[(size_t)frame_idx];
+    std::FILE* f = segment(fi.seg, err);
+    if(!f) return false;
+    if(std::fseek(f, (long)fi.offset, SEEK_SET)!=0){ if(err)*err="t3s: seek frame failed"; return false; }
+
+    std::string meta(fi.meta_len, '\0');
+    if(fi.meta_len && !read_bytes(f, meta.data(), fi.meta_len)){ if(err)*err="t3s: read frame meta failed"; return false; }
+
+    // === APPROVE META-ONLY ===
+    if(approve_meta && !approve_meta(meta)){
+        if(err)*err="t3s: meta not approved - frame payload not read";
+        return false;
+    }
+
+    out_words.resize((size_t)fi.words);
+    uint32_t pl_crc=0;
+    if((fi.words && !read_bytes(f, out_words.data(), sizeof(Word27)*out_words.size())) || !read_le(f, pl_crc)){
+        out_words.clear();
+        if(err)*err="t3s: read frame payload failed";
+        return false;
+    }
+    if((fi.words ? crc32_acc(out_words.data(), sizeof(Word27)*out_words.size()) : 0u) != pl_crc){
+        out_words.clear();
+        if(err)*err="t3s: frame payload crc mismatch";
+        return false;
+    }
+    return true;
+}
+
+// ========================= criture projete (mmap) =========================
+// Fichier pr-dimensionn puis projet en criture ; CRC par plages signales.
+
+namespace {
+// CRC d'une zone crite par plages (ordre et threads quelconques)
+struct RangeCrc {
+    struct Piece { uint64_t begin, n; uint32_t crc; };
+    std::mutex mu;
+    std::vector<Piece> pieces;
+    const uint8_t* base=nullptr;
+    uint64_t bytes=0;
+
+    void commit(uint64_t begin, uint64_t n){
+        if(begin>=bytes || n==0) return;
+        n=std::min(n, bytes-begin);
+        const uint32_t c=T3Crc32::crc32(base+begin, (size_t)n);
+        std::lock_guard<std::mutex> lk(mu);
+        pieces.push_back(Piece{begin, n, c});
+    }
+    // Plages tries ; trous (et recouvrements) recalculs directement
+    uint32_t finish(){
+        std::sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b){ return a.begin<b.begin; });
+        uint32_t c=0; uint64_t cur=0;
+        for(const Piece& p : pieces){
+            if(p.begin+p.n <= cur) continue;
+            if(p.begin==cur) c=T3Crc32::combine(c, p.crc, p.n);
+            else if(p.begin>cur) c=T3Crc32::combine(c, T3Crc32::crc32(base+cur, (size_t)(p.begin+p.n-cur)), p.begin+p.n-cur);
+            else c=T3Crc32::update(c, base+cur, (size_t)(p.begin+p.n-cur));
+            cur=p.begin+p.n;
+        }
+        if(cur<bytes) c=T3Crc32::update(c, base+cur, (size_t)(bytes-cur));
+        pieces.clear();
+        return c;
+    }
+};
+
+// Mta complte pour que (ofs + taille) soit multiple de 4 :
+// JSON -> espaces en fin (vide -> "{}") ; TLV -> entre de bourrage ignore.
+static void pad_meta(std::string& m, uint64_t ofs){
+    if(m.empty() && (ofs & 3)) m="{}";
+    size_t pad = (size_t)((4 - ((ofs + m.size()) & 3)) & 3);
+    if(!pad) return;
+    if(T3Meta::is_tlv(m)){
+        if(pad<2) pad+=4;
+        m.push_back((char)T3Meta::kTagPad);
+        m.push_back((char)(pad-2));
+        m.append(pad-2, '\0');
+    }
+    else m.append(pad, ' ');
+}
+
+// Fichier de sortie pr-dimensionn + projection en criture
+struct MapRW {
+    std::string path;
+    uint8_t* base=nullptr;
+    uint64_t len=0;
+    std::vector<uint8_t> heap; // repli sans mmap : crit d'un bloc  la fermeture
+#if T3A_HAVE_MMAP
+    int fd=-1;
+#endif
+    bool create(const std::string& p, uint64_t bytes, std::string* err){
+        path=p; len=bytes;
+#if T3A_HAVE_MMAP
+        fd = ::open(p.c_str(), O_RDWR|O_CREAT|O_TRUNC, 0644);
+        if(fd<0){ if(err)*err=strerror(errno); return false; }
+        if(ftruncate(fd, (off_t)bytes)!=0){ if(err)*err=strerror(errno); return false; }
+#if defined(__linux__)
+        // Blocs rservs : pas de SIGBUS (disque plein) en crivant dans la projection
+        const int rc = posix_fallocate(fd, 0, (off_t)bytes);
+        if(rc!=0 && rc!=EOPNOTSUPP && rc!=EINVAL){ if(err)*err=strerror(rc); return false; }
+#endif
+        if(bytes==0) return true;
+        void* m = mmap(nullptr, (size_t)bytes, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        if(m==MAP_FAILED){ if(err)*err=strerror(errno); return false; }
+        base=(uint8_t*)m;
+        return true;
+#else
+        heap.assign((size_t)bytes, 0);
+        base=heap.data();
+        return true;
+#endif
+    }
+    bool finish(std::string* err){
+        bool ok=true;
+#if T3A_HAVE_MMAP
+        if(base){
+            if(msync(base, (size_t)len, MS_SYNC)!=0){ ok=false; if(err)*err=strerror(errno); }
+            munmap(base, (size_t)len);
+        }
+        if(fd>=0 && ::close(fd)!=0 && ok){ ok=false; if(err)*err=strerror(errno); }
+        fd=-1;
+#else
+        File fp;
+        if(!fp.open(path, "wb") || (!heap.empty() && !write_bytes(fp.f, heap.data(), heap.size()))){
+            ok=false; if(err)*err="map writer: I/O error";
+        }
+        heap.clear(); heap.shrink_to_fit();
+#endif
+        base=nullptr;
+        return ok;
+    }
+    ~MapRW(){ finish(nullptr); }
+};
+} // namespace
+
+struct T3PMapWriter::Out {
+    MapRW map;
+    RangeCrc crc;
+    uint64_t crc_ofs=0;
+};
+
+T3PMapWriter::T3PMapWriter() = default;
+
+T3PMapWriter::~T3PMapWriter()
+{
+    if(out_) close(nullptr);
+}
+
+bool T3PMapWriter::open(const std::string& path,
+                        SubwordMode sub, int w, int h,
+                        uint64_t words_count,
+                        const std::string& meta_json,
+                        std::string* err)
+{
+    if(out_ && !close(err)) return false;
+    std::string meta=meta_json;
+    pad_meta(meta, kT3PHeadBytes);
+    const uint8_t ver=6, subu=(uint8_t)sub;
+    const uint16_t W=(uint16_t)w, H=(uint16_t)h;
+    const uint32_t meta_len=(uint32_t)meta.size();
+
+    std::vector<uint8_t> head;
+    head.insert(head.end(), {'T','3','P','6', ver, subu});
+    put_u16(head, W); put_u16(head, H);
+    put_u32(head, meta_len); put_u64(head, words_count);
+    put_u32(head, t3p_hdr_crc(ver, subu, W, H, meta_len, words_count));
+    head.insert(head.end(), meta.begin(), meta.end());
+
+    const uint64_t wbytes=words_count*sizeof(Word27);
+    std::unique_ptr<Out> o(new Out);
+    if(!o->map.create(path, head.size() + wbytes + 4, err)) return false;
+    std::memcpy(o->map.base, head.data(), head.size());
+    o->crc.base=o->map.base + head.size();
+    o->crc.bytes=wbytes;
+    o->crc_ofs=head.size() + wbytes;
+    words_=(Word27*)(o->map.base + head.size());
+    n_=words_count;
+    out_=std::move(o);
+    return true;
+}
+
+void T3PMapWriter::commit(uint64_t begin, uint64_t n)
+{
+    if(out_) out_->crc.commit(begin*sizeof(Word27), n*sizeof(Word27));
+}
+
+bool T3PMapWriter::close(std::string* err)
+{
+    if(!out_) return true;
+    std::unique_ptr<Out> o=std::move(out_);
+    words_=nullptr; n_=0;
+    const uint32_t c = o->crc.bytes ? o->crc.finish() : 0u;
+    uint8_t* p = o->map.base + o->crc_ofs;
+    for(int i=0;i<4;++i) p[i]=(uint8_t)(c>>(8*i));
+    return o->map.finish(err);
+}
+
+struct T3VMapWriter::Out {
+    MapRW map;
+    std::vector<std::unique_ptr<RangeCrc>> crc; // 1 par frame
+};
+
+T3VMapWriter::T3VMapWriter() = default;
+
+T3VMapWriter::~T3VMapWriter()
+{
+    if(out_) close(nullptr);
+}
+
+bool T3VMapWriter::open(const std::string& path,
+                        SubwordMode sub, int w, int h,
+                        const std::vector<uint64_t>& frame_words,
+                        const std::string& meta_json_global,
+                        const std::vector<std::string>& metas_per_frame,
+                        const std::vector<T3VFrameTime>* times,
+                        const T3VTimeBase& tb,
+                        std::string* err)
+{
+    if(out_ && !close(err)) return false;
+    index_.clear();
+    const size_t n=frame_words.size();
+    if(times){
+        if(times->size()!=n){ if(err)*err="t3v_map: times.size() != frame count"; return false; }
+        if(tb.num==0 || tb.den==0){ if(err)*err="t3v_map: invalid timebase"; return false; }
+        for(size_t i=1;i<n;++i){
+            if((*times)[i].pts < (*times)[i-1].pts){ if(err)*err="t3v_map: pts must be non-decreasing"; return false; }
+        }
+    }
+    const bool per_frame = metas_per_frame.size()==n;
+    const uint8_t ver=times? 7 : 6, subu=(uint8_t)sub;
+    const uint16_t W=(uint16_t)w, H=(uint16_t)h;
+    static constexpr uint64_t kHead = 4+1+1+2+2+8+4+4;
+
+    std::string meta_g=meta_json_global;
+    pad_meta(meta_g, kHead);
+    std::vector<std::string> metas(n);
+    std::vector<T3VFrameIndex> index(n);
+    const uint64_t idx_bytes = (ver>=7) ? 8 + 32*(uint64_t)n + 4 : 20*(uint64_t)n;
+    uint64_t ofs = kHead + meta_g.size() + idx_bytes;
+    for(size_t i=0;i<n;++i){
+        if(per_frame && !metas_per_frame[i].empty()){ metas[i]=metas_per_frame[i]; pad_meta(metas[i], 0); }
+        T3VFrameIndex& e=index[i];
+        e.offset=ofs; e.words=frame_words[i]; e.meta_len=(uint32_t)metas[i].size();
+        if(times){ e.pts=(*times)[i].pts; e.flags=(*times)[i].flags; }
+        ofs += e.meta_len + e.words*sizeof(Word27) + 4;
+    }
+
+    std::vector<uint8_t> head, ib;
+    head.insert(head.end(), {'T','3','V','6', ver, subu});
+    put_u16(head, W); put_u16(head, H);
+    put_u64(head, (uint64_t)n); put_u32(head, (uint32_t)meta_g.size());
+    put_u32(head, t3v_hdr_crc(ver, subu, W, H, (uint64_t)n, (uint32_t)meta_g.size()));
+    head.insert(head.end(), meta_g.begin(), meta_g.end());
+    t3v_index_bytes(ver, tb, index, ib);
+    head.insert(head.end(), ib.begin(), ib.end());
+
+    std::unique_ptr<Out> o(new Out);
+    if(!o->map.create(path, ofs, err)) return false;
+    std::memcpy(o->map.base, head.data(), head.size());
+    o->crc.resize(n);
+    for(size_t i=0;i<n;++i){
+        const T3VFrameIndex& e=index[i];
+        if(e.meta_len) std::memcpy(o->map.base + e.offset, metas[i].data(), e.meta_len);
+        o->crc[i].reset(new RangeCrc);
+        o->crc[i]->base=o->map.base + e.offset + e.meta_len;
+        o->crc[i]->bytes=e.words*sizeof(Word27);
+    }
+    index_=std::move(index);
+    out_=std::move(o);
+    return true;
+}
+
+Word27* T3VMapWriter::frame(uint64_t i)
+{
+    if(!out_ || i>=index_.size()) return nullptr;
+    return (Word27*)out_->crc[(size_t)i]->base;
+}
+
+void T3VMapWriter::commit(uint64_t i, uint64_t begin, uint64_t n)
+{
+    if(out_ && i<index_.size()) out_->crc[(size_t)i]->commit(begin*sizeof(Word27), n*sizeof(Word27));
+}
+
+bool T3VMapWriter::close(std::string* err)
+{
+    if(!out_) return true;
+    std::unique_ptr<Out> o=std::move(out_);
+    // CRC restants (plages non signales) : frames rparties sur les curs
+    T3Par::parallel_for(index_.size(), [&](size_t b, size_t e){
+        for(size_t i=b;i<e;++i){
+            RangeCrc& r=*o->crc[i];
+            const uint32_t c = r.bytes ? r.finish() : 0u;
+            uint8_t* p = (uint8_t*)r.base + r.bytes;
+            for(int k=0;k<4;++k) p[k]=(uint8_t)(c>>(8*k));
+        }
+    });
+    return o->map.finish(err);
+}
+
+// ============================ Vrification ==================================
+// Fichier projet en lecture seule ; CRC32 des payloads sans copie, par
+// morceaux de 4 Mo rpartis sur les curs puis recombins (crc32_combine).
+
+namespace {
+static constexpr size_t kVerifyPiece = (size_t)4 << 20;
+
+struct MapRO {
+    const uint8_t* base=nullptr;
+    size_t len=0;
+    std::vector<uint8_t> heap; // repli sans mmap
+#if T3A_HAVE_MMAP
+    int fd=-1;
+    bool mapped=false;
+#endif
+    ~MapRO(){
+#if T3A_HAVE_MMAP
+        if(mapped) munmap((void*)base, len);
+        if(fd>=0){
+#if defined(POSIX_FADV_DONTNEED)
+            // Scrub : pages lues une seule fois, ne pas vincer le cache utile
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+            ::close(fd);
+        }
+#endif
+    }
+    bool open(const std::string& path, std::string* err){
+#if T3A_HAVE_MMAP
+        fd = ::open(path.c_str(), O_RDONLY);
+        if(fd<0){ if(err)*err=strerror(errno); return false; }
+        struct stat st{};
+        if(fstat(fd, &st)!=0){ if(err)*err=strerror(errno); return false; }
+        len=(size_t)st.st_size;
+        if(len==0) return true;
+#if defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        void* m = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        if(m==MAP_FAILED){ if(err)*err=strerror(errno); return false; }
+        madvise(m, len, MADV_SEQUENTIAL);
+        base=(const uint8_t*)m; mapped=true;
+        return true;
+#else
+        File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+        std::fseek(fp.f, 0, SEEK_END);
+        const long n = std::ftell(fp.f);
+        std::fseek(fp.f, 0, SEEK_SET);
+        heap.resize(n>0? (size_t)n : 0);
+        if(!heap.empty() && !read_bytes(fp.f, heap.data(), heap.size())){ if(err)*err="verify: I/O error"; return false; }
+        base=heap.data(); len=heap.size();
+        return true;
+#endif
+    }
+};
+
+// Payloads  vrifier (unit = frame / entre), dcoups en morceaux
+struct VerifyPlan {
+    struct Unit { size_t first=0, pieces=0; uint32_t want=0; bool bad=false; };
+    struct Piece { const uint8_t* p; size_t n; };
+    std::vector<Unit> units;
+    std::vector<Piece> pieces;
+    uint64_t bytes=0;
+
+    // p==nullptr : payload hors fichier (unit invalide d'office)
+    void add(const uint8_t* p, size_t n, uint32_t want){
+        Unit u; u.first=pieces.size(); u.want=want; u.bad=(p==nullptr);
+        if(p){
+            for(size_t o=0; o<n; o+=kVerifyPiece) pieces.push_back(Piece{p+o, std::min(kVerifyPiece, n-o)});
+            u.pieces=pieces.size()-u.first;
+            bytes+=n;
+        }
+        units.push_back(u);
+    }
+
+    void run(unsigned threads, std::vector<uint64_t>& bad){
+        std::vector<uint32_t> crc(pieces.size());
+        T3Par::parallel_for(pieces.size(), [&](size_t b, size_t e){
+            for(size_t i=b;i<e;++i) crc[i]=T3Crc32::crc32(pieces[i].p, pieces[i].n);
+        }, threads, 1);
+        for(size_t u=0; u<units.size(); ++u){
+            const Unit& U=units[u];
+            uint32_t c=0;
+            for(size_t k=0;k<U.pieces;++k){
+                const size_t i=U.first+k;
+                c = k ? T3Crc32::combine(c, crc[i], pieces[i].n) : crc[i];
+            }
+            if(U.bad || c!=U.want) bad.push_back(u);
+        }
+    }
+};
+
+// [ofs, ofs+n+4) dans le fichier (payload + CRC final) ?
+static bool verify_span_ok(const MapRO& m, uint64_t ofs, uint64_t n){
+    return ofs <= m.len && n <= m.len - ofs && 4 <= m.len - ofs - n;
+}
+} // namespace
+
+bool t3_verify(const std::string& path, T3VerifyReport& rep, unsigned threads, std::string* err)
+{
+    rep = T3VerifyReport{};
+    const auto t0 = std::chrono::steady_clock::now();
+    MapRO m;
+    if(!m.open(path, err)) return false;
+    rep.file_bytes=m.len;
+    if(m.len<4){ if(err)*err="verify: file too small"; return false; }
+
+    VerifyPlan plan;
+    if(std::memcmp(m.base, "T3P6", 4)==0){
+        rep.kind="t3p";
+        T3AEntry e; uint64_t wc=0;
+        if(!t3p_blob_head(m.base, m.len, e, wc)){ if(err)*err="t3p: bad header or truncated file"; return false; }
+        const size_t wbytes=(size_t)wc*sizeof(Word27);
+        const uint8_t* w=m.base + kT3PHeadBytes + e.meta_len;
+        plan.add(w, wbytes, ld_u32(w + wbytes));
+    }
+    else if(std::memcmp(m.base, "T3V6", 4)==0){
+        rep.kind="t3v";
+        SubwordMode sub; int w=0, h=0; std::string meta; uint64_t count=0;
+        std::vector<T3VFrameIndex> index;
+        if(!t3v_read_header(path, sub, w, h, meta, count, index, err)) return false;
+        for(const auto& e : index){
+            const uint64_t ofs=e.offset + e.meta_len, n=e.words*sizeof(Word27);
+            if(e.words > m.len || !verify_span_ok(m, ofs, n)){ plan.add(nullptr, 0, 0); continue; }
+            plan.add(m.base + ofs, (size_t)n, ld_u32(m.base + ofs + n));
+        }
+    }
+    else if(std::memcmp(m.base, "T3A1", 4)==0){
+        rep.kind="t3a";
+        T3AHead hd;
+        if(!t3a_parse_head(m.base, m.len, hd)){ if(err)*err="t3a: bad header"; return false; }
+        if(hd.n_entries){
+            if(hd.dir_offset < kT3AHeadBytes || hd.dir_offset > m.len || hd.dir_bytes > m.len - hd.dir_offset
+               || hd.dir_bytes < kT3AEntryBytes*(uint64_t)hd.n_entries){
+                if(err)*err="t3a: directory out of range"; return false;
+            }
+            const uint8_t* dir = m.base + hd.dir_offset;
+            if(T3Crc32::crc32(dir, (size_t)hd.dir_bytes) != hd.dir_crc){ if(err)*err="t3a: directory crc mismatch"; return false; }
+            for(uint32_t i=0;i<hd.n_entries;++i){
+                const uint8_t* d = dir + kT3AEntryBytes*i;
+                const uint64_t ofs=ld_u64(d+8), bytes=ld_u64(d+16);
+                T3AEntry e; uint64_t wc=0;
+                if(ofs > m.len || bytes > m.len - ofs || !t3p_blob_head(m.base+ofs, (size_t)bytes, e, wc)){
+                    plan.add(nullptr, 0, 0); continue;
+                }
+                const size_t wbytes=(size_t)wc*sizeof(Word27);
+                const uint8_t* w=m.base + ofs + kT3PHeadBytes + e.meta_len;
+                plan.add(w, wbytes, ld_u32(w + wbytes));
+            }
+        }
+    }
+    else { if(err)*err="verify: unsupported container (expect T3P6, T3V6 or T3A1)"; return false; }
+
+    plan.run(threads, rep.bad);
+    rep.units=plan.units.size();
+    rep.checked_bytes=plan.bytes;
+    rep.seconds=std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+// =============================== Lecture dcime ============================
+// Lignes chantillonnes seulement (fseek + 1 lecture par ligne) : 1/k des
+// octets lus pour un aperu 1/k, un mot gard sur k dans chaque ligne.
+
+namespace {
+static bool read_decimated(FILE* f, uint64_t payload_ofs, uint64_t words,
+                           SubwordMode sub, int W, int H, int k,
+                           std::vector<Word27>& out, int& out_w, int& out_h,
+                           std::string* err)
+{
+    if(k<1 || W<=0 || H<=0){ if(err)*err="decimated: bad size or factor"; return false; }
+    WordRaster R;
+    if(!word_raster_for(words, sub, W, H, R)){ if(err)*err="decimated: payload is not a w*h raster"; return false; }
+    const uint64_t stride=R.stride;
+    const int x0=R.x0, y0=R.y0;
+
+    const int dw=decimated_dim(W, k), dh=decimated_dim(H, k);
+    const int xa=decimated_pick(0, k, W), xb=decimated_pick(dw-1, k, W);
+    std::vector<Word27> row((size_t)(xb-xa+1));
+    out.resize((size_t)dw*dh);
+    for(int y=0; y<dh; ++y){
+        const uint64_t r=(uint64_t)(y0 + decimated_pick(y, k, H));
+        const uint64_t ofs=payload_ofs + (r*stride + (uint64_t)(x0+xa))*sizeof(Word27);
+        if(std::fseek(f, (long)ofs, SEEK_SET)!=0 || !read_bytes(f, row.data(), row.size()*sizeof(Word27))){
+            if(err)*err="decimated: read row failed"; return false;
+        }
+        Word27* o=out.data() + (size_t)y*dw;
+        for(int x=0; x<dw; ++x) o[x]=row[(size_t)(decimated_pick(x, k, W)-xa)];
+    }
+    out_w=dw; out_h=dh;
+    return true;
+}
+} // namespace
+
+bool t3p_read_decimated(const std::string& path, int k,
+                        const ApproveMetaFn& approve_meta,
+                        std::vector<Word27>& out_words,
+                        int& out_w, int& out_h,
+                        std::string* err)
+{
+    out_words.clear(); out_w=out_h=0;
+    SubwordMode sub; int W=0, H=0; std::string meta; uint64_t wc=0;
+    if(!t3p_read_header(path, sub, W, H, meta, wc, err)) return false;
+    if(approve_meta && !approve_meta(meta)){
+        if(err)*err="t3p: meta not approved  payload not read";
+        return false;
+    }
+    File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+    return read_decimated(fp.f, kT3PHeadBytes + meta.size(), wc, sub, W, H, k, out_words, out_w, out_h, err);
+}
+
+bool t3v_read_frame_decimated(const std::string& path,
+                              uint64_t frame_idx, int k,
+                              const ApproveMetaFn& approve_meta,
+                              std::vector<Word27>& out_words,
+                              int& out_w, int& out_h,
+                              std::string* err)
+{
+    out_words.clear(); out_w=out_h=0;
+    SubwordMode sub; int W=0, H=0; std::string meta_g; uint64_t fc=0; std::vector<T3VFrameIndex> idx;
+    if(!t3v_read_header(path, sub, W, H, meta_g, fc, idx, err)) return false;
+    if(frame_idx >= fc){ if(err)*err="t3v: frame idx OOB"; return false; }
+    const T3VFrameIndex& fi = idx[(size_t)frame_idx];
+
+    File fp; if(!fp.open(path, "rb")){ if(err)*err=strerror(errno); return false; }
+    std::string meta;
+    if(fi.meta_len){
+        meta.resize(fi.meta_len);
+        if(std::fseek(fp.f, (long)fi.offset, SEEK_SET)!=0 || !read_bytes(fp.f, meta.data(), fi.meta_len)){
+            if(err)*err="t3v: read frame meta failed"; return false;
+        }
+    }
+    if(approve_meta && !approve_meta(meta)){
+        if(err)*err="t3v: meta not approved  frame payload not read";
+        return false;
+    }
+    return read_decimated(fp.f, fi.offset + fi.meta_len, fi.words, sub, W, H, k, out_words, out_w, out_h, err);
+}
+
+} // namespace T3Container
@@ -0,0 +1,156 @@
+// ============================================================================
+//  File: src/minitest_async.cpp — Tests API asynchrone t3_async (rapport JSON)
+//  Project: Ternary Image/Video Codec v6
+//  Build (exemple, C++20) :
+//    g++ -std=c++20 -O2 -Iinclude -Ithird_party src/minitest_async.cpp
+//        src/io_t3p_t3v.cpp src/ternary_image_codec_v6_min.cpp
+//        src/codec_profiles.cpp -pthread -o minitest_async
+//  Couverture :
+//    AsyncT3VReader::open/frame via sync_wait, backends IoKind::Threads et
+//    IoKind::Auto (io_uring si disponible) : chaque frame comparée à
+//    t3v_read_frame (mots, ou refus identique), frame au CRC altéré, méta
+//    refusée (payload non lu), Runtime::read_at à cheval sur la fin du
+//    fichier (lecture courte → octets restants).
+//  Fichiers de test écrits dans le dossier courant (test_async_*).
+// ============================================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "t3_async.hpp"
+
+using namespace T3Async;
+using namespace T3Container;
+
+static std::vector<Word27> make_frame(size_t n, uint32_t seed){
+    std::vector<Word27> v(n);
+    uint32_t x = seed*2654435761u + 1u;
+    for(auto& w : v){ x ^= x<<13; x ^= x>>17; x ^= x<<5; w.u = x % 19683u; }
+    return v;
+}
+
+static bool same_words(const std::vector<Word27>& a, const std::vector<Word27>& b){
+    if(a.size()!=b.size()) return false;
+    for(size_t i=0;i<a.size();++i) if(a[i].u!=b[i].u) return false;
+    return true;
+}
+
+static bool file_bytes(const std::string& p, uint64_t& n){
+    FILE* f=std::fopen(p.c_str(), "rb");
+    if(!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    const long e=std::ftell(f);
+    std::fclose(f);
+    n = e<0 ? 0 : (uint64_t)e;
+    return e>=0;
+}
+
+// Un octet du payload de la frame i inversé (CRC payload faux)
+static bool corrupt_frame(const std::string& p, const T3VFrameIndex& fi){
+    FILE* f=std::fopen(p.c_str(), "r+b");
+    if(!f) return false;
+    const long pos=(long)(fi.offset + fi.meta_len + 1);
+    int c=0;
+    bool ok = std::fseek(f, pos, SEEK_SET)==0 && (c=std::fgetc(f))!=EOF
+           && std::fseek(f, pos, SEEK_SET)==0 && std::fputc(c ^ 0x21, f)!=EOF;
+    return std::fclose(f)==0 && ok;
+}
+
+// Méta contenant "deny" : refusée par les deux lecteurs
+static bool approve(const std::string& m){ return m.find("deny")==std::string::npos; }
+
+struct Frames {
+    uint64_t n = 0;
+    uint64_t same = 0;      // accord async / sync (mots ou refus)
+    bool crc_rejected = false;
+    bool meta_rejected = false;
+    bool eof_short = false;
+    std::string backend, err;
+};
+
+// ver 7, frames petites et > 64 Ko (CRC côté calcul), frame 2 refusée,
+// frame 3 corrompue
+static const char* kPath = "test_async.t3v";
+static const uint64_t kDeny = 2, kBad = 3;
+
+static bool make_input(std::vector<std::vector<Word27>>& frames, std::string& err){
+    const size_t sizes[] = {64, 20000, 256, 30000, 0, 1024};
+    std::vector<T3VFrameTime> times;
+    std::vector<std::string> metas;
+    for(size_t i=0;i<6;++i){
+        frames.push_back(make_frame(sizes[i], (uint32_t)i+1));
+        T3VFrameTime t; t.pts=(int64_t)i; times.push_back(t);
+        metas.push_back(i==kDeny ? "{\"deny\":1}" : "{\"i\":" + std::to_string(i) + "}");
+    }
+    T3VTimeBase tb; tb.num=1; tb.den=25;
+    if(!t3v_write_timed(kPath, SubwordMode::S27, 200, 150, frames, times, tb, "{\"async\":1}", metas, &err))
+        return false;
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t n=0;
+    std::vector<T3VFrameIndex> idx;
+    if(!t3v_read_header(kPath, sub, w, h, m, n, idx, &err)) return false;
+    return corrupt_frame(kPath, idx[(size_t)kBad]);
+}
+
+static Frames run_backend(IoKind kind){
+    Frames R;
+    RuntimeOptions o; o.io = kind; o.io_threads = 2;
+    Runtime rt(o);
+    R.backend = rt.io().name();
+
+    AsyncT3VReader rd(rt);
+    rd.set_approve(approve);
+    const Status st = sync_wait(rt.loop(), rd.open(kPath));
+    if(!st.ok){ R.err = st.err; return R; }
+    R.n = rd.frame_count();
+    for(uint64_t i=0;i<R.n;++i){
+        Result<std::vector<Word27>> a = sync_wait(rt.loop(), rd.frame(i));
+        std::vector<Word27> b; std::string eb;
+        const bool ok_b = t3v_read_frame(kPath, i, approve, b, &eb);
+        if(a.ok==ok_b && (ok_b ? same_words(a.value, b) : a.value.empty())) ++R.same;
+        if(i==kBad)  R.crc_rejected  = !a.ok && a.err.find("crc mismatch")!=std::string::npos;
+        if(i==kDeny) R.meta_rejected = !a.ok && a.err.find("not approved")!=std::string::npos;
+    }
+
+    // 64 octets demandés, 10 avant la fin : 10 rendus
+    uint64_t size=0;
+    const int fd = ::open(kPath, O_RDONLY | O_CLOEXEC);
+    if(fd>=0 && file_bytes(kPath, size)){
+        std::vector<uint8_t> buf(64);
+        auto t = [&]() -> Task<long> { co_return co_await rt.read_at(fd, buf.data(), buf.size(), size - 10); };
+        R.eof_short = sync_wait(rt.loop(), t())==10;
+    }
+    if(fd>=0) ::close(fd);
+    return R;
+}
+
+int main(){
+    bool all_ok = true;
+    std::vector<std::vector<Word27>> frames;
+    std::string err;
+    const bool ok_in = make_input(frames, err);
+    all_ok = ok_in;
+
+    std::cout << "{\n  \"t3_async\": {\n";
+    std::cout << "    \"input\": " << (ok_in? "true":"false") << ",\n";
+    std::cout << "    \"backends\": [\n";
+    const IoKind kinds[] = {IoKind::Threads, IoKind::Auto};
+    for(size_t k=0;k<2;++k){
+        const Frames R = ok_in ? run_backend(kinds[k]) : Frames{};
+        const bool ok = R.n==frames.size() && R.same==R.n && R.crc_rejected && R.meta_rejected && R.eof_short;
+        all_ok = all_ok && ok;
+        std::cout << "      {\"io\":\"" << (k==0? "threads":"auto") << "\",\"backend\":\"" << R.backend << "\""
+                  << ",\"frames\":" << R.n << ",\"same_as_sync\":" << R.same
+                  << ",\"crc_rejected\":" << (R.crc_rejected? "true":"false")
+                  << ",\"meta_rejected\":" << (R.meta_rejected? "true":"false")
+                  << ",\"eof_short_read\":" << (R.eof_short? "true":"false")
+                  << ",\"ok\":" << (ok? "true":"false") << "}" << (k==0? ",\n" : "\n");
+    }
+    std::cout << "    ],\n";
+    std::cout << "    \"final_status\": " << (all_ok? "\"PASS\"" : "\"CHECK\"") << "\n";
+    std::cout << "  }\n}\n";
+    std::remove(kPath);
+    return all_ok? 0: 1;
+}
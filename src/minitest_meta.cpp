@@ -0,0 +1,258 @@
+// ============================================================================
+//  File: src/minitest_meta.cpp — Tests méta TLV t3_meta (rapport JSON)
+//  Project: Ternary Image/Video Codec v6
+//  Build (exemple):
+//    g++ -std=c++17 -O2 -Iinclude src/minitest_meta.cpp -o minitest_meta
+//  Couverture :
+//    encode_json → parse → to_json (aller-retour, types U/S/B/N), résidu
+//    (clés hors dictionnaire, chaînes échappées, types inattendus, objets
+//    imbriqués), entrée de bourrage 0x7E, varint de longueur malformé,
+//    extract_build_from_meta identique en JSON et en TLV, overlay de route
+//    (security_route_helper) sur une méta TLV : clés hors dictionnaire et
+//    chaînes à échapper rangées au résidu.
+// ============================================================================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "t3_meta.hpp"
+#include "security_policy.hpp"
+#include "security_route_helper.hpp"
+
+// ---------- Cas nommés : {"name", "ok", "err"} ------------------------------
+struct CaseResult { std::string name; bool ok; std::string err; };
+
+#define CHECK(c) do{ if(!(c)){ err = "check failed: " #c; return false; } }while(0)
+
+static std::string json_escape(const std::string& s){
+    std::string o;
+    for(char c : s){
+        if(c=='"' || c=='\\'){ o.push_back('\\'); o.push_back(c); }
+        else if((unsigned char)c < 0x20) o.push_back(' ');
+        else o.push_back(c);
+    }
+    return o;
+}
+
+static std::string tlv_of(const std::string& json){
+    std::string t;
+    return T3Meta::encode_json(json, t) ? t : std::string();
+}
+
+static bool same_build(const T3Security::BuildTag& a, const T3Security::BuildTag& b){
+    return a.domain==b.domain && a.build_hash==b.build_hash && a.type_hash==b.type_hash
+        && a.version==b.version && a.pclass==b.pclass && a.radius_m==b.radius_m
+        && a.route_ttl==b.route_ttl && a.route_hops==b.route_hops
+        && a.route_phase==b.route_phase && a.route_origin==b.route_origin;
+}
+
+// ---------- encode → parse → to_json ----------------------------------------
+static bool case_roundtrip(std::string& err){
+    const std::string js = "{\"domain\":\"lab.a\",\"version\":300,\"route_sandbox\":true,"
+                           "\"fps\":29.97,\"route_accepted\":false,\"n_trits\":9999999999999999999}";
+    const std::string t = tlv_of(js);
+    CHECK(T3Meta::is_tlv(t));
+    CHECK(t.size() < js.size());
+
+    T3Meta::MetaView v;
+    CHECK(v.parse(t) && v.residual().empty());
+    std::string_view sv; uint64_t u=0;
+    CHECK(v.get_str(T3Meta::kDomain, sv) && sv=="lab.a");
+    CHECK(v.get_uint("version", u) && u==300);
+    CHECK(v.get_uint(T3Meta::kNTrits, u) && u==9999999999999999999ull);
+    CHECK(v.get_uint(T3Meta::kRouteSandbox, u) && u==1);
+    CHECK(v.get_str(T3Meta::kFps, sv) && sv=="29.97");
+    CHECK(!v.get_str(T3Meta::kVersion, sv));        // U n’est pas une chaîne
+
+    // to_json : ordre du dictionnaire ; ré-encodé → mêmes octets
+    const std::string back = T3Meta::to_json(t);
+    CHECK(back=="{\"domain\":\"lab.a\",\"version\":300,\"route_accepted\":false,"
+                "\"route_sandbox\":true,\"n_trits\":9999999999999999999,\"fps\":29.97}");
+    CHECK(tlv_of(back)==t);
+    CHECK(T3Meta::to_json(js)==js);                 // JSON rendu tel quel
+    // > 19 chiffres : hors dictionnaire (résidu), valeur conservée
+    const std::string big = tlv_of("{\"n_trits\":18446744073709551615}");
+    CHECK(v.parse(big) && !v.has(T3Meta::kNTrits) && v.residual()=="{\"n_trits\":18446744073709551615}");
+    CHECK(T3Meta::to_json(tlv_of("{}"))=="{}");
+    std::string dummy;
+    CHECK(!T3Meta::encode_json("[1,2]", dummy));
+    CHECK(!T3Meta::encode_json("{\"a\":}", dummy));
+    CHECK(!T3Meta::encode_json("{\"a\":1", dummy));
+    return true;
+}
+
+// ---------- Résidu -----------------------------------------------------------
+static bool case_residual(std::string& err){
+    const std::string js = "{\"domain\":\"a\\\"\",\"x\":[1,{\"y\":2}],\"version\":\"3\","
+                           "\"route\":{\"ttl\":4},\"gen\":\"g\",\"gen\":\"dup\"}";
+    const std::string t = tlv_of(js);
+    T3Meta::MetaView v;
+    CHECK(v.parse(t));
+    CHECK(!v.has(T3Meta::kDomain) && !v.has(T3Meta::kVersion));
+    CHECK(v.residual()=="{\"domain\":\"a\\\"\",\"x\":[1,{\"y\":2}],\"version\":\"3\","
+                        "\"route\":{\"ttl\":4},\"gen\":\"dup\"}");
+    std::string_view sv;
+    CHECK(v.get_str(T3Meta::kGen, sv) && sv=="g");  // 1re occurrence au dictionnaire
+
+    // to_json : dictionnaire puis membres du résidu
+    CHECK(T3Meta::to_json(t)=="{\"gen\":\"g\",\"domain\":\"a\\\"\",\"x\":[1,{\"y\":2}],"
+                              "\"version\":\"3\",\"route\":{\"ttl\":4},\"gen\":\"dup\"}");
+
+    // find_* : dictionnaire puis résidu, même lecture naïve qu’en JSON
+    std::string s1, s2; uint64_t u1=0, u2=0;
+    CHECK(T3Meta::find_str(t, "domain", s1) && T3Security::meta_find_str(js, "domain", s2) && s1==s2);
+    CHECK(T3Meta::find_uint(t, "ttl", u1) && T3Security::meta_find_uint(js, "ttl", u2) && u1==u2 && u1==4);
+
+    // Décision : TLV et JSON donnent le même BuildTag (domaine échappé compris)
+    const T3Security::BuildTag bt = T3Security::extract_build_from_meta(t);
+    CHECK(same_build(bt, T3Security::extract_build_from_meta(js)));
+    CHECK(bt.domain==s2 && !bt.domain.empty() && bt.route_ttl==4);
+
+    // set_* : refus hors dictionnaire / type différent / chaîne à échapper
+    std::string w = t;
+    CHECK(!T3Meta::set_uint(w, "nope", 1) && !T3Meta::set_uint(w, "domain", 1));
+    CHECK(!T3Meta::set_str(w, "route_via", "q\"x") && !T3Meta::set_str(w, "route_via", "b\\s"));
+    CHECK(!T3Meta::set_bool(w, "version", true));
+    CHECK(w==t);
+    CHECK(T3Meta::set_str(w, "domain", "b") && T3Meta::find_str(w, "domain", s1) && s1=="b");
+    CHECK(T3Meta::erase_entry(w, T3Meta::kDomain) && w==t);
+    CHECK(T3Meta::erase_entry(w, T3Meta::kDomain) && w==t);   // absente : inchangé
+    return true;
+}
+
+// ---------- Bourrage 0x7E ---------------------------------------------------
+static bool case_pad(std::string& err){
+    const std::string js = "{\"domain\":\"p\",\"route_ttl\":9,\"k\":1}";
+    const std::string t = tlv_of(js);
+    for(size_t n : {0u, 1u, 3u, 200u}){   // 200 : longueur sur 2 octets de varint
+        std::string p = t;
+        p.push_back((char)T3Meta::kTagPad);
+        T3Meta::put_varint(p, n);
+        p.append(n, '\xAA');
+        T3Meta::MetaView v;
+        CHECK(v.parse(p));
+        CHECK(T3Meta::to_json(p)==T3Meta::to_json(t));
+        uint64_t u=0;
+        CHECK(T3Meta::find_uint(p, "route_ttl", u) && u==9);
+        CHECK(T3Meta::find_uint(p, "k", u) && u==1);
+        // set_* recopie le bourrage, l’entrée modifiée passe en fin
+        CHECK(T3Meta::set_uint(p, "route_ttl", 8) && T3Meta::find_uint(p, "route_ttl", u) && u==8);
+        CHECK(p.size()==t.size() + 1 + (n>=128 ? 2 : 1) + n);
+    }
+    // Tag inconnu (version future) : ignoré comme le bourrage
+    std::string f = t;
+    f.push_back((char)0x60); f.push_back(2); f.append("zz");
+    T3Meta::MetaView v;
+    CHECK(v.parse(f) && T3Meta::to_json(f)==T3Meta::to_json(t));
+    return true;
+}
+
+// ---------- Varint malformé -------------------------------------------------
+static bool case_bad_varint(std::string& err){
+    const std::string t = tlv_of("{\"domain\":\"d\"}");
+    T3Meta::MetaView v;
+
+    std::string a = t;                       // varint tronqué (bit de suite en fin)
+    a.push_back((char)T3Meta::kTagPad); a.push_back((char)0x80);
+    CHECK(!v.parse(a) && !v.ok());
+
+    std::string b = t;                       // longueur au-delà du blob
+    b.push_back((char)T3Meta::kTagPad); b.push_back((char)5); b.append("xy");
+    CHECK(!v.parse(b));
+
+    std::string c = t;                       // varint de 11 octets (> 64 bits)
+    c.push_back((char)T3Meta::kTagPad); c.append(10, (char)0xFF); c.push_back((char)0x01);
+    CHECK(!v.parse(c));
+
+    std::string d = t;                       // longueur 2^63 : refusée sans débordement
+    d.push_back((char)T3Meta::kTagPad); d.append(9, (char)0x80); d.push_back((char)0x01);
+    CHECK(!v.parse(d));
+
+    // Blob invalide : set/erase refusés, blob inchangé ; find_* en repli texte
+    std::string e = a;
+    CHECK(!T3Meta::set_uint(e, "route_ttl", 1) && !T3Meta::erase_entry(e, T3Meta::kDomain) && e==a);
+    std::string s;
+    CHECK(!T3Meta::find_str(a, "domain", s));
+
+    // Valeur U au varint tronqué dans le dictionnaire
+    std::string g(reinterpret_cast<const char*>(T3Meta::kMagic), 4);
+    g.push_back(1);
+    g.push_back((char)T3Meta::kRouteTtl); g.push_back(1); g.push_back((char)0x80);
+    uint64_t u=0;
+    CHECK(v.parse(g) && !v.get_uint(T3Meta::kRouteTtl, u));
+    return true;
+}
+
+// ---------- Overlay de route sur méta TLV -----------------------------------
+static bool case_route_tlv(std::string& err){
+    const std::string js = "{\"domain\":\"lab.a\",\"route_ttl\":5,\"route_hops\":1,\"note\":\"n\"}";
+    const std::string t = tlv_of(js);
+    std::string oj, ot;
+    CHECK(T3Route::prepare_redirect_meta_accept(js, "via.b", "next.c", 4, oj));
+    CHECK(T3Route::prepare_redirect_meta_accept(t, "via.b", "next.c", 4, ot));
+    CHECK(T3Meta::is_tlv(ot));
+    CHECK(same_build(T3Security::extract_build_from_meta(ot), T3Security::extract_build_from_meta(oj)));
+    std::string s;
+    CHECK(T3Meta::find_str(ot, "route_next", s) && s=="next.c");
+
+    // Clés hors dictionnaire : résidu (créé puis complété), jamais perdues
+    T3Route::set_or_insert_uint(ot, "route_epoch", 7);
+    T3Route::set_or_insert_bool(ot, "route_audit", true);
+    T3Route::set_or_insert_str(ot, "route_zone", "z1");
+    T3Route::set_or_insert_uint(ot, "route_epoch", 8);
+    uint64_t u=0;
+    CHECK(T3Meta::find_uint(ot, "route_epoch", u) && u==8);
+    CHECK(T3Meta::find_str(ot, "route_zone", s) && s=="z1");
+    const std::string j = T3Meta::to_json(ot);
+    CHECK(j.find("\"note\":\"n\"")!=std::string::npos && j.find("\"route_audit\": true")!=std::string::npos);
+
+    std::string e = tlv_of("{\"domain\":\"x\"}");   // sans résidu au départ
+    T3Route::set_or_insert_uint(e, "hop_limit", 3);
+    T3Meta::MetaView v;
+    CHECK(v.parse(e) && v.residual()=="{\"hop_limit\": 3 }");
+
+    // Chaîne à échapper pour une clé du dictionnaire : résidu, entrée retirée,
+    // même valeur lue qu’en JSON
+    std::string qj = oj, qt = ot;
+    T3Route::set_or_insert_str(qj, "route_via", "v\\\"q");
+    T3Route::set_or_insert_str(qt, "route_via", "v\\\"q");
+    CHECK(v.parse(qt) && !v.has(T3Meta::kRouteVia));
+    std::string a, b;
+    CHECK(T3Meta::find_str(qt, "route_via", a) && T3Security::meta_find_str(qj, "route_via", b) && a==b);
+
+    // mark_* : booléens du dictionnaire + raison
+    T3Route::mark_sandbox(ot, "why");
+    CHECK(T3Meta::find_str(ot, "route_reason", s) && s=="why");
+    CHECK(v.parse(ot) && v.get_uint(T3Meta::kRouteSandbox, u) && u==1);
+    return true;
+}
+
+int main(){
+    const struct { const char* name; bool (*fn)(std::string&); } cases[] = {
+        {"tlv_roundtrip",   case_roundtrip},
+        {"tlv_residual",    case_residual},
+        {"tlv_pad",         case_pad},
+        {"tlv_bad_varint",  case_bad_varint},
+        {"route_on_tlv",    case_route_tlv},
+    };
+    bool all_ok = true;
+    std::vector<CaseResult> res;
+    for(const auto& c : cases){
+        std::string err;
+        const bool ok = c.fn(err);
+        res.push_back({c.name, ok, ok ? std::string() : err});
+        all_ok = all_ok && ok;
+    }
+    std::cout << "{\n  \"t3_meta\": {\n    \"cases\": [\n";
+    for(size_t i=0;i<res.size();++i){
+        std::cout << "      {\"name\":\"" << res[i].name << "\",\"ok\":" << (res[i].ok? "true":"false");
+        if(!res[i].ok) std::cout << ",\"err\":\"" << json_escape(res[i].err) << "\"";
+        std::cout << "}" << (i+1<res.size()? ",\n" : "\n");
+    }
+    std::cout << "    ],\n";
+    std::cout << "    \"final_status\": " << (all_ok? "\"PASS\"" : "\"CHECK\"") << "\n";
+    std::cout << "  }\n}\n";
+    return all_ok? 0: 1;
+}
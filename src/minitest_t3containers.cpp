@@ -1,13 +1,23 @@
 // ============================================================================
-//  File: src/minitest_t3containers.cpp  Tests .t3p / .t3v (rapport JSON)
+//  File: src/minitest_t3containers.cpp  Tests conteneurs T3 (rapport JSON)
 //  Project: Ternary Image/Video Codec v6
 //  Build (exemple):
-//    g++ -std=c++17 -O2 -Iinclude -Ithird_party \
-//        src/minitest_t3containers.cpp -o minitest_t3containers
-//  Note: dtecte io_t3p_t3v.hpp via __has_include ; si absent => SKIP.
+//    g++ -std=c++17 -O2 -Iinclude -Ithird_party src/minitest_t3containers.cpp
+//        src/io_t3p_t3v.cpp src/ternary_image_codec_v6_min.cpp -pthread
+//        -o minitest_t3containers
+//  Couverture :
+//    .t3p (5 sous-modes), .t3v ver 6, .t3v ver 7 (pts/flags, seek),
+//    lecture ver 6 crit octet par octet (CRC header sur bourrage  zro),
+//    .t3a (ajout, remplacement, ajout non valid), .t3s (segments),
+//    T3PMapWriter / T3VMapWriter, t3v_cut / t3v_concat,
+//    .t3k/.t3r (ddup, release + gc, bascule interrompue, chunk corrompu),
+//    .t3pl (plans partiels, words_count / tailles de plans incohrents).
+//  Fichiers de test crits dans le dossier courant (test_*).
 // ============================================================================
 
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -17,6 +27,10 @@
 
 #include "ternary_image_codec_v6_min.hpp"
 #include "io_image.hpp" // ImageU8 + quant helpers
+#include "io_t3p_t3v.hpp"
+#include "t3_crc32.hpp"
+
+using namespace T3Container;
 
 // ---------- CRC12(0x80F) & Parit ternaire {0,1,2} --------------------------
 static uint16_t crc12_0x80F(const uint8_t* data, size_t len){
@@ -33,24 +47,6 @@ static uint16_t crc12_0x80F(const uint8_t* data, size_t len){
     }
     return crc & 0x0FFF;
 }
-static uint8_t parity_mod3_unbalanced(const std::vector<uint8_t>& u){
-    uint32_t s=0; for(uint8_t t: u) s+=t; return (uint8_t)(s%3);
-}
-
-// ---------- pack base-243 (5 trits {0,1,2} -> 1 octet 0..242) --------------
-static void pack_u_base243(const std::vector<uint8_t>& trits, std::vector<uint8_t>& out){
-    out.clear();
-    size_t n = trits.size();
-    for(size_t i=0;i<n;i+=5){
-        int k = (int)std::min<size_t>(5, n-i);
-        uint32_t val=0, p=1;
-        for(int j=0;j<k;++j){ val += (uint32_t)trits[i+j]*p; p*=3; }
-        out.push_back((uint8_t)val);
-    }
-}
-
-// ---------- balanced {-1,0,1} -> unbalanced {0,1,2} ------------------------
-static inline uint8_t bal_to_unb(int8_t b){ return (uint8_t)(b+1); }
 
 // ---------- contenu synthtique (damier) ------------------------------------
 static void make_rgb_pattern(int w,int h, ImageU8& out){
@@ -73,18 +69,49 @@ static bool make_words_for(SubwordMode sub, std::vector<Word27>& out, int& w, in
     return encode_raw_pixels_to_words_subword(q, sub, out);
 }
 
-// ---------- T3 containers API (dtecte) ------------------------------------
-#if __has_include("io_t3p_t3v.hpp")
-  #include "io_t3p_t3v.hpp"
-  #define HAS_T3 1
-#else
-  #define HAS_T3 0
-  // Stubs si le header n'est pas encore ajout
-  inline bool t3p_write(const std::string&, SubwordMode, int, int, const std::vector<Word27>&, const std::string& = {}){ return false; }
-  inline bool t3p_read (const std::string&, SubwordMode&, int&, int&, std::vector<Word27>&, std::string* = nullptr){ return false; }
-  inline bool t3v_write(const std::string&, SubwordMode, int, int, const std::vector<std::vector<Word27>>&, double, const std::string& = {}){ return false; }
-  inline bool t3v_read (const std::string&, SubwordMode&, int&, int&, std::vector<std::vector<Word27>>&, double&, std::string* = nullptr){ return false; }
-#endif
+// Petite frame wh : blocs 1616 constants (tuiles rptes) + graine
+static std::vector<Word27> small_frame(int w, int h, uint32_t seed){
+    std::vector<Word27> v((size_t)w*h);
+    for(int y=0;y<h;++y)
+        for(int x=0;x<w;++x)
+            v[(size_t)y*w+x].u = (((uint32_t)(x/16 + y/16) & 1u) ? 1000u : 7u) + seed*((uint32_t)(x/16)==1u);
+    return v;
+}
+
+static bool same_words(const std::vector<Word27>& a, const std::vector<Word27>& b){
+    if(a.size()!=b.size()) return false;
+    for(size_t i=0;i<a.size();++i) if(a[i].u!=b[i].u) return false;
+    return true;
+}
+
+static bool read_file(const std::string& p, std::vector<uint8_t>& out){
+    out.clear();
+    FILE* f=std::fopen(p.c_str(), "rb");
+    if(!f) return false;
+    uint8_t b[65536];
+    size_t n;
+    while((n=std::fread(b,1,sizeof(b),f))>0) out.insert(out.end(), b, b+n);
+    std::fclose(f);
+    return true;
+}
+static bool write_file(const std::string& p, const std::vector<uint8_t>& d){
+    FILE* f=std::fopen(p.c_str(), "wb");
+    if(!f) return false;
+    const bool ok = d.empty() || std::fwrite(d.data(),1,d.size(),f)==d.size();
+    return std::fclose(f)==0 && ok;
+}
+
+static bool file_exists(const std::string& p){
+    FILE* f=std::fopen(p.c_str(), "rb");
+    if(f) std::fclose(f);
+    return f!=nullptr;
+}
+
+static void put_u16(std::vector<uint8_t>& o, uint16_t v){ o.push_back((uint8_t)v); o.push_back((uint8_t)(v>>8)); }
+static void put_u32(std::vector<uint8_t>& o, uint32_t v){ for(int i=0;i<4;++i) o.push_back((uint8_t)(v>>(8*i))); }
+static void put_u64(std::vector<uint8_t>& o, uint64_t v){ for(int i=0;i<8;++i) o.push_back((uint8_t)(v>>(8*i))); }
+
+static const ApproveMetaFn kApproveAll = [](const std::string&){ return true; };
 
 static const char* mname(SubwordMode m){
     switch(m){
@@ -97,9 +124,585 @@ static const char* mname(SubwordMode m){
     }
 }
 
+// ---------- Cas nomms : {"name", "ok", "err"} ------------------------------
+struct CaseResult { std::string name; bool ok; std::string err; };
+static std::vector<CaseResult> g_cases;
+
+// CHECK(cond) : chec du cas courant avec l'expression (ou l'erreur API)
+#define CHECK(c) do{ if(!(c)){ if(err.empty()) err = "check failed: " #c; return false; } }while(0)
+
+static std::string json_escape(const std::string& s){
+    std::string o;
+    for(char c : s){
+        if(c=='"' || c=='\\'){ o.push_back('\\'); o.push_back(c); }
+        else if((unsigned char)c < 0x20) o.push_back(' ');
+        else o.push_back(c);
+    }
+    return o;
+}
+
+// ---------- Srialisation indpendante (format document) -------------------
+// CRC header = CRC32 de la structure logique, octets de bourrage  zro :
+//   T3P6 : {u8 ver, u8 sub, u16 W, u16 H, pad[2], u32 meta_len, pad[4], u64 words}
+//   T3V6 : {u8 ver, u8 sub, u16 W, u16 H, pad[2], u64 frames, u32 meta_len, pad[4]}
+static uint32_t golden_t3p_hdr_crc(uint8_t ver, uint8_t sub, uint16_t W, uint16_t H,
+                                   uint32_t meta_len, uint64_t words){
+    uint8_t b[24] = {0};
+    b[0]=ver; b[1]=sub;
+    std::memcpy(b+2, &W, 2); std::memcpy(b+4, &H, 2);
+    std::memcpy(b+8, &meta_len, 4); std::memcpy(b+16, &words, 8);
+    return T3Crc32::crc32(b, sizeof(b));
+}
+static uint32_t golden_t3v_hdr_crc(uint8_t ver, uint8_t sub, uint16_t W, uint16_t H,
+                                   uint64_t frames, uint32_t meta_len){
+    uint8_t b[24] = {0};
+    b[0]=ver; b[1]=sub;
+    std::memcpy(b+2, &W, 2); std::memcpy(b+4, &H, 2);
+    std::memcpy(b+8, &frames, 8); std::memcpy(b+16, &meta_len, 4);
+    return T3Crc32::crc32(b, sizeof(b));
+}
+static void golden_t3p(SubwordMode sub, int w, int h, const std::vector<Word27>& words,
+                       const std::string& meta, std::vector<uint8_t>& o){
+    o.assign({'T','3','P','6', 6, (uint8_t)sub});
+    put_u16(o, (uint16_t)w); put_u16(o, (uint16_t)h);
+    put_u32(o, (uint32_t)meta.size()); put_u64(o, words.size());
+    put_u32(o, golden_t3p_hdr_crc(6, (uint8_t)sub, (uint16_t)w, (uint16_t)h, (uint32_t)meta.size(), words.size()));
+    o.insert(o.end(), meta.begin(), meta.end());
+    for(const Word27& x : words) put_u32(o, x.u);
+    put_u32(o, words.empty() ? 0u : T3Crc32::crc32(words.data(), words.size()*sizeof(Word27)));
+}
+// .t3v ver 6 : index n  { u64 offset, u64 words, u32 meta_len } puis blocs
+static void golden_t3v6(SubwordMode sub, int w, int h, const std::vector<std::vector<Word27>>& frames,
+                        const std::string& meta_g, const std::vector<std::string>& metas,
+                        std::vector<uint8_t>& o){
+    const uint64_t n = frames.size();
+    o.assign({'T','3','V','6', 6, (uint8_t)sub});
+    put_u16(o, (uint16_t)w); put_u16(o, (uint16_t)h);
+    put_u64(o, n); put_u32(o, (uint32_t)meta_g.size());
+    put_u32(o, golden_t3v_hdr_crc(6, (uint8_t)sub, (uint16_t)w, (uint16_t)h, n, (uint32_t)meta_g.size()));
+    o.insert(o.end(), meta_g.begin(), meta_g.end());
+    uint64_t ofs = o.size() + 20*n;
+    for(size_t i=0;i<frames.size();++i){
+        put_u64(o, ofs); put_u64(o, frames[i].size()); put_u32(o, (uint32_t)metas[i].size());
+        ofs += metas[i].size() + frames[i].size()*sizeof(Word27) + 4;
+    }
+    for(size_t i=0;i<frames.size();++i){
+        o.insert(o.end(), metas[i].begin(), metas[i].end());
+        for(const Word27& x : frames[i]) put_u32(o, x.u);
+        put_u32(o, frames[i].empty() ? 0u : T3Crc32::crc32(frames[i].data(), frames[i].size()*sizeof(Word27)));
+    }
+}
+
+// ---------- .t3p / .t3v ver 6 : octets de rfrence + lecture ---------------
+static bool case_t3p_golden(std::string& err){
+    const std::vector<Word27> words = small_frame(48, 32, 3);
+    const std::string meta = "{\"gen\":\"golden\"}";
+    std::vector<uint8_t> ref, got;
+    golden_t3p(SubwordMode::S21, 48, 32, words, meta, ref);
+    CHECK(t3p_write("test_golden.t3p", SubwordMode::S21, 48, 32, words, meta, &err));
+    CHECK(read_file("test_golden.t3p", got));
+    CHECK(got==ref);   // mme octets, CRC header compris
+
+    CHECK(write_file("test_golden_ref.t3p", ref));
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t wc=0;
+    CHECK(t3p_read_header("test_golden_ref.t3p", sub, w, h, m, wc, &err));
+    CHECK(sub==SubwordMode::S21 && w==48 && h==32 && m==meta && wc==words.size());
+    std::vector<Word27> back;
+    CHECK(t3p_read_payload("test_golden_ref.t3p", kApproveAll, back, &err));
+    CHECK(same_words(back, words));
+
+    // Header altr (un bit de h) : rejet par le CRC
+    ref[10] ^= 1;
+    CHECK(write_file("test_golden_bad.t3p", ref));
+    std::string e2;
+    CHECK(!t3p_read_header("test_golden_bad.t3p", sub, w, h, m, wc, &e2));
+    CHECK(e2.find("crc")!=std::string::npos);
+    return true;
+}
+
+static bool case_t3v6_compat(std::string& err){
+    std::vector<std::vector<Word27>> frames;
+    for(uint32_t i=0;i<4;++i) frames.push_back(small_frame(32, 32, i));
+    frames.push_back({});   // frame vide (CRC 0)
+    const std::vector<std::string> metas = {"{\"i\":0}", "", "{\"i\":2}", "{\"i\":3}", "{}"};
+    const std::string meta_g = "{\"fps\":25}";
+    std::vector<uint8_t> ref, got;
+    golden_t3v6(SubwordMode::S24, 32, 32, frames, meta_g, metas, ref);
+
+    // criture non horodate : toujours ver 6, identique  l'octet prs
+    CHECK(t3v_write("test_v6.t3v", SubwordMode::S24, 32, 32, frames, meta_g, metas, &err));
+    CHECK(read_file("test_v6.t3v", got));
+    CHECK(got.size()>4 && got[4]==6);
+    CHECK(got==ref);
+
+    // Fichier ver 6 produit hors bibliothque : pts = i, KEY, tb = 1/fps
+    CHECK(write_file("test_v6_ref.t3v", ref));
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t n=0;
+    std::vector<T3VFrameIndex> idx; T3VTimeBase tb;
+    CHECK(t3v_read_header("test_v6_ref.t3v", sub, w, h, m, n, idx, &err, &tb));
+    CHECK(sub==SubwordMode::S24 && w==32 && h==32 && n==frames.size() && m==meta_g);
+    CHECK(tb.num==1000 && tb.den==25000);
+    for(size_t i=0;i<idx.size();++i){
+        CHECK(idx[i].pts==(int64_t)i && idx[i].flags==T3V_FRAME_KEY);
+        CHECK(idx[i].meta_len==metas[i].size() && idx[i].words==frames[i].size());
+    }
+    for(uint64_t i=0;i<n;++i){
+        std::vector<Word27> back;
+        std::string seen;
+        CHECK(t3v_read_frame("test_v6_ref.t3v", i, [&](const std::string& mm){ seen=mm; return true; }, back, &err));
+        CHECK(seen==metas[(size_t)i] && same_words(back, frames[(size_t)i]));
+    }
+    uint64_t fi=0;
+    CHECK(t3v_seek_time("test_v6_ref.t3v", 0.13, fi, false, &err));   // 0.13 s  25 fps
+    CHECK(fi==3);
+
+    T3VerifyReport rep;
+    CHECK(t3_verify("test_v6_ref.t3v", rep, 0, &err));
+    CHECK(rep.kind=="t3v" && rep.units==frames.size() && rep.ok());
+    return true;
+}
+
+// ---------- .t3v ver 7 : pts / flags / seek ---------------------------------
+static bool make_v7(const std::string& path, size_t n, std::vector<std::vector<Word27>>& frames,
+                    std::vector<T3VFrameTime>& times, std::string& err){
+    frames.clear(); times.clear();
+    for(size_t i=0;i<n;++i){
+        frames.push_back(small_frame(32, 16, (uint32_t)(100+i)));
+        T3VFrameTime t;
+        t.pts = (int64_t)(3*i);
+        t.flags = (i%3==0) ? T3V_FRAME_KEY : 0u;
+        times.push_back(t);
+    }
+    T3VTimeBase tb; tb.num=1; tb.den=90;
+    std::vector<std::string> metas(n, "{\"k\":1}");
+    return t3v_write_timed(path, SubwordMode::S15, 32, 16, frames, times, tb, "{\"seq\":\"v7\"}", metas, &err);
+}
+
+static bool case_t3v7(std::string& err){
+    std::vector<std::vector<Word27>> frames;
+    std::vector<T3VFrameTime> times;
+    CHECK(make_v7("test_v7.t3v", 7, frames, times, err));
+    std::vector<uint8_t> got;
+    CHECK(read_file("test_v7.t3v", got) && got.size()>4 && got[4]==7);
+
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t n=0;
+    std::vector<T3VFrameIndex> idx; T3VTimeBase tb;
+    CHECK(t3v_read_header("test_v7.t3v", sub, w, h, m, n, idx, &err, &tb));
+    CHECK(n==7 && tb.num==1 && tb.den==90);
+    for(size_t i=0;i<idx.size();++i) CHECK(idx[i].pts==times[i].pts && idx[i].flags==times[i].flags);
+    for(uint64_t i=0;i<n;++i){
+        std::vector<Word27> back;
+        CHECK(t3v_read_frame("test_v7.t3v", i, kApproveAll, back, &err));
+        CHECK(same_words(back, frames[(size_t)i]));
+    }
+    // pts 3i  90 Hz : t = 0.2 s -> pts 18 -> frame 6 ; keyframe prcdente = 6
+    // t = 0.15 s -> pts 13.5 -> frame 4 ; key_only -> frame 3
+    CHECK(t3v_seek_time(idx, tb, 0.2)==6);
+    CHECK(t3v_seek_time(idx, tb, 0.15)==4);
+    CHECK(t3v_seek_time(idx, tb, 0.15, true)==3);
+    CHECK(t3v_seek_time(idx, tb, -1.0)==0);
+
+    // Index altr : CRC d'index ver 7
+    const size_t pos = 4+1+1+2+2+8+4+4 + m.size() + 8 + 24;   // pts de la frame 0
+    got[pos] ^= 0x40;
+    CHECK(write_file("test_v7_bad.t3v", got));
+    std::string e2;
+    CHECK(!t3v_read_header("test_v7_bad.t3v", sub, w, h, m, n, idx, &e2, &tb));
+    CHECK(e2.find("index crc")!=std::string::npos);
+
+    // pts dcroissants refuss
+    times[2].pts = 1;
+    std::string e3;
+    CHECK(!t3v_write_timed("test_v7_x.t3v", SubwordMode::S15, 32, 16, frames, times, tb, "", {}, &e3));
+    return true;
+}
+
+// ---------- t3v_cut / t3v_concat ------------------------------------------
+static bool case_t3v_edit(std::string& err){
+    std::vector<std::vector<Word27>> f7, f6;
+    std::vector<T3VFrameTime> times;
+    CHECK(make_v7("test_edit_v7.t3v", 6, f7, times, err));
+    for(uint32_t i=0;i<3;++i) f6.push_back(small_frame(32, 16, 500+i));
+    CHECK(t3v_write("test_edit_v6.t3v", SubwordMode::S15, 32, 16, f6, "{\"fps\":30}", {}, &err));
+
+    T3VEditStats st;
+    CHECK(t3v_cut("test_edit_v7.t3v", 2, 5, "test_cut.t3v", &st, &err));
+    CHECK(st.frames==3);
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t n=0;
+    std::vector<T3VFrameIndex> idx; T3VTimeBase tb;
+    CHECK(t3v_read_header("test_cut.t3v", sub, w, h, m, n, idx, &err, &tb));
+    CHECK(n==3 && idx[0].pts==0 && idx[1].pts==3 && idx[2].pts==6);
+    CHECK(idx[0].flags==0 && idx[1].flags==T3V_FRAME_KEY);   // flags d'origine conservs
+    for(uint64_t i=0;i<n;++i){
+        std::vector<Word27> back;
+        CHECK(t3v_read_frame("test_cut.t3v", i, kApproveAll, back, &err));
+        CHECK(same_words(back, f7[(size_t)(2+i)]));
+    }
+
+    // ver 6 (1/30 s) + coupe ver 7 (1/90 s) -> ver 7, timebase du 1er fichier
+    CHECK(t3v_concat({"test_edit_v6.t3v", "test_cut.t3v"}, "test_concat.t3v", &st, &err));
+    CHECK(st.frames==6);
+    std::vector<uint8_t> got;
+    CHECK(read_file("test_concat.t3v", got) && got.size()>4 && got[4]==7);
+    CHECK(t3v_read_header("test_concat.t3v", sub, w, h, m, n, idx, &err, &tb));
+    CHECK(n==6 && m=="{\"fps\":30}");
+    for(size_t i=1;i<idx.size();++i) CHECK(idx[i].pts > idx[i-1].pts);
+    for(uint64_t i=0;i<n;++i){
+        std::vector<Word27> back;
+        CHECK(t3v_read_frame("test_concat.t3v", i, kApproveAll, back, &err));
+        CHECK(same_words(back, i<3 ? f6[(size_t)i] : f7[(size_t)(i-1)]));
+    }
+
+    // Sortie = entre (autre chemin vers le mme fichier) : refus, source intacte
+    std::vector<uint8_t> before, after;
+    CHECK(read_file("test_edit_v7.t3v", before));
+    std::string e1;
+    CHECK(!t3v_cut("test_edit_v7.t3v", 0, 3, "./test_edit_v7.t3v", nullptr, &e1));
+    CHECK(!t3v_concat({"test_edit_v6.t3v", "test_cut.t3v"}, "./test_cut.t3v", nullptr, &e1));
+    CHECK(read_file("test_edit_v7.t3v", after) && after==before);
+    CHECK(!file_exists("test_edit_v7.t3v.tmp"));
+
+    // Dimensions diffrentes : refus
+    std::vector<std::vector<Word27>> other(1, small_frame(16, 16, 1));
+    CHECK(t3v_write("test_edit_other.t3v", SubwordMode::S15, 16, 16, other, "", {}, &err));
+    std::string e2;
+    CHECK(!t3v_concat({"test_edit_v6.t3v", "test_edit_other.t3v"}, "test_concat_bad.t3v", nullptr, &e2));
+    return true;
+}
+
+// ---------- .t3a : ajout, remplacement, ajout non valid --------------------
+static bool case_t3a(std::string& err){
+    std::remove("test_arch.t3a");
+    std::remove("test_arch_wc.t3a");
+    const std::vector<Word27> a = small_frame(32, 32, 1), b = small_frame(48, 16, 2), c = small_frame(16, 16, 3);
+    CHECK(t3p_write("test_arch_c.t3p", SubwordMode::S18, 16, 16, c, "{\"n\":\"c\"}", &err));
+    {
+        T3AWriter W;
+        CHECK(W.open("test_arch.t3a", &err));
+        CHECK(W.add("a", SubwordMode::S21, 32, 32, a, "{\"n\":\"a\"}", &err));
+        CHECK(W.add("b", SubwordMode::S24, 48, 16, b, "{\"n\":\"b\"}", &err));
+        CHECK(W.add_t3p_file("c", "test_arch_c.t3p", &err));
+        CHECK(W.commit(&err));
+    }
+    {
+        T3AReader R;
+        CHECK(R.open("test_arch.t3a", &err));
+        CHECK(R.size()==3 && R.find("zz")==-1);
+        const long ib = R.find("b");
+        CHECK(ib>=0);
+        const T3AEntry e = R.entry((size_t)ib);
+        CHECK(e.name=="b" && e.w==48 && e.h==16 && e.sub==SubwordMode::S24);
+        CHECK(R.meta((size_t)ib)=="{\"n\":\"b\"}");
+        std::vector<Word27> back;
+        CHECK(R.read_payload((size_t)ib, kApproveAll, back, &err) && same_words(back, b));
+        std::string e2;
+        CHECK(!R.read_payload((size_t)ib, [](const std::string&){ return false; }, back, &e2));
+
+        // Blob = .t3p octet pour octet
+        std::vector<uint8_t> x, y;
+        CHECK(R.extract_t3p((size_t)R.find("c"), "test_arch_c_out.t3p", &err));
+        CHECK(read_file("test_arch_c.t3p", x) && read_file("test_arch_c_out.t3p", y) && x==y);
+    }
+    // Reprise : remplacement de "b" + nouvelle entre
+    const std::vector<Word27> b2 = small_frame(48, 16, 9);
+    {
+        T3AWriter W;
+        CHECK(W.open("test_arch.t3a", &err));
+        CHECK(W.size()==3);
+        CHECK(W.add("b", SubwordMode::S24, 48, 16, b2, "{\"n\":\"b2\"}", &err));
+        CHECK(W.add("d", SubwordMode::S27, 32, 32, a, "", &err));
+        CHECK(W.commit(&err));
+        CHECK(W.size()==4);
+
+        // Ajout non valid : une copie prise avant commit() garde l'tat prcdent
+        CHECK(W.add("e", SubwordMode::S27, 16, 16, c, "", &err));
+        std::vector<uint8_t> snap;
+        CHECK(read_file("test_arch.t3a", snap) && write_file("test_arch_snap.t3a", snap));
+    }
+    {
+        T3AReader R;
+        CHECK(R.open("test_arch_snap.t3a", &err));
+        CHECK(R.size()==4 && R.find("e")==-1 && R.find("d")>=0);
+        std::vector<Word27> back;
+        CHECK(R.read_payload((size_t)R.find("b"), kApproveAll, back, &err) && same_words(back, b2));
+        CHECK(R.read_payload((size_t)R.find("a"), kApproveAll, back, &err) && same_words(back, a));
+    }
+    {
+        // Destructeur de l'crivain : commit des ajouts en attente
+        T3AReader R;
+        CHECK(R.open("test_arch.t3a", &err));
+        CHECK(R.size()==5 && R.find("e")>=0);
+        T3VerifyReport rep;
+        CHECK(t3_verify("test_arch.t3a", rep, 0, &err));
+        CHECK(rep.kind=="t3a" && rep.units==5 && rep.ok());
+    }
+    {
+        // Rpertoire dont offset + taille dborde 64 bits : refus (lecteur, reprise)
+        std::vector<uint8_t> d;
+        CHECK(read_file("test_arch.t3a", d) && d.size() > 32);
+        uint64_t dir_ofs=0;
+        std::memcpy(&dir_ofs, d.data()+8, 8);
+        const uint64_t wrap = ~dir_ofs + 2;           // dir_ofs + wrap == 1
+        std::memcpy(d.data()+16, &wrap, 8);
+        CHECK(write_file("test_arch_wrap.t3a", d));
+        T3AReader R;
+        std::string e1, e2;
+        CHECK(!R.open("test_arch_wrap.t3a", &e1) && e1.find("out of range")!=std::string::npos);
+        T3AWriter W;
+        CHECK(!W.open("test_arch_wrap.t3a", &e2) && e2.find("out of range")!=std::string::npos);
+    }
+    {
+        // .t3p dont words_count*4 dborde vers la vraie taille : blob refus
+        std::vector<uint8_t> d;
+        CHECK(read_file("test_arch_c.t3p", d) && d.size() > 26);
+        uint32_t meta_len=0; uint64_t wc=0;
+        std::memcpy(&meta_len, d.data()+10, 4); std::memcpy(&wc, d.data()+14, 8);
+        wc += (uint64_t)1 << 62;
+        const uint32_t crc = golden_t3p_hdr_crc(d[4], d[5], 16, 16, meta_len, wc);
+        std::memcpy(d.data()+14, &wc, 8); std::memcpy(d.data()+22, &crc, 4);
+        CHECK(write_file("test_arch_wc.t3p", d));
+        T3AWriter W;
+        std::string e3;
+        CHECK(W.open("test_arch_wc.t3a", &err));
+        CHECK(!W.add_t3p_file("x", "test_arch_wc.t3p", &e3));
+    }
+    return true;
+}
+
+// ---------- .t3s : segments round-robin -------------------------------------
+static bool case_t3s(std::string& err){
+    std::vector<std::vector<Word27>> frames;
+    for(uint32_t i=0;i<5;++i) frames.push_back(small_frame(32, 16, 40+i));
+    {
+        T3SWriter W;
+        CHECK(W.open("test_set.t3s", {"test_set_0.t3g", "test_set_1.t3g"},
+                     SubwordMode::S21, 32, 16, "{\"set\":1}", &err, 2));
+        for(size_t i=0;i<frames.size();++i)
+            CHECK(W.add_frame(frames[i], "{\"f\":" + std::to_string(i) + "}", &err));
+        CHECK(W.frame_count()==5);
+        CHECK(W.close(&err));
+    }
+    T3SReader R;
+    CHECK(R.open("test_set.t3s", &err));
+    CHECK(R.frame_count()==5 && R.width()==32 && R.height()==16 && R.sub()==SubwordMode::S21);
+    CHECK(R.meta_json()=="{\"set\":1}" && R.segments().size()==2);
+    for(uint64_t i=0;i<R.frame_count();++i){
+        CHECK(R.frame(i).seg==i%2);
+        std::vector<Word27> back;
+        std::string seen;
+        CHECK(R.read_frame(i, [&](const std::string& m){ seen=m; return true; }, back, &err));
+        CHECK(seen=="{\"f\":" + std::to_string(i) + "}" && same_words(back, frames[(size_t)i]));
+    }
+    std::vector<Word27> back;
+    std::string e2;
+    CHECK(!R.read_frame(1, [](const std::string&){ return false; }, back, &e2) && back.empty());
+    return true;
+}
+
+// ---------- T3PMapWriter / T3VMapWriter -------------------------------------
+static bool case_map_writers(std::string& err){
+    const std::vector<Word27> img = small_frame(40, 24, 5);
+    {
+        T3PMapWriter W;
+        CHECK(W.open("test_map.t3p", SubwordMode::S18, 40, 24, img.size(), "{\"gen\":\"map\"}", &err));
+        CHECK(W.size()==img.size());
+        // Deux plages, valides dans le dsordre
+        const uint64_t half = img.size()/2;
+        std::memcpy(W.words()+half, img.data()+half, (img.size()-half)*sizeof(Word27));
+        W.commit(half, img.size()-half);
+        std::memcpy(W.words(), img.data(), half*sizeof(Word27));
+        W.commit(0, half);
+        CHECK(W.close(&err));
+    }
+    SubwordMode sub; int w=0,h=0; std::string m; uint64_t wc=0;
+    CHECK(t3p_read_header("test_map.t3p", sub, w, h, m, wc, &err));
+    CHECK(sub==SubwordMode::S18 && w==40 && h==24 && wc==img.size());
+    CHECK(m.find("\"gen\":\"map\"")!=std::string::npos);
+    CHECK((4+1+1+2+2+4+8+4 + m.size()) % 4 == 0);   // mots aligns sur 4 o
+    std::vector<Word27> back;
+    CHECK(t3p_read_payload("test_map.t3p", kApproveAll, back, &err) && same_words(back, img));
+
+    // Vido ver 7 : tailles connues d'avance, plage non valide complte  close()
+    std::vector<std::vector<Word27>> frames;
+    std::vector<uint64_t> sizes;
+    std::vector<T3VFrameTime> times;
+    for(uint32_t i=0;i<3;++i){
+        frames.push_back(small_frame(24, 16, 60+i));
+        sizes.push_back(frames.back().size());
+        T3VFrameTime t; t.pts=(int64_t)(2*i); t.flags = i==0 ? T3V_FRAME_KEY : 0u;
+        times.push_back(t);
+    }
+    T3VTimeBase tb; tb.num=1; tb.den=50;
+    {
+        T3VMapWriter W;
+        CHECK(W.open("test_map.t3v", SubwordMode::S27, 24, 16, sizes, "{\"v\":1}",
+                     {"{\"a\":0}", "", "{\"a\":2}"}, &times, tb, &err));
+        CHECK(W.frame_count()==3);
+        for(uint64_t i=0;i<3;++i){
+            std::memcpy(W.frame(i), frames[(size_t)i].data(), sizes[(size_t)i]*sizeof(Word27));
+            if(i!=1) W.commit(i, 0, sizes[(size_t)i]);
+        }
+        CHECK(W.close(&err));
+    }
+    uint64_t n=0;
+    std::vector<T3VFrameIndex> idx; T3VTimeBase tb_r;
+    CHECK(t3v_read_header("test_map.t3v", sub, w, h, m, n, idx, &err, &tb_r));
+    CHECK(n==3 && tb_r.num==1 && tb_r.den==50 && idx[2].pts==4 && idx[0].flags==T3V_FRAME_KEY);
+    for(uint64_t i=0;i<n;++i){
+        CHECK(t3v_read_frame("test_map.t3v", i, kApproveAll, back, &err));
+        CHECK(same_words(back, frames[(size_t)i]));
+    }
+    T3VerifyReport rep;
+    CHECK(t3_verify("test_map.t3v", rep, 0, &err) && rep.ok() && rep.units==3);
+    return true;
+}
+
+// ---------- .t3k / .t3r : magasin de chunks ---------------------------------
+static void t3k_clean(const std::string& p){
+    for(const char* s : {"", ".idx", ".idx.gc", ".gc", ".idx.tmp"}) std::remove((p + s).c_str());
+}
+
+static bool case_chunkstore(std::string& err){
+    const std::string pack = "test_store.t3k";
+    t3k_clean(pack);
+    T3Chunk::Layout L; L.tile_w=16; L.tile_h=16;
+    const int W=64, H=48;                       // 43 tuiles 1616
+    const std::vector<Word27> A = small_frame(W, H, 11), B = small_frame(W, H, 22);
+    std::vector<std::vector<Word27>> vid = {A, A, small_frame(W, H, 33)};
+
+    T3ChunkStore S;
+    CHECK(S.open(pack, &err));
+    S.set_layout(L);
+
+    // Ddup : tuiles identiques dans l'image, puis entre conteneurs
+    T3KStats st;
+    CHECK(S.put_image("test_A.t3r", SubwordMode::S21, W, H, A, "{\"img\":\"A\"}", &st, &err));
+    CHECK(st.chunks==12 && st.chunks_new>0 && st.chunks_new<st.chunks);
+    const size_t n_a = S.chunk_count();
+    CHECK(n_a==st.chunks_new);
+    CHECK(S.put_image("test_A2.t3r", SubwordMode::S21, W, H, A, "{\"img\":\"A2\"}", &st, &err));
+    CHECK(st.chunks_new==0 && st.bytes_written==0 && S.chunk_count()==n_a);
+    CHECK(S.put_video("test_V.t3r", SubwordMode::S21, W, H, vid, "{\"vid\":1}", {"", "", "{\"f\":2}"}, &st, &err));
+    CHECK(st.chunks==36 && st.chunks_new < 12);   // frames 0 et 1 = A : rien de neuf
+    CHECK(S.put_image("test_B.t3r", SubwordMode::S21, W, H, B, "", &st, &err));
+    CHECK(st.chunks_new>0);
+
+    T3RInfo IV;
+    CHECK(t3r_read_header("test_V.t3r", IV, &err));
+    CHECK(IV.frames.size()==3 && IV.meta_json=="{\"vid\":1}" && IV.layout.tile_w==16);
+    std::vector<Word27> back;
+    for(size_t i=0;i<3;++i) CHECK(S.read_frame(IV, i, kApproveAll, back, &err) && same_words(back, vid[i]));
+
+    // release : refs dcrmentes, rien de mort tant qu'une rfrence reste
+    CHECK(S.dead_chunks()==0);
+    CHECK(S.release("test_A.t3r", &err));
+    CHECK(S.dead_chunks()==0);
+    CHECK(!S.release("test_A.t3r", nullptr));      // fichier supprim
+    CHECK(S.release("test_B.t3r", &err));
+    const size_t dead = S.dead_chunks();
+    CHECK(dead>0);
+    const uint64_t pack_before = S.pack_bytes();
+
+    // gc : pack rcrit, frames encore lisibles
+    std::vector<uint8_t> idx_old;
+    CHECK(read_file(pack + ".idx", idx_old));
+    uint64_t reclaimed=0;
+    CHECK(S.gc(&reclaimed, &err));
+    CHECK(reclaimed>0 && S.pack_bytes()==pack_before-reclaimed && S.dead_chunks()==0);
+    for(size_t i=0;i<3;++i) CHECK(S.read_frame(IV, i, kApproveAll, back, &err) && same_words(back, vid[i]));
+    T3RInfo IA2;
+    CHECK(t3r_read_header("test_A2.t3r", IA2, &err));
+    CHECK(S.read_frame(IA2, 0, kApproveAll, back, &err) && same_words(back, A));
+    S.close();
+
+    // Bascule interrompue aprs le renommage du pack : .idx prim (gen-1) +
+    // .idx.gc de la bonne gnration -> l'ouverture termine la bascule
+    std::vector<uint8_t> idx_new;
+    CHECK(read_file(pack + ".idx", idx_new));
+    CHECK(write_file(pack + ".idx.gc", idx_new) && write_file(pack + ".idx", idx_old));
+    CHECK(S.open(pack, &err));
+    CHECK(!file_exists(pack + ".idx.gc"));
+    CHECK(S.read_frame(IV, 2, kApproveAll, back, &err) && same_words(back, vid[2]));
+    S.close();
+
+    // Bascule interrompue avant le renommage : .idx.gc d'une autre gnration ignor
+    CHECK(write_file(pack + ".idx.gc", idx_old));
+    CHECK(S.open(pack, &err));
+    CHECK(!file_exists(pack + ".idx.gc"));
+    CHECK(S.dead_chunks()==0);
+    S.close();
+
+    // .idx prim sans .idx.gc : refus (jamais un index d'une autre gnration)
+    CHECK(write_file(pack + ".idx", idx_old));
+    std::string e2;
+    CHECK(!S.open(pack, &e2));
+    CHECK(write_file(pack + ".idx", idx_new));
+
+    // Chunk corrompu dans le pack : hash recalcul  la lecture et au gc
+    std::vector<uint8_t> pk;
+    CHECK(read_file(pack, pk) && pk.size() > 16+20+4);
+    pk[16+20+1] ^= 0x5A;                     // 1er enregistrement, donnes
+    CHECK(write_file(pack, pk));
+    CHECK(S.open(pack, &err));
+    bool any_bad=false;
+    for(size_t i=0;i<3;++i){
+        std::string e3;
+        if(!S.read_frame(IV, i, kApproveAll, back, &e3)){
+            CHECK(e3.find("hash mismatch")!=std::string::npos && back.empty());
+            any_bad=true;
+        }
+    }
+    if(!S.read_frame(IA2, 0, kApproveAll, back, nullptr)) any_bad=true;
+    CHECK(any_bad);
+    std::string e4;
+    CHECK(!S.gc(nullptr, &e4) && e4.find("hash mismatch")!=std::string::npos);
+    S.close();
+    return true;
+}
+
+// ---------- .t3pl : plans de trits ------------------------------------------
+// Header T3PL (aprs magic) : ver, sub, W, H, n_planes, rsv, meta_len, words
+// (20 octets) + 13 entres de 20 octets {digit, pad[3], offset, bytes, crc}.
+static bool t3pl_patch(const std::string& p, size_t at, const void* v, size_t n){
+    std::vector<uint8_t> d;
+    if(!read_file(p, d) || d.size() < 4+280+4) return false;
+    std::memcpy(d.data()+at, v, n);
+    const uint32_t crc = T3Crc32::crc32(d.data()+4, 280);
+    std::memcpy(d.data()+4+280, &crc, 4);
+    return write_file(p, d);
+}
+static bool case_t3pl(std::string& err){
+    const std::vector<Word27> a = small_frame(40, 24, 5);
+    std::vector<Word27> back;
+    int used=0;
+    CHECK(t3pl_write("test_planes.t3pl", SubwordMode::S21, 40, 24, a, "{\"p\":1}", &err));
+    CHECK(t3pl_read("test_planes.t3pl", kApproveAll, -1, back, &used, &err) && used==13 && same_words(back, a));
+    CHECK(t3pl_read("test_planes.t3pl", kApproveAll, 4, back, &used, &err) && used==4 && back.size()==a.size());
+
+    // Mots != w*h : refus  l'criture
+    std::string e1;
+    CHECK(!t3pl_write("test_planes_bad.t3pl", SubwordMode::S21, 40, 25, a, "", &e1) && !file_exists("test_planes_bad.t3pl"));
+
+    // words_count hors w*h (CRC header recalcul) : refus avant allocation
+    std::vector<uint8_t> orig;
+    CHECK(read_file("test_planes.t3pl", orig));
+    const uint64_t huge = (uint64_t)1 << 40;
+    CHECK(t3pl_patch("test_planes.t3pl", 4+12, &huge, 8));
+    std::string e2;
+    CHECK(!t3pl_read("test_planes.t3pl", kApproveAll, -1, back, &used, &e2) && e2.find("words_count")!=std::string::npos);
+
+    // Taille d'un plan != plane_bytes(words_count) : refus
+    CHECK(write_file("test_planes.t3pl", orig));
+    const uint32_t pb = (uint32_t)((a.size()+4)/5 + 1);
+    CHECK(t3pl_patch("test_planes.t3pl", 4+20+12*20+12, &pb, 4));
+    std::string e3;
+    CHECK(!t3pl_read("test_planes.t3pl", kApproveAll, -1, back, &used, &e3) && e3.find("plane size")!=std::string::npos);
+    return true;
+}
+
 int main(){
     std::cout << "{\n  \"t3containers\": {\n";
-    std::cout << "    \"available\": " << (HAS_T3? "true":"false") << ",\n";
+    std::cout << "    \"available\": true,\n";
 
     bool all_ok = true;
 
@@ -110,29 +713,22 @@ int main(){
         int w=0,h=0; std::vector<Word27> words;
         bool ok_gen = make_words_for(sub, words, w, h);
 
-        // srialisation ternaire pour CRC/parit
-        std::vector<int8_t> bal; bal.reserve((size_t)w*h*13);
-        std::vector<uint8_t> unb; unb.reserve(bal.size());
-        // NB: on ne dispose pas ici des trits balanced par pixel (exposs ct cur);
-        //     on produit une estimation via dcodage->re-quant->encode pour la forme.
-        //     Pour le rapport conteneur, on drive la signature des 'words' byte-packs.
-        (void)bal;
-
-        // pack des Word27 (approx: on re-packe via trits unbalanced synthtiques)
-        // Ici, pour rapport, on prend les bytes de la reprsentation brute des Word27 :
+        // Signature rapport : CRC12 des octets bruts des Word27
         const uint8_t* raw_bytes = reinterpret_cast<const uint8_t*>(words.data());
         size_t raw_len = words.size()*sizeof(Word27);
         uint16_t crc12 = crc12_0x80F(raw_bytes, raw_len);
 
         bool ok_write=false, ok_read=false, ok_eq=false;
         SubwordMode sub_r=SubwordMode::S27; int wr=0,hr=0; std::vector<Word27> words_r;
+        std::string meta_r; uint64_t wc=0;
 
-        if(HAS_T3 && ok_gen){
+        if(ok_gen){
             std::string path = std::string("test_") + mname(sub) + ".t3p";
             ok_write = t3p_write(path, sub, w, h, words, "{\"gen\":\"minitest\"}");
             if(ok_write){
-                ok_read = t3p_read(path, sub_r, wr, hr, words_r, nullptr);
-                ok_eq   = ok_read && sub_r==sub && wr==w && hr==h && words_r==words;
+                ok_read = t3p_read_header(path, sub_r, wr, hr, meta_r, wc)
+                          && t3p_read_payload(path, kApproveAll, words_r);
+                ok_eq   = ok_read && sub_r==sub && wr==w && hr==h && same_words(words_r, words);
             }
         }
 
@@ -141,12 +737,12 @@ int main(){
         std::cout << "      {\"mode\":\"" << mname(sub) << "\","
                   << "\"w\":"<<w<<",\"h\":"<<h
                   << ",\"words\":"<<words.size()
-                  << ",\"crc12_raw\":\"" << std::hex << std::uppercase << std::setw(3) << std::setfill('0') << (crc12&0x0FFF) << std::dec << "\""
+                  << ",\"crc12_raw\":\"" << std::hex << std::uppercase << std::setw(3) << std::setfill('0') << (crc12&0x0FFF) << std::dec << std::setfill(' ') << "\""
                   << ",\"write\":" << (ok_write? "true":"false")
                   << ",\"read\":"  << (ok_read? "true":"false")
                   << ",\"equal\":" << (ok_eq? "true":"false")
                   << "}";
-        all_ok = all_ok && (!HAS_T3 || (ok_write&&ok_read&&ok_eq));
+        all_ok = all_ok && ok_write && ok_read && ok_eq;
     }
     std::cout << "\n    ],\n";
 
@@ -163,22 +759,51 @@ int main(){
         frames.push_back(std::move(words));
     }
     double fps_w=25.0, fps_r=0.0;
-    if(HAS_T3){
-        ok_write = t3v_write("test_S21.t3v", sub, w, h, frames, fps_w, "{\"seq\":\"minitest\"}");
-        std::vector<std::vector<Word27>> back;
+    {
+        ok_write = t3v_write("test_S21.t3v", sub, w, h, frames, "{\"seq\":\"minitest\",\"fps\":25}", {});
         SubwordMode sub_r=SubwordMode::S27; int wr=0,hr=0;
-        if(ok_write) ok_read = t3v_read("test_S21.t3v", sub_r, wr, hr, back, fps_r, nullptr);
-        ok_frames = ok_read && sub_r==sub && wr==w && hr==h && back.size()==frames.size();
-        if(ok_frames){
-            for(size_t i=0;i<frames.size();++i) if(back[i]!=frames[i]) { ok_frames=false; break; }
+        std::string meta_r; uint64_t n=0; std::vector<T3VFrameIndex> idx; T3VTimeBase tb;
+        if(ok_write) ok_read = t3v_read_header("test_S21.t3v", sub_r, wr, hr, meta_r, n, idx, nullptr, &tb);
+        if(ok_read && tb.num) fps_r = (double)tb.den / tb.num;
+        ok_frames = ok_read && sub_r==sub && wr==w && hr==h && n==frames.size();
+        for(size_t i=0; ok_frames && i<frames.size(); ++i){
+            std::vector<Word27> back;
+            ok_frames = t3v_read_frame("test_S21.t3v", i, kApproveAll, back) && same_words(back, frames[i]);
         }
     }
+    all_ok = all_ok && ok_write && ok_read && ok_frames;
     std::cout << "      \"mode\":\"S21\",\n";
     std::cout << "      \"w\":"<<w<<", \"h\":"<<h<<", \"frames\":"<<frames.size()<<",\n";
     std::cout << "      \"write\":"<<(ok_write? "true":"false")<<", \"read\":"<<(ok_read? "true":"false")<<", \"equal\":"<<(ok_frames? "true":"false")<<",\n";
     std::cout << "      \"fps_w\":"<<fps_w<<", \"fps_r\":"<<fps_r<<"\n";
     std::cout << "    },\n";
 
+    // --- Cas par format ----------------------------------------------------
+    const struct { const char* name; bool (*fn)(std::string&); } cases[] = {
+        {"t3p_golden_bytes",  case_t3p_golden},
+        {"t3v_ver6_compat",   case_t3v6_compat},
+        {"t3v_ver7_pts",      case_t3v7},
+        {"t3v_cut_concat",    case_t3v_edit},
+        {"t3a_archive",       case_t3a},
+        {"t3s_segments",      case_t3s},
+        {"map_writers",       case_map_writers},
+        {"t3k_chunkstore",    case_chunkstore},
+        {"t3pl_planes",       case_t3pl},
+    };
+    for(const auto& c : cases){
+        std::string err;
+        const bool ok = c.fn(err);
+        g_cases.push_back({c.name, ok, ok ? std::string() : err});
+        all_ok = all_ok && ok;
+    }
+    std::cout << "    \"cases\": [\n";
+    for(size_t i=0;i<g_cases.size();++i){
+        std::cout << "      {\"name\":\"" << g_cases[i].name << "\",\"ok\":" << (g_cases[i].ok? "true":"false");
+        if(!g_cases[i].ok) std::cout << ",\"err\":\"" << json_escape(g_cases[i].err) << "\"";
+        std::cout << "}" << (i+1<g_cases.size()? ",\n" : "\n");
+    }
+    std::cout << "    ],\n";
+
     std::cout << "    \"final_status\": " << (all_ok? "\"PASS\"" : "\"CHECK\"") << "\n";
     std::cout << "  }\n}\n";
     return all_ok? 0: 1;
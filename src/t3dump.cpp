@@ -1,5 +1,5 @@
 // ============================================================================
-//  File: src/t3dump.cpp  CLI .t3p / .t3v dumper + extract PNG
+//  File: src/t3dump.cpp  CLI .t3p / .t3v / .t3pl / .t3a / .t3k / .t3r / .t3s dumper + extract PNG
 //  Project: Ternary Image/Video Codec v6
 //
 //  USAGE EXAMPLES
@@ -17,6 +17,41 @@
 //   # Extraire toutes les frames .t3v dans un dossier
 //   ./t3dump input.t3v --extract-png all --outdir ./frames
 //
+//   # Frame affiche  t=12.5 s (index pts, sans lecture des frames) ;
+//   # --key : keyframe qui la prcde
+//   ./t3dump input.t3v --seek 12.5 [--key] --extract-png 0 --out t.png
+//
+//   # Plans de trits : .t3p -> .t3pl, puis aperu avec les 3 premiers plans
+//   ./t3dump input.t3p --to-planes input.t3pl
+//   ./t3dump input.t3pl --planes 3 --extract-png 0 --out coarse.png
+//
+//   # Archive .t3a : ajout de .t3p (cre si absente), liste, extraction O(1)
+//   ./t3dump corpus.t3a --add a.t3p --add b.t3p
+//   ./t3dump corpus.t3a
+//   ./t3dump corpus.t3a --entry a.t3p --extract-png 0 --out a.png
+//   ./t3dump corpus.t3a --entry '#1' --to-t3p b.t3p
+//
+//   # Magasin de chunks ddupliqu : a.t3p -> a.t3r (rfrences), relecture
+//   ./t3dump media.t3k --add a.t3p --add cam1.t3v [--tile 64x16]
+//   ./t3dump a.t3r --store media.t3k --extract-png 0 --out a.png
+//   ./t3dump media.t3k --release a.t3r --gc
+//
+//   # Vido rpartie sur plusieurs disques (.t3s + 1 segment .t3g par disque)
+//   ./t3dump cam.t3v --to-stripes cam.t3s --segdir /mnt/nvme0 --segdir /mnt/nvme1
+//   ./t3dump cam.t3s --extract-png 12 --out f12.png
+//
+//   # Contrle d'intgrit (header/index + CRC32 de chaque payload, mmap,
+//   # tous les curs) ; code retour 1 si corruption
+//   ./t3dump archive.t3v --verify [--threads N] [--json]
+//
+//   # Aperu 1/8 sans lecture complte (lignes chantillonnes seulement) ;
+//   # --box : moyenne 88 (frame lue en entier)
+//   ./t3dump cam.t3v --preview 8 [--box] --extract-png all --outdir ./thumbs
+//
+//   # PNG : niveau fast (stockage) .. best, compression par blocs sur
+//   # --threads curs (io_png_mt.hpp)
+//   ./t3dump cam.t3v --extract-png all --outdir ./frames --png-level fast --threads 8
+//
 //  BUILD (exemples)
 //  ----------------
 //   g++ -std=c++17 -O2 -Iinclude -Ithird_party \
@@ -29,6 +64,19 @@
 //   * CRC-12(0x80F) calcul sur les octets bruts de Word27 (format .t3p/.t3v minimal).
 //   * Parit mod 3 ~ somme(byte%3) mod 3 sur les octets bruts (approx rapide).
 //   * Extraction PNG utilise words_to_image_subword(...) du pont io_image.hpp.
+//   * .t3pl : table des plans (chiffre, taille, CRC) ; --planes K reconstruit
+//     depuis les K premiers plans (fichier tronqu -> plans disponibles).
+//   * .t3a : rpertoire central (hash du nom -> blob .t3p), lu par mmap ;
+//     --entry NOM ou '#i' slectionne une entre sans parcourir l'archive.
+//   * .t3k/.t3r : tuiles hashes (128 bits) stockes une fois dans le pack ;
+//     --add n'crit que les tuiles absentes, --release dcrmente les refs,
+//     --gc compacte le pack (chunks sans rfrence supprims).
+//   * .t3s : frame i sur le segment i % N ; --segdir relatif = relatif au
+//     dossier du manifeste.
+//   * --verify (.t3p/.t3v/.t3a) : vrais CRC32 du conteneur (pas le CRC-12
+//     indicatif ci-dessus), dbit en Go/s et liste des frames invalides.
+//   * --preview K : 1 pixel = 1 mot, l'aperu lit 1 ligne sur K et dcode
+//     1 mot sur K (O(pixels/K)) ; CRC payload non contrl dans ce mode.
 // ============================================================================
 
 #include <cstdio>
@@ -40,10 +88,15 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <unordered_set>
 
 #include "ternary_image_codec_v6_min.hpp" // SubwordMode, StdRes helpers
 #include "io_t3p_t3v.hpp"                 // t3p_* / t3v_* (impl minimale fournie)
 #include "io_image.hpp"                   // words_to_image_subword(...)
+#include "t3_tritplanes.hpp"              // T3Planes::plane_name
+#include "t3_meta.hpp"                   // mta TLV (fps)
+
+using namespace T3Container;
 
 static uint16_t crc12_0x80F(const uint8_t* data, size_t len)
 {
@@ -104,14 +157,43 @@ struct Args
     int  idx=0;
     std::string out_png="frame.png";
     std::string outdir=".";
+    int  planes=-1;          // .t3pl : #plans utiliss (-1 = tous)
+    std::string to_planes;   // .t3p -> .t3pl
+    std::string entry;       // .t3a : nom ou "#i"
+    std::vector<std::string> add; // .t3a : .t3p  ajouter
+    std::string to_t3p;      // .t3a : copie brute de l'entre
+    std::string store;       // .t3r : pack .t3k des chunks
+    std::vector<std::string> release; // .t3k : .t3r  librer
+    bool gc=false;           // .t3k : compactage
+    int  tile_w=-1, tile_h=0; // .t3k : dcoupage (--tile WxH, W=0 -> bandes)
+    double seek=-1.0;        // .t3v : --seek SECONDES (remplace l'index de frame)
+    bool key=false;          // .t3v : --seek sur keyframe
+    std::string to_stripes;  // .t3v -> manifeste .t3s
+    std::vector<std::string> segdirs; // .t3s : 1 dossier par disque
+    bool verify=false;       // .t3p/.t3v/.t3a : contrle CRC complet
+    unsigned threads=0;      // --verify / criture PNG : 0 = tous les curs
+    int  png_level=-1;       // --png-level (-1 = dfaut T3Png, 6)
+    int  preview=0;          // .t3p/.t3v : --preview K (aperu 1/K  l'extraction)
+    bool box=false;          // --preview : moyenne KK au lieu du point central
 };
 static void print_usage(const char* exe)
 {
     std::cerr
             << "Usage:\n"
-            << "  " << exe << " <file.t3p|file.t3v> [--json]\n"
+            << "  " << exe << " <file.t3p|file.t3v|file.t3pl|file.t3a|file.t3k|file.t3r|file.t3s> [--json]\n"
             << "  " << exe << " <file> --extract-png 0 --out out.png\n"
-            << "  " << exe << " <file.t3v> --extract-png all --outdir ./frames\n";
+            << "  " << exe << " <file.t3v> --extract-png all --outdir ./frames\n"
+            << "  " << exe << " <file.t3v> --seek SECONDS [--key] [--extract-png 0 --out out.png]\n"
+            << "  " << exe << " <file.t3v> --to-stripes out.t3s --segdir DIR [--segdir DIR ...]\n"
+            << "  " << exe << " <file.t3p> --to-planes out.t3pl\n"
+            << "  " << exe << " <file.t3pl> --planes K --extract-png 0 --out out.png\n"
+            << "  " << exe << " <file.t3a> --add in.t3p [--add ...]\n"
+            << "  " << exe << " <file.t3a> --entry NAME|#i [--extract-png 0 --out out.png] [--to-t3p out.t3p]\n"
+            << "  " << exe << " <store.t3k> [--add in.t3p|in.t3v ...] [--tile WxH] [--release x.t3r ...] [--gc]\n"
+            << "  " << exe << " <file.t3r> --store store.t3k --extract-png 0|all [--out out.png|--outdir dir]\n"
+            << "  " << exe << " <file.t3p|file.t3v|file.t3a> --verify [--threads N] [--json]\n"
+            << "  " << exe << " <file.t3p|file.t3v> --preview K [--box] --extract-png 0|all [--seek SECONDS] [--out out.png|--outdir dir]\n"
+            << "  PNG output: [--png-level fast|speed|default|best|0..9] [--threads N]\n";
 }
 static bool parse_args(int argc,char**argv, Args& a)
 {
@@ -151,17 +233,143 @@ static bool parse_args(int argc,char**argv, Args& a)
         {
             a.outdir=argv[++i];
         }
+        else if(s=="--planes" && i+1<argc)
+        {
+            a.planes=std::atoi(argv[++i]);
+        }
+        else if(s=="--to-planes" && i+1<argc)
+        {
+            a.to_planes=argv[++i];
+        }
+        else if(s=="--entry" && i+1<argc)
+        {
+            a.entry=argv[++i];
+        }
+        else if(s=="--add" && i+1<argc)
+        {
+            a.add.push_back(argv[++i]);
+        }
+        else if(s=="--to-t3p" && i+1<argc)
+        {
+            a.to_t3p=argv[++i];
+        }
+        else if(s=="--seek" && i+1<argc)
+        {
+            a.seek=std::atof(argv[++i]);
+        }
+        else if(s=="--key")
+        {
+            a.key=true;
+        }
+        else if(s=="--to-stripes" && i+1<argc)
+        {
+            a.to_stripes=argv[++i];
+        }
+        else if(s=="--segdir" && i+1<argc)
+        {
+            a.segdirs.push_back(argv[++i]);
+        }
+        else if(s=="--store" && i+1<argc)
+        {
+            a.store=argv[++i];
+        }
+        else if(s=="--release" && i+1<argc)
+        {
+            a.release.push_back(argv[++i]);
+        }
+        else if(s=="--gc")
+        {
+            a.gc=true;
+        }
+        else if(s=="--verify")
+        {
+            a.verify=true;
+        }
+        else if(s=="--preview" && i+1<argc)
+        {
+            a.preview=std::atoi(argv[++i]);
+            if(a.preview<1)
+            {
+                std::cerr<<"[t3dump] --preview expects K >= 1\n";
+                return false;
+            }
+        }
+        else if(s=="--png-level" && i+1<argc)
+        {
+            if(!T3Png::parse_level(argv[++i], a.png_level))
+            {
+                std::cerr<<"[t3dump] --png-level expects fast|speed|default|best|0..9\n";
+                return false;
+            }
+        }
+        else if(s=="--box")
+        {
+            a.box=true;
+        }
+        else if(s=="--threads" && i+1<argc)
+        {
+            a.threads=(unsigned)std::max(0, std::atoi(argv[++i]));
+        }
+        else if(s=="--tile" && i+1<argc)
+        {
+            if(std::sscanf(argv[++i], "%dx%d", &a.tile_w, &a.tile_h)!=2 || a.tile_w<0 || a.tile_h<=0)
+            {
+                std::cerr<<"[t3dump] --tile expects WxH (W=0 for full-width bands)\n";
+                return false;
+            }
+        }
     }
     return !a.path.empty();
 }
 
+// Lecture complte via l'API T3Container (header puis payload)
+static bool load_t3p(const std::string& path, SubwordMode& sub, int& w, int& h,
+                     std::vector<Word27>& words, std::string* meta)
+{
+    std::string m;
+    uint64_t n=0;
+    if(!t3p_read_header(path, sub, w, h, m, n)) return false;
+    if(!t3p_read_payload(path, nullptr, words)) return false;
+    if(meta) *meta=m;
+    return true;
+}
+static bool load_t3v(const std::string& path, SubwordMode& sub, int& w, int& h,
+                     std::vector<std::vector<Word27>>& frames, double& fps, std::string* meta,
+                     std::vector<T3VFrameIndex>* out_index=nullptr, T3VTimeBase* out_tb=nullptr)
+{
+    std::string m;
+    uint64_t count=0;
+    std::vector<T3VFrameIndex> index;
+    if(!t3v_read_header(path, sub, w, h, m, count, index, nullptr, out_tb)) return false;
+    frames.assign((size_t)count, {});
+    for(uint64_t i=0; i<count; ++i)
+        if(!t3v_read_frame(path, i, nullptr, frames[(size_t)i])) return false;
+    // fps : cl JSON "fps" de la mta globale si prsente
+    fps=0.0;
+    T3Meta::MetaView mv;
+    std::string_view sv;
+    if(mv.parse(m))
+    {
+        if(mv.get_str(T3Meta::kFps, sv)) fps=std::atof(std::string(sv).c_str());
+    }
+    else
+    {
+        size_t k=m.find("\"fps\"");
+        if(k!=std::string::npos && (k=m.find(':', k))!=std::string::npos)
+            fps=std::atof(m.c_str()+k+1);
+    }
+    if(meta) *meta=m;
+    if(out_index) *out_index=std::move(index);
+    return true;
+}
+
 static bool dump_t3p(const Args& A)
 {
     SubwordMode sub;
     int w=0,h=0;
     std::vector<Word27> words;
     std::string meta;
-    if(!t3p_read(A.path, sub, w, h, words, &meta))
+    if(!load_t3p(A.path, sub, w, h, words, &meta))
     {
         std::cerr<<"[t3dump] read failed: "<<A.path<<"\n";
         return false;
@@ -212,6 +420,93 @@ static bool dump_t3p(const Args& A)
         }
         if(!A.json) std::cout<<"extracted -> "<<out<<"\n";
     }
+
+    if(!A.to_planes.empty())
+    {
+        std::string err;
+        if(!t3pl_write(A.to_planes, sub, w, h, words, meta, &err))
+        {
+            std::cerr<<"[t3dump] t3pl write failed: "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"planes -> "<<A.to_planes<<"\n";
+    }
+    return true;
+}
+
+static bool dump_t3pl(const Args& A)
+{
+    SubwordMode sub;
+    int w=0,h=0;
+    std::string meta, err;
+    uint64_t n=0;
+    std::vector<T3PLPlaneIndex> idx;
+    if(!t3pl_read_header(A.path, sub, w, h, meta, n, idx, &err))
+    {
+        std::cerr<<"[t3dump] read failed: "<<A.path<<" ("<<err<<")\n";
+        return false;
+    }
+
+    if(A.json)
+    {
+        std::cout << "{\n"
+                  << "  \"t3pl\": {\n"
+                  << "    \"file\": \""<<A.path<<"\",\n"
+                  << "    \"mode\": \""<<mname(sub)<<"\",\n"
+                  << "    \"w\": "<<w<<", \"h\": "<<h<<", \"words\": "<<n<<",\n"
+                  << "    \"meta_len\": "<<meta.size()<<",\n"
+                  << "    \"planes\": [";
+        for(size_t p=0; p<idx.size(); ++p)
+        {
+            std::cout << (p?",":"") << "\n      {\"name\": \""<<T3Planes::plane_name((int)p)
+                      << "\", \"digit\": "<<(int)idx[p].digit
+                      << ", \"offset\": "<<idx[p].offset
+                      << ", \"bytes\": "<<idx[p].bytes
+                      << ", \"crc32\": \""<< std::hex << std::uppercase << std::setw(8) << std::setfill('0') << idx[p].crc32 << std::dec << std::setfill(' ') << "\"}";
+        }
+        std::cout << "\n    ]\n  }\n}\n";
+    }
+    else
+    {
+        std::cout<<"== .t3pl ==\n"
+                 <<"file: "<<A.path<<"\n"
+                 <<"mode: "<<mname(sub)<<"\n"
+                 <<"size: "<<w<<" x "<<h<<"\n"
+                 <<"words: "<<n<<"\n"
+                 <<"meta: "<<meta.size()<<" bytes\n"
+                 <<"planes: "<<idx.size()<<"\n";
+        for(size_t p=0; p<idx.size(); ++p)
+        {
+            std::cout<<"  ["<<std::setw(2)<<p<<"] "<<std::setw(3)<<T3Planes::plane_name((int)p)
+                     <<"  digit="<<std::setw(2)<<(int)idx[p].digit
+                     <<"  offset="<<idx[p].offset
+                     <<"  bytes="<<idx[p].bytes
+                     <<"  crc32=0x"<< std::hex << std::uppercase << std::setw(8) << std::setfill('0') << idx[p].crc32 << std::dec << std::setfill(' ') << "\n";
+        }
+    }
+
+    if(A.extract)
+    {
+        if(!A.extract_all && A.idx!=0)
+        {
+            std::cerr<<"[t3dump] .t3pl has only frame 0\n";
+            return false;
+        }
+        std::vector<Word27> words;
+        int used=0;
+        if(!t3pl_read(A.path, nullptr, A.planes, words, &used, &err))
+        {
+            std::cerr<<"[t3dump] t3pl read failed: "<<err<<"\n";
+            return false;
+        }
+        std::string out = A.extract_all ? (A.outdir+"/frame_0000.png") : A.out_png;
+        if(!words_to_image_subword(words, sub, w, h, out))
+        {
+            std::cerr<<"[t3dump] PNG write failed: "<<out<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"extracted ("<<used<<"/"<<T3Planes::kPlanes<<" planes) -> "<<out<<"\n";
+    }
     return true;
 }
 
@@ -222,7 +517,9 @@ static bool dump_t3v(const Args& A)
     std::vector<std::vector<Word27>> frames;
     double fps=0.0;
     std::string meta;
-    if(!t3v_read(A.path, sub, w, h, frames, fps, &meta))
+    std::vector<T3VFrameIndex> index;
+    T3VTimeBase tb;
+    if(!load_t3v(A.path, sub, w, h, frames, fps, &meta, &index, &tb))
     {
         std::cerr<<"[t3dump] read failed: "<<A.path<<"\n";
         return false;
@@ -245,6 +542,9 @@ static bool dump_t3v(const Args& A)
         crc_glob ^= c;
         p3_glob  = (uint8_t)((p3_glob + approx_parity_mod3(raw, raw_len)) % 3);
     }
+    size_t keys=0;
+    for(const auto& e : index) keys += (e.flags & T3V_FRAME_KEY) ? 1 : 0;
+    const double dur = index.empty() ? 0.0 : tb.seconds(index.back().pts - index.front().pts);
 
     if(A.json)
     {
@@ -256,6 +556,7 @@ static bool dump_t3v(const Args& A)
                   << "    \"words_total\": "<<total_words<<", \"bytes_total\": "<<total_bytes<<",\n"
                   << "    \"crc12_concat_xor\": \""<< std::hex << std::uppercase << std::setw(3) << std::setfill('0') << (crc_glob&0x0FFF) << std::dec <<"\",\n"
                   << "    \"parity3_sum\": "<<(int)p3_glob<<",\n"
+                  << "    \"timebase\": \""<<tb.num<<"/"<<tb.den<<"\", \"span_s\": "<<dur<<", \"keyframes\": "<<keys<<",\n"
                   << "    \"meta_len\": "<<meta.size()<<"\n"
                   << "  }\n}\n";
     }
@@ -269,9 +570,27 @@ static bool dump_t3v(const Args& A)
                  <<"words_total: "<<total_words<<"  bytes_total: "<<total_bytes<<"\n"
                  <<"crc12(concat^): 0x"<< std::hex << std::uppercase << std::setw(3) << std::setfill('0') << (crc_glob&0x0FFF) << std::dec << "\n"
                  <<"parity3(sum): "<<(int)p3_glob<<"\n"
+                 <<"timebase: "<<tb.num<<"/"<<tb.den<<"  span: "<<dur<<" s  keyframes: "<<keys<<"\n"
                  <<"meta: "<<meta.size()<<" bytes\n";
     }
 
+    // --seek : recherche dichotomique dans l'index pts
+    int frame_sel = A.idx;
+    if(A.seek>=0.0)
+    {
+        const long i = t3v_seek_time(index, tb, A.seek, A.key);
+        if(i<0)
+        {
+            std::cerr<<"[t3dump] seek on empty video\n";
+            return false;
+        }
+        frame_sel=(int)i;
+        if(!A.json)
+            std::cout<<"seek "<<A.seek<<" s -> frame "<<i<<"  pts="<<index[(size_t)i].pts
+                     <<" ("<<tb.seconds(index[(size_t)i].pts)<<" s)"
+                     <<((index[(size_t)i].flags & T3V_FRAME_KEY)? "  key" : "")<<"\n";
+    }
+
     if(A.extract)
     {
         if(A.extract_all)
@@ -291,7 +610,7 @@ static bool dump_t3v(const Args& A)
         }
         else
         {
-            int idx = std::clamp(A.idx, 0, (int)frames.size()-1);
+            int idx = std::clamp(frame_sel, 0, (int)frames.size()-1);
             std::string out = A.out_png;
             if(!words_to_image_subword(frames[(size_t)idx], sub, w, h, out))
             {
@@ -301,20 +620,588 @@ static bool dump_t3v(const Args& A)
             if(!A.json) std::cout<<"extracted frame "<<idx<<" -> "<<out<<"\n";
         }
     }
+
+    if(!A.to_stripes.empty())
+    {
+        if(A.segdirs.empty())
+        {
+            std::cerr<<"[t3dump] --to-stripes needs at least one --segdir\n";
+            return false;
+        }
+        // Segments : <segdir>/<nom du manifeste sans extension>.<k>.t3g
+        std::string stem = A.to_stripes;
+        const size_t sl = stem.find_last_of("/\\");
+        if(sl!=std::string::npos) stem = stem.substr(sl+1);
+        if(has_suffix(stem, ".t3s")) stem.resize(stem.size()-4);
+        std::vector<std::string> segs;
+        for(size_t k=0; k<A.segdirs.size(); ++k)
+            segs.push_back(A.segdirs[k] + "/" + stem + "." + std::to_string(k) + ".t3g");
+
+        std::string err;
+        T3SWriter S;
+        if(!S.open(A.to_stripes, segs, sub, w, h, meta, &err))
+        {
+            std::cerr<<"[t3dump] t3s open failed: "<<err<<"\n";
+            return false;
+        }
+        for(auto& fr : frames)
+        {
+            if(!S.add_frame(std::move(fr), std::string(), &err))
+            {
+                std::cerr<<"[t3dump] t3s write failed: "<<err<<"\n";
+                return false;
+            }
+        }
+        if(!S.close(&err))
+        {
+            std::cerr<<"[t3dump] t3s close failed: "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"stripes -> "<<A.to_stripes<<" ("<<segs.size()<<" segments)\n";
+    }
+    return true;
+}
+
+static bool dump_t3a(const Args& A)
+{
+    std::string err;
+    if(!A.add.empty())
+    {
+        T3AWriter W;
+        if(!W.open(A.path, &err))
+        {
+            std::cerr<<"[t3dump] t3a open failed: "<<err<<"\n";
+            return false;
+        }
+        for(const auto& in : A.add)
+        {
+            const size_t sl = in.find_last_of("/\\");
+            const std::string name = (sl==std::string::npos)? in : in.substr(sl+1);
+            if(!W.add_t3p_file(name, in, &err))
+            {
+                std::cerr<<"[t3dump] t3a add failed: "<<err<<"\n";
+                return false;
+            }
+        }
+        if(!W.commit(&err))
+        {
+            std::cerr<<"[t3dump] t3a commit failed: "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"added "<<A.add.size()<<" -> "<<A.path<<" ("<<W.size()<<" entries)\n";
+        if(A.entry.empty()) return true;
+    }
+
+    T3AReader R;
+    if(!R.open(A.path, &err))
+    {
+        std::cerr<<"[t3dump] read failed: "<<A.path<<" ("<<err<<")\n";
+        return false;
+    }
+
+    if(A.entry.empty())
+    {
+        if(A.json)
+        {
+            std::cout << "{\n"
+                      << "  \"t3a\": {\n"
+                      << "    \"file\": \""<<A.path<<"\",\n"
+                      << "    \"entries\": [";
+            for(size_t i=0; i<R.size(); ++i)
+            {
+                const T3AEntry e = R.entry(i);
+                std::cout << (i?",":"") << "\n      {\"name\": \""<<e.name<<"\", \"mode\": \""<<mname(e.sub)
+                          << "\", \"w\": "<<e.w<<", \"h\": "<<e.h
+                          << ", \"offset\": "<<e.offset<<", \"bytes\": "<<e.bytes
+                          << ", \"meta_len\": "<<e.meta_len<<"}";
+            }
+            std::cout << "\n    ]\n  }\n}\n";
+        }
+        else
+        {
+            std::cout<<"== .t3a ==\n"
+                     <<"file: "<<A.path<<"\n"
+                     <<"entries: "<<R.size()<<"\n";
+            for(size_t i=0; i<R.size(); ++i)
+            {
+                const T3AEntry e = R.entry(i);
+                std::cout<<"  ["<<i<<"] "<<e.name<<"  "<<mname(e.sub)<<" "<<e.w<<"x"<<e.h
+                         <<"  @"<<e.offset<<"  bytes="<<e.bytes<<"  meta="<<e.meta_len<<"\n";
+            }
+        }
+        return true;
+    }
+
+    // Slection : "#i" = index, sinon nom (table de hachage du rpertoire)
+    long idx = -1;
+    if(A.entry.size()>1 && A.entry[0]=='#')
+    {
+        idx = std::atol(A.entry.c_str()+1);
+        if(idx<0 || (size_t)idx>=R.size()) idx=-1;
+    }
+    else idx = R.find(A.entry);
+    if(idx<0)
+    {
+        std::cerr<<"[t3dump] no such entry: "<<A.entry<<"\n";
+        return false;
+    }
+    const T3AEntry e = R.entry((size_t)idx);
+    if(!A.json)
+        std::cout<<"entry ["<<idx<<"] "<<e.name<<"  "<<mname(e.sub)<<" "<<e.w<<"x"<<e.h
+                 <<"  bytes="<<e.bytes<<"  meta="<<e.meta_len<<"\n";
+
+    if(!A.to_t3p.empty())
+    {
+        if(!R.extract_t3p((size_t)idx, A.to_t3p, &err))
+        {
+            std::cerr<<"[t3dump] t3p write failed: "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"t3p -> "<<A.to_t3p<<"\n";
+    }
+    if(A.extract)
+    {
+        std::vector<Word27> words;
+        if(!R.read_payload((size_t)idx, nullptr, words, &err))
+        {
+            std::cerr<<"[t3dump] t3a read failed: "<<err<<"\n";
+            return false;
+        }
+        std::string out = A.extract_all ? (A.outdir+"/frame_0000.png") : A.out_png;
+        if(!words_to_image_subword(words, e.sub, e.w, e.h, out))
+        {
+            std::cerr<<"[t3dump] PNG write failed: "<<out<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"extracted -> "<<out<<"\n";
+    }
     return true;
 }
 
+static std::string with_ext(const std::string& path, const char* ext)
+{
+    const size_t sl = path.find_last_of("/\\"), dot = path.find_last_of('.');
+    if(dot==std::string::npos || (sl!=std::string::npos && dot<sl)) return path + ext;
+    return path.substr(0, dot) + ext;
+}
+
+static bool dump_t3k(const Args& A)
+{
+    std::string err;
+    T3ChunkStore S;
+    if(!S.open(A.path, &err))
+    {
+        std::cerr<<"[t3dump] t3k open failed: "<<err<<"\n";
+        return false;
+    }
+    if(A.tile_w>=0 || A.tile_h>0)
+    {
+        T3Chunk::Layout L = S.layout();
+        if(A.tile_w>=0) L.tile_w=(uint16_t)A.tile_w;
+        if(A.tile_h>0)  L.tile_h=(uint16_t)A.tile_h;
+        S.set_layout(L);
+    }
+
+    // Ajout : in.t3p / in.t3v -> in.t3r (rfrences seulement)
+    for(const auto& in : A.add)
+    {
+        SubwordMode sub;
+        int w=0,h=0;
+        std::string meta;
+        T3KStats st;
+        const std::string out = with_ext(in, ".t3r");
+        bool ok=false;
+        if(has_suffix(in, ".t3v"))
+        {
+            std::vector<std::vector<Word27>> frames;
+            double fps=0.0;
+            ok = load_t3v(in, sub, w, h, frames, fps, &meta)
+                 && S.put_video(out, sub, w, h, frames, meta, {}, &st, &err);
+        }
+        else
+        {
+            std::vector<Word27> words;
+            ok = load_t3p(in, sub, w, h, words, &meta)
+                 && S.put_image(out, sub, w, h, words, meta, &st, &err);
+        }
+        if(!ok)
+        {
+            std::cerr<<"[t3dump] t3k add failed: "<<in<<" "<<err<<"\n";
+            return false;
+        }
+        if(!A.json)
+            std::cout<<in<<" -> "<<out<<"  chunks="<<st.chunks<<" new="<<st.chunks_new
+                     <<"  in="<<st.bytes_in<<" written="<<st.bytes_written<<"\n";
+    }
+    for(const auto& r : A.release)
+    {
+        if(!S.release(r, &err))
+        {
+            std::cerr<<"[t3dump] t3k release failed: "<<r<<" "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"released "<<r<<"\n";
+    }
+    if(A.gc)
+    {
+        uint64_t freed=0;
+        if(!S.gc(&freed, &err))
+        {
+            std::cerr<<"[t3dump] t3k gc failed: "<<err<<"\n";
+            return false;
+        }
+        if(!A.json) std::cout<<"gc: reclaimed "<<freed<<" bytes\n";
+    }
+
+    if(A.json)
+    {
+        std::cout << "{\n"
+                  << "  \"t3k\": {\n"
+                  << "    \"file\": \""<<A.path<<"\",\n"
+                  << "    \"chunks\": "<<S.chunk_count()<<", \"dead_chunks\": "<<S.dead_chunks()<<",\n"
+                  << "    \"live_bytes\": "<<S.live_bytes()<<", \"pack_bytes\": "<<S.pack_bytes()<<"\n"
+                  << "  }\n}\n";
+    }
+    else
+    {
+        std::cout<<"== .t3k ==\n"
+                 <<"file: "<<A.path<<"\n"
+                 <<"chunks: "<<S.chunk_count()<<"  (dead: "<<S.dead_chunks()<<")\n"
+                 <<"live_bytes: "<<S.live_bytes()<<"  pack_bytes: "<<S.pack_bytes()<<"\n";
+    }
+    return true;
+}
+
+static bool dump_t3r(const Args& A)
+{
+    std::string err;
+    T3RInfo I;
+    if(!t3r_read_header(A.path, I, &err))
+    {
+        std::cerr<<"[t3dump] read failed: "<<A.path<<" ("<<err<<")\n";
+        return false;
+    }
+    size_t refs=0;
+    uint64_t words=0;
+    std::unordered_set<T3Chunk::Hash128, T3Chunk::Hash128Hasher> uniq;
+    for(const auto& F : I.frames)
+    {
+        refs += F.refs.size();
+        words += F.words;
+        uniq.insert(F.refs.begin(), F.refs.end());
+    }
+
+    if(A.json)
+    {
+        std::cout << "{\n"
+                  << "  \"t3r\": {\n"
+                  << "    \"file\": \""<<A.path<<"\",\n"
+                  << "    \"mode\": \""<<mname(I.sub)<<"\",\n"
+                  << "    \"w\": "<<I.w<<", \"h\": "<<I.h<<", \"frames\": "<<I.frames.size()<<",\n"
+                  << "    \"tile_w\": "<<I.layout.tile_w<<", \"tile_h\": "<<I.layout.tile_h<<",\n"
+                  << "    \"words_total\": "<<words<<", \"refs\": "<<refs<<", \"unique_refs\": "<<uniq.size()<<",\n"
+                  << "    \"meta_len\": "<<I.meta_json.size()<<"\n"
+                  << "  }\n}\n";
+    }
+    else
+    {
+        std::cout<<"== .t3r ==\n"
+                 <<"file: "<<A.path<<"\n"
+                 <<"mode: "<<mname(I.sub)<<"\n"
+                 <<"size: "<<I.w<<" x "<<I.h<<"\n"
+                 <<"frames: "<<I.frames.size()<<"\n"
+                 <<"tiles: "<<I.layout.tile_w<<" x "<<I.layout.tile_h<<"\n"
+                 <<"words_total: "<<words<<"\n"
+                 <<"refs: "<<refs<<"  unique: "<<uniq.size()<<"\n"
+                 <<"meta: "<<I.meta_json.size()<<" bytes\n";
+    }
+
+    if(!A.extract) return true;
+    if(A.store.empty())
+    {
+        std::cerr<<"[t3dump] .t3r extraction needs --store pack.t3k\n";
+        return false;
+    }
+    T3ChunkStore S;
+    if(!S.open(A.store, &err))
+    {
+        std::cerr<<"[t3dump] t3k open failed: "<<err<<"\n";
+        return false;
+    }
+    size_t f0=0, f1=I.frames.size();
+    if(!A.extract_all)
+    {
+        if(A.idx<0 || (size_t)A.idx>=I.frames.size())
+        {
+            std::cerr<<"[t3dump] frame index out of range\n";
+            return false;
+        }
+        f0=(size_t)A.idx;
+        f1=f0+1;
+    }
+    std::vector<Word27> fw;
+    for(size_t i=f0; i<f1; ++i)
+    {
+        if(!S.read_frame(I, i, nullptr, fw, &err))
+        {
+            std::cerr<<"[t3dump] t3r read failed: "<<err<<"\n";
+            return false;
+        }
+        std::string out = A.out_png;
+        if(A.extract_all)
+        {
+            char name[256];
+            std::snprintf(name, sizeof(name), "%s/frame_%04zu.png", A.outdir.c_str(), i);
+            out = name;
+        }
+        if(!words_to_image_subword(fw, I.sub, I.w, I.h, out))
+        {
+            std::cerr<<"[t3dump] PNG write failed: "<<out<<"\n";
+            return false;
+        }
+        if(!A.json && !A.extract_all) std::cout<<"extracted frame "<<i<<" -> "<<out<<"\n";
+    }
+    if(!A.json)
+    {
+        if(A.extract_all) std::cout<<"extracted "<<(f1-f0)<<" frames -> "<<A.outdir<<"/frame_####.png\n";
+        std::cout<<"chunk cache: "<<S.cache().hits()<<" hits / "<<S.cache().misses()<<" misses\n";
+    }
+    return true;
+}
+
+static bool dump_t3s(const Args& A)
+{
+    std::string err;
+    T3SReader R;
+    if(!R.open(A.path, &err))
+    {
+        std::cerr<<"[t3dump] read failed: "<<A.path<<" ("<<err<<")\n";
+        return false;
+    }
+    std::vector<uint64_t> per_seg(R.segments().size(), 0), bytes_seg(R.segments().size(), 0);
+    uint64_t total_words=0;
+    for(uint64_t i=0; i<R.frame_count(); ++i)
+    {
+        const T3SFrameIndex& e = R.frame(i);
+        per_seg[e.seg]++;
+        bytes_seg[e.seg] += e.meta_len + e.words*sizeof(Word27) + 4;
+        total_words += e.words;
+    }
+
+    if(A.json)
+    {
+        std::cout << "{\n"
+                  << "  \"t3s\": {\n"
+                  << "    \"file\": \""<<A.path<<"\",\n"
+                  << "    \"mode\": \""<<mname(R.sub())<<"\",\n"
+                  << "    \"w\": "<<R.width()<<", \"h\": "<<R.height()<<", \"frames\": "<<R.frame_count()<<",\n"
+                  << "    \"words_total\": "<<total_words<<",\n"
+                  << "    \"meta_len\": "<<R.meta_json().size()<<",\n"
+                  << "    \"segments\": [";
+        for(size_t s=0; s<per_seg.size(); ++s)
+            std::cout << (s?",":"") << "\n      {\"path\": \""<<R.segments()[s]<<"\", \"frames\": "<<per_seg[s]
+                      << ", \"bytes\": "<<bytes_seg[s]<<"}";
+        std::cout << "\n    ]\n  }\n}\n";
+    }
+    else
+    {
+        std::cout<<"== .t3s ==\n"
+                 <<"file: "<<A.path<<"\n"
+                 <<"mode: "<<mname(R.sub())<<"\n"
+                 <<"size: "<<R.width()<<" x "<<R.height()<<"\n"
+                 <<"frames: "<<R.frame_count()<<"\n"
+                 <<"words_total: "<<total_words<<"\n"
+                 <<"meta: "<<R.meta_json().size()<<" bytes\n"
+                 <<"segments: "<<per_seg.size()<<"\n";
+        for(size_t s=0; s<per_seg.size(); ++s)
+            std::cout<<"  ["<<s<<"] "<<R.segments()[s]<<"  frames="<<per_seg[s]<<"  bytes="<<bytes_seg[s]<<"\n";
+    }
+
+    if(!A.extract) return true;
+    uint64_t f0=0, f1=R.frame_count();
+    if(!A.extract_all)
+    {
+        if(A.idx<0 || (uint64_t)A.idx>=R.frame_count())
+        {
+            std::cerr<<"[t3dump] frame index out of range\n";
+            return false;
+        }
+        f0=(uint64_t)A.idx;
+        f1=f0+1;
+    }
+    std::vector<Word27> fw;
+    for(uint64_t i=f0; i<f1; ++i)
+    {
+        if(!R.read_frame(i, nullptr, fw, &err))
+        {
+            std::cerr<<"[t3dump] t3s read failed: "<<err<<"\n";
+            return false;
+        }
+        std::string out = A.out_png;
+        if(A.extract_all)
+        {
+            char name[256];
+            std::snprintf(name, sizeof(name), "%s/frame_%04llu.png", A.outdir.c_str(), (unsigned long long)i);
+            out = name;
+        }
+        if(!words_to_image_subword(fw, R.sub(), R.width(), R.height(), out))
+        {
+            std::cerr<<"[t3dump] PNG write failed: "<<out<<"\n";
+            return false;
+        }
+        if(!A.json && !A.extract_all) std::cout<<"extracted frame "<<i<<" -> "<<out<<"\n";
+    }
+    if(!A.json && A.extract_all) std::cout<<"extracted "<<(f1-f0)<<" frames -> "<<A.outdir<<"/frame_####.png\n";
+    return true;
+}
+
+// Aperu 1/K (--preview K) : .t3p / .t3v sans chargement complet ; seules les
+// lignes chantillonnes sont lues (--box : frame lue en entier, moyenne KK)
+static bool preview_file(const Args& A)
+{
+    const bool is_t3v = has_suffix(A.path, ".t3v");
+    if(!is_t3v && !has_suffix(A.path, ".t3p"))
+    {
+        std::cerr<<"[t3dump] --preview expects a .t3p or .t3v file\n";
+        return false;
+    }
+    SubwordMode sub;
+    int w=0,h=0;
+    uint64_t count=1;
+    std::string meta, err;
+    std::vector<T3VFrameIndex> index;
+    if(is_t3v ? !t3v_read_header(A.path, sub, w, h, meta, count, index, &err)
+              : !t3p_read_header(A.path, sub, w, h, meta, count, &err))
+    {
+        std::cerr<<"[t3dump] read failed: "<<A.path<<" ("<<err<<")\n";
+        return false;
+    }
+    if(!is_t3v) count=1;
+    if(count==0)
+    {
+        std::cerr<<"[t3dump] empty video\n";
+        return false;
+    }
+
+    uint64_t f0=0, f1=1;
+    if(A.extract_all) f1=count;
+    else
+    {
+        long sel=A.idx;
+        if(A.seek>=0.0 && is_t3v)
+        {
+            uint64_t i=0;
+            if(!t3v_seek_time(A.path, A.seek, i, A.key, &err))
+            {
+                std::cerr<<"[t3dump] seek failed: "<<err<<"\n";
+                return false;
+            }
+            sel=(long)i;
+        }
+        if(sel<0 || (uint64_t)sel>=count)
+        {
+            std::cerr<<"[t3dump] frame "<<sel<<" out of range (0.."<<count-1<<")\n";
+            return false;
+        }
+        f0=(uint64_t)sel;
+        f1=f0+1;
+    }
+
+    const int k=A.preview;
+    int pw=decimated_dim(w,k), ph=decimated_dim(h,k);
+    std::vector<Word27> words;
+    for(uint64_t i=f0; i<f1; ++i)
+    {
+        bool ok;
+        if(A.box)
+            ok = is_t3v ? t3v_read_frame(A.path, i, nullptr, words, &err)
+                        : t3p_read_payload(A.path, nullptr, words, &err);
+        else
+            ok = is_t3v ? t3v_read_frame_decimated(A.path, i, k, nullptr, words, pw, ph, &err)
+                        : t3p_read_decimated(A.path, k, nullptr, words, pw, ph, &err);
+        if(!ok)
+        {
+            std::cerr<<"[t3dump] read failed: "<<err<<"\n";
+            return false;
+        }
+        std::string out = A.out_png;
+        if(A.extract_all)
+        {
+            char name[256];
+            std::snprintf(name, sizeof(name), "%s/frame_%04llu.png", A.outdir.c_str(), (unsigned long long)i);
+            out = name;
+        }
+        // --box : moyenne KK sur la frame complte ; sinon mots dj dcims
+        if(A.box ? !words_to_image_decimated(words, sub, w, h, k, true, out)
+                 : !words_to_image_decimated(words, sub, pw, ph, 1, false, out))
+        {
+            std::cerr<<"[t3dump] PNG write failed: "<<out<<"\n";
+            return false;
+        }
+        if(!A.json && !A.extract_all) std::cout<<"preview 1/"<<k<<(A.box? " (box)":"")<<" frame "<<i<<" "<<pw<<"x"<<ph<<" -> "<<out<<"\n";
+    }
+    if(!A.json && A.extract_all) std::cout<<"preview 1/"<<k<<(A.box? " (box)":"")<<" "<<(f1-f0)<<" frames "<<pw<<"x"<<ph<<" -> "<<A.outdir<<"/frame_####.png\n";
+    return true;
+}
+
+// Contrle d'intgrit : false si header illisible ou payload corrompu
+static bool verify_file(const Args& A)
+{
+    T3VerifyReport R;
+    std::string err;
+    if(!t3_verify(A.path, R, A.threads, &err))
+    {
+        if(A.json) std::cout<<"{\n  \"file\": \""<<A.path<<"\",\n  \"ok\": false,\n  \"error\": \""<<err<<"\"\n}\n";
+        else std::cerr<<"[t3dump] verify: "<<err<<"\n";
+        return false;
+    }
+    const char* unit = R.kind=="t3a" ? "entry" : "frame";
+    if(A.json)
+    {
+        std::cout<<"{\n"
+                 <<"  \"file\": \""<<A.path<<"\",\n"
+                 <<"  \"kind\": \""<<R.kind<<"\",\n"
+                 <<"  \"ok\": "<<(R.ok()? "true":"false")<<",\n"
+                 <<"  \"units\": "<<R.units<<",\n"
+                 <<"  \"file_bytes\": "<<R.file_bytes<<",\n"
+                 <<"  \"checked_bytes\": "<<R.checked_bytes<<",\n"
+                 <<"  \"seconds\": "<<R.seconds<<",\n"
+                 <<"  \"gbps\": "<<R.gbps()<<",\n"
+                 <<"  \"bad\": [";
+        for(size_t i=0; i<R.bad.size(); ++i) std::cout<<(i? ", ":"")<<R.bad[i];
+        std::cout<<"]\n}\n";
+    }
+    else
+    {
+        for(uint64_t b : R.bad) std::cout<<"BAD "<<unit<<" "<<b<<"\n";
+        std::cout<<"verify: "<<(R.ok()? "OK":"CORRUPT")<<"  "<<R.kind<<"  "<<(R.kind=="t3a"? "entries=":"frames=")<<R.units
+                 <<"  bad="<<R.bad.size()<<"  bytes="<<R.checked_bytes
+                 <<"  time="<<std::fixed<<std::setprecision(3)<<R.seconds<<" s  "
+                 <<std::setprecision(2)<<R.gbps()<<" GB/s\n";
+    }
+    return R.ok();
+}
+
 int main(int argc,char**argv)
 {
     Args A{};
     if(!parse_args(argc,argv,A)) return 2;
+    if(A.png_level>=0) T3Png::default_options().level=A.png_level;
+    T3Png::default_options().threads=A.threads;
 
     bool ok=false;
+    if(A.verify) return verify_file(A)? 0 : 1;
+    if(A.preview>0 && A.extract) return preview_file(A)? 0 : 1;
     if(has_suffix(A.path, ".t3p")) ok = dump_t3p(A);
     else if(has_suffix(A.path, ".t3v")) ok = dump_t3v(A);
+    else if(has_suffix(A.path, ".t3pl")) ok = dump_t3pl(A);
+    else if(has_suffix(A.path, ".t3a")) ok = dump_t3a(A);
+    else if(has_suffix(A.path, ".t3k")) ok = dump_t3k(A);
+    else if(has_suffix(A.path, ".t3r")) ok = dump_t3r(A);
+    else if(has_suffix(A.path, ".t3s")) ok = dump_t3s(A);
     else
     {
-        std::cerr<<"[t3dump] unsupported extension (expect .t3p or .t3v)\n";
+        std::cerr<<"[t3dump] unsupported extension (expect .t3p, .t3v, .t3pl, .t3a, .t3k, .t3r or .t3s)\n";
         return 2;
     }
     return ok? 0 : 1;
@@ -8,8 +8,23 @@
 //                      [--no-pack] [--no-balanced]
 //                      [--haar-tile 8 --haar-thresh 6]
 //                      [--rc-block 32 --rc-angles 8 --rc-z 1.2]
+//                      [--rc-quadtree [--rc-qt 64:16] [--rc-qt-var 64]]
+//     Quadtree AnisoRC : blocs 64->32->16 dcoups selon la variance Y
+//     (image intgrale) ; zones plates = grands blocs, moins de trits.
+//                      [--progressive]   # ver=2 : sketch | LL | HL | LH | HH
+//                      [--target-nnz N | --target-density D]
+//     Dbit cible en 1 passe : histogramme |coef| (Haar) ou z-scores (RC),
+//     seuil choisi pour <= N trits de dtail non nuls (ou fraction D) ;
+//     remplace --haar-thresh / --rc-z, valeurs retenues dans la meta.
 //
-//  t3proto_tool info   stream.t3proto [--json]
+//  t3proto_tool encode-seq --out seq.t3proto f0.png f1.png ...
+//                      [--keyint K] [--haar-tile 8 --haar-thresh 6] [--threads N]
+//     Squence Haar (ver=3) : trame cl toutes les K trames, sinon par tuile
+//     saut (drapeaux bitsliced) ou rsidu ternaire mod 3 + delta LL.
+//  t3proto_tool decode-seq seq.t3proto --out frame_%04d.png [--raw] [--threads N]
+//     Reconstruit chaque trame (seules les tuiles modifies sont recalcules).
+//
+//  t3proto_tool info   stream.t3proto [--json]   # v2 : sections, v3 : trames
 //
 //  t3proto_tool export-unb  stream.t3proto --out tri_unb.bin
 //  t3proto_tool export-bal  stream.t3proto --out tri_bal.bin
@@ -22,14 +37,26 @@
 //  t3proto_tool cat         --out merged.t3proto a.t3proto b.t3proto ...
 //                           [--require-balanced] [--require-packed]
 //
+//  t3proto_tool decode      in.t3proto --out out.png|out.y
+//                           [--raw] [--threads N] [--repeat R] [--bytes K]
+//     Reconstruit le plan Y (tuiles/blocs en parallle) ; .png = gris RGB,
+//     --raw (ou .y) = plan Y brut WH. Affiche le dbit (MPix/s, Mtrits/s).
+//     v2 + --bytes K : ne lit que les K premiers octets (aperu progressif).
+//
+//  t3proto_tool thumb       in.t3proto --out thumb.png [--bytes K]
+//     v2 : crit le plan LL (1 pixel par tuile/bloc) comme vignette.
+//
 //  BUILD
 //  -----
-//   g++ -std=c++17 -O2 -Iinclude -Ithird_party \
+//   g++ -std=c++17 -O2 -Iinclude -Ithird_party
 //       src/compile_stb.cpp src/t3proto_tool.cpp -o t3proto_tool
+//   # Dcodage JPEG/PNG rapide (io_fastdecode.hpp), ex. libjpeg-turbo + libpng :
+//   g++ -std=c++17 -O2 -Iinclude -Ithird_party -DTERNARY_USE_LIBJPEG -DTERNARY_USE_LIBPNG
+//       src/compile_stb.cpp src/io_fastdecode.cpp src/t3proto_tool.cpp -ljpeg -lpng -o t3proto_tool
 //
 //  NOTE
 //  ----
-//    "encode" ncessite les prototypes (flags -DPROTO_*).
+//    "encode" et "decode" ncessitent les prototypes (flags -DPROTO_*).
 //    "info/export/repack/cat" n'ont pas besoin des prototypes pour lire/crire.
 // ============================================================================
 
@@ -43,6 +70,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 
 #include "io_image.hpp"         // ImageU8, load_image_rgb8(...)
 #include "codec_profiles.hpp"   // encode_prototype_ternary(...), ProtoConfig, pack/unpack helpers
@@ -55,7 +83,12 @@ static void usage()
               "t3proto_tool encode --in <img> --out <file.t3proto> --profile {haar|rc}\n"
               "                   [--no-pack] [--no-balanced]\n"
               "                   [--haar-tile N] [--haar-thresh T]\n"
-              "                   [--rc-block N] [--rc-angles A] [--rc-z Z]\n"
+              "                   [--rc-block N] [--rc-angles A] [--rc-z Z] [--progressive]\n"
+              "                   [--target-nnz N | --target-density D]\n"
+              "                   [--rc-quadtree [--rc-qt MAX:MIN] [--rc-qt-var V]]\n"
+              "t3proto_tool encode-seq --out <seq.t3proto> <f0> <f1> ...\n"
+              "                   [--keyint K] [--haar-tile N] [--haar-thresh T] [--threads N]\n"
+              "t3proto_tool decode-seq <seq.t3proto> --out <frame_%04d.png|.y> [--raw] [--threads N]\n"
               "t3proto_tool info <file.t3proto> [--json]\n"
               "t3proto_tool export-unb  <file.t3proto> --out tri_unb.bin\n"
               "t3proto_tool export-bal  <file.t3proto> --out tri_bal.bin\n"
@@ -63,7 +96,10 @@ static void usage()
               "                   [--keep-balanced] [--keep-packed] [--n-trits N] [--guess] [--strict]\n"
               "                   [--force-exact N]\n"
               "t3proto_tool cat --out merged.t3proto <a.t3proto> <b.t3proto> ...\n"
-              "                   [--require-balanced] [--require-packed]\n";
+              "                   [--require-balanced] [--require-packed]\n"
+              "t3proto_tool decode <in.t3proto> --out <out.png|out.y>\n"
+              "                   [--raw] [--threads N] [--repeat R] [--bytes K]\n"
+              "t3proto_tool thumb <in.t3proto> --out <thumb.png> [--bytes K]\n";
 }
 static bool eqi(const std::string& a, const char* b)
 {
@@ -75,6 +111,7 @@ static bool eqi(const std::string& a, const char* b)
 // -------- helpers trs simples pour extraire des infos de meta JSON (sans lib)
 static bool meta_find_int(const std::string& meta, const std::string& key, uint64_t& out)
 {
+    if(T3Meta::is_tlv(meta)) return T3Meta::find_uint(meta, key, out);
     auto pos = meta.find("\""+key+"\"");
     if(pos==std::string::npos) return false;
     pos = meta.find(':', pos);
@@ -96,6 +133,7 @@ static bool meta_find_int(const std::string& meta, const std::string& key, uint6
 }
 static bool meta_find_str(const std::string& meta, const std::string& key, std::string& out)
 {
+    if(T3Meta::is_tlv(meta)) return T3Meta::find_str(meta, key, out);
     auto pos = meta.find("\""+key+"\"");
     if(pos==std::string::npos) return false;
     pos = meta.find(':', pos);
@@ -267,6 +305,25 @@ static void meta_upsert_counts(std::string& meta,
     replace_key("exact_n_trits", (exact? "true":"false"), false);
 }
 
+// --------- dbit cible : rappel du seuil retenu (bloc "rate" de la meta)
+static void print_rate(const std::string& meta)
+{
+    auto raw = [&](const char* key)
+    {
+        auto pos = meta.find(std::string("\"")+key+"\"");
+        if(pos==std::string::npos) return std::string("?");
+        pos = meta.find(':', pos);
+        if(pos==std::string::npos) return std::string("?");
+        size_t end = meta.find_first_of(",}", pos);
+        return meta.substr(pos+1, end==std::string::npos? std::string::npos : end-pos-1);
+    };
+    if(meta.find("\"rate\"")==std::string::npos) return;
+    const bool haar = meta.find("\"z_thresh\"")==std::string::npos;
+    std::cout<<"rate: "<<(haar? "thresh=" : "z_thresh=")<<raw(haar? "thresh" : "z_thresh")
+             <<"  nnz="<<raw("nnz")<<"/"<<raw("n_details")
+             <<"  (target "<<raw("target_nnz")<<", density "<<raw("density")<<")\n";
+}
+
 // ============================================================================
 // main
 // ============================================================================
@@ -283,7 +340,7 @@ int main(int argc, char** argv)
     if(cmd=="encode")
     {
         std::string in, out, profile;
-        bool want_pack=true, want_bal=true;
+        bool want_pack=true, want_bal=true, progressive=false;
         ProtoConfig cfg{};
         cfg.profile = ProtoProfile::None;
 
@@ -298,6 +355,7 @@ int main(int argc, char** argv)
             }
             else if(s=="--no-pack")     want_pack=false;
             else if(s=="--no-balanced") want_bal=false;
+            else if(s=="--progressive") progressive=true;
             // Haar overrides
             else if(s=="--haar-tile" && i+1<argc)   cfg.haar_tile=std::atoi(argv[++i]);
             else if(s=="--haar-thresh" && i+1<argc) cfg.haar_thresh=std::atoi(argv[++i]);
@@ -305,6 +363,18 @@ int main(int argc, char** argv)
             else if(s=="--rc-block" && i+1<argc)   cfg.rc_block=std::atoi(argv[++i]);
             else if(s=="--rc-angles" && i+1<argc)  cfg.rc_angles=std::atoi(argv[++i]);
             else if(s=="--rc-z" && i+1<argc)       cfg.rc_tern_z=(float)std::atof(argv[++i]);
+            else if(s=="--rc-quadtree")           cfg.rc_quadtree=true;
+            else if(s=="--rc-qt" && i+1<argc)
+            {
+                // MAX:MIN (ex. 64:16)
+                const char* v=argv[++i];
+                cfg.rc_qt_max=std::atoi(v);
+                if(const char* c=std::strchr(v, ':')) cfg.rc_qt_min=std::atoi(c+1);
+            }
+            else if(s=="--rc-qt-var" && i+1<argc)  cfg.rc_qt_var=(float)std::atof(argv[++i]);
+            // Dbit cible (1 passe)
+            else if(s=="--target-nnz" && i+1<argc)     cfg.target_nnz=std::strtoull(argv[++i], nullptr, 10);
+            else if(s=="--target-density" && i+1<argc) cfg.target_density=(float)std::atof(argv[++i]);
         }
         if(in.empty()||out.empty()||profile.empty())
         {
@@ -320,11 +390,13 @@ int main(int argc, char** argv)
         }
 
         ImageU8 rgb;
-        if(!load_image_rgb8(in, rgb))
+        const char* backend="stb";
+        if(!load_image_rgb8(in, rgb, &backend))
         {
             std::cerr<<"cannot load: "<<in<<"\n";
             return 1;
         }
+        std::cout<<"load: "<<in<<"  "<<rgb.w<<"x"<<rgb.h<<"  (decoder="<<backend<<")\n";
 
         std::vector<int8_t>  bal;
         std::vector<uint8_t> bytes;
@@ -337,6 +409,24 @@ int main(int argc, char** argv)
             std::cerr<<"profile not compiled in this build. Rebuild with -DPROTO_*.\n";
             return 1;
         }
+        if(progressive)
+        {
+            std::vector<ProtoSection> secs;
+            if(!encode_prototype_progressive(rgb, cfg, secs, meta))
+            {
+                std::cerr<<"encode_prototype_progressive failed.\n";
+                return 1;
+            }
+            if(!t3proto::t3proto_write_progressive(out, cfg.profile, (uint32_t)rgb.w, (uint32_t)rgb.h,
+                                                   secs, meta))
+            {
+                std::cerr<<"t3proto_write_progressive failed: "<<out<<"\n";
+                return 1;
+            }
+            std::cout<<"OK: wrote "<<out<<"  (progressive, sections="<<secs.size()<<")\n";
+            print_rate(meta);
+            return 0;
+        }
         if(!encode_prototype_ternary(rgb, cfg, bal, (want_pack? &bytes: nullptr), meta))
         {
             std::cerr<<"encode_prototype_ternary failed.\n";
@@ -357,6 +447,189 @@ int main(int argc, char** argv)
             return 1;
         }
         std::cout<<"OK: wrote "<<out<<"  (trits="<<bal.size()<<", bytes="<<bytes.size()<<")\n";
+        print_rate(meta);
+        return 0;
+    }
+
+    // -------------------------------------------------------------- ENCODE-SEQ
+    if(cmd=="encode-seq")
+    {
+        std::string out;
+        std::vector<std::string> inputs;
+        unsigned threads=0;
+        ProtoConfig cfg{};
+        cfg.profile = ProtoProfile::HaarTernary;
+        for(int i=2; i<argc; ++i)
+        {
+            std::string s=argv[i];
+            if(s=="--out" && i+1<argc) out=argv[++i];
+            else if(s=="--keyint" && i+1<argc)      cfg.seq_key_interval=std::atoi(argv[++i]);
+            else if(s=="--haar-tile" && i+1<argc)   cfg.haar_tile=std::atoi(argv[++i]);
+            else if(s=="--haar-thresh" && i+1<argc) cfg.haar_thresh=std::atoi(argv[++i]);
+            else if(s=="--threads" && i+1<argc)     threads=(unsigned)std::atoi(argv[++i]);
+            else inputs.push_back(s);
+        }
+        if(out.empty() || inputs.empty())
+        {
+            usage();
+            return 2;
+        }
+        if(!encode_prototype_available(cfg.profile))
+        {
+            std::cerr<<"profile not compiled in this build. Rebuild with -DPROTO_*.\n";
+            return 1;
+        }
+        bool load_err=false;
+        const char* backend="stb";
+        auto next = [&](size_t i, ImageU8& rgb)
+        {
+            if(i>=inputs.size()) return false;
+            if(!load_image_rgb8(inputs[i], rgb, &backend))
+            {
+                std::cerr<<"cannot load: "<<inputs[i]<<"\n";
+                load_err=true;
+                return false;
+            }
+            return true;
+        };
+        uint32_t W=0, H=0;
+        std::vector<ProtoSeqFrame> frames;
+        std::string meta;
+        auto t0 = std::chrono::steady_clock::now();
+        const bool ok = encode_prototype_sequence(next, cfg, W, H, frames, meta, threads);
+        auto t1 = std::chrono::steady_clock::now();
+        if(load_err) return 1;
+        if(!ok)
+        {
+            std::cerr<<"encode_prototype_sequence failed (frame size mismatch?).\n";
+            return 1;
+        }
+        if(!t3proto::t3proto_write_sequence(out, cfg.profile, W, H, frames, meta))
+        {
+            std::cerr<<"t3proto_write_sequence failed: "<<out<<"\n";
+            return 1;
+        }
+        uint64_t bytes=0, n_key=0;
+        for(const auto& F : frames)
+        {
+            bytes += F.data.size();
+            n_key += (F.type==ProtoSeqFrameType::Key);
+        }
+        const double s = std::chrono::duration<double>(t1-t0).count();
+        std::cout<<"OK: wrote "<<out<<"  (frames="<<frames.size()<<", key="<<n_key
+                 <<", payload="<<bytes<<" B)\n";
+        uint64_t skipped=0, ll_only=0, coded=0;
+        meta_find_int(meta, "tiles_skipped", skipped);
+        meta_find_int(meta, "tiles_ll_only", ll_only);
+        meta_find_int(meta, "tiles_coded", coded);
+        std::cout<<"tiles (delta frames): skipped="<<skipped<<"  ll_only="<<ll_only
+                 <<"  coded="<<coded<<"\n"
+                 <<std::fixed<<std::setprecision(3)
+                 <<"time: "<<s*1e3<<" ms  "<<(double)frames.size()/s<<" frames/s (incl. load, decoder="<<backend<<")\n";
+        return 0;
+    }
+
+    // -------------------------------------------------------------- DECODE-SEQ
+    if(cmd=="decode-seq")
+    {
+        if(argc<5)
+        {
+            usage();
+            return 2;
+        }
+        std::string in=argv[2], out;
+        bool raw=false;
+        unsigned threads=0;
+        for(int i=3; i<argc; ++i)
+        {
+            std::string s=argv[i];
+            if(s=="--out" && i+1<argc) out=argv[++i];
+            else if(s=="--raw") raw=true;
+            else if(s=="--threads" && i+1<argc) threads=(unsigned)std::atoi(argv[++i]);
+        }
+        if(out.empty())
+        {
+            usage();
+            return 2;
+        }
+        if(out.size()>2 && eqi(out.substr(out.size()-2), ".y")) raw=true;
+
+        t3proto::SequenceInfo SI;
+        if(t3proto::t3proto_peek_version(in)!=3 || !t3proto::t3proto_read_sequence(in, SI))
+        {
+            std::cerr<<"not a sequence .t3proto (v3): "<<in<<"\n";
+            return 1;
+        }
+        if(!encode_prototype_available(SI.profile))
+        {
+            std::cerr<<"profile not compiled in this build. Rebuild with -DPROTO_*.\n";
+            return 1;
+        }
+        // --out : motif printf (%d) ou nom unique (suffixe _NNNN ajout)
+        auto frame_path = [&](size_t i)
+        {
+            char buf[1024];
+            if(out.find('%')!=std::string::npos)
+                std::snprintf(buf, sizeof(buf), out.c_str(), (int)i);
+            else
+            {
+                const size_t dot = out.find_last_of('.');
+                const std::string stem = (dot==std::string::npos)? out : out.substr(0, dot);
+                const std::string ext  = (dot==std::string::npos)? "" : out.substr(dot);
+                std::snprintf(buf, sizeof(buf), "%s_%04d%s", stem.c_str(), (int)i, ext.c_str());
+            }
+            return std::string(buf);
+        };
+        double dec_s=0;
+        size_t n_out=0;
+        bool wr_err=false;
+        auto tlast = std::chrono::steady_clock::now();
+        auto sink = [&](size_t i, const ImageU8& Y)
+        {
+            dec_s += std::chrono::duration<double>(std::chrono::steady_clock::now()-tlast).count();
+            const std::string path = frame_path(i);
+            bool wrote=false;
+            if(raw)
+            {
+                std::FILE* f = std::fopen(path.c_str(), "wb");
+                if(f)
+                {
+                    wrote = std::fwrite(Y.data.data(),1,Y.data.size(),f)==Y.data.size();
+                    std::fclose(f);
+                }
+            }
+            else
+            {
+                ImageU8 rgb;
+                rgb.w=Y.w;
+                rgb.h=Y.h;
+                rgb.c=3;
+                rgb.data.resize((size_t)Y.w*Y.h*3);
+                for(size_t k=0; k<Y.data.size(); ++k)
+                    ycbcr_to_rgb(Y.data[k],128,128, rgb.data[k*3+0],rgb.data[k*3+1],rgb.data[k*3+2]);
+                wrote = save_image_png(path, rgb);
+            }
+            if(!wrote)
+            {
+                std::cerr<<"write failed: "<<path<<"\n";
+                wr_err=true;
+                return false;
+            }
+            ++n_out;
+            tlast = std::chrono::steady_clock::now();
+            return true;
+        };
+        if(!decode_prototype_sequence(SI.profile, SI.W, SI.H, SI.frames, SI.meta, sink, threads))
+        {
+            std::cerr<<"decode_prototype_sequence failed (meta/params mismatch?).\n";
+            return 1;
+        }
+        if(wr_err) return 1;
+        const double mpix = (double)SI.W*SI.H*(double)n_out/1e6;
+        std::cout<<"OK: decoded "<<in<<" -> "<<n_out<<" frames ("<<SI.W<<"x"<<SI.H<<")\n"
+                 <<std::fixed<<std::setprecision(3)
+                 <<"time: "<<dec_s*1e3<<" ms (decode only)  "
+                 <<(dec_s>0? mpix/dec_s : 0.0)<<" MPix/s\n";
         return 0;
     }
 
@@ -375,6 +648,87 @@ int main(int argc, char** argv)
             if(std::string(argv[i])=="--json") json=true;
         }
 
+        if(t3proto::t3proto_peek_version(path)==3)
+        {
+            t3proto::SequenceInfo I;
+            if(!t3proto::t3proto_read_sequence(path, I, false))
+            {
+                std::cerr<<"read failed: "<<path<<"\n";
+                return 1;
+            }
+            size_t n_key=0;
+            for(const auto& F : I.frames) n_key += (F.type==ProtoSeqFrameType::Key);
+            if(json)
+            {
+                std::cout << "{\n  \"t3proto\": {\n"
+                          << "    \"file\": \""<<path<<"\", \"version\": 3,\n"
+                          << "    \"W\": "<<I.W<<", \"H\": "<<I.H<<",\n"
+                          << "    \"trits\": "<<I.n_trits<<", \"payload_bytes\": "<<I.n_bytes<<",\n"
+                          << "    \"header_bytes\": "<<I.header_bytes<<",\n"
+                          << "    \"frames\": [";
+                for(size_t k=0; k<I.frames.size(); ++k)
+                    std::cout << (k? ",":"") << "\n      {\"type\":\""
+                              <<(I.frames[k].type==ProtoSeqFrameType::Key? "key" : "delta")<<"\","
+                              << "\"coded\":"<<I.frames[k].n_coded<<",\"offset\":"<<I.frame_offset[k]
+                              << ",\"bytes\":"<<I.frame_bytes[k]<<"}";
+                std::cout << "\n    ]\n  }\n}\n";
+            }
+            else
+            {
+                std::cout<<"== .t3proto (v3, sequence) ==\n"
+                         <<"file: "<<path<<"\n"
+                         <<"dims: "<<I.W<<" x "<<I.H<<"\n"
+                         <<"frames: "<<I.frames.size()<<"  (key "<<n_key<<")\n"
+                         <<"trits: "<<I.n_trits<<"  payload: "<<I.n_bytes<<" B  header: "<<I.header_bytes<<" B\n";
+                for(size_t k=0; k<I.frames.size(); ++k)
+                    std::cout<<"  ["<<k<<"] "<<(I.frames[k].type==ProtoSeqFrameType::Key? "key  " : "delta")
+                             <<" coded="<<I.frames[k].n_coded<<"  @"<<I.frame_offset[k]
+                             <<"  bytes="<<I.frame_bytes[k]<<"\n";
+            }
+            return 0;
+        }
+        if(t3proto::t3proto_peek_version(path)==2)
+        {
+            t3proto::ProgressiveInfo I;
+            if(!t3proto::t3proto_read_progressive(path, I, 0))
+            {
+                std::cerr<<"read failed: "<<path<<"\n";
+                return 1;
+            }
+            auto pname2 = (I.profile==ProtoProfile::HaarTernary? "HaarTernary"
+                           : I.profile==ProtoProfile::AnisoRC? "AnisoRC" : "None");
+            if(json)
+            {
+                std::cout << "{\n  \"t3proto\": {\n"
+                          << "    \"file\": \""<<path<<"\", \"version\": 2,\n"
+                          << "    \"profile\": \""<<pname2<<"\",\n"
+                          << "    \"W\": "<<I.W<<", \"H\": "<<I.H<<",\n"
+                          << "    \"trits\": "<<I.n_trits<<", \"payload_bytes\": "<<I.n_bytes<<",\n"
+                          << "    \"header_bytes\": "<<I.header_bytes<<",\n"
+                          << "    \"sections\": [";
+                for(size_t k=0; k<I.sec.size(); ++k)
+                    std::cout << (k? ",":"") << "\n      {\"kind\":\""<<proto_section_name(I.sec[k].kind)<<"\","
+                              << "\"items\":"<<I.sec[k].n_items<<",\"offset\":"<<I.sec_offset[k]
+                              << ",\"bytes\":"<<I.sec_bytes[k]<<"}";
+                std::cout << "\n    ]\n  }\n}\n";
+            }
+            else
+            {
+                std::cout<<"== .t3proto (v2, progressive) ==\n"
+                         <<"file: "<<path<<"\n"
+                         <<"profile: "<<pname2<<"\n"
+                         <<"dims: "<<I.W<<" x "<<I.H<<"\n"
+                         <<"trits: "<<I.n_trits<<"  payload: "<<I.n_bytes<<" B  header: "<<I.header_bytes<<" B\n"
+                         <<"sections:\n";
+                for(size_t k=0; k<I.sec.size(); ++k)
+                    std::cout<<"  ["<<k<<"] "<<std::left<<std::setw(8)<<proto_section_name(I.sec[k].kind)<<std::right
+                             <<" items="<<I.sec[k].n_items<<"  @"<<I.sec_offset[k]
+                             <<"  bytes="<<I.sec_bytes[k]
+                             <<"  (prefix "<<(I.sec_offset[k]+I.sec_bytes[k])<<" B)\n";
+            }
+            return 0;
+        }
+
         ProtoProfile prof=ProtoProfile::None;
         uint32_t W=0,H=0;
         std::string meta;
@@ -801,6 +1155,250 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    // ------------------------------------------------------------------- DECODE
+    if(cmd=="decode")
+    {
+        if(argc<5)
+        {
+            usage();
+            return 2;
+        }
+        std::string in=argv[2], out;
+        bool raw=false;
+        unsigned threads=0;
+        int repeat=1;
+        uint64_t max_bytes=UINT64_MAX;
+        for(int i=3; i<argc; ++i)
+        {
+            std::string s=argv[i];
+            if(s=="--out" && i+1<argc) out=argv[++i];
+            else if(s=="--raw") raw=true;
+            else if(s=="--bytes" && i+1<argc) max_bytes=(uint64_t)std::strtoull(argv[++i], nullptr, 10);
+            else if(s=="--threads" && i+1<argc) threads=(unsigned)std::atoi(argv[++i]);
+            else if(s=="--repeat" && i+1<argc)  repeat=std::max(1, std::atoi(argv[++i]));
+        }
+        if(out.empty())
+        {
+            usage();
+            return 2;
+        }
+        if(out.size()>2 && eqi(out.substr(out.size()-2), ".y")) raw=true;
+
+        ProtoProfile prof=ProtoProfile::None;
+        uint32_t W=0,H=0;
+        std::string meta;
+        std::vector<int8_t>  bal;
+        std::vector<uint8_t> bytes;
+        if(t3proto::t3proto_peek_version(in)==3)
+        {
+            std::cerr<<"sequence .t3proto (v3): use decode-seq.\n";
+            return 1;
+        }
+        const bool v2 = (t3proto::t3proto_peek_version(in)==2);
+        t3proto::ProgressiveInfo PI;
+        uint64_t n_trits_used=0;
+        if(v2)
+        {
+            if(!t3proto::t3proto_read_progressive(in, PI, max_bytes))
+            {
+                std::cerr<<"read failed: "<<in<<"\n";
+                return 1;
+            }
+            prof=PI.profile;
+            W=PI.W;
+            H=PI.H;
+            meta=PI.meta;
+            for(const auto& S : PI.sec)
+                if(!S.data.empty() && S.enc==ProtoSecEnc::Base243) n_trits_used += S.n_items;
+        }
+        else if(!t3proto::t3proto_read(in, prof, W,H, &bal, &bytes, &meta))
+        {
+            std::cerr<<"read failed: "<<in<<"\n";
+            return 1;
+        }
+        if(!encode_prototype_available(prof))
+        {
+            std::cerr<<"profile not compiled in this build. Rebuild with -DPROTO_*.\n";
+            return 1;
+        }
+        if(!v2 && bal.empty())
+        {
+            // flux pack seul : n_trits du header (exact, crit par t3proto_write)
+            peek::Counts C{};
+            uint64_t ntr = (peek::read_counts(in, C) ? C.n_trits : 0);
+            if(ntr==0) ntr = t3proto::infer_ntrits_from_meta(prof, W,H, meta, (uint64_t)bytes.size());
+            if(ntr==0 || bytes.empty())
+            {
+                std::cerr<<"no trits in file (neither balanced nor packed).\n";
+                return 1;
+            }
+            unpack_base243_to_balanced(bytes, (size_t)ntr, bal);
+        }
+        if(!v2) n_trits_used = (uint64_t)bal.size();
+
+        ImageU8 Y;
+        double best_s=1e30;
+        for(int r=0; r<repeat; ++r)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            bool ok = v2 ? decode_prototype_progressive(prof, W,H, PI.sec, meta, Y, threads)
+                      : decode_prototype_ternary(prof, W,H, bal, meta, Y, threads);
+            auto t1 = std::chrono::steady_clock::now();
+            if(!ok)
+            {
+                std::cerr<<"decode_prototype_ternary failed (meta/params mismatch?).\n";
+                return 1;
+            }
+            best_s = std::min(best_s, std::chrono::duration<double>(t1-t0).count());
+        }
+
+        bool wrote=false;
+        if(raw)
+        {
+            std::FILE* f = std::fopen(out.c_str(), "wb");
+            if(f)
+            {
+                wrote = std::fwrite(Y.data.data(),1,Y.data.size(),f)==Y.data.size();
+                std::fclose(f);
+            }
+        }
+        else
+        {
+            ImageU8 rgb;
+            rgb.w=Y.w;
+            rgb.h=Y.h;
+            rgb.c=3;
+            rgb.data.resize((size_t)Y.w*Y.h*3);
+            for(size_t i=0; i<Y.data.size(); ++i)
+                ycbcr_to_rgb(Y.data[i],128,128, rgb.data[i*3+0],rgb.data[i*3+1],rgb.data[i*3+2]);
+            wrote = save_image_png(out, rgb);
+        }
+        if(!wrote)
+        {
+            std::cerr<<"write failed: "<<out<<"\n";
+            return 1;
+        }
+
+        const double mpix = (double)W*H/1e6;
+        std::cout<<"OK: decoded "<<in<<" -> "<<out<<"  ("<<W<<"x"<<H<<", trits="<<n_trits_used<<")\n";
+        if(v2)
+        {
+            std::cout<<"sections:";
+            for(const auto& S : PI.sec)
+                std::cout<<" "<<proto_section_name(S.kind)<<(S.data.empty()? "(missing)" : "");
+            std::cout<<"\n";
+        }
+        std::cout<<std::fixed<<std::setprecision(3)
+                 <<"time: "<<best_s*1e3<<" ms (best of "<<repeat<<")  "
+                 <<mpix/best_s<<" MPix/s  "
+                 <<(double)n_trits_used/1e6/best_s<<" Mtrits/s\n";
+        return 0;
+    }
+
+    // -------------------------------------------------------------------- THUMB
+    if(cmd=="thumb")
+    {
+        if(argc<5)
+        {
+            usage();
+            return 2;
+        }
+        std::string in=argv[2], out;
+        uint64_t max_bytes=UINT64_MAX;
+        for(int i=3; i<argc; ++i)
+        {
+            std::string s=argv[i];
+            if(s=="--out" && i+1<argc) out=argv[++i];
+            else if(s=="--bytes" && i+1<argc) max_bytes=(uint64_t)std::strtoull(argv[++i], nullptr, 10);
+        }
+        if(out.empty())
+        {
+            usage();
+            return 2;
+        }
+        t3proto::ProgressiveInfo PI;
+        if(t3proto::t3proto_peek_version(in)!=2 || !t3proto::t3proto_read_progressive(in, PI, max_bytes))
+        {
+            std::cerr<<"not a progressive .t3proto (v2): "<<in<<"\n";
+            return 1;
+        }
+        uint64_t N=0, gx=0, gy=0, qmin=0;
+        const bool haar = (PI.profile==ProtoProfile::HaarTernary);
+        if(!haar && meta_find_int(PI.meta, "len_tree", qmin) && meta_find_int(PI.meta, "qt_min", qmin))
+        {
+            // Quadtree : LL par feuille -> plan DC (sans dtails), 1 px par qt_min
+            std::vector<ProtoSection> dc;
+            for(const auto& S : PI.sec)
+                if(S.kind==ProtoSecKind::QTree || S.kind==ProtoSecKind::LL) dc.push_back(S);
+            ImageU8 Y;
+            if(qmin==0 || !decode_prototype_progressive(PI.profile, PI.W, PI.H, dc, PI.meta, Y, 0))
+            {
+                std::cerr<<"no usable qtree/LL sections in file.\n";
+                return 1;
+            }
+            gx=(PI.W+qmin-1)/qmin;
+            gy=(PI.H+qmin-1)/qmin;
+            ImageU8 rgb;
+            rgb.w=(int)gx;
+            rgb.h=(int)gy;
+            rgb.c=3;
+            rgb.data.resize((size_t)gx*gy*3);
+            for(uint64_t y=0; y<gy; ++y)
+                for(uint64_t x=0; x<gx; ++x)
+                {
+                    const size_t sy=std::min<size_t>((size_t)(y*qmin+qmin/2), (size_t)Y.h-1);
+                    const size_t sx=std::min<size_t>((size_t)(x*qmin+qmin/2), (size_t)Y.w-1);
+                    const size_t i=(size_t)(y*gx+x);
+                    ycbcr_to_rgb(Y.data[sy*(size_t)Y.w+sx],128,128, rgb.data[i*3+0],rgb.data[i*3+1],rgb.data[i*3+2]);
+                }
+            if(!save_image_png(out, rgb))
+            {
+                std::cerr<<"write failed: "<<out<<"\n";
+                return 1;
+            }
+            std::cout<<"OK: thumbnail "<<gx<<"x"<<gy<<" -> "<<out<<"\n";
+            return 0;
+        }
+        if(!meta_find_int(PI.meta, haar? "tile" : "block", N) || N==0)
+        {
+            std::cerr<<"missing tile/block size in meta.\n";
+            return 1;
+        }
+        gx=(PI.W+N-1)/N;
+        gy=(PI.H+N-1)/N;
+        const ProtoSection* LL=nullptr;
+        for(size_t k=0; k<PI.sec.size(); ++k)
+        {
+            if(PI.sec[k].kind!=ProtoSecKind::LL) continue;
+            if(PI.sec[k].data.empty())
+            {
+                std::cerr<<"LL section not within the first "<<max_bytes<<" bytes (needs "
+                         <<(PI.sec_offset[k]+PI.sec_bytes[k])<<").\n";
+                return 1;
+            }
+            LL=&PI.sec[k];
+        }
+        if(!LL || LL->data.size()!=gx*gy)
+        {
+            std::cerr<<"no usable LL section in file.\n";
+            return 1;
+        }
+        ImageU8 rgb;
+        rgb.w=(int)gx;
+        rgb.h=(int)gy;
+        rgb.c=3;
+        rgb.data.resize((size_t)gx*gy*3);
+        for(size_t i=0; i<LL->data.size(); ++i)
+            ycbcr_to_rgb(LL->data[i],128,128, rgb.data[i*3+0],rgb.data[i*3+1],rgb.data[i*3+2]);
+        if(!save_image_png(out, rgb))
+        {
+            std::cerr<<"write failed: "<<out<<"\n";
+            return 1;
+        }
+        std::cout<<"OK: thumbnail "<<gx<<"x"<<gy<<" -> "<<out<<"\n";
+        return 0;
+    }
+
     usage();
     return 2;
 }
@@ -136,22 +136,46 @@ static inline bool validate_sub(SubwordMode sub){
     return is_valid_subword(sub);
 }
 
-bool encode_raw_pixels_to_words_subword(const std::vector<PixelYCbCrQuant>& px,
+bool encode_raw_pixels_to_words_subword(const PixelYCbCrQuant* px, size_t n,
                                         SubwordMode sub,
                                         std::vector<Word27>& out_words)
 {
     if(!validate_sub(sub)) return false;
     // Impl. min : identique à la version non-subword
-    return encode_raw_pixels_to_words(px, out_words);
+    out_words.clear();
+    out_words.reserve(n);
+    for(size_t i=0; i<n; ++i){
+        Word27 w{};
+        w.u = pack13_from_quant(px[i]);
+        out_words.push_back(w);
+    }
+    return true;
 }
 
-bool decode_raw_words_to_pixels_subword(const std::vector<Word27>& in_words,
+bool decode_raw_words_to_pixels_subword(const Word27* in_words, size_t n,
                                         SubwordMode sub,
                                         std::vector<PixelYCbCrQuant>& out_px)
 {
     if(!validate_sub(sub)) return false;
     // Impl. min : identique à la version non-subword
-    return decode_raw_words_to_pixels(in_words, out_px);
+    out_px.clear();
+    out_px.reserve(n);
+    for(size_t i=0; i<n; ++i) out_px.push_back(unpack13_to_quant(in_words[i].u));
+    return true;
+}
+
+bool encode_raw_pixels_to_words_subword(const std::vector<PixelYCbCrQuant>& px,
+                                        SubwordMode sub,
+                                        std::vector<Word27>& out_words)
+{
+    return encode_raw_pixels_to_words_subword(px.data(), px.size(), sub, out_words);
+}
+
+bool decode_raw_words_to_pixels_subword(const std::vector<Word27>& in_words,
+                                        SubwordMode sub,
+                                        std::vector<PixelYCbCrQuant>& out_px)
+{
+    return decode_raw_words_to_pixels_subword(in_words.data(), in_words.size(), sub, out_px);
 }
 
 // ====================== [Section 5] Notes d’évolution =======================